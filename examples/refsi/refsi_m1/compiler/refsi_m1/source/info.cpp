@@ -26,7 +26,11 @@ namespace refsi_m1 {
 
 RefSiM1Info::RefSiM1Info(mux_device_info_t mux_device_info,
                          const riscv::hal_device_info_riscv_t *hal_device_info)
-    : RiscvInfo(mux_device_info, hal_device_info) {}
+    : RiscvInfo(mux_device_info, hal_device_info) {
+  // This target replaces the riscv late target passes with its own, which the
+  // riscv deferred compilation path would bypass.
+  supports_deferred_compilation = false;
+}
 
 std::unique_ptr<compiler::Target> RefSiM1Info::createTarget(
     compiler::Context *context, compiler::NotifyCallbackFn callback) const {
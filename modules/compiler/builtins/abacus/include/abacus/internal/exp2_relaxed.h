@@ -0,0 +1,68 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef __ABACUS_INTERNAL_EXP2_RELAXED_H__
+#define __ABACUS_INTERNAL_EXP2_RELAXED_H__
+
+#include <abacus/abacus_config.h>
+#include <abacus/abacus_detail_cast.h>
+#include <abacus/abacus_relational.h>
+#include <abacus/abacus_type_traits.h>
+#include <abacus/internal/floor_unsafe.h>
+#include <abacus/internal/horner_polynomial.h>
+#include <abacus/internal/ldexp_unsafe.h>
+
+namespace abacus {
+namespace internal {
+/// @brief Single precision 2^x for relaxed math builds.
+///
+/// Rounds x to the nearest integer k and approximates 2^(x - k) with a single
+/// polynomial, without any of the extra precision the full precision
+/// builtins carry through range reduction. The result is within 2 ULP of 2^x,
+/// which for `exp`, whose argument is rounded when scaled, is within the
+/// OpenCL 3.0 relaxed math bound of 3 + floor(fabs(2 * x)) ULP.
+/// There are no branches so the function can be vectorized.
+///
+/// @param[in] x Value to raise 2 to the power of.
+///
+/// @return 2^x, overflowing to infinity and underflowing to zero, or NaN if x
+/// is NaN.
+template <typename T>
+inline T exp2_relaxed(const T &x) {
+  using SignedType = typename TypeTraits<T>::SignedType;
+
+  // 0.5f gives a k whose reduced input is in the range [-0.5f, 0.5f]
+  const SignedType k = abacus::internal::floor_unsafe(x + 0.5f);
+  const T f = x - abacus::detail::cast::convert<T>(k);
+
+  // minimax from -0.5 -> 0.5 of 2^x, see exp2.sollya
+  const abacus_float polynomial[7] = {
+      1.0000000005541665f,    0.6931472057372673f,   0.24022646890634405f,
+      0.055503287769656406f,  0.009618488957102513f, 0.0013399931219124377f,
+      0.00015345812004000534f};
+
+  T result = abacus::internal::ldexp_unsafe(
+      abacus::internal::horner_polynomial(f, polynomial), k);
+
+  // Outside of this range k overflows the exponent of the result.
+  result = __abacus_select(result, 0.0f, x < -150.0f);
+  result = __abacus_select(result, ABACUS_INFINITY, x > 128.0f);
+  return __abacus_select(result, x, __abacus_isnan(x));
+}
+}  // namespace internal
+}  // namespace abacus
+
+#endif  //__ABACUS_INTERNAL_EXP2_RELAXED_H__
@@ -0,0 +1,81 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef __ABACUS_INTERNAL_LOG_RELAXED_H__
+#define __ABACUS_INTERNAL_LOG_RELAXED_H__
+
+#include <abacus/abacus_config.h>
+#include <abacus/abacus_detail_cast.h>
+#include <abacus/abacus_relational.h>
+#include <abacus/abacus_type_traits.h>
+#include <abacus/internal/horner_polynomial.h>
+
+namespace abacus {
+namespace internal {
+/// @brief Single precision natural logarithm for relaxed math builds.
+///
+/// Splits x into 2^k * (1 + f), with 1 + f in the range [sqrt(0.5), sqrt(2)),
+/// using integer operations rather than `frexp`, and evaluates
+/// log(1 + f) = 2 * atanh(f / (2 + f)) with a short polynomial. The result is
+/// within 1 ULP of log(x). There are no branches so the function can be
+/// vectorized.
+///
+/// @param[in] x Positive and finite value to take the logarithm of, results
+/// for zero, negative, infinite or NaN inputs are not meaningful.
+///
+/// @return log(x).
+template <typename T>
+inline T log_relaxed(const T &x) {
+  using SignedType = typename TypeTraits<T>::SignedType;
+
+  // Scale denormals by 2^25 so that their exponent bits are meaningful.
+  const SignedType xIsDenorm =
+      abacus::detail::cast::as<SignedType>(x) < (SignedType)0x00800000;
+  const T xNormal = __abacus_select(x, x * 33554432.0f, xIsDenorm);
+  SignedType k = __abacus_select((SignedType)0, (SignedType)-25, xIsDenorm);
+
+  // Subtracting the bit pattern of sqrt(0.5) moves the boundary between
+  // exponents, so that the significand lands in [sqrt(0.5), sqrt(2)).
+  const SignedType sqrtHalf = 0x3f3504f3;
+  const SignedType bits =
+      abacus::detail::cast::as<SignedType>(xNormal) - sqrtHalf;
+  k += bits >> 23;
+  const T f =
+      abacus::detail::cast::as<T>((bits & 0x007fffff) + sqrtHalf) - 1.0f;
+
+  // log(1 + f) = log((1 + s) / (1 - s)) where s = f / (2 + f), and
+  // log((1 + s) / (1 - s)) = 2s + s * r(s^2), r(z) = 2z/3 + 2z^2/5 + ...
+  const T s = f / (2.0f + f);
+  const T z = s * s;
+
+  // minimax from 0 -> 0.0295 of r(z) / z, see log.sollya
+  const abacus_float polynomial[3] = {6.6666683619e-01f, 3.9988943050e-01f,
+                                      2.9575951051e-01f};
+  const T r = z * abacus::internal::horner_polynomial(z, polynomial);
+
+  // 2s = f - f^2 / 2 + s * f^2 / 2, so the larger terms are added last to
+  // keep the rounding error small, and ln(2) is split in two so k * ln2Hi is
+  // exact.
+  const T halfFSquared = 0.5f * f * f;
+  const T kf = abacus::detail::cast::convert<T>(k);
+  const abacus_float ln2Hi = 6.9313812256e-01f;
+  const abacus_float ln2Lo = 9.0580006145e-06f;
+  return s * (halfFSquared + r) + kf * ln2Lo - halfFSquared + f + kf * ln2Hi;
+}
+}  // namespace internal
+}  // namespace abacus
+
+#endif  //__ABACUS_INTERNAL_LOG_RELAXED_H__
@@ -0,0 +1,76 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef __ABACUS_INTERNAL_SINCOS_RELAXED_H__
+#define __ABACUS_INTERNAL_SINCOS_RELAXED_H__
+
+#include <abacus/abacus_config.h>
+#include <abacus/abacus_detail_cast.h>
+#include <abacus/abacus_relational.h>
+#include <abacus/abacus_type_traits.h>
+#include <abacus/internal/floor_unsafe.h>
+#include <abacus/internal/sincos_approx.h>
+
+namespace abacus {
+namespace internal {
+/// @brief Single precision sine and cosine for relaxed math builds.
+///
+/// Replaces the Payne-Hanek range reduction of the full precision builtins
+/// with a three step Cody & Waite reduction by pi / 2, which has no branches
+/// so the function can be vectorized. The absolute error is below 2^-20 for
+/// |x| < 2^16, well within the OpenCL 3.0 relaxed math bound of 2^-11 in
+/// [-pi, pi], and grows for larger inputs as the reduction loses precision.
+///
+/// @param[in] x Angle in radians.
+/// @param[out] out_cos cos(x).
+///
+/// @return sin(x).
+template <typename T>
+inline T sincos_relaxed(const T &x, T *out_cos) {
+  using SignedType = typename TypeTraits<T>::SignedType;
+
+  // x = k * pi / 2 + r, with r in the range [-pi / 4, pi / 4].
+  const SignedType k = abacus::internal::floor_unsafe(x * ABACUS_2_PI_F + 0.5f);
+  const T kf = abacus::detail::cast::convert<T>(k);
+
+  // The first two parts of pi / 2 have enough trailing zero bits that their
+  // products with k are exact.
+  T r = x - kf * 1.5703125f;
+  r = r - kf * 4.837512969970703125e-4f;
+  r = r - kf * 7.54978995489188216e-8f;
+
+  T cosApprox;
+  const T sinApprox = abacus::internal::sincos_approx(r, &cosApprox);
+
+  // sin and cos swap in odd quadrants, and change sign every other quadrant.
+  const SignedType swap = SignedType((k & 0x1) != 0);
+  const T sinResult = __abacus_select(sinApprox, cosApprox, swap);
+  const T cosResult = __abacus_select(cosApprox, sinApprox, swap);
+
+  const SignedType notFinite = __abacus_isinf(x) | __abacus_isnan(x);
+
+  *out_cos = __abacus_select(cosResult, -cosResult,
+                             SignedType(((k + 1) & 0x2) != 0));
+  *out_cos = __abacus_select(*out_cos, FPShape<T>::NaN(), notFinite);
+
+  const T result =
+      __abacus_select(sinResult, -sinResult, SignedType((k & 0x2) != 0));
+  return __abacus_select(result, FPShape<T>::NaN(), notFinite);
+}
+}  // namespace internal
+}  // namespace abacus
+
+#endif  //__ABACUS_INTERNAL_SINCOS_RELAXED_H__
@@ -18,6 +18,7 @@
 #include <abacus/abacus_math.h>
 #include <abacus/internal/payne_hanek.h>
 #include <abacus/internal/sincos_approx.h>
+#include <abacus/internal/sincos_relaxed.h>
 
 namespace {
 template <typename T>
@@ -42,6 +43,18 @@ T cos(const T x) {
   return __abacus_select(-result, result, cond2);
 }
 
+// Single precision has a faster tier for relaxed math builds.
+template <typename T>
+T cos_float(const T x) {
+  if (__abacus_usefast()) {
+    T cosRelaxed;
+    abacus::internal::sincos_relaxed(x, &cosRelaxed);
+    return cosRelaxed;
+  }
+
+  return cos<>(x);
+}
+
 #ifdef __CA_BUILTINS_HALF_SUPPORT
 template <typename T>
 T cos_half(const T x) {
@@ -76,12 +89,22 @@ abacus_half8 ABACUS_API __abacus_cos(abacus_half8 x) { return cos_half<>(x); }
 abacus_half16 ABACUS_API __abacus_cos(abacus_half16 x) { return cos_half<>(x); }
 #endif  // __CA_BUILTINS_HALF_SUPPORT
 
-abacus_float ABACUS_API __abacus_cos(abacus_float x) { return cos<>(x); }
-abacus_float2 ABACUS_API __abacus_cos(abacus_float2 x) { return cos<>(x); }
-abacus_float3 ABACUS_API __abacus_cos(abacus_float3 x) { return cos<>(x); }
-abacus_float4 ABACUS_API __abacus_cos(abacus_float4 x) { return cos<>(x); }
-abacus_float8 ABACUS_API __abacus_cos(abacus_float8 x) { return cos<>(x); }
-abacus_float16 ABACUS_API __abacus_cos(abacus_float16 x) { return cos<>(x); }
+abacus_float ABACUS_API __abacus_cos(abacus_float x) { return cos_float<>(x); }
+abacus_float2 ABACUS_API __abacus_cos(abacus_float2 x) {
+  return cos_float<>(x);
+}
+abacus_float3 ABACUS_API __abacus_cos(abacus_float3 x) {
+  return cos_float<>(x);
+}
+abacus_float4 ABACUS_API __abacus_cos(abacus_float4 x) {
+  return cos_float<>(x);
+}
+abacus_float8 ABACUS_API __abacus_cos(abacus_float8 x) {
+  return cos_float<>(x);
+}
+abacus_float16 ABACUS_API __abacus_cos(abacus_float16 x) {
+  return cos_float<>(x);
+}
 
 #ifdef __CA_BUILTINS_DOUBLE_SUPPORT
 abacus_double ABACUS_API __abacus_cos(abacus_double x) { return cos<>(x); }
@@ -17,6 +17,7 @@
 #include <abacus/abacus_config.h>
 #include <abacus/abacus_detail_cast.h>
 #include <abacus/abacus_math.h>
+#include <abacus/internal/exp2_relaxed.h>
 #include <abacus/internal/exp_unsafe.h>
 
 namespace {
@@ -57,6 +58,10 @@ struct helper<T, abacus_half> {
 template <typename T>
 struct helper<T, abacus_float> {
   static T _(const T x) {
+    if (__abacus_usefast()) {
+      return abacus::internal::exp2_relaxed(x * ABACUS_LOG2E_F);
+    }
+
     T result = abacus::internal::exp_unsafe(x);
     result = __abacus_select(result, 0.0f, x < -110.0f);
     return __abacus_select(result, ABACUS_INFINITY, x > 89.0f);
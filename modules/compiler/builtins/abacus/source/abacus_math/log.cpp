@@ -20,6 +20,7 @@
 #include <abacus/abacus_relational.h>
 #include <abacus/abacus_type_traits.h>
 #include <abacus/internal/horner_polynomial.h>
+#include <abacus/internal/log_relaxed.h>
 
 namespace {
 template <typename T, typename E = typename TypeTraits<T>::ElementType>
@@ -120,7 +121,17 @@ struct helper<T, abacus_half> {
 
 template <typename T>
 struct helper<T, abacus_float> {
-  static T _(const T x) { return __abacus_log2(x) * ABACUS_LN2_F; }
+  static T _(const T x) {
+    if (__abacus_usefast()) {
+      T result = abacus::internal::log_relaxed(x);
+      result = __abacus_select(result, -ABACUS_INFINITY, x == 0.0f);
+      result = __abacus_select(result, ABACUS_INFINITY, __abacus_isinf(x));
+      return __abacus_select(result, FPShape<T>::NaN(),
+                             (x < 0.0f) | __abacus_isnan(x));
+    }
+
+    return __abacus_log2(x) * ABACUS_LN2_F;
+  }
 };
 
 #ifdef __CA_BUILTINS_DOUBLE_SUPPORT
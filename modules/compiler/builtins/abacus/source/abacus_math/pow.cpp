@@ -18,12 +18,16 @@
 #include <abacus/abacus_math.h>
 #include <abacus/abacus_relational.h>
 #include <abacus/abacus_type_traits.h>
+#include <abacus/internal/exp2_relaxed.h>
 #include <abacus/internal/is_odd.h>
+#include <abacus/internal/log_relaxed.h>
 #include <abacus/internal/pow_unsafe.h>
 
 namespace {
+// Applies the special cases of pow to result, an approximation of |x|^y that
+// is only required to be meaningful for finite, non-zero x and y.
 template <typename T>
-inline T pow(const T x, const T y) {
+inline T pow_special_cases(const T x, const T y, T result) {
   typedef typename TypeTraits<T>::SignedType SignedType;
 
   const T xAbs = __abacus_fabs(x);
@@ -41,12 +45,13 @@ inline T pow(const T x, const T y) {
 
   const SignedType xAbsInt = abacus::detail::cast::as<SignedType>(xAbs);
 
-  T result = abacus::internal::pow_unsafe(xAbs, y);
-
-  result =
-      __abacus_select(result, -result, SignedType(xIsNegative & yIsOddInt));
+  const SignedType resultIsNegative = xIsNegative & yIsOddInt;
+  result = __abacus_select(result, -result, resultIsNegative);
 
-  result = __abacus_select(result, T(0),
+  // Zero results keep the sign of x for odd integer y, e.g. pow(-0, 3) = -0
+  // and pow(-INFINITY, -3) = -0.
+  result = __abacus_select(result,
+                           __abacus_select(T(0), T(-0.0f), resultIsNegative),
                            SignedType(xIsInf | yIsInf | (xAbsInt == 0)));
 
   // Return positive INFINITY in the following conditions:
@@ -92,6 +97,28 @@ inline T pow(const T x, const T y) {
 
   return result;
 }
+
+template <typename T>
+inline T pow(const T x, const T y) {
+  return pow_special_cases(
+      x, y, abacus::internal::pow_unsafe(__abacus_fabs(x), y));
+}
+
+// Single precision has a faster tier for relaxed math builds, the OpenCL 3.0
+// relaxed math rules let pow be derived as exp2(y * log2(x)). Relaxed math
+// doesn't imply finite math, so the special cases are the same as for the
+// full precision path.
+template <typename T>
+inline T pow_float(const T x, const T y) {
+  if (__abacus_usefast()) {
+    const T result = abacus::internal::exp2_relaxed(
+        y * (abacus::internal::log_relaxed(__abacus_fabs(x)) *
+             ABACUS_LOG2E_F));
+    return pow_special_cases(x, y, result);
+  }
+
+  return pow<>(x, y);
+}
 }  // namespace
 
 #ifdef __CA_BUILTINS_HALF_SUPPORT
@@ -116,22 +143,22 @@ abacus_half16 ABACUS_API __abacus_pow(abacus_half16 x, abacus_half16 y) {
 #endif  // __CA_BUILTINS_HALF_SUPPORT
 
 abacus_float ABACUS_API __abacus_pow(abacus_float x, abacus_float y) {
-  return pow<>(x, y);
+  return pow_float<>(x, y);
 }
 abacus_float2 ABACUS_API __abacus_pow(abacus_float2 x, abacus_float2 y) {
-  return pow<>(x, y);
+  return pow_float<>(x, y);
 }
 abacus_float3 ABACUS_API __abacus_pow(abacus_float3 x, abacus_float3 y) {
-  return pow<>(x, y);
+  return pow_float<>(x, y);
 }
 abacus_float4 ABACUS_API __abacus_pow(abacus_float4 x, abacus_float4 y) {
-  return pow<>(x, y);
+  return pow_float<>(x, y);
 }
 abacus_float8 ABACUS_API __abacus_pow(abacus_float8 x, abacus_float8 y) {
-  return pow<>(x, y);
+  return pow_float<>(x, y);
 }
 abacus_float16 ABACUS_API __abacus_pow(abacus_float16 x, abacus_float16 y) {
-  return pow<>(x, y);
+  return pow_float<>(x, y);
 }
 
 #ifdef __CA_BUILTINS_DOUBLE_SUPPORT
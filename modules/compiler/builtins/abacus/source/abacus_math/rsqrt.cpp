@@ -22,6 +22,7 @@
 #include <abacus/abacus_type_traits.h>
 #include <abacus/internal/is_denorm.h>
 #include <abacus/internal/ldexp_unsafe.h>
+#include <abacus/internal/rsqrt_initial_guess.h>
 #include <abacus/internal/rsqrt_unsafe.h>
 
 namespace {
@@ -72,6 +73,10 @@ struct helper<T, abacus_float> {
     typedef typename TypeTraits<T>::SignedType SignedType;
     typedef typename TypeTraits<T>::UnsignedType UnsignedType;
 
+    if (__abacus_usefast()) {
+      return relaxed(x);
+    }
+
     const UnsignedType xUint = abacus::detail::cast::as<UnsignedType>(x);
 
     // We use the exact bounds for rtz as it also works with ftz and the
@@ -129,6 +134,42 @@ struct helper<T, abacus_float> {
 
     return ans;
   }
+
+  // Single precision has a faster tier for relaxed math builds. Evaluating
+  // x * y * y as (x * y) * y in the Newton-Raphson iterations keeps the
+  // intermediate values in range for large x, so only denormals need scaling.
+  static T relaxed(const T x) {
+    typedef typename TypeTraits<T>::SignedType SignedType;
+    typedef typename TypeTraits<T>::UnsignedType UnsignedType;
+
+    const UnsignedType xUint = abacus::detail::cast::as<UnsignedType>(x);
+
+    // See the full precision path above for the scaling of denormals.
+    const SignedType xSmall = abacus::internal::is_denorm(x);
+    const T processedX = __abacus_select(
+        x,
+        abacus::detail::cast::as<T>(xUint | 0x00800000u) * 16777216.0f -
+            __abacus_as_float(0x0C800000),
+        xSmall);
+
+    T ans = abacus::internal::rsqrt_initial_guess(processedX);
+    ans = 0.5f * ans * (3.0f - (processedX * ans) * ans);
+    ans = 0.5f * ans * (3.0f - (processedX * ans) * ans);
+
+    // Correcting the previous result, rather than computing a new one, in
+    // the last iteration keeps the error within 2 ULP.
+    ans = ans + 0.5f * ans * (1.0f - (processedX * ans) * ans);
+
+    ans = __abacus_select(ans, ans * 4096.0f, xSmall);
+
+    // Relaxed math doesn't imply finite math, so the special cases are the
+    // same as for the full precision path.
+    ans = __abacus_select(ans, 0.0f, __abacus_isinf(x));
+    ans = __abacus_select(ans, __abacus_copysign(ABACUS_INFINITY, x),
+                          x == 0.0f);
+    return __abacus_select(ans, FPShape<T>::NaN(),
+                           (x < 0.0f) | __abacus_isnan(x));
+  }
 };
 
 #ifdef __CA_BUILTINS_DOUBLE_SUPPORT
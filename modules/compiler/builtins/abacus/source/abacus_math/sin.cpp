@@ -18,6 +18,7 @@
 #include <abacus/abacus_math.h>
 #include <abacus/internal/payne_hanek.h>
 #include <abacus/internal/sincos_approx.h>
+#include <abacus/internal/sincos_relaxed.h>
 
 namespace {
 template <typename T>
@@ -42,6 +43,17 @@ T sin(const T x) {
   return __abacus_select(-result, result, cond2);
 }
 
+// Single precision has a faster tier for relaxed math builds.
+template <typename T>
+T sin_float(const T x) {
+  if (__abacus_usefast()) {
+    T cosRelaxed;
+    return abacus::internal::sincos_relaxed(x, &cosRelaxed);
+  }
+
+  return sin<>(x);
+}
+
 #ifdef __CA_BUILTINS_HALF_SUPPORT
 template <typename T>
 T sin_half(const T x) {
@@ -86,12 +98,22 @@ abacus_half8 ABACUS_API __abacus_sin(abacus_half8 x) { return sin_half<>(x); }
 abacus_half16 ABACUS_API __abacus_sin(abacus_half16 x) { return sin_half<>(x); }
 #endif  // __CA_BUILTINS_HALF_SUPPORT
 
-abacus_float ABACUS_API __abacus_sin(abacus_float x) { return sin<>(x); }
-abacus_float2 ABACUS_API __abacus_sin(abacus_float2 x) { return sin<>(x); }
-abacus_float3 ABACUS_API __abacus_sin(abacus_float3 x) { return sin<>(x); }
-abacus_float4 ABACUS_API __abacus_sin(abacus_float4 x) { return sin<>(x); }
-abacus_float8 ABACUS_API __abacus_sin(abacus_float8 x) { return sin<>(x); }
-abacus_float16 ABACUS_API __abacus_sin(abacus_float16 x) { return sin<>(x); }
+abacus_float ABACUS_API __abacus_sin(abacus_float x) { return sin_float<>(x); }
+abacus_float2 ABACUS_API __abacus_sin(abacus_float2 x) {
+  return sin_float<>(x);
+}
+abacus_float3 ABACUS_API __abacus_sin(abacus_float3 x) {
+  return sin_float<>(x);
+}
+abacus_float4 ABACUS_API __abacus_sin(abacus_float4 x) {
+  return sin_float<>(x);
+}
+abacus_float8 ABACUS_API __abacus_sin(abacus_float8 x) {
+  return sin_float<>(x);
+}
+abacus_float16 ABACUS_API __abacus_sin(abacus_float16 x) {
+  return sin_float<>(x);
+}
 
 #ifdef __CA_BUILTINS_DOUBLE_SUPPORT
 abacus_double ABACUS_API __abacus_sin(abacus_double x) { return sin<>(x); }
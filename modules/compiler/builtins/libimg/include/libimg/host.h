@@ -101,6 +101,29 @@ void HostInitializeImage(const cl_image_format& image_format,
 /// @param ptr Pointer to external storage.
 void HostAttachImageStorage(HostImage* image, void* ptr);
 
+/// @brief Check whether an image's data may be stored in the given layout.
+///
+/// The IMAGE_LAYOUT_TILED layout is supported by 2D, 2D array and 3D images
+/// with tightly packed rows and slices.
+///
+/// @param image Initialized image to query.
+/// @param layout Either IMAGE_LAYOUT_LINEAR or IMAGE_LAYOUT_TILED.
+///
+/// @return Returns true if the layout is supported, false otherwise.
+bool HostIsImageLayoutSupported(const HostImage* image, const UInt layout);
+
+/// @brief Set the layout of an image's data.
+///
+/// The layout must be set before the image data is initialized, existing data
+/// is not rearranged. All host side image manipulation functions and the
+/// kernel API account for the layout, images stored in the
+/// IMAGE_LAYOUT_TILED layout must not be accessed using their pitches.
+///
+/// @param image Image to set the layout of.
+/// @param layout Either IMAGE_LAYOUT_LINEAR or IMAGE_LAYOUT_TILED, must be
+/// supported as reported by libimg::HostIsImageLayoutSupported().
+void HostSetImageLayout(HostImage* image, const UInt layout);
+
 /// @brief Create a sampler from OpenCL sampler values.
 ///
 /// This function translates the original CL values to their CLK equivalents,
@@ -183,6 +206,34 @@ void HostCopyImage(const HostImage* src_image, HostImage* dst_image,
                    const size_t src_origin[3], const size_t dst_origin[3],
                    const size_t region[3]);
 
+/// @brief Copy rows of pixels from an image into linearly laid out memory.
+///
+/// Unlike libimg::HostReadImage the rows are stored at the offsets they would
+/// have in a linear image using the image's pitches, this is used to present
+/// an image with a non-linear layout to the host, e.g. when it is mapped.
+///
+/// @param image Image to read from.
+/// @param linear_offset Offset in bytes into the linear image data to begin
+/// copying from, must be a multiple of the pixel size.
+/// @param size Size in bytes of the linear image data to copy, must be a
+/// multiple of the pixel size.
+/// @param dst Memory holding the linear image data to write into.
+void HostCopyImageToLinear(const HostImage* image, const size_t linear_offset,
+                           const size_t size, uint8_t* dst);
+
+/// @brief Copy rows of pixels from linearly laid out memory into an image.
+///
+/// The inverse of libimg::HostCopyImageToLinear.
+///
+/// @param image Image to write into.
+/// @param linear_offset Offset in bytes into the linear image data to begin
+/// copying from, must be a multiple of the pixel size.
+/// @param size Size in bytes of the linear image data to copy, must be a
+/// multiple of the pixel size.
+/// @param src Memory holding the linear image data to read from.
+void HostCopyLinearToImage(HostImage* image, const size_t linear_offset,
+                           const size_t size, const uint8_t* src);
+
 /// @brief Copy from source image to destination buffer.
 ///
 /// @param src_image Source image to copy from.
@@ -196,6 +196,24 @@
 #define FILTER_MODE_MASK 0x30
 /// @}
 
+/// @brief Image storage layouts.
+/// @weakgroup Layouts
+/// @{
+
+/// @brief IMAGE_LAYOUT_LINEAR pixels are stored row by row, using the image's
+/// row and slice pitches.
+#define IMAGE_LAYOUT_LINEAR 0x0
+/// @brief IMAGE_LAYOUT_TILED each slice is split into bands of
+/// IMAGE_TILE_SIZE rows, each band is split into tiles of IMAGE_TILE_SIZE
+/// columns, and the pixels of a tile are stored contiguously row by row.
+///
+/// Tiles on the right and bottom edges of the image are narrowed to fit, so
+/// the storage size matches that of a tightly packed linear image.
+#define IMAGE_LAYOUT_TILED 0x1
+/// @brief Width and height in pixels of an IMAGE_LAYOUT_TILED tile.
+#define IMAGE_TILE_SIZE 8
+/// @}
+
 /// @brief Sampler, image_library's representation of sampler.
 typedef libimg::UInt Sampler;
 
@@ -219,8 +237,41 @@ typedef struct {
   libimg::Size row_pitch;
   /// @brief Size in bytes of a slice on the image.
   libimg::Size slice_pitch;
+  /// @brief Layout of the pixels in the image data, either IMAGE_LAYOUT_LINEAR
+  /// or IMAGE_LAYOUT_TILED.
+  libimg::UInt layout;
 } ImageMetaData;
 
+/// @brief Get the byte offset of a pixel from the start of the image data.
+///
+/// @param desc Description of the image.
+/// @param i Column of the pixel.
+/// @param j Row of the pixel, should be 0 for 1D images.
+/// @param k Slice of the pixel, layer for 1D and 2D image arrays.
+///
+/// @return Returns the offset in bytes of the pixel.
+inline libimg::Size ImageGetPixelOffset(const ImageMetaData& desc,
+                                       libimg::Size i, libimg::Size j,
+                                       libimg::Size k) {
+  if (IMAGE_LAYOUT_TILED != desc.layout) {
+    return desc.pixel_size * i + desc.row_pitch * j + desc.slice_pitch * k;
+  }
+  const libimg::Size tile_mask =
+      ~static_cast<libimg::Size>(IMAGE_TILE_SIZE - 1);
+  const libimg::Size tile_i = i & tile_mask;
+  const libimg::Size tile_j = j & tile_mask;
+  // Edge tiles are narrower and/or shorter than IMAGE_TILE_SIZE.
+  const libimg::Size remaining_width = desc.width - tile_i;
+  const libimg::Size remaining_height = desc.height - tile_j;
+  const libimg::Size tile_width =
+      remaining_width < IMAGE_TILE_SIZE ? remaining_width : IMAGE_TILE_SIZE;
+  const libimg::Size tile_height =
+      remaining_height < IMAGE_TILE_SIZE ? remaining_height : IMAGE_TILE_SIZE;
+  return desc.slice_pitch * k + desc.row_pitch * tile_j +
+         desc.pixel_size *
+             (tile_i * tile_height + (j - tile_j) * tile_width + (i - tile_i));
+}
+
 /// @brief An image object, used by both the host and kernel API's.
 typedef struct {
   /// @brief Embedded description of the image data.
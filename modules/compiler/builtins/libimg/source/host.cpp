@@ -24,6 +24,7 @@
 #include <libimg/shared.h>
 #include <libimg/validate.h>
 
+#include <algorithm>
 #include <cassert>
 #include <climits>
 #include <cstdlib>
@@ -59,6 +60,95 @@ static uint8_t *HostImageRawDataStorageInternalAddress(
   return HostImageAlignAddress(unaligned_raw_data);
 }
 
+// Calls `func(offset, index, count)` for each run of pixels in row `y` of slice
+// `z` which is contiguous in the image data, beginning with the pixel in column
+// `x` and spanning `width` pixels. `offset` is the byte offset of the run in
+// the image data, `index` is the position in pixels of the run in the span.
+template <typename F>
+static void HostForEachPixelRun(const ImageMetaData &desc, const size_t x,
+                                const size_t y, const size_t z,
+                                const size_t width, F &&func) {
+  if (IMAGE_LAYOUT_TILED != desc.layout) {
+    func(ImageGetPixelOffset(desc, x, y, z), size_t(0), width);
+    return;
+  }
+  for (size_t index = 0; index < width;) {
+    const size_t i = x + index;
+    const size_t count =
+        std::min(width - index, IMAGE_TILE_SIZE - (i % IMAGE_TILE_SIZE));
+    func(ImageGetPixelOffset(desc, i, y, z), index, count);
+    index += count;
+  }
+}
+
+// Calls `func(offset, linear_offset, count)` for each run of pixels which is
+// contiguous in the image data in the `size` bytes beginning at
+// `linear_offset` in the linear representation of the image data.
+template <typename F>
+static void HostForEachLinearPixelRun(const ImageMetaData &desc,
+                                      const size_t linear_offset,
+                                      const size_t size, F &&func) {
+  IMG_ASSERT(0 == linear_offset % desc.pixel_size,
+             "linear_offset must be a multiple of the pixel size!");
+  IMG_ASSERT(0 == size % desc.pixel_size,
+             "size must be a multiple of the pixel size!");
+  const size_t end = linear_offset + size;
+  for (size_t offset = linear_offset; offset < end;) {
+    const size_t z = offset / desc.slice_pitch;
+    const size_t y = (offset % desc.slice_pitch) / desc.row_pitch;
+    const size_t x = (offset % desc.row_pitch) / desc.pixel_size;
+    // Skip row and slice padding, which only exist in linear images.
+    if (y >= desc.height) {
+      offset = (z + 1) * desc.slice_pitch;
+      continue;
+    }
+    if (x >= desc.width) {
+      offset = z * desc.slice_pitch + (y + 1) * desc.row_pitch;
+      continue;
+    }
+    const size_t width =
+        std::min(desc.width - x, (end - offset) / desc.pixel_size);
+    HostForEachPixelRun(desc, x, y, z, width,
+                        [&](size_t image_offset, size_t index, size_t count) {
+                          func(image_offset,
+                               offset + index * desc.pixel_size, count);
+                        });
+    offset += width * desc.pixel_size;
+  }
+}
+
+bool libimg::HostIsImageLayoutSupported(const HostImage *image,
+                                        const UInt layout) {
+  IMG_ASSERT(image, "image must not be null!");
+  switch (layout) {
+    case IMAGE_LAYOUT_LINEAR:
+      return true;
+    case IMAGE_LAYOUT_TILED: {
+      const ImageMetaData &desc = image->image.meta_data;
+      switch (image->type) {
+        case CL_MEM_OBJECT_IMAGE2D:
+        case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+        case CL_MEM_OBJECT_IMAGE3D:
+          break;
+        default:
+          return false;
+      }
+      // Tiles span several rows, so padding at the end of rows or slices can
+      // not be represented.
+      return desc.row_pitch == desc.width * desc.pixel_size &&
+             desc.slice_pitch == desc.row_pitch * desc.height;
+    }
+    default:
+      return false;
+  }
+}
+
+void libimg::HostSetImageLayout(HostImage *image, const UInt layout) {
+  IMG_ASSERT(HostIsImageLayoutSupported(image, layout),
+             "layout is not supported by the image!");
+  image->image.meta_data.layout = layout;
+}
+
 libimg::HostSampler libimg::HostCreateSampler(
     const cl_bool normalized_coordinates,
     const cl_addressing_mode addressing_mode,
@@ -468,6 +558,7 @@ void libimg::HostInitializeImage(const cl_image_format &image_format,
                                  libimg::HostImage *image) {
   image->type = image_desc.image_type;
 
+  image->image.meta_data.layout = IMAGE_LAYOUT_LINEAR;
   image->image.meta_data.channel_order = image_format.image_channel_order;
   image->image.meta_data.channel_type = image_format.image_channel_data_type;
   image->image.meta_data.pixel_size = libimg::HostGetPixelSize(image_format);
@@ -566,18 +657,18 @@ void libimg::HostReadImage(const HostImage *image, const size_t origin[3],
                            const size_t region[3], const size_t dst_row_pitch,
                            const size_t dst_slice_pitch, uint8_t *dst) {
   const ImageMetaData &desc = image->image.meta_data;
-
-  const uint8_t *src = image->image.raw_data + origin[0] * desc.pixel_size;
-
-  const size_t row_size = region[0] * desc.pixel_size;
+  const uint8_t *src = image->image.raw_data;
 
   for (size_t z = 0; z < region[2]; ++z) {
-    const uint8_t *src_slice = src + (z + origin[2]) * desc.slice_pitch;
     uint8_t *dst_slice = dst + z * dst_slice_pitch;
     for (size_t y = 0; y < region[1]; ++y) {
-      const uint8_t *src_row = src_slice + (y + origin[1]) * desc.row_pitch;
       uint8_t *dst_row = dst_slice + y * dst_row_pitch;
-      std::memmove(dst_row, src_row, row_size);
+      HostForEachPixelRun(
+          desc, origin[0], y + origin[1], z + origin[2], region[0],
+          [&](size_t offset, size_t index, size_t count) {
+            std::memmove(dst_row + index * desc.pixel_size, src + offset,
+                         count * desc.pixel_size);
+          });
     }
   }
 }
@@ -586,22 +677,48 @@ void libimg::HostWriteImage(HostImage *image, const size_t origin[3],
                             const size_t region[3], const size_t src_row_pitch,
                             const size_t src_slice_pitch, const uint8_t *src) {
   const ImageMetaData &desc = image->image.meta_data;
-
-  uint8_t *dst = image->image.raw_data + origin[0] * desc.pixel_size;
-
-  const size_t row_size = region[0] * desc.pixel_size;
+  uint8_t *dst = image->image.raw_data;
 
   for (size_t z = 0; z < region[2]; ++z) {
     const uint8_t *src_slice = src + z * src_slice_pitch;
-    uint8_t *dst_slice = dst + (z + origin[2]) * desc.slice_pitch;
     for (size_t y = 0; y < region[1]; ++y) {
       const uint8_t *src_row = src_slice + y * src_row_pitch;
-      uint8_t *dst_row = dst_slice + (y + origin[1]) * desc.row_pitch;
-      std::memmove(dst_row, src_row, row_size);
+      HostForEachPixelRun(
+          desc, origin[0], y + origin[1], z + origin[2], region[0],
+          [&](size_t offset, size_t index, size_t count) {
+            std::memmove(dst + offset, src_row + index * desc.pixel_size,
+                         count * desc.pixel_size);
+          });
     }
   }
 }
 
+void libimg::HostCopyImageToLinear(const HostImage *image,
+                                   const size_t linear_offset,
+                                   const size_t size, uint8_t *dst) {
+  const ImageMetaData &desc = image->image.meta_data;
+  const uint8_t *src = image->image.raw_data;
+
+  HostForEachLinearPixelRun(
+      desc, linear_offset, size,
+      [&](size_t offset, size_t dst_offset, size_t count) {
+        std::memmove(dst + dst_offset, src + offset, count * desc.pixel_size);
+      });
+}
+
+void libimg::HostCopyLinearToImage(HostImage *image,
+                                   const size_t linear_offset,
+                                   const size_t size, const uint8_t *src) {
+  const ImageMetaData &desc = image->image.meta_data;
+  uint8_t *dst = image->image.raw_data;
+
+  HostForEachLinearPixelRun(
+      desc, linear_offset, size,
+      [&](size_t offset, size_t src_offset, size_t count) {
+        std::memmove(dst + offset, src + src_offset, count * desc.pixel_size);
+      });
+}
+
 libimg::UInt4 ShuffleOrder(const libimg::UInt order, const libimg::UInt4 &in) {
   switch (order)
   case CL_A: {
@@ -711,17 +828,18 @@ void libimg::HostFillImage(HostImage *image, const void *fill_color,
     }
   }
 
-  uint8_t *dst = image->image.raw_data + origin[0] * desc.pixel_size +
-                 origin[1] * desc.row_pitch + origin[2] * desc.slice_pitch;
+  uint8_t *dst = image->image.raw_data;
 
   for (size_t z = 0; z < region[2]; ++z) {
-    uint8_t *dst_slice = dst + z * desc.slice_pitch;
     for (size_t y = 0; y < region[1]; ++y) {
-      uint8_t *dst_row = dst_slice + y * desc.row_pitch;
-      for (size_t x = 0; x < region[0]; ++x) {
-        uint8_t *dst_pixel = dst_row + x * desc.pixel_size;
-        std::memcpy(dst_pixel, final_color, desc.pixel_size);
-      }
+      HostForEachPixelRun(desc, origin[0], y + origin[1], z + origin[2],
+                          region[0], [&](size_t offset, size_t, size_t count) {
+                            uint8_t *dst_run = dst + offset;
+                            for (size_t x = 0; x < count; ++x) {
+                              std::memcpy(dst_run + x * desc.pixel_size,
+                                          final_color, desc.pixel_size);
+                            }
+                          });
     }
   }
 }
@@ -732,24 +850,26 @@ void libimg::HostCopyImage(const HostImage *src_image, HostImage *dst_image,
   const ImageMetaData &src_desc = src_image->image.meta_data;
   const ImageMetaData &dst_desc = dst_image->image.meta_data;
 
-  const uint8_t *const src =
-      src_image->image.raw_data + src_origin[0] * src_desc.pixel_size;
-  uint8_t *const dst =
-      dst_image->image.raw_data + dst_origin[0] * dst_desc.pixel_size;
-
-  const size_t z_max = region[2];
-  const size_t y_max = region[1];
-  const size_t x_size = region[0] * src_desc.pixel_size;
-
-  for (size_t z = 0; z < z_max; z++) {
-    const uint8_t *const src_slice =
-        src + (z + src_origin[2]) * src_desc.slice_pitch;
-    uint8_t *const dst_slice = dst + (z + dst_origin[2]) * dst_desc.slice_pitch;
-    for (size_t y = 0; y < y_max; y++) {
-      const uint8_t *const src_row =
-          src_slice + (y + src_origin[1]) * src_desc.row_pitch;
-      uint8_t *dst_row = dst_slice + (y + dst_origin[1]) * dst_desc.row_pitch;
-      std::memmove(dst_row, src_row, x_size);
+  const uint8_t *const src = src_image->image.raw_data;
+  uint8_t *const dst = dst_image->image.raw_data;
+  const size_t pixel_size = src_desc.pixel_size;
+
+  for (size_t z = 0; z < region[2]; z++) {
+    for (size_t y = 0; y < region[1]; y++) {
+      // Split each contiguous run of the source row by the contiguous runs of
+      // the destination row, which differ when the image layouts differ.
+      HostForEachPixelRun(
+          src_desc, src_origin[0], y + src_origin[1], z + src_origin[2],
+          region[0], [&](size_t src_offset, size_t src_index, size_t count) {
+            HostForEachPixelRun(
+                dst_desc, dst_origin[0] + src_index, y + dst_origin[1],
+                z + dst_origin[2], count,
+                [&](size_t dst_offset, size_t dst_index, size_t dst_count) {
+                  std::memmove(dst + dst_offset,
+                               src + src_offset + dst_index * pixel_size,
+                               dst_count * pixel_size);
+                });
+          });
     }
   }
 }
@@ -760,22 +880,20 @@ void libimg::HostCopyImageToBuffer(const HostImage *src_image, void *dst_buffer,
                                    const size_t dst_offset) {
   const ImageMetaData &desc = src_image->image.meta_data;
 
-  const uint8_t *const src =
-      src_image->image.raw_data + desc.pixel_size * src_origin[0] +
-      src_origin[1] * desc.row_pitch + src_origin[2] * desc.slice_pitch;
-  uint8_t *const dst = static_cast<uint8_t *>(dst_buffer) + dst_offset;
-
-  const size_t z_max = region[2];
-  const size_t y_max = region[1];
-  const size_t x_size = region[0] * desc.pixel_size;
-
-  uint8_t *dst_row = dst;
-  for (size_t z = 0; z < z_max; z++) {
-    const uint8_t *src_row = src + desc.slice_pitch * z;
-    for (size_t y = 0; y < y_max; y++) {
-      std::memmove(dst_row, src_row, x_size);
-      dst_row += x_size;
-      src_row += desc.row_pitch;
+  const uint8_t *const src = src_image->image.raw_data;
+  uint8_t *dst_row = static_cast<uint8_t *>(dst_buffer) + dst_offset;
+
+  const size_t row_size = region[0] * desc.pixel_size;
+
+  for (size_t z = 0; z < region[2]; z++) {
+    for (size_t y = 0; y < region[1]; y++) {
+      HostForEachPixelRun(
+          desc, src_origin[0], y + src_origin[1], z + src_origin[2], region[0],
+          [&](size_t offset, size_t index, size_t count) {
+            std::memmove(dst_row + index * desc.pixel_size, src + offset,
+                         count * desc.pixel_size);
+          });
+      dst_row += row_size;
     }
   }
 }
@@ -786,28 +904,20 @@ void libimg::HostCopyBufferToImage(const void *src_buffer, HostImage *dst_image,
                                    const size_t region[3]) {
   const ImageMetaData &desc = dst_image->image.meta_data;
 
-  const uint8_t *src = static_cast<const uint8_t *>(src_buffer) + src_offset;
-  uint8_t *dst = dst_image->image.raw_data;
+  const uint8_t *src_row = static_cast<const uint8_t *>(src_buffer) + src_offset;
+  uint8_t *const dst = dst_image->image.raw_data;
 
-  const size_t z_max = dst_origin[2] + region[2];
-  const size_t y_max = dst_origin[1] + region[1];
-  const size_t x_size = region[0] * desc.pixel_size;
-
-  const size_t region_slice_pitch = region[1] * region[0] * desc.pixel_size;
-  const size_t region_row_pitch = region[0] * desc.pixel_size;
-
-  for (size_t z = dst_origin[2]; z < z_max; z++) {
-    const uint8_t *src_row = src;
-    uint8_t *dst_row = dst;
-
-    for (size_t y = dst_origin[1]; y < y_max; y++) {
-      std::memmove(dst_row, src_row, x_size);
+  const size_t row_size = region[0] * desc.pixel_size;
 
-      src_row += region_row_pitch;
-      dst_row += desc.row_pitch;
+  for (size_t z = 0; z < region[2]; z++) {
+    for (size_t y = 0; y < region[1]; y++) {
+      HostForEachPixelRun(
+          desc, dst_origin[0], y + dst_origin[1], z + dst_origin[2], region[0],
+          [&](size_t offset, size_t index, size_t count) {
+            std::memmove(dst + offset, src_row + index * desc.pixel_size,
+                         count * desc.pixel_size);
+          });
+      src_row += row_size;
     }
-
-    src += region_slice_pitch;
-    dst += desc.slice_pitch;
   }
 }
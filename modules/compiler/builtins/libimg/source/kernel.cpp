@@ -2125,7 +2125,7 @@ inline VecTy image_2d_sampler_read_helper(const libimg::Float2 &coord,
           }
 
           const void *data =
-              &raw_image_data[desc.pixel_size * i + desc.row_pitch * j];
+              &raw_image_data[ImageGetPixelOffset(desc, i, j, 0)];
           return read_vec4(data, desc.channel_order, desc.channel_type);
           break;
         }
@@ -2196,7 +2196,7 @@ inline VecTy image_2d_sampler_read_helper(const libimg::Float2 &coord,
         }
       }
       const void *data =
-          &raw_image_data[desc.pixel_size * i + desc.row_pitch * j];
+          &raw_image_data[ImageGetPixelOffset(desc, i, j, 0)];
       return read_vec4(data, desc.channel_order, desc.channel_type);
     }
     case CLK_FILTER_LINEAR: {
@@ -2236,23 +2236,23 @@ inline VecTy image_2d_sampler_read_helper(const libimg::Float2 &coord,
 
           t_i0j0 = (i0_outside || j0_outside)
                        ? border_res
-                       : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                   desc.row_pitch * j0],
+                       : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                       desc, i0, j0, 0)],
                                    desc.channel_order, desc.channel_type);
           t_i1j0 = (i1_outside || j0_outside)
                        ? border_res
-                       : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                   desc.row_pitch * j0],
+                       : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                       desc, i1, j0, 0)],
                                    desc.channel_order, desc.channel_type);
           t_i0j1 = (i0_outside || j1_outside)
                        ? border_res
-                       : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                   desc.row_pitch * j1],
+                       : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                       desc, i0, j1, 0)],
                                    desc.channel_order, desc.channel_type);
           t_i1j1 = (i1_outside || j1_outside)
                        ? border_res
-                       : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                   desc.row_pitch * j1],
+                       : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                       desc, i1, j1, 0)],
                                    desc.channel_order, desc.channel_type);
 
           break;
@@ -2280,23 +2280,23 @@ inline VecTy image_2d_sampler_read_helper(const libimg::Float2 &coord,
 
           t_i0j0 = (i0_outside || j0_outside)
                        ? border_res
-                       : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                   desc.row_pitch * j0],
+                       : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                       desc, i0, j0, 0)],
                                    desc.channel_order, desc.channel_type);
           t_i1j0 = (i1_outside || j0_outside)
                        ? border_res
-                       : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                   desc.row_pitch * j0],
+                       : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                       desc, i1, j0, 0)],
                                    desc.channel_order, desc.channel_type);
           t_i0j1 = (i0_outside || j1_outside)
                        ? border_res
-                       : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                   desc.row_pitch * j1],
+                       : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                       desc, i0, j1, 0)],
                                    desc.channel_order, desc.channel_type);
           t_i1j1 = (i1_outside || j1_outside)
                        ? border_res
-                       : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                   desc.row_pitch * j1],
+                       : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                       desc, i1, j1, 0)],
                                    desc.channel_order, desc.channel_type);
           break;
         }
@@ -2323,23 +2323,23 @@ inline VecTy image_2d_sampler_read_helper(const libimg::Float2 &coord,
 
           t_i0j0 = (i0_outside || j0_outside)
                        ? border_res
-                       : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                   desc.row_pitch * j0],
+                       : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                       desc, i0, j0, 0)],
                                    desc.channel_order, desc.channel_type);
           t_i1j0 = (i1_outside || j0_outside)
                        ? border_res
-                       : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                   desc.row_pitch * j0],
+                       : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                       desc, i1, j0, 0)],
                                    desc.channel_order, desc.channel_type);
           t_i0j1 = (i0_outside || j1_outside)
                        ? border_res
-                       : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                   desc.row_pitch * j1],
+                       : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                       desc, i0, j1, 0)],
                                    desc.channel_order, desc.channel_type);
           t_i1j1 = (i1_outside || j1_outside)
                        ? border_res
-                       : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                   desc.row_pitch * j1],
+                       : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                       desc, i1, j1, 0)],
                                    desc.channel_order, desc.channel_type);
           break;
         }
@@ -2382,16 +2382,16 @@ inline VecTy image_2d_sampler_read_helper(const libimg::Float2 &coord,
           b = frac(v - 0.5f);
 
           t_i0j0 = read_vec4(
-              &raw_image_data[desc.pixel_size * i0 + desc.row_pitch * j0],
+              &raw_image_data[ImageGetPixelOffset(desc, i0, j0, 0)],
               desc.channel_order, desc.channel_type);
           t_i1j0 = read_vec4(
-              &raw_image_data[desc.pixel_size * i1 + desc.row_pitch * j0],
+              &raw_image_data[ImageGetPixelOffset(desc, i1, j0, 0)],
               desc.channel_order, desc.channel_type);
           t_i0j1 = read_vec4(
-              &raw_image_data[desc.pixel_size * i0 + desc.row_pitch * j1],
+              &raw_image_data[ImageGetPixelOffset(desc, i0, j1, 0)],
               desc.channel_order, desc.channel_type);
           t_i1j1 = read_vec4(
-              &raw_image_data[desc.pixel_size * i1 + desc.row_pitch * j1],
+              &raw_image_data[ImageGetPixelOffset(desc, i1, j1, 0)],
               desc.channel_order, desc.channel_type);
           break;
         }
@@ -2429,16 +2429,16 @@ inline VecTy image_2d_sampler_read_helper(const libimg::Float2 &coord,
           b = frac(v - 0.5f);
 
           t_i0j0 = read_vec4(
-              &raw_image_data[desc.pixel_size * i0 + desc.row_pitch * j0],
+              &raw_image_data[ImageGetPixelOffset(desc, i0, j0, 0)],
               desc.channel_order, desc.channel_type);
           t_i1j0 = read_vec4(
-              &raw_image_data[desc.pixel_size * i1 + desc.row_pitch * j0],
+              &raw_image_data[ImageGetPixelOffset(desc, i1, j0, 0)],
               desc.channel_order, desc.channel_type);
           t_i0j1 = read_vec4(
-              &raw_image_data[desc.pixel_size * i0 + desc.row_pitch * j1],
+              &raw_image_data[ImageGetPixelOffset(desc, i0, j1, 0)],
               desc.channel_order, desc.channel_type);
           t_i1j1 = read_vec4(
-              &raw_image_data[desc.pixel_size * i1 + desc.row_pitch * j1],
+              &raw_image_data[ImageGetPixelOffset(desc, i1, j1, 0)],
               desc.channel_order, desc.channel_type);
           break;
         }
@@ -2519,8 +2519,7 @@ inline VecTy image_3d_sampler_read_helper(const libimg::Float4 &coord,
           }
 
           const void *data =
-              &raw_image_data[desc.pixel_size * i + desc.row_pitch * j +
-                              desc.slice_pitch * k];
+              &raw_image_data[ImageGetPixelOffset(desc, i, j, k)];
           return read_vec4(data, desc.channel_order, desc.channel_type);
         }
         case CLK_ADDRESS_CLAMP: {
@@ -2540,8 +2539,7 @@ inline VecTy image_3d_sampler_read_helper(const libimg::Float4 &coord,
           }
 
           const void *data =
-              &raw_image_data[desc.pixel_size * i + desc.row_pitch * j +
-                              desc.slice_pitch * k];
+              &raw_image_data[ImageGetPixelOffset(desc, i, j, k)];
           return read_vec4(data, desc.channel_order, desc.channel_type);
         }
         case CLK_ADDRESS_NONE: {
@@ -2561,8 +2559,7 @@ inline VecTy image_3d_sampler_read_helper(const libimg::Float4 &coord,
           }
 
           const void *data =
-              &raw_image_data[desc.pixel_size * i + desc.row_pitch * j +
-                              desc.slice_pitch * k];
+              &raw_image_data[ImageGetPixelOffset(desc, i, j, k)];
           return read_vec4(data, desc.channel_order, desc.channel_type);
         }
         case CLK_ADDRESS_REPEAT: {
@@ -2599,8 +2596,7 @@ inline VecTy image_3d_sampler_read_helper(const libimg::Float4 &coord,
             k = k - depth;
           }
           const void *data =
-              &raw_image_data[desc.pixel_size * i + desc.row_pitch * j +
-                              desc.slice_pitch * k];
+              &raw_image_data[ImageGetPixelOffset(desc, i, j, k)];
           return read_vec4(data, desc.channel_order, desc.channel_type);
         }
         case CLK_ADDRESS_MIRRORED_REPEAT: {
@@ -2638,8 +2634,7 @@ inline VecTy image_3d_sampler_read_helper(const libimg::Float4 &coord,
           k = libimg::min(k, static_cast<libimg::Int>(depth - 1));
 
           const void *data =
-              &raw_image_data[desc.pixel_size * i + desc.row_pitch * j +
-                              desc.slice_pitch * k];
+              &raw_image_data[ImageGetPixelOffset(desc, i, j, k)];
           return read_vec4(data, desc.channel_order, desc.channel_type);
         }
       }
@@ -2694,51 +2689,43 @@ inline VecTy image_3d_sampler_read_helper(const libimg::Float4 &coord,
 
           t_i0j0k0 = (i0_outside || j0_outside || k0_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                     desc.row_pitch * j0 +
-                                                     desc.slice_pitch * k0],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i0, j0, k0)],
                                      desc.channel_order, desc.channel_type);
           t_i1j0k0 = (i1_outside || j0_outside || k0_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                     desc.row_pitch * j0 +
-                                                     desc.slice_pitch * k0],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i1, j0, k0)],
                                      desc.channel_order, desc.channel_type);
           t_i0j1k0 = (i0_outside || j1_outside || k0_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                     desc.row_pitch * j1 +
-                                                     desc.slice_pitch * k0],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i0, j1, k0)],
                                      desc.channel_order, desc.channel_type);
           t_i1j1k0 = (i1_outside || j1_outside || k0_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                     desc.row_pitch * j1 +
-                                                     desc.slice_pitch * k0],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i1, j1, k0)],
                                      desc.channel_order, desc.channel_type);
           t_i0j0k1 = (i0_outside || j0_outside || k1_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                     desc.row_pitch * j0 +
-                                                     desc.slice_pitch * k1],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i0, j0, k1)],
                                      desc.channel_order, desc.channel_type);
           t_i1j0k1 = (i1_outside || j0_outside || k1_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                     desc.row_pitch * j0 +
-                                                     desc.slice_pitch * k1],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i1, j0, k1)],
                                      desc.channel_order, desc.channel_type);
           t_i0j1k1 = (i0_outside || j1_outside || k1_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                     desc.row_pitch * j1 +
-                                                     desc.slice_pitch * k1],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i0, j1, k1)],
                                      desc.channel_order, desc.channel_type);
           t_i1j1k1 = (i1_outside || j1_outside || k1_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                     desc.row_pitch * j1 +
-                                                     desc.slice_pitch * k1],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i1, j1, k1)],
                                      desc.channel_order, desc.channel_type);
 
           a = frac(u - 0.5f);
@@ -2776,51 +2763,43 @@ inline VecTy image_3d_sampler_read_helper(const libimg::Float4 &coord,
 
           t_i0j0k0 = (i0_outside || j0_outside || k0_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                     desc.row_pitch * j0 +
-                                                     desc.slice_pitch * k0],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i0, j0, k0)],
                                      desc.channel_order, desc.channel_type);
           t_i1j0k0 = (i1_outside || j0_outside || k0_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                     desc.row_pitch * j0 +
-                                                     desc.slice_pitch * k0],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i1, j0, k0)],
                                      desc.channel_order, desc.channel_type);
           t_i0j1k0 = (i0_outside || j1_outside || k0_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                     desc.row_pitch * j1 +
-                                                     desc.slice_pitch * k0],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i0, j1, k0)],
                                      desc.channel_order, desc.channel_type);
           t_i1j1k0 = (i1_outside || j1_outside || k0_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                     desc.row_pitch * j1 +
-                                                     desc.slice_pitch * k0],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i1, j1, k0)],
                                      desc.channel_order, desc.channel_type);
           t_i0j0k1 = (i0_outside || j0_outside || k1_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                     desc.row_pitch * j0 +
-                                                     desc.slice_pitch * k1],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i0, j0, k1)],
                                      desc.channel_order, desc.channel_type);
           t_i1j0k1 = (i1_outside || j0_outside || k1_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                     desc.row_pitch * j0 +
-                                                     desc.slice_pitch * k1],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i1, j0, k1)],
                                      desc.channel_order, desc.channel_type);
           t_i0j1k1 = (i0_outside || j1_outside || k1_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                     desc.row_pitch * j1 +
-                                                     desc.slice_pitch * k1],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i0, j1, k1)],
                                      desc.channel_order, desc.channel_type);
           t_i1j1k1 = (i1_outside || j1_outside || k1_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                     desc.row_pitch * j1 +
-                                                     desc.slice_pitch * k1],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i1, j1, k1)],
                                      desc.channel_order, desc.channel_type);
 
           a = frac(u - 0.5f);
@@ -2858,51 +2837,43 @@ inline VecTy image_3d_sampler_read_helper(const libimg::Float4 &coord,
 
           t_i0j0k0 = (i0_outside || j0_outside || k0_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                     desc.row_pitch * j0 +
-                                                     desc.slice_pitch * k0],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i0, j0, k0)],
                                      desc.channel_order, desc.channel_type);
           t_i1j0k0 = (i1_outside || j0_outside || k0_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                     desc.row_pitch * j0 +
-                                                     desc.slice_pitch * k0],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i1, j0, k0)],
                                      desc.channel_order, desc.channel_type);
           t_i0j1k0 = (i0_outside || j1_outside || k0_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                     desc.row_pitch * j1 +
-                                                     desc.slice_pitch * k0],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i0, j1, k0)],
                                      desc.channel_order, desc.channel_type);
           t_i1j1k0 = (i1_outside || j1_outside || k0_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                     desc.row_pitch * j1 +
-                                                     desc.slice_pitch * k0],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i1, j1, k0)],
                                      desc.channel_order, desc.channel_type);
           t_i0j0k1 = (i0_outside || j0_outside || k1_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                     desc.row_pitch * j0 +
-                                                     desc.slice_pitch * k1],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i0, j0, k1)],
                                      desc.channel_order, desc.channel_type);
           t_i1j0k1 = (i1_outside || j0_outside || k1_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                     desc.row_pitch * j0 +
-                                                     desc.slice_pitch * k1],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i1, j0, k1)],
                                      desc.channel_order, desc.channel_type);
           t_i0j1k1 = (i0_outside || j1_outside || k1_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i0 +
-                                                     desc.row_pitch * j1 +
-                                                     desc.slice_pitch * k1],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i0, j1, k1)],
                                      desc.channel_order, desc.channel_type);
           t_i1j1k1 = (i1_outside || j1_outside || k1_outside)
                          ? border_res
-                         : read_vec4(&raw_image_data[desc.pixel_size * i1 +
-                                                     desc.row_pitch * j1 +
-                                                     desc.slice_pitch * k1],
+                         : read_vec4(&raw_image_data[ImageGetPixelOffset(
+                                                         desc, i1, j1, k1)],
                                      desc.channel_order, desc.channel_type);
 
           a = frac(u - 0.5f);
@@ -2962,36 +2933,28 @@ inline VecTy image_3d_sampler_read_helper(const libimg::Float4 &coord,
           c = frac(w - 0.5f);
 
           t_i0j0k0 = read_vec4(
-              &raw_image_data[desc.pixel_size * i0 + desc.row_pitch * j0 +
-                              desc.slice_pitch * k0],
+              &raw_image_data[ImageGetPixelOffset(desc, i0, j0, k0)],
               desc.channel_order, desc.channel_type);
           t_i1j0k0 = read_vec4(
-              &raw_image_data[desc.pixel_size * i1 + desc.row_pitch * j0 +
-                              desc.slice_pitch * k0],
+              &raw_image_data[ImageGetPixelOffset(desc, i1, j0, k0)],
               desc.channel_order, desc.channel_type);
           t_i0j1k0 = read_vec4(
-              &raw_image_data[desc.pixel_size * i0 + desc.row_pitch * j1 +
-                              desc.slice_pitch * k0],
+              &raw_image_data[ImageGetPixelOffset(desc, i0, j1, k0)],
               desc.channel_order, desc.channel_type);
           t_i1j1k0 = read_vec4(
-              &raw_image_data[desc.pixel_size * i1 + desc.row_pitch * j1 +
-                              desc.slice_pitch * k0],
+              &raw_image_data[ImageGetPixelOffset(desc, i1, j1, k0)],
               desc.channel_order, desc.channel_type);
           t_i0j0k1 = read_vec4(
-              &raw_image_data[desc.pixel_size * i0 + desc.row_pitch * j0 +
-                              desc.slice_pitch * k1],
+              &raw_image_data[ImageGetPixelOffset(desc, i0, j0, k1)],
               desc.channel_order, desc.channel_type);
           t_i1j0k1 = read_vec4(
-              &raw_image_data[desc.pixel_size * i1 + desc.row_pitch * j0 +
-                              desc.slice_pitch * k1],
+              &raw_image_data[ImageGetPixelOffset(desc, i1, j0, k1)],
               desc.channel_order, desc.channel_type);
           t_i0j1k1 = read_vec4(
-              &raw_image_data[desc.pixel_size * i0 + desc.row_pitch * j1 +
-                              desc.slice_pitch * k1],
+              &raw_image_data[ImageGetPixelOffset(desc, i0, j1, k1)],
               desc.channel_order, desc.channel_type);
           t_i1j1k1 = read_vec4(
-              &raw_image_data[desc.pixel_size * i1 + desc.row_pitch * j1 +
-                              desc.slice_pitch * k1],
+              &raw_image_data[ImageGetPixelOffset(desc, i1, j1, k1)],
               desc.channel_order, desc.channel_type);
 
           break;
@@ -3041,36 +3004,28 @@ inline VecTy image_3d_sampler_read_helper(const libimg::Float4 &coord,
           c = frac(w - 0.5f);
 
           t_i0j0k0 = read_vec4(
-              &raw_image_data[desc.pixel_size * i0 + desc.row_pitch * j0 +
-                              desc.slice_pitch * k0],
+              &raw_image_data[ImageGetPixelOffset(desc, i0, j0, k0)],
               desc.channel_order, desc.channel_type);
           t_i1j0k0 = read_vec4(
-              &raw_image_data[desc.pixel_size * i1 + desc.row_pitch * j0 +
-                              desc.slice_pitch * k0],
+              &raw_image_data[ImageGetPixelOffset(desc, i1, j0, k0)],
               desc.channel_order, desc.channel_type);
           t_i0j1k0 = read_vec4(
-              &raw_image_data[desc.pixel_size * i0 + desc.row_pitch * j1 +
-                              desc.slice_pitch * k0],
+              &raw_image_data[ImageGetPixelOffset(desc, i0, j1, k0)],
               desc.channel_order, desc.channel_type);
           t_i1j1k0 = read_vec4(
-              &raw_image_data[desc.pixel_size * i1 + desc.row_pitch * j1 +
-                              desc.slice_pitch * k0],
+              &raw_image_data[ImageGetPixelOffset(desc, i1, j1, k0)],
               desc.channel_order, desc.channel_type);
           t_i0j0k1 = read_vec4(
-              &raw_image_data[desc.pixel_size * i0 + desc.row_pitch * j0 +
-                              desc.slice_pitch * k1],
+              &raw_image_data[ImageGetPixelOffset(desc, i0, j0, k1)],
               desc.channel_order, desc.channel_type);
           t_i1j0k1 = read_vec4(
-              &raw_image_data[desc.pixel_size * i1 + desc.row_pitch * j0 +
-                              desc.slice_pitch * k1],
+              &raw_image_data[ImageGetPixelOffset(desc, i1, j0, k1)],
               desc.channel_order, desc.channel_type);
           t_i0j1k1 = read_vec4(
-              &raw_image_data[desc.pixel_size * i0 + desc.row_pitch * j1 +
-                              desc.slice_pitch * k1],
+              &raw_image_data[ImageGetPixelOffset(desc, i0, j1, k1)],
               desc.channel_order, desc.channel_type);
           t_i1j1k1 = read_vec4(
-              &raw_image_data[desc.pixel_size * i1 + desc.row_pitch * j1 +
-                              desc.slice_pitch * k1],
+              &raw_image_data[ImageGetPixelOffset(desc, i1, j1, k1)],
               desc.channel_order, desc.channel_type);
 
           break;
@@ -3485,36 +3440,28 @@ libimg::UInt4 __Codeplay_read_imageui_1d(Image *image, Sampler sampler,
 /* =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-= */
 libimg::Float4 __Codeplay_read_imagef_3d(Image *image, libimg::Int4 coord) {
   ImageMetaData &desc = image->meta_data;
-  const void *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v4<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v4<libimg::Int>(
-                                            coord, libimg::vec_elem::y) +
-                       desc.slice_pitch * libimg::get_v4<libimg::Int>(
-                                              coord, libimg::vec_elem::z)];
+  const void *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::y),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::z))];
   return float4_reader::read(data, desc.channel_order, desc.channel_type);
 }
 
 libimg::Float4 __Codeplay_read_imagef_2d_array(Image *image,
                                                libimg::Int4 coord) {
   ImageMetaData &desc = image->meta_data;
-  const void *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v4<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v4<libimg::Int>(
-                                            coord, libimg::vec_elem::y) +
-                       desc.slice_pitch * libimg::get_v4<libimg::Int>(
-                                              coord, libimg::vec_elem::z)];
+  const void *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::y),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::z))];
   return float4_reader::read(data, desc.channel_order, desc.channel_type);
 }
 
 libimg::Float4 __Codeplay_read_imagef_2d(Image *image, libimg::Int2 coord) {
   ImageMetaData &desc = image->meta_data;
-  const void *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v2<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v2<libimg::Int>(
-                                            coord, libimg::vec_elem::y)];
+  const void *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v2<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v2<libimg::Int>(coord, libimg::vec_elem::y), 0)];
   return float4_reader::read(data, desc.channel_order, desc.channel_type);
 }
 
@@ -3537,35 +3484,27 @@ libimg::Float4 __Codeplay_read_imagef_1d(Image *image, libimg::Int coord) {
 
 libimg::Int4 __Codeplay_read_imagei_3d(Image *image, libimg::Int4 coord) {
   ImageMetaData &desc = image->meta_data;
-  const void *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v4<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v4<libimg::Int>(
-                                            coord, libimg::vec_elem::y) +
-                       desc.slice_pitch * libimg::get_v4<libimg::Int>(
-                                              coord, libimg::vec_elem::z)];
+  const void *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::y),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::z))];
   return int4_reader::read(data, desc.channel_order, desc.channel_type);
 }
 
 libimg::Int4 __Codeplay_read_imagei_2d_array(Image *image, libimg::Int4 coord) {
   ImageMetaData &desc = image->meta_data;
-  const void *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v4<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v4<libimg::Int>(
-                                            coord, libimg::vec_elem::y) +
-                       desc.slice_pitch * libimg::get_v4<libimg::Int>(
-                                              coord, libimg::vec_elem::z)];
+  const void *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::y),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::z))];
   return int4_reader::read(data, desc.channel_order, desc.channel_type);
 }
 
 libimg::Int4 __Codeplay_read_imagei_2d(Image *image, libimg::Int2 coord) {
   ImageMetaData &desc = image->meta_data;
-  const void *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v2<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v2<libimg::Int>(
-                                            coord, libimg::vec_elem::y)];
+  const void *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v2<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v2<libimg::Int>(coord, libimg::vec_elem::y), 0)];
   return int4_reader::read(data, desc.channel_order, desc.channel_type);
 }
 
@@ -3587,36 +3526,28 @@ libimg::Int4 __Codeplay_read_imagei_1d(Image *image, libimg::Int coord) {
 
 libimg::UInt4 __Codeplay_read_imageui_3d(Image *image, libimg::Int4 coord) {
   ImageMetaData &desc = image->meta_data;
-  const void *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v4<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v4<libimg::Int>(
-                                            coord, libimg::vec_elem::y) +
-                       desc.slice_pitch * libimg::get_v4<libimg::Int>(
-                                              coord, libimg::vec_elem::z)];
+  const void *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::y),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::z))];
   return uint4_reader::read(data, desc.channel_order, desc.channel_type);
 }
 
 libimg::UInt4 __Codeplay_read_imageui_2d_array(Image *image,
                                                libimg::Int4 coord) {
   ImageMetaData &desc = image->meta_data;
-  const void *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v4<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v4<libimg::Int>(
-                                            coord, libimg::vec_elem::y) +
-                       desc.slice_pitch * libimg::get_v4<libimg::Int>(
-                                              coord, libimg::vec_elem::z)];
+  const void *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::y),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::z))];
   return uint4_reader::read(data, desc.channel_order, desc.channel_type);
 }
 
 libimg::UInt4 __Codeplay_read_imageui_2d(Image *image, libimg::Int2 coord) {
   ImageMetaData &desc = image->meta_data;
-  const void *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v2<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v2<libimg::Int>(
-                                            coord, libimg::vec_elem::y)];
+  const void *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v2<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v2<libimg::Int>(coord, libimg::vec_elem::y), 0)];
   return uint4_reader::read(data, desc.channel_order, desc.channel_type);
 }
 
@@ -3644,37 +3575,29 @@ libimg::UInt4 __Codeplay_read_imageui_1d(Image *image, libimg::Int coord) {
 void __Codeplay_write_imagef_3d(Image *image, libimg::Int4 coord,
                                 libimg::Float4 color) {
   ImageMetaData &desc = image->meta_data;
-  libimg::UChar *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v4<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v4<libimg::Int>(
-                                            coord, libimg::vec_elem::y) +
-                       desc.slice_pitch * libimg::get_v4<libimg::Int>(
-                                              coord, libimg::vec_elem::z)];
+  libimg::UChar *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::y),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::z))];
   float4_writer::write(data, color, desc.channel_order, desc.channel_type);
 }
 
 void __Codeplay_write_imagef_2d_array(Image *image, libimg::Int4 coord,
                                       libimg::Float4 color) {
   ImageMetaData &desc = image->meta_data;
-  libimg::UChar *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v4<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v4<libimg::Int>(
-                                            coord, libimg::vec_elem::y) +
-                       desc.slice_pitch * libimg::get_v4<libimg::Int>(
-                                              coord, libimg::vec_elem::z)];
+  libimg::UChar *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::y),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::z))];
   float4_writer::write(data, color, desc.channel_order, desc.channel_type);
 }
 
 void __Codeplay_write_imagef_2d(Image *image, libimg::Int2 coord,
                                 libimg::Float4 color) {
   ImageMetaData &desc = image->meta_data;
-  libimg::UChar *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v2<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v2<libimg::Int>(
-                                            coord, libimg::vec_elem::y)];
+  libimg::UChar *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v2<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v2<libimg::Int>(coord, libimg::vec_elem::y), 0)];
   float4_writer::write(data, color, desc.channel_order, desc.channel_type);
 }
 
@@ -3700,37 +3623,29 @@ void __Codeplay_write_imagef_1d(Image *image, libimg::Int coord,
 void __Codeplay_write_imagei_3d(Image *image, libimg::Int4 coord,
                                 libimg::Int4 color) {
   ImageMetaData &desc = image->meta_data;
-  libimg::UChar *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v4<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v4<libimg::Int>(
-                                            coord, libimg::vec_elem::y) +
-                       desc.slice_pitch * libimg::get_v4<libimg::Int>(
-                                              coord, libimg::vec_elem::z)];
+  libimg::UChar *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::y),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::z))];
   int4_writer::write(data, color, desc.channel_order, desc.channel_type);
 }
 
 void __Codeplay_write_imagei_2d_array(Image *image, libimg::Int4 coord,
                                       libimg::Int4 color) {
   ImageMetaData &desc = image->meta_data;
-  libimg::UChar *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v4<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v4<libimg::Int>(
-                                            coord, libimg::vec_elem::y) +
-                       desc.slice_pitch * libimg::get_v4<libimg::Int>(
-                                              coord, libimg::vec_elem::z)];
+  libimg::UChar *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::y),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::z))];
   int4_writer::write(data, color, desc.channel_order, desc.channel_type);
 }
 
 void __Codeplay_write_imagei_2d(Image *image, libimg::Int2 coord,
                                 libimg::Int4 color) {
   ImageMetaData &desc = image->meta_data;
-  libimg::UChar *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v2<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v2<libimg::Int>(
-                                            coord, libimg::vec_elem::y)];
+  libimg::UChar *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v2<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v2<libimg::Int>(coord, libimg::vec_elem::y), 0)];
   int4_writer::write(data, color, desc.channel_order, desc.channel_type);
 }
 
@@ -3756,37 +3671,29 @@ void __Codeplay_write_imagei_1d(Image *image, libimg::Int coord,
 void __Codeplay_write_imageui_3d(Image *image, libimg::Int4 coord,
                                  libimg::UInt4 color) {
   ImageMetaData &desc = image->meta_data;
-  libimg::UChar *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v4<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v4<libimg::Int>(
-                                            coord, libimg::vec_elem::y) +
-                       desc.slice_pitch * libimg::get_v4<libimg::Int>(
-                                              coord, libimg::vec_elem::z)];
+  libimg::UChar *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::y),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::z))];
   uint4_writer::write(data, color, desc.channel_order, desc.channel_type);
 }
 
 void __Codeplay_write_imageui_2d_array(Image *image, libimg::Int4 coord,
                                        libimg::UInt4 color) {
   ImageMetaData &desc = image->meta_data;
-  libimg::UChar *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v4<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v4<libimg::Int>(
-                                            coord, libimg::vec_elem::y) +
-                       desc.slice_pitch * libimg::get_v4<libimg::Int>(
-                                              coord, libimg::vec_elem::z)];
+  libimg::UChar *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::y),
+      libimg::get_v4<libimg::Int>(coord, libimg::vec_elem::z))];
   uint4_writer::write(data, color, desc.channel_order, desc.channel_type);
 }
 
 void __Codeplay_write_imageui_2d(Image *image, libimg::Int2 coord,
                                  libimg::UInt4 color) {
   ImageMetaData &desc = image->meta_data;
-  libimg::UChar *data =
-      &image->raw_data[desc.pixel_size * libimg::get_v2<libimg::Int>(
-                                             coord, libimg::vec_elem::x) +
-                       desc.row_pitch * libimg::get_v2<libimg::Int>(
-                                            coord, libimg::vec_elem::y)];
+  libimg::UChar *data = &image->raw_data[ImageGetPixelOffset(
+      desc, libimg::get_v2<libimg::Int>(coord, libimg::vec_elem::x),
+      libimg::get_v2<libimg::Int>(coord, libimg::vec_elem::y), 0)];
   uint4_writer::write(data, color, desc.channel_order, desc.channel_type);
 }
 
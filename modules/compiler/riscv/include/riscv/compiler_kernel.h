@@ -0,0 +1,107 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+
+/// @file
+///
+/// @brief RISC-V deferred compilation kernel API.
+
+#ifndef RISCV_COMPILER_KERNEL_H_INCLUDED
+#define RISCV_COMPILER_KERNEL_H_INCLUDED
+
+#include <base/kernel.h>
+#include <cargo/dynamic_array.h>
+
+#include <array>
+#include <map>
+#include <memory>
+
+namespace llvm {
+class Module;
+}
+
+namespace riscv {
+class RiscvModule;
+
+/// @brief A kernel ELF executable specialized for a local size.
+struct SpecializedKernel {
+  /// @brief The lld linked ELF executable containing the kernel.
+  cargo::dynamic_array<uint8_t> elf;
+
+  /// @brief Sub-group size of the kernel, or zero for degenerate sub-groups.
+  uint32_t sub_group_size;
+
+  /// @brief Preferred number of work-items executed by one kernel invocation.
+  uint32_t pref_work_width;
+};
+
+/// @brief A kernel whose compilation is deferred until its local size is
+/// known.
+///
+/// Every local size the kernel is enqueued with is compiled and linked once,
+/// the resulting ELF executables are cached for the lifetime of the kernel.
+class RiscvKernel : public compiler::BaseKernel {
+ public:
+  RiscvKernel(RiscvModule &module, std::unique_ptr<llvm::Module> kernel_module,
+              std::string name, std::array<size_t, 3> preferred_local_sizes,
+              size_t local_memory_used);
+
+  ~RiscvKernel();
+
+  /// @see Kernel::precacheLocalSize
+  compiler::Result precacheLocalSize(size_t local_size_x, size_t local_size_y,
+                                     size_t local_size_z) override;
+
+  /// @see Kernel::getDynamicWorkWidth
+  cargo::expected<uint32_t, compiler::Result> getDynamicWorkWidth(
+      size_t local_size_x, size_t local_size_y, size_t local_size_z) override;
+
+  /// @see Kernel::createSpecializedKernel
+  cargo::expected<cargo::dynamic_array<uint8_t>, compiler::Result>
+  createSpecializedKernel(
+      const mux_ndrange_options_t &specialization_options) override;
+
+  /// @see Kernel::querySubGroupSizeForLocalSize
+  cargo::expected<uint32_t, compiler::Result> querySubGroupSizeForLocalSize(
+      size_t local_size_x, size_t local_size_y, size_t local_size_z) override;
+
+  /// @see Kernel::queryLocalSizeForSubGroupCount
+  cargo::expected<std::array<size_t, 3>, compiler::Result>
+  queryLocalSizeForSubGroupCount(size_t sub_group_count) override;
+
+  /// @see Kernel::queryMaxSubGroupCount
+  cargo::expected<size_t, compiler::Result> queryMaxSubGroupCount() override;
+
+ private:
+  /// @brief Gets a `SpecializedKernel` object for the given local size.
+  ///
+  /// @param local_size Local size to specialize the kernel for.
+  cargo::expected<const SpecializedKernel &, compiler::Result>
+  lookupOrCreateSpecializedKernel(std::array<size_t, 3> local_size);
+
+  /// @brief Module this kernel was created from, which owns the kernel.
+  RiscvModule &module;
+
+  /// @brief LLVM module containing only the kernel function and functions it
+  /// calls, not yet finalized for a local size.
+  std::unique_ptr<llvm::Module> kernel_module;
+
+  /// @brief Map of local sizes to the ELF executables specialized for them.
+  std::map<std::array<size_t, 3>, SpecializedKernel> specialized_kernel_map;
+};
+}  // namespace riscv
+
+#endif  // RISCV_COMPILER_KERNEL_H_INCLUDED
@@ -70,6 +70,22 @@ class RiscvModule : public compiler::BaseModule {
   /// this module.
   llvm::TargetMachine *getTargetMachine();
 
+  /// @brief Generates code for a module which has been through the late target
+  /// passes and links it against the runtime library into an ELF executable.
+  ///
+  /// @note Callers must hold the context lock and the LLVM global mutex.
+  ///
+  /// @param[in] module LLVM module to generate code for.
+  /// @param[out] elf Storage for the linked ELF executable.
+  ///
+  /// @return Returns `compiler::Result::SUCCESS` on success, or an error code
+  /// if code generation or linking failed.
+  compiler::Result emitBinary(llvm::Module &module,
+                              cargo::dynamic_array<uint8_t> &elf);
+
+  /// @brief Returns the target this module was created for.
+  const riscv::RiscvTarget &getTarget() const;
+
  protected:
   /// @see BaseModule::getLateTargetPasses
   llvm::ModulePassManager getLateTargetPasses(
@@ -78,8 +94,6 @@ class RiscvModule : public compiler::BaseModule {
   /// @see Module::createKernel
   compiler::Kernel *createKernel(const std::string &name) override;
 
-  const riscv::RiscvTarget &getTarget() const;
-
  private:
   cargo::dynamic_array<uint8_t> object_code;
 
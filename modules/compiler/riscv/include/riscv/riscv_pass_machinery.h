@@ -54,6 +54,16 @@ class RiscvPassMachinery : public compiler::BaseModulePassMachinery {
   /// @return Result ModulePassManager containing passes
   llvm::ModulePassManager getLateTargetPasses();
 
+  /// @brief Returns the pass pipeline which finalizes kernels whose metadata
+  /// has already been encoded, i.e. `getLateTargetPasses` without the initial
+  /// transfer of kernel metadata.
+  ///
+  /// This is run directly by `RiscvKernel` for deferred compilation, after
+  /// encoding the local size the kernel is specialized for.
+  ///
+  /// @return Result ModulePassManager containing passes
+  virtual llvm::ModulePassManager getKernelFinalizationPasses();
+
   struct OptimizationOptions {
     llvm::SmallVector<vecz::VeczPassOptions> vecz_pass_opts;
     bool force_no_tail = false;
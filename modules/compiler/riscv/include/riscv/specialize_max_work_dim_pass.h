@@ -0,0 +1,42 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// RISC-V pass narrowing kernels' maximum work dimension to their local size.
+
+#ifndef RISCV_SPECIALIZE_MAX_WORK_DIM_PASS_H_INCLUDED
+#define RISCV_SPECIALIZE_MAX_WORK_DIM_PASS_H_INCLUDED
+
+#include <llvm/IR/PassManager.h>
+
+namespace riscv {
+/// @brief Pass encoding the number of dimensions a kernel's required local
+/// size spans as its maximum work dimension.
+///
+/// Local sizes are 1 beyond the enqueued work dimension, so the work-item
+/// loops only need to iterate over the dimensions the local size spans. Run
+/// by `RiscvKernel` once it has encoded the local size a kernel is
+/// specialized for. An existing, narrower maximum work dimension is kept.
+struct SpecializeMaxWorkDimPass final
+    : public llvm::PassInfoMixin<SpecializeMaxWorkDimPass> {
+  llvm::PreservedAnalyses run(llvm::Module &module,
+                              llvm::ModuleAnalysisManager &AM);
+};
+
+}  // namespace riscv
+
+#endif  // RISCV_SPECIALIZE_MAX_WORK_DIM_PASS_H_INCLUDED
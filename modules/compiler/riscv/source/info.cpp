@@ -39,7 +39,11 @@ RiscvInfo::RiscvInfo(mux_device_info_t mux_device_info,
 
   vectorizable = false;
   dma_optimizable = true;
+#ifdef CA_RISCV_DEFERRED_COMPILATION
+  supports_deferred_compilation = true;
+#else
   supports_deferred_compilation = false;
+#endif
   kernel_debug = true;
 }
 
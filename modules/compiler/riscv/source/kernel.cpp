@@ -0,0 +1,311 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <base/base_module_pass_machinery.h>
+#include <compiler/utils/attributes.h>
+#include <compiler/utils/encode_kernel_metadata_pass.h>
+#include <compiler/utils/llvm_global_mutex.h>
+#include <compiler/utils/metadata_analysis.h>
+#include <llvm/ADT/Statistic.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/CrashRecoveryContext.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <metadata/handler/vectorize_info_metadata.h>
+#include <riscv/compiler_kernel.h>
+#include <riscv/module.h>
+#include <riscv/riscv_pass_machinery.h>
+#include <riscv/specialize_max_work_dim_pass.h>
+#include <riscv/target.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace riscv {
+
+RiscvKernel::RiscvKernel(RiscvModule &module,
+                         std::unique_ptr<llvm::Module> kernel_module,
+                         std::string name,
+                         std::array<size_t, 3> preferred_local_sizes,
+                         size_t local_memory_used)
+    : BaseKernel(name, preferred_local_sizes[0], preferred_local_sizes[1],
+                 preferred_local_sizes[2], local_memory_used),
+      module(module),
+      kernel_module(std::move(kernel_module)) {}
+
+RiscvKernel::~RiscvKernel() {
+  // Destroying the module touches the LLVMContext it belongs to.
+  const std::lock_guard<compiler::BaseContext> guard(
+      module.getTarget().getContext());
+  kernel_module.reset();
+}
+
+compiler::Result RiscvKernel::precacheLocalSize(size_t local_size_x,
+                                                size_t local_size_y,
+                                                size_t local_size_z) {
+  if (local_size_x == 0 || local_size_y == 0 || local_size_z == 0) {
+    return compiler::Result::INVALID_VALUE;
+  }
+
+  auto specialized_kernel = lookupOrCreateSpecializedKernel(
+      {local_size_x, local_size_y, local_size_z});
+  if (!specialized_kernel) {
+    return specialized_kernel.error();
+  }
+  return compiler::Result::SUCCESS;
+}
+
+cargo::expected<uint32_t, compiler::Result> RiscvKernel::getDynamicWorkWidth(
+    size_t local_size_x, size_t local_size_y, size_t local_size_z) {
+  auto specialized_kernel = lookupOrCreateSpecializedKernel(
+      {local_size_x, local_size_y, local_size_z});
+  if (!specialized_kernel) {
+    return cargo::make_unexpected(specialized_kernel.error());
+  }
+  // We report the preferred work width as the maximum work width.
+  return specialized_kernel->pref_work_width;
+}
+
+cargo::expected<cargo::dynamic_array<uint8_t>, compiler::Result>
+RiscvKernel::createSpecializedKernel(
+    const mux_ndrange_options_t &specialization_options) {
+  if (!specialization_options.descriptors &&
+      specialization_options.descriptors_length > 0) {
+    return cargo::make_unexpected(compiler::Result::INVALID_VALUE);
+  }
+
+  if (specialization_options.descriptors &&
+      specialization_options.descriptors_length == 0) {
+    return cargo::make_unexpected(compiler::Result::INVALID_VALUE);
+  }
+
+  for (int i = 0; i < 3; i++) {
+    if (specialization_options.local_size[i] == 0) {
+      return cargo::make_unexpected(compiler::Result::INVALID_VALUE);
+    }
+  }
+
+  if (!specialization_options.global_offset) {
+    return cargo::make_unexpected(compiler::Result::INVALID_VALUE);
+  }
+
+  if (!specialization_options.global_size) {
+    return cargo::make_unexpected(compiler::Result::INVALID_VALUE);
+  }
+
+  if (specialization_options.dimensions == 0 ||
+      specialization_options.dimensions > 3) {
+    return cargo::make_unexpected(compiler::Result::INVALID_VALUE);
+  }
+
+  // Local sizes beyond the enqueued dimensions are always 1, so the local size
+  // alone also captures the number of dimensions the kernel is specialized
+  // for.
+  std::array<size_t, 3> local_size;
+  std::copy(std::begin(specialization_options.local_size),
+            std::end(specialization_options.local_size),
+            std::begin(local_size));
+  for (uint32_t i = specialization_options.dimensions; i < 3; i++) {
+    if (local_size[i] != 1) {
+      return cargo::make_unexpected(compiler::Result::INVALID_VALUE);
+    }
+  }
+
+  auto specialized_kernel = lookupOrCreateSpecializedKernel(local_size);
+  if (!specialized_kernel) {
+    return cargo::make_unexpected(specialized_kernel.error());
+  }
+
+  // The cached ELF outlives the returned copy, which is handed to
+  // muxCreateExecutable.
+  const auto &elf = specialized_kernel->elf;
+  cargo::dynamic_array<uint8_t> binary_out;
+  if (binary_out.alloc(elf.size())) {
+    return cargo::make_unexpected(compiler::Result::OUT_OF_MEMORY);
+  }
+  std::memcpy(binary_out.data(), elf.data(), elf.size());
+  return {std::move(binary_out)};
+}
+
+cargo::expected<uint32_t, compiler::Result>
+RiscvKernel::querySubGroupSizeForLocalSize(size_t local_size_x,
+                                           size_t local_size_y,
+                                           size_t local_size_z) {
+  auto specialized_kernel = lookupOrCreateSpecializedKernel(
+      {local_size_x, local_size_y, local_size_z});
+  if (!specialized_kernel) {
+    return cargo::make_unexpected(specialized_kernel.error());
+  }
+  // If we've compiled with degenerate sub-groups, the sub-group size is the
+  // work-group size.
+  if (specialized_kernel->sub_group_size == 0) {
+    return local_size_x * local_size_y * local_size_z;
+  }
+
+  // Otherwise, on risc-v we always vectorize in the x-dimension, so
+  // sub-groups "go" in the x-dimension.
+  return std::min(local_size_x,
+                  static_cast<size_t>(specialized_kernel->sub_group_size));
+}
+
+cargo::expected<std::array<size_t, 3>, compiler::Result>
+RiscvKernel::queryLocalSizeForSubGroupCount(size_t sub_group_count) {
+  // Try to compile something and see what subgroup size we get
+  const auto &info = *module.getTarget().getCompilerInfo()->device_info;
+  const size_t max_local_size_x = info.max_work_group_size_x;
+  auto specialized_kernel =
+      lookupOrCreateSpecializedKernel({max_local_size_x, 1, 1});
+  if (!specialized_kernel) {
+    return cargo::make_unexpected(specialized_kernel.error());
+  }
+
+  // If we've compiled with degenerate sub-groups, the work-group size is the
+  // sub-group size.
+  const auto sub_group_size = specialized_kernel->sub_group_size;
+  if (sub_group_size == 0) {
+    if (sub_group_count == 1) {
+      return {{max_local_size_x, 1, 1}};
+    }
+    return {{0, 0, 0}};
+  }
+
+  const auto local_size = sub_group_count * sub_group_size;
+  if (local_size <= max_local_size_x) {
+    return {{local_size, 1, 1}};
+  }
+
+  return {{0, 0, 0}};
+}
+
+cargo::expected<size_t, compiler::Result>
+RiscvKernel::queryMaxSubGroupCount() {
+  // As on host, assume this kernel *could* be compiled with a trivial
+  // sub-group size of 1 for a given ND-range.
+  const auto &info = *module.getTarget().getCompilerInfo()->device_info;
+  return static_cast<size_t>(info.max_sub_group_count);
+}
+
+cargo::expected<const SpecializedKernel &, compiler::Result>
+RiscvKernel::lookupOrCreateSpecializedKernel(
+    std::array<size_t, 3> local_size) {
+  const auto &target = module.getTarget();
+  const std::lock_guard<compiler::BaseContext> guard(target.getContext());
+
+  auto found = specialized_kernel_map.find(local_size);
+  if (found != specialized_kernel_map.end()) {
+    return found->second;
+  }
+
+  std::unique_ptr<llvm::Module> specialized_module(
+      llvm::CloneModule(*kernel_module));
+  if (nullptr == specialized_module) {
+    return cargo::make_unexpected(compiler::Result::OUT_OF_MEMORY);
+  }
+
+  auto pass_mach = module.createPassMachinery();
+  if (!pass_mach) {
+    return cargo::make_unexpected(compiler::Result::OUT_OF_MEMORY);
+  }
+  module.initializePassMachineryForFinalize(*pass_mach);
+  auto &riscv_pass_mach = static_cast<RiscvPassMachinery &>(*pass_mach);
+  riscv_pass_mach.setCompilerOptions(module.getOptions());
+
+  llvm::ModulePassManager pm;
+  // Set up the kernel metadata which informs later passes which kernel we're
+  // interested in optimizing. We've already done this when initially creating
+  // the kernel, but now we have more accurate local size data.
+  compiler::utils::EncodeKernelMetadataPassOptions pass_opts;
+  pass_opts.KernelName = name;
+  pass_opts.LocalSizes = {static_cast<uint64_t>(local_size[0]),
+                          static_cast<uint64_t>(local_size[1]),
+                          static_cast<uint64_t>(local_size[2])};
+  pm.addPass(compiler::utils::EncodeKernelMetadataPass(pass_opts));
+
+  // The work-item loops only need to iterate over the dimensions the local
+  // size actually spans.
+  pm.addPass(SpecializeMaxWorkDimPass());
+
+  pm.addPass(riscv_pass_mach.getKernelFinalizationPasses());
+
+  // Numerous things below touch LLVM's global state, so ensure we avoid data
+  // races by locking the LLVM global mutex.
+  const std::lock_guard<std::mutex> globalLock(
+      compiler::utils::getLLVMGlobalMutex());
+  {
+    llvm::CrashRecoveryContext CRC;
+    llvm::CrashRecoveryContext::Enable();
+    const bool crashed = !CRC.RunSafely(
+        [&] { pm.run(*specialized_module, riscv_pass_mach.getMAM()); });
+    llvm::CrashRecoveryContext::Disable();
+    if (crashed) {
+      return cargo::make_unexpected(compiler::Result::FINALIZE_PROGRAM_FAILURE);
+    }
+
+    if (llvm::AreStatisticsEnabled()) {
+      llvm::PrintStatistics();
+    }
+  }
+
+  // Scalable widths are scaled by the vscale of the device, as the riscv mux
+  // target does for precompiled kernels.
+  const uint32_t vscale =
+      std::max(target.riscv_hal_device_info->vlen / 64, 1u);
+  auto getWidth = [vscale](const FixedOrScalableQuantity<uint32_t> &q) {
+    return q.getKnownMinValue() * (q.isScalable() ? vscale : 1);
+  };
+
+  // Pick the widest kernel variant which fits the local size, as the riscv mux
+  // target would when choosing between them.
+  SpecializedKernel specialized_kernel{{}, 0, 1};
+  bool found_variant = false;
+  for (auto &f : *specialized_module) {
+    if (!compiler::utils::isKernelEntryPt(f)) {
+      continue;
+    }
+    const auto fn_metadata =
+        riscv_pass_mach.getFAM()
+            .getResult<compiler::utils::VectorizeMetadataAnalysis>(f);
+    const uint32_t min_work_width =
+        std::max(getWidth(fn_metadata.min_work_item_factor), 1u);
+    const uint32_t sub_group_size = getWidth(fn_metadata.sub_group_size);
+    if (local_size[0] % min_work_width != 0 ||
+        (sub_group_size != 0 && local_size[0] % sub_group_size != 0)) {
+      continue;
+    }
+    const uint32_t pref_work_width =
+        std::max(getWidth(fn_metadata.pref_work_item_factor), 1u);
+    if (!found_variant ||
+        pref_work_width > specialized_kernel.pref_work_width) {
+      specialized_kernel.sub_group_size = sub_group_size;
+      specialized_kernel.pref_work_width = pref_work_width;
+      found_variant = true;
+    }
+  }
+  if (!found_variant) {
+    return cargo::make_unexpected(compiler::Result::FINALIZE_PROGRAM_FAILURE);
+  }
+
+  const compiler::Result err =
+      module.emitBinary(*specialized_module, specialized_kernel.elf);
+  if (compiler::Result::SUCCESS != err) {
+    return cargo::make_unexpected(err);
+  }
+
+  return specialized_kernel_map
+      .emplace(local_size, std::move(specialized_kernel))
+      .first->second;
+}
+
+}  // namespace riscv
@@ -17,11 +17,14 @@
 #include <base/macros.h>
 #include <base/pass_pipelines.h>
 #include <compiler/utils/cl_builtin_info.h>
+#include <compiler/utils/compute_local_memory_usage_pass.h>
 #include <compiler/utils/device_info.h>
+#include <compiler/utils/encode_kernel_metadata_pass.h>
 #include <compiler/utils/lld_linker.h>
 #include <compiler/utils/llvm_global_mutex.h>
 #include <compiler/utils/metadata.h>
 #include <compiler/utils/metadata_analysis.h>
+#include <compiler/utils/reduce_to_function_pass.h>
 #include <llvm/ADT/Statistic.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
 #include <llvm/IR/Module.h>
@@ -30,7 +33,9 @@
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Process.h>
 #include <llvm/Target/TargetMachine.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 #include <multi_llvm/multi_llvm.h>
+#include <riscv/compiler_kernel.h>
 #include <riscv/ir_to_builtins_pass.h>
 #include <riscv/module.h>
 #include <riscv/riscv_pass_machinery.h>
@@ -57,12 +62,55 @@ compiler::Result RiscvModule::createBinary(
   // Lock the context, this is necessary due to analysis/pass managers being
   // owned by the LLVMContext and we are making heavy use of both below.
   const std::lock_guard<compiler::BaseContext> contextLock(context);
+
+  // With deferred compilation the late target passes were skipped when the
+  // module was finalized, so run them now on a copy of the module that covers
+  // every kernel.
+  std::unique_ptr<llvm::Module> late_module;
+  if (getTarget().getCompilerInfo()->supports_deferred_compilation) {
+    late_module = llvm::CloneModule(*finalized_llvm_module);
+    if (!late_module) {
+      return compiler::Result::OUT_OF_MEMORY;
+    }
+    auto pass_mach = createPassMachinery();
+    initializePassMachineryForFinalize(*pass_mach);
+    auto &riscv_pass_mach = static_cast<RiscvPassMachinery &>(*pass_mach);
+    riscv_pass_mach.setCompilerOptions(getOptions());
+
+    llvm::ModulePassManager pm;
+    pm.addPass(riscv_pass_mach.getLateTargetPasses());
+    const std::lock_guard<std::mutex> globalLock(
+        compiler::utils::getLLVMGlobalMutex());
+    llvm::CrashRecoveryContext CRC;
+    llvm::CrashRecoveryContext::Enable();
+    const bool crashed = !CRC.RunSafely(
+        [&] { pm.run(*late_module, riscv_pass_mach.getMAM()); });
+    llvm::CrashRecoveryContext::Disable();
+    if (crashed) {
+      return compiler::Result::FINALIZE_PROGRAM_FAILURE;
+    }
+  }
+
   // Numerous things below touch LLVM's global state, in particular
   // retriggering command-line option parsing at various points. Ensure we
   // avoid data races by locking the LLVM global mutex.
   const std::lock_guard<std::mutex> globalLock(
       compiler::utils::getLLVMGlobalMutex());
 
+  const compiler::Result err = emitBinary(
+      late_module ? *late_module : *finalized_llvm_module, object_code);
+  if (compiler::Result::SUCCESS != err) {
+    return err;
+  }
+
+  // Return the binary buffer.
+  binary = object_code;
+
+  return compiler::Result::SUCCESS;
+}
+
+compiler::Result RiscvModule::emitBinary(
+    llvm::Module &module, cargo::dynamic_array<uint8_t> &elf) {
   // Write to an Elf object
   auto *TM = getTargetMachine();
   llvm::SmallVector<char, 512> objectBinary;
@@ -76,9 +124,8 @@ compiler::Result RiscvModule::createBinary(
     compiler::Result err = compiler::Result::FAILURE;
     llvm::CrashRecoveryContext CRC;
     llvm::CrashRecoveryContext::Enable();
-    const bool crashed = !CRC.RunSafely([&] {
-      err = compiler::emitCodeGenFile(*finalized_llvm_module, TM, ostream);
-    });
+    const bool crashed = !CRC.RunSafely(
+        [&] { err = compiler::emitCodeGenFile(module, TM, ostream); });
     llvm::CrashRecoveryContext::Disable();
     if (crashed) {
       return compiler::Result::FINALIZE_PROGRAM_FAILURE;
@@ -100,7 +147,6 @@ compiler::Result RiscvModule::createBinary(
   // entry point will not be used directly.
   lld_args.push_back("-e0");
 
-  const cargo::dynamic_array<uint8_t> finalizer_binary;
   {
     bool linkSuccess = false;
     llvm::CrashRecoveryContext CRC;
@@ -118,10 +164,10 @@ compiler::Result RiscvModule::createBinary(
         return;
       }
       auto size = (*linkResult)->getBufferSize();
-      if (cargo::success != object_code.alloc(size)) {
+      if (cargo::success != elf.alloc(size)) {
         return;
       }
-      std::memcpy(object_code.data(), (*linkResult)->getBufferStart(), size);
+      std::memcpy(elf.data(), (*linkResult)->getBufferStart(), size);
       linkSuccess = true;
     });
     llvm::CrashRecoveryContext::Disable();
@@ -143,23 +189,62 @@ compiler::Result RiscvModule::createBinary(
         llvm::errs() << "Unable to open ELF file " << *copyElfPath << " :\n";
         llvm::errs() << "\t" << error.message() << "\n";
       } else {
-        const uint8_t *elf_data = object_code.data();
-        of.write(reinterpret_cast<const char *>(elf_data), object_code.size());
+        const uint8_t *elf_data = elf.data();
+        of.write(reinterpret_cast<const char *>(elf_data), elf.size());
         llvm::errs() << "Writing ELF file  to " << *copyElfPath << "\n";
       }
     }
   }
 #endif
 
-  // Return the binary buffer.
-  binary = object_code;
-
   return compiler::Result::SUCCESS;
 }
 
-// No deferred support so just return nullptr
-compiler::Kernel *RiscvModule::createKernel(const std::string &) {
-  return nullptr;
+compiler::Kernel *RiscvModule::createKernel(const std::string &name) {
+  if (!getTarget().getCompilerInfo()->supports_deferred_compilation) {
+    return nullptr;
+  }
+
+  std::unique_ptr<llvm::Module> kernel_module;
+  handler::GenericMetadata kernel_md(name, name, 0);
+  {
+    const std::lock_guard<compiler::BaseContext> guard(context);
+    kernel_module = llvm::CloneModule(*finalized_llvm_module);
+
+    if (!kernel_module || !kernel_module->getFunction(name)) {
+      return nullptr;
+    }
+
+    llvm::ModulePassManager pm;
+    auto pass_mach = createPassMachinery();
+    pass_mach->initializeStart();
+    pass_mach->initializeFinish();
+
+    // Set up the kernel metadata which informs later passes which kernel we're
+    // interested in optimizing.
+    const compiler::utils::EncodeKernelMetadataPassOptions pass_opts{name};
+    pm.addPass(compiler::utils::EncodeKernelMetadataPass(pass_opts));
+    pm.addPass(compiler::utils::ReduceToFunctionPass());
+    pm.addPass(compiler::utils::ComputeLocalMemoryUsagePass());
+
+    pm.run(*kernel_module, pass_mach->getMAM());
+    // Retrieve the estimation of the amount of local memory this kernel uses.
+    if (auto *f = kernel_module->getFunction(name)) {
+      kernel_md = pass_mach->getFAM()
+                      .getResult<compiler::utils::GenericMetadataAnalysis>(*f);
+    }
+  }
+
+  // Match the preferred local sizes reported by the riscv mux target for
+  // precompiled kernels.
+  auto device_info = target.getCompilerInfo()->device_info;
+  const std::array<size_t, 3> local_sizes = {
+      std::min(64u, device_info->max_work_group_size_x), 1, 1};
+
+  assert(kernel_md.local_memory_usage <= SIZE_MAX);
+  return new RiscvKernel(*this, std::move(kernel_module),
+                         kernel_md.kernel_name, local_sizes,
+                         static_cast<size_t>(kernel_md.local_memory_usage));
 }
 
 const riscv::RiscvTarget &RiscvModule::getTarget() const {
@@ -172,6 +257,12 @@ llvm::ModulePassManager RiscvModule::getLateTargetPasses(
     llvm::EnableStatistics();
   }
 
+  // With deferred compilation each kernel is finalized separately once its
+  // local size is known, see RiscvKernel.
+  if (getTarget().getCompilerInfo()->supports_deferred_compilation) {
+    return llvm::ModulePassManager();
+  }
+
   return static_cast<RiscvPassMachinery &>(pass_mach).getLateTargetPasses();
 }
 
@@ -0,0 +1,51 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <compiler/utils/attributes.h>
+#include <compiler/utils/metadata.h>
+#include <riscv/specialize_max_work_dim_pass.h>
+
+using namespace llvm;
+
+namespace riscv {
+
+PreservedAnalyses SpecializeMaxWorkDimPass::run(Module &module,
+                                                ModuleAnalysisManager &) {
+  bool modified = false;
+
+  for (auto &func : module) {
+    if (!compiler::utils::isKernelEntryPt(func)) {
+      continue;
+    }
+    const auto local_size = compiler::utils::getLocalSizeMetadata(func);
+    if (!local_size) {
+      continue;
+    }
+
+    const uint32_t work_dim =
+        (*local_size)[2] > 1 ? 3 : ((*local_size)[1] > 1 ? 2 : 1);
+    const auto max_work_dim = compiler::utils::parseMaxWorkDimMetadata(func);
+    if (max_work_dim && *max_work_dim <= work_dim) {
+      continue;
+    }
+    compiler::utils::encodeMaxWorkDimMetadata(func, work_dim);
+    modified = true;
+  }
+
+  return modified ? PreservedAnalyses::none() : PreservedAnalyses::all();
+}
+
+}  // namespace riscv
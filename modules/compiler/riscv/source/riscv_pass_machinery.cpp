@@ -24,6 +24,7 @@
 #include <compiler/utils/manual_type_legalization_pass.h>
 #include <compiler/utils/metadata.h>
 #include <compiler/utils/metadata_analysis.h>
+#include <compiler/utils/pass_functions.h>
 #include <compiler/utils/replace_address_space_qualifier_functions_pass.h>
 #include <compiler/utils/replace_local_module_scope_variables_pass.h>
 #include <compiler/utils/replace_mem_intrinsics_pass.h>
@@ -31,12 +32,15 @@
 #include <compiler/utils/verify_reqd_sub_group_size_pass.h>
 #include <compiler/utils/work_item_loops_pass.h>
 #include <llvm/ADT/StringRef.h>
+#include <llvm/Analysis/TargetTransformInfo.h>
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 #include <metadata/handler/vectorize_info_metadata.h>
 #include <riscv/ir_to_builtins_pass.h>
 #include <riscv/riscv_pass_machinery.h>
+#include <riscv/specialize_max_work_dim_pass.h>
 #include <vecz/pass.h>
+#include <vecz/vecz_target_info.h>
 
 namespace riscv {
 
@@ -142,6 +146,94 @@ RiscvPassMachinery::processOptimizationOptions(
   return env_var_opts;
 }
 
+namespace {
+/// @brief Chooses per-kernel vectorization options for RVV.
+///
+/// The width is the widest number of lanes that fits the register group the
+/// target reports for fixed-width vectors, for the kernel's widest element
+/// type, narrowed until the values the kernel keeps live per work-item fit in
+/// the vector register file. The predication strategy then follows the local
+/// size, if it is known:
+/// * a multiple of the width needs no tail, so only a vector kernel is built;
+/// * smaller than the width is covered by a single vector-predicated kernel;
+/// * anything else, or an unknown local size, builds both a vector kernel and
+///   a vector-predicated one which the work-item loops use as the tail.
+///
+/// @param[in] F Kernel to choose the options for.
+/// @param[in] AM Module analysis manager.
+/// @param[in] Base Options to start from, carrying any vectorization choices.
+/// @param[out] PassOpts Options to vectorize the kernel with.
+///
+/// @return Whether the kernel should be vectorized.
+bool getCostModelVeczPassOpts(
+    llvm::Function &F, llvm::ModuleAnalysisManager &AM,
+    const vecz::VeczPassOptions &Base,
+    llvm::SmallVectorImpl<vecz::VeczPassOptions> &PassOpts) {
+  auto &M = *F.getParent();
+  auto &FAM =
+      AM.getResult<llvm::FunctionAnalysisManagerModuleProxy>(M).getManager();
+  const auto &TTI = FAM.getResult<llvm::TargetIRAnalysis>(F);
+  vecz::TargetInfo *const TI = AM.getResult<vecz::TargetInfoAnalysis>(M);
+
+  // The fixed-width register size is the size of the register group the
+  // backend lowers fixed-width vectors to, i.e. the device's VLEN (see
+  // RiscvTarget's use of Zvl*b) or the minimum the V extension guarantees,
+  // already multiplied by the LMUL the backend prefers. It is zero if the
+  // device has no vector unit, in which case there's nothing to do.
+  const unsigned RegisterWidth =
+      TTI.getRegisterBitWidth(llvm::TargetTransformInfo::RGK_FixedWidthVector)
+          .getFixedValue();
+  if (!TI || RegisterWidth == 0) {
+    return false;
+  }
+
+  // Vectors of elements wider than 64 bits are not legal on RVV.
+  const unsigned ElementWidth =
+      std::min(compiler::utils::getWidestElementWidth(F), 64u);
+  const unsigned MaxWidth = RegisterWidth / ElementWidth;
+
+  llvm::SmallVector<const llvm::Value *, 16> LiveValues;
+  compiler::utils::getApproximateLiveValues(F, LiveValues);
+  const unsigned Width = TI->estimateSimdWidth(TTI, LiveValues, MaxWidth);
+  if (Width < 2) {
+    return false;
+  }
+
+  const auto LocalSizes = compiler::utils::getLocalSizeMetadata(F);
+  const uint64_t LocalSize =
+      LocalSizes ? (*LocalSizes)[Base.vec_dim_idx] : 0;
+  if (LocalSize == 1) {
+    return false;
+  }
+
+  auto *const VecTy = llvm::FixedVectorType::get(
+      llvm::Type::getIntNTy(F.getContext(), ElementWidth), Width);
+  const bool CanPredicate = TI->isVPVectorLegal(F, VecTy);
+
+  vecz::VeczPassOptions VectorOpts = Base;
+  VectorOpts.factor =
+      compiler::utils::VectorizationFactor::getFixedWidth(Width);
+  VectorOpts.local_size = LocalSize;
+
+  // Vector-predicated kernels cover partial groups themselves, so they are not
+  // given the local size; vecz would otherwise narrow them to fit it.
+  vecz::VeczPassOptions VPOpts = VectorOpts;
+  VPOpts.local_size = 0;
+  VPOpts.choices.enable(vecz::VectorizationChoices::eVectorPredication);
+
+  PassOpts.clear();
+  if (LocalSize && LocalSize < Width && CanPredicate) {
+    PassOpts.push_back(VPOpts);
+    return true;
+  }
+  PassOpts.push_back(VectorOpts);
+  if ((!LocalSize || LocalSize % Width != 0) && CanPredicate) {
+    PassOpts.push_back(VPOpts);
+  }
+  return true;
+}
+}  // namespace
+
 bool riscvVeczPassOpts(llvm::Function &F, llvm::ModuleAnalysisManager &AM,
                        llvm::SmallVectorImpl<vecz::VeczPassOptions> &PassOpts) {
   auto vecz_mode = compiler::getVectorizationMode(F);
@@ -162,7 +254,20 @@ bool riscvVeczPassOpts(llvm::Function &F, llvm::ModuleAnalysisManager &AM,
   if (env_var_opts.vecz_pass_opts.empty()) {
     return false;
   }
+  // Unless overridden by CA_RISCV_VF, let the cost model pick the options for
+  // this kernel.
+  if (!std::getenv("CA_RISCV_VF")) {
+    return getCostModelVeczPassOpts(F, AM, env_var_opts.vecz_pass_opts.front(),
+                                    PassOpts);
+  }
   PassOpts.assign(env_var_opts.vecz_pass_opts);
+  // Under deferred compilation the local size is known, which lets vecz pick
+  // a width that fits it.
+  if (auto local_sizes = compiler::utils::getLocalSizeMetadata(F)) {
+    for (auto &opts : PassOpts) {
+      opts.local_size = (*local_sizes)[opts.vec_dim_idx];
+    }
+  }
   return true;
 }
 
@@ -187,6 +292,16 @@ void RiscvPassMachinery::registerPasses() {
 llvm::ModulePassManager RiscvPassMachinery::getLateTargetPasses() {
   llvm::ModulePassManager PM;
 
+  PM.addPass(compiler::utils::TransferKernelMetadataPass());
+
+  PM.addPass(getKernelFinalizationPasses());
+
+  return PM;
+}
+
+llvm::ModulePassManager RiscvPassMachinery::getKernelFinalizationPasses() {
+  llvm::ModulePassManager PM;
+
   std::optional<std::string> env_debug_prefix;
 #if defined(CA_ENABLE_DEBUG_SUPPORT) || defined(CA_RISCV_DEMO_MODE)
   env_debug_prefix = target.env_debug_prefix;
@@ -196,8 +311,6 @@ llvm::ModulePassManager RiscvPassMachinery::getLateTargetPasses() {
   auto env_var_opts =
       processOptimizationOptions(env_debug_prefix, /* vecz_mode*/ {});
 
-  PM.addPass(compiler::utils::TransferKernelMetadataPass());
-
   if (env_debug_prefix) {
     const std::string dump_ir_env_name = *env_debug_prefix + "_DUMP_IR";
     if (std::getenv(dump_ir_env_name.c_str())) {
@@ -236,6 +349,7 @@ llvm::ModulePassManager RiscvPassMachinery::getLateTargetPasses() {
   compiler::utils::WorkItemLoopsPassOptions WIOpts;
   WIOpts.IsDebug = options.opt_disable;
   WIOpts.ForceNoTail = env_var_opts.force_no_tail;
+  WIOpts.SoALiveVars = true;
   PM.addPass(compiler::utils::WorkItemLoopsPass(WIOpts));
 
   // Verify that any required sub-group size was met.
@@ -298,6 +412,11 @@ bool RiscvPassMachinery::handlePipelineElement(llvm::StringRef Name,
     return true;
   }
 
+  if (Name.consume_front("riscv-kernel-passes")) {
+    PM.addPass(getKernelFinalizationPasses());
+    return true;
+  }
+
   return false;
 }
 
@@ -318,6 +437,8 @@ void RiscvPassMachinery::printPassNames(llvm::raw_ostream &OS) {
 
   OS << "  riscv-late-passes\n";
   OS << "    Runs the pipeline for BaseModule::getLateTargetPasses\n";
+  OS << "  riscv-kernel-passes\n";
+  OS << "    Runs the pipeline for RiscvKernel specialization\n";
 }
 
 }  // namespace riscv
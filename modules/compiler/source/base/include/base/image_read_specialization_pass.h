@@ -0,0 +1,102 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Class ImageReadSpecializationPass interface.
+
+#ifndef BASE_IMAGE_READ_SPECIALIZATION_PASS_H_INCLUDED
+#define BASE_IMAGE_READ_SPECIALIZATION_PASS_H_INCLUDED
+
+#include <llvm/IR/PassManager.h>
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+namespace llvm {
+class Function;
+}
+
+namespace compiler {
+/// @addtogroup cl_compiler
+/// @{
+
+/// @brief Image and sampler kernel arguments whose values are known at the
+/// time the kernel is compiled, e.g. at enqueue time under deferred
+/// compilation.
+struct ImageSpecializationInfo {
+  /// @brief Map of sampler kernel argument indices to their libimg sampler
+  /// values.
+  std::map<unsigned, uint32_t> Samplers;
+  /// @brief Map of image kernel argument indices to their libimg channel order
+  /// and channel type.
+  std::map<unsigned, std::pair<uint32_t, uint32_t>> Formats;
+
+  bool empty() const { return Samplers.empty() && Formats.empty(); }
+
+  bool operator<(const ImageSpecializationInfo &other) const {
+    return std::tie(Samplers, Formats) <
+           std::tie(other.Samplers, other.Formats);
+  }
+};
+
+/// @brief Encodes known image and sampler kernel arguments onto a kernel as
+/// metadata.
+///
+/// This metadata is encoded as:
+/// define void @foo() !mux_image_spec !X
+/// !X = { !A, !B, ... }
+/// !A = { i32 argIdx, i32 samplerValue }
+/// !B = { i32 argIdx, i32 channelOrder, i32 channelType }
+///
+/// @param[in] f Kernel on which to encode the metadata.
+/// @param[in] info Known image and sampler arguments to encode.
+void encodeImageSpecializationMetadata(llvm::Function &f,
+                                       const ImageSpecializationInfo &info);
+
+/// @brief Retrieves known image and sampler kernel arguments from metadata.
+///
+/// @param[in] f Kernel from which to decode the metadata.
+///
+/// @return The decoded information if present, else `std::nullopt`.
+std::optional<ImageSpecializationInfo> getImageSpecializationMetadata(
+    const llvm::Function &f);
+
+/// @brief Clones and specializes image library read functions for call sites
+/// with compile-time known samplers and image formats.
+///
+/// The image library decodes the sampler's filter mode, addressing mode and
+/// normalized-coordinates flag, and the image's channel order and type, for
+/// every pixel it reads. When the sampler is a constant (or a kernel argument
+/// described by `!mux_image_spec` metadata) and/or the image's format is known,
+/// the called read function is cloned with those values folded in, leaving a
+/// branch-free read path that later optimizations can inline and vectorize.
+///
+/// This pass must run after the image library has been linked into the
+/// module.
+struct ImageReadSpecializationPass final
+    : public llvm::PassInfoMixin<ImageReadSpecializationPass> {
+  llvm::PreservedAnalyses run(llvm::Module &module,
+                              llvm::ModuleAnalysisManager &am);
+};
+
+/// @}
+}  // namespace compiler
+
+#endif  // BASE_IMAGE_READ_SPECIALIZATION_PASS_H_INCLUDED
@@ -22,6 +22,7 @@
 #include <base/combine_fpext_fptrunc_pass.h>
 #include <base/fast_math_pass.h>
 #include <base/image_argument_substitution_pass.h>
+#include <base/image_read_specialization_pass.h>
 #include <base/mem_to_reg_pass.h>
 #include <base/pass_pipelines.h>
 #include <base/printf_replacement_pass.h>
@@ -364,6 +365,8 @@ parseWorkItemLoopsPassOptions(StringRef Params) {
       Opts.IsDebug = true;
     } else if (ParamName == "no-tail") {
       Opts.ForceNoTail = true;
+    } else if (ParamName == "soa") {
+      Opts.SoALiveVars = true;
     }
   }
   return Opts;
@@ -0,0 +1,291 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <base/image_read_specialization_pass.h>
+#include <compiler/utils/metadata.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/Twine.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Metadata.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/Local.h>
+
+using namespace llvm;
+
+namespace {
+constexpr const char *ImageSpecMD = "mux_image_spec";
+
+/// @brief Name of the function which materializes constant samplers.
+constexpr const char *SamplerInitializerName = "__translate_sampler_initializer";
+
+/// @brief Byte offsets of the channel order and channel type in libimg's
+/// ImageMetaData, which is the first member of an Image.
+constexpr uint64_t ChannelOrderOffset = 0;
+constexpr uint64_t ChannelTypeOffset = 4;
+
+using KnownFormat = std::pair<uint32_t, uint32_t>;
+
+bool isImageReadFunction(const Function &F) {
+  return !F.isDeclaration() && F.getName().contains("__Codeplay_read_image");
+}
+
+bool takesSampler(const Function &F) {
+  // The sampler overloads are mangled as (Image *, unsigned int, coord).
+  return F.arg_size() == 3 && F.getName().contains("P5Imagej");
+}
+
+std::optional<uint32_t> getKnownSampler(
+    Value *V, const compiler::ImageSpecializationInfo *Info) {
+  // Look through the integer and pointer casts introduced when samplers were
+  // lowered to integers.
+  while (true) {
+    if (auto *Cast = dyn_cast<CastInst>(V)) {
+      V = Cast->getOperand(0);
+    } else if (auto *CE = dyn_cast<ConstantExpr>(V); CE && CE->isCast()) {
+      V = CE->getOperand(0);
+    } else {
+      break;
+    }
+  }
+
+  if (auto *C = dyn_cast<ConstantInt>(V)) {
+    return C->getZExtValue();
+  }
+
+  if (auto *CI = dyn_cast<CallInst>(V)) {
+    if (auto *Callee = CI->getCalledFunction();
+        Callee && Callee->getName() == SamplerInitializerName) {
+      if (auto *C = dyn_cast<ConstantInt>(CI->getArgOperand(0))) {
+        return C->getZExtValue();
+      }
+    }
+  }
+
+  if (auto *A = dyn_cast<Argument>(V); A && Info) {
+    auto It = Info->Samplers.find(A->getArgNo());
+    if (It != Info->Samplers.end()) {
+      return It->second;
+    }
+  }
+
+  return std::nullopt;
+}
+
+std::optional<KnownFormat> getKnownFormat(
+    Value *V, const compiler::ImageSpecializationInfo *Info) {
+  if (auto *A = dyn_cast<Argument>(V->stripPointerCasts()); A && Info) {
+    auto It = Info->Formats.find(A->getArgNo());
+    if (It != Info->Formats.end()) {
+      return It->second;
+    }
+  }
+  return std::nullopt;
+}
+
+/// @brief Folds away control flow made redundant by constant propagation.
+void foldConstantControlFlow(Function &F) {
+  bool Changed;
+  do {
+    Changed = false;
+    for (auto &BB : F) {
+      Changed |= SimplifyInstructionsInBlock(&BB);
+      Changed |= ConstantFoldTerminator(&BB, /*DeleteDeadConditions*/ true);
+    }
+    Changed |= removeUnreachableBlocks(F);
+  } while (Changed);
+}
+
+Function *createSpecialization(Function &F, std::optional<uint32_t> Sampler,
+                               std::optional<KnownFormat> Format) {
+  ValueToValueMapTy VMap;
+  Function *const NewF = CloneFunction(&F, VMap);
+
+  // Record what the clone was specialized for, so that read functions it
+  // forwards its arguments to can be specialized in turn.
+  compiler::ImageSpecializationInfo Info;
+  std::string Suffix;
+  if (Sampler) {
+    Info.Samplers[1] = *Sampler;
+    Suffix += (Twine(".s") + Twine(*Sampler)).str();
+    Argument *const SamplerArg = NewF->getArg(1);
+    SamplerArg->replaceAllUsesWith(
+        ConstantInt::get(SamplerArg->getType(), *Sampler));
+  }
+
+  if (Format) {
+    Info.Formats[0] = *Format;
+    Suffix +=
+        (Twine(".f") + Twine(Format->first) + "_" + Twine(Format->second))
+            .str();
+    const DataLayout &DL = F.getParent()->getDataLayout();
+    Argument *const ImageArg = NewF->getArg(0);
+    SmallVector<std::pair<LoadInst *, uint32_t>, 8> Replacements;
+    for (auto &I : instructions(*NewF)) {
+      auto *const LI = dyn_cast<LoadInst>(&I);
+      if (!LI || !LI->getType()->isIntegerTy(32)) {
+        continue;
+      }
+      APInt Offset(DL.getIndexTypeSizeInBits(LI->getPointerOperandType()), 0);
+      if (LI->getPointerOperand()->stripAndAccumulateConstantOffsets(
+              DL, Offset, /*AllowNonInbounds*/ true) != ImageArg) {
+        continue;
+      }
+      if (Offset == ChannelOrderOffset) {
+        Replacements.push_back({LI, Format->first});
+      } else if (Offset == ChannelTypeOffset) {
+        Replacements.push_back({LI, Format->second});
+      }
+    }
+    for (auto [LI, Value] : Replacements) {
+      LI->replaceAllUsesWith(ConstantInt::get(LI->getType(), Value));
+      LI->eraseFromParent();
+    }
+  }
+
+  compiler::encodeImageSpecializationMetadata(*NewF, Info);
+  NewF->setName(F.getName() + Suffix);
+  NewF->setLinkage(GlobalValue::InternalLinkage);
+  if (!NewF->hasFnAttribute(Attribute::NoInline)) {
+    NewF->addFnAttr(Attribute::InlineHint);
+  }
+
+  foldConstantControlFlow(*NewF);
+  return NewF;
+}
+}  // namespace
+
+namespace compiler {
+
+void encodeImageSpecializationMetadata(Function &f,
+                                       const ImageSpecializationInfo &info) {
+  auto &Ctx = f.getContext();
+  auto *const i32Ty = Type::getInt32Ty(Ctx);
+  auto getMD = [i32Ty](uint32_t v) -> Metadata * {
+    return ConstantAsMetadata::get(ConstantInt::get(i32Ty, v));
+  };
+
+  SmallVector<Metadata *, 8> Ops;
+  for (const auto &[Idx, Sampler] : info.Samplers) {
+    Ops.push_back(MDTuple::get(Ctx, {getMD(Idx), getMD(Sampler)}));
+  }
+  for (const auto &[Idx, Format] : info.Formats) {
+    Ops.push_back(MDTuple::get(
+        Ctx, {getMD(Idx), getMD(Format.first), getMD(Format.second)}));
+  }
+
+  f.setMetadata(ImageSpecMD, Ops.empty() ? nullptr : MDTuple::get(Ctx, Ops));
+}
+
+std::optional<ImageSpecializationInfo> getImageSpecializationMetadata(
+    const Function &f) {
+  auto *const MD = f.getMetadata(ImageSpecMD);
+  if (!MD) {
+    return std::nullopt;
+  }
+
+  ImageSpecializationInfo Info;
+  for (const auto &Op : MD->operands()) {
+    auto *const Entry = cast<MDTuple>(Op);
+    auto getValue = [Entry](unsigned i) {
+      return static_cast<uint32_t>(
+          mdconst::extract<ConstantInt>(Entry->getOperand(i))->getZExtValue());
+    };
+    if (Entry->getNumOperands() == 2) {
+      Info.Samplers[getValue(0)] = getValue(1);
+    } else if (Entry->getNumOperands() == 3) {
+      Info.Formats[getValue(0)] = {getValue(1), getValue(2)};
+    }
+  }
+  return Info;
+}
+
+PreservedAnalyses ImageReadSpecializationPass::run(Module &M,
+                                                   ModuleAnalysisManager &) {
+  // Cache the known arguments of each calling function. Vectorized kernels
+  // look them up on the scalar kernel they were derived from.
+  std::map<Function *, std::optional<ImageSpecializationInfo>> CallerInfos;
+  auto getCallerInfo = [&](Function &Caller) -> const ImageSpecializationInfo * {
+    auto [It, Inserted] = CallerInfos.try_emplace(&Caller);
+    if (Inserted) {
+      It->second = getImageSpecializationMetadata(Caller);
+      if (!It->second) {
+        if (auto Link = utils::parseVeczToOrigFnLinkMetadata(Caller);
+            Link && Link->first) {
+          It->second = getImageSpecializationMetadata(*Link->first);
+        }
+      }
+    }
+    return It->second ? &*It->second : nullptr;
+  };
+
+  using SpecializationKey = std::tuple<Function *, std::optional<uint32_t>,
+                                       std::optional<KnownFormat>>;
+  std::map<SpecializationKey, Function *> Specializations;
+  SmallPtrSet<Function *, 8> Specialized;
+
+  // The image library's overloads forward their arguments to other read
+  // functions, whose calls only see the known values once the forwarding
+  // function has been specialized. Repeat until no call can be rewritten.
+  bool Changed = false;
+  bool Rewritten;
+  do {
+    Rewritten = false;
+
+    SmallVector<CallInst *, 16> Calls;
+    for (auto &F : M) {
+      if (!isImageReadFunction(F) || Specialized.contains(&F)) {
+        continue;
+      }
+      for (auto *U : F.users()) {
+        if (auto *CI = dyn_cast<CallInst>(U);
+            CI && CI->getCalledFunction() == &F) {
+          Calls.push_back(CI);
+        }
+      }
+    }
+
+    for (auto *CI : Calls) {
+      Function *const Callee = CI->getCalledFunction();
+      const ImageSpecializationInfo *Info = getCallerInfo(*CI->getFunction());
+
+      const std::optional<uint32_t> Sampler =
+          takesSampler(*Callee) ? getKnownSampler(CI->getArgOperand(1), Info)
+                                : std::nullopt;
+      const std::optional<KnownFormat> Format =
+          getKnownFormat(CI->getArgOperand(0), Info);
+      if (!Sampler && !Format) {
+        continue;
+      }
+
+      auto &Specialization = Specializations[{Callee, Sampler, Format}];
+      if (!Specialization) {
+        Specialization = createSpecialization(*Callee, Sampler, Format);
+        Specialized.insert(Specialization);
+      }
+      CI->setCalledFunction(Specialization);
+      Rewritten = true;
+    }
+    Changed |= Rewritten;
+  } while (Rewritten);
+
+  return Changed ? PreservedAnalyses::none() : PreservedAnalyses::all();
+}
+
+}  // namespace compiler
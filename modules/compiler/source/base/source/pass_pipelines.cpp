@@ -14,6 +14,7 @@
 //
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <base/image_read_specialization_pass.h>
 #include <base/pass_pipelines.h>
 #include <compiler/utils/add_kernel_wrapper_pass.h>
 #include <compiler/utils/add_scheduling_parameters_pass.h>
@@ -79,6 +80,10 @@ void addLateBuiltinsPasses(ModulePassManager &PM,
                            const BasePassPipelineTuner &tuner) {
   PM.addPass(compiler::utils::LinkBuiltinsPass());
 
+  // Now that the image library is linked in, specialize image reads on any
+  // samplers and image formats known at compile time.
+  PM.addPass(compiler::ImageReadSpecializationPass());
+
   PM.addPass(compiler::utils::DefineMuxDmaPass());
 
   PM.addPass(compiler::utils::ReplaceMuxMathDeclsPass(
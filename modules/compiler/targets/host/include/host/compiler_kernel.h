@@ -21,6 +21,7 @@
 #ifndef HOST_COMPILER_KERNEL_H_INCLUDED
 #define HOST_COMPILER_KERNEL_H_INCLUDED
 
+#include <base/image_read_specialization_pass.h>
 #include <base/kernel.h>
 #include <compiler/module.h>
 #include <host/utils/jit_kernel.h>
@@ -87,18 +88,26 @@ class HostKernel : public compiler::BaseKernel {
   /// @brief Gets an `OptimizedKernel` object for the given local size.
   ///
   /// @param local_size Local size to optimize the kernel for.
+  /// @param images Samplers and image formats to specialize image reads on.
   cargo::expected<const OptimizedKernel &, compiler::Result>
-  lookupOrCreateOptimizedKernel(std::array<size_t, 3> local_size);
+  lookupOrCreateOptimizedKernel(
+      std::array<size_t, 3> local_size,
+      const compiler::ImageSpecializationInfo &images = {});
+
+  /// @brief Key identifying a specialization of this kernel.
+  using OptimizedKernelKey =
+      std::pair<std::array<size_t, 3>, compiler::ImageSpecializationInfo>;
 
   /// @brief LLVM module containing only the kernel function and functions it
   /// calls, not yet optimized for a local size.
   llvm::Module *module;
 
-  /// @brief Map of optimized modules to their local sizes.
+  /// @brief Map of optimized modules to their local sizes and known image
+  /// arguments.
   ///
   /// By an "optimized module" we mean a copy of this kernel's LLVM module which
   /// has had passes that optimize for a specific local size run on it.
-  std::map<std::array<size_t, 3>, OptimizedKernel> optimized_kernel_map;
+  std::map<OptimizedKernelKey, OptimizedKernel> optimized_kernel_map;
 
   /// @brief A set of JITDylibs created to manage JIT resources for kernels.
   std::unordered_set<std::string> kernel_jit_dylibs;
@@ -33,6 +33,9 @@ enum Type {
   slice,
   total_slices,
   work_dim,
+  arena,
+  arena_size,
+  arena_required,
   total
 };
 }
@@ -0,0 +1,64 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// Place work-group state in the per-thread arena rather than on the stack.
+
+#ifndef HOST_WORK_GROUP_ARENA_PASS_H_INCLUDED
+#define HOST_WORK_GROUP_ARENA_PASS_H_INCLUDED
+
+#include <llvm/IR/PassManager.h>
+
+namespace host {
+
+/// @brief Suffix of the symbol through which a kernel reports its arena size.
+///
+/// NOTE: This must match host::arena_s::size_symbol_suffix in the host mux
+/// target.
+constexpr const char ArenaSizeSymbolSuffix[] = ".arena-size";
+
+/// @brief This pass moves large and variable-sized stack allocations of kernel
+/// entry points into the arena passed through the schedule info struct.
+///
+/// These allocations are the barrier live variables, `__local` buffers and
+/// `__local` module-scope variables of the whole work-group, which grow with
+/// the work-group size and would otherwise risk overflowing the stacks of the
+/// threads running the kernel.
+///
+/// Large allocations in the entry block are given fixed offsets at the start
+/// of the arena. Variable-sized allocations are bump-allocated after them,
+/// releasing their memory wherever the stack would be restored. Each
+/// allocation checks that it fits in the arena, falling back to the stack
+/// otherwise, and the arena size the kernel needed is reported back through
+/// the schedule info struct.
+///
+/// So that the arena can be sized before the kernel first runs, the pass also
+/// emits a constant named after the entry point with `ArenaSizeSymbolSuffix`
+/// appended. It holds two 64-bit values, the bytes the kernel needs whatever
+/// the work-group size, and the bytes of barrier live variables it needs per
+/// work-item.
+///
+/// The pass expects to run once the kernel wrappers have been inlined into the
+/// entry point.
+class WorkGroupArenaPass final
+    : public llvm::PassInfoMixin<WorkGroupArenaPass> {
+ public:
+  llvm::PreservedAnalyses run(llvm::Module &, llvm::ModuleAnalysisManager &);
+};
+}  // namespace host
+
+#endif  // HOST_WORK_GROUP_ARENA_PASS_H_INCLUDED
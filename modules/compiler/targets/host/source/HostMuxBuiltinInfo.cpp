@@ -14,6 +14,7 @@
 //
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <compiler/utils/dma.h>
 #include <compiler/utils/metadata.h>
 #include <compiler/utils/pass_functions.h>
 #include <compiler/utils/scheduling.h>
@@ -62,6 +63,7 @@ StructType *HostBIMuxInfo::getScheduleInfoStruct(Module &M) {
   auto *const size_type = compiler::utils::getSizeType(M);
   auto *const array_type = ArrayType::get(size_type, 3);
 
+  // NOTE: This must match host::schedule_info_s in the host mux target.
   SmallVector<Type *, ScheduleInfoStruct::total> elements(
       ScheduleInfoStruct::total);
 
@@ -71,6 +73,9 @@ StructType *HostBIMuxInfo::getScheduleInfoStruct(Module &M) {
   elements[ScheduleInfoStruct::slice] = size_type;
   elements[ScheduleInfoStruct::total_slices] = size_type;
   elements[ScheduleInfoStruct::work_dim] = uint_type;
+  elements[ScheduleInfoStruct::arena] = PointerType::getUnqual(Ctx);
+  elements[ScheduleInfoStruct::arena_size] = size_type;
+  elements[ScheduleInfoStruct::arena_required] = size_type;
 
   return StructType::create(elements, HostStructName);
 }
@@ -134,6 +139,143 @@ HostBIMuxInfo::getMuxSchedulingParameters(Module &M) {
   return {WIInfo, SchedInfo, WGInfo};
 }
 
+/// @brief Copy `NumLines` lines of `LineSize` bytes with a `memcpy` per line,
+/// or with a single `memcpy` when the lines are contiguous in both the source
+/// and the destination.
+///
+/// @return The block the copy finishes in, which has no terminator.
+static BasicBlock *copyLines(BasicBlock *BB, Value *DstPtr, Value *SrcPtr,
+                             Value *LineSize, Value *DstLineStride,
+                             Value *SrcLineStride, Value *NumLines) {
+  auto &Ctx = BB->getContext();
+  auto *const F = BB->getParent();
+  auto *const ContiguousBB = BasicBlock::Create(Ctx, "dma.contiguous", F);
+  auto *const LinesBB = BasicBlock::Create(Ctx, "dma.lines", F);
+  auto *const ExitBB = BasicBlock::Create(Ctx, "dma.lines.exit", F);
+
+  // Copying no lines is also handled by the contiguous copy, which then
+  // copies no bytes, as the loop over lines always runs at least once.
+  IRBuilder<> B(BB);
+  auto *const IsContiguous = B.CreateOr(
+      B.CreateAnd(B.CreateICmpEQ(DstLineStride, LineSize),
+                  B.CreateICmpEQ(SrcLineStride, LineSize)),
+      B.CreateICmpEQ(NumLines, ConstantInt::get(NumLines->getType(), 0)));
+  B.CreateCondBr(IsContiguous, ContiguousBB, LinesBB);
+
+  IRBuilder<> ContiguousIRB(ContiguousBB);
+  ContiguousIRB.CreateMemCpy(DstPtr, MaybeAlign(), SrcPtr, MaybeAlign(),
+                             ContiguousIRB.CreateMul(LineSize, NumLines));
+  ContiguousIRB.CreateBr(ExitBB);
+
+  compiler::utils::CreateLoopOpts opts;
+  opts.IVs = {SrcPtr, DstPtr};
+  opts.loopIVNames = {"dma.src", "dma.dst"};
+  compiler::utils::createLoop(
+      LinesBB, ExitBB, ConstantInt::get(NumLines->getType(), 0), NumLines,
+      opts,
+      [&](BasicBlock *LoopBB, Value *, ArrayRef<Value *> IVsCurr,
+          MutableArrayRef<Value *> IVsNext) {
+        IRBuilder<> LoopIRB(LoopBB);
+        LoopIRB.CreateMemCpy(IVsCurr[1], MaybeAlign(), IVsCurr[0],
+                             MaybeAlign(), LineSize);
+        IVsNext[0] =
+            LoopIRB.CreateGEP(LoopIRB.getInt8Ty(), IVsCurr[0], SrcLineStride);
+        IVsNext[1] =
+            LoopIRB.CreateGEP(LoopIRB.getInt8Ty(), IVsCurr[1], DstLineStride);
+        return LoopBB;
+      });
+
+  return ExitBB;
+}
+
+/// @brief Define the `__mux_dma_read_*` and `__mux_dma_write_*` builtins as
+/// bulk copies.
+///
+/// The default definitions copy a byte at a time. Host executes the
+/// work-items of a work-group one after another on the same thread, so the
+/// copy finishes before any other work-item needs it, and the work-item
+/// which performs it is best served by `memcpy`, which moves whole vectors at
+/// a time. `__mux_dma_wait` keeps its default definition, which does nothing.
+///
+/// @param[in] ID Identifier of the builtin to define.
+/// @param[in] F Declaration of the builtin to define.
+/// @param[in] GetLocalIDFn The `__mux_get_local_id` builtin.
+static Function *defineDMA(compiler::utils::BuiltinID ID, Function &F,
+                           Function &GetLocalIDFn) {
+  auto &Ctx = F.getContext();
+  auto *const ExitBB = BasicBlock::Create(Ctx, "exit", &F);
+  auto *const CopyBB = BasicBlock::Create(Ctx, "copy", &F, ExitBB);
+  auto *const EntryBB = BasicBlock::Create(Ctx, "entry", &F, CopyBB);
+
+  compiler::utils::buildThreadCheck(EntryBB, CopyBB, ExitBB, GetLocalIDFn);
+
+  Argument *const ArgDstPtr = F.getArg(0);
+  Argument *const ArgSrcPtr = F.getArg(1);
+  Argument *const ArgLineSize = F.getArg(2);
+  BasicBlock *CopyExitBB = nullptr;
+  switch (ID) {
+    default:
+      llvm_unreachable("Unexpected DMA builtin");
+    case compiler::utils::eMuxBuiltinDMARead1D:
+    case compiler::utils::eMuxBuiltinDMAWrite1D: {
+      IRBuilder<> B(CopyBB);
+      B.CreateMemCpy(ArgDstPtr, MaybeAlign(), ArgSrcPtr, MaybeAlign(),
+                     ArgLineSize);
+      CopyExitBB = CopyBB;
+    } break;
+    case compiler::utils::eMuxBuiltinDMARead2D:
+    case compiler::utils::eMuxBuiltinDMAWrite2D:
+      CopyExitBB = copyLines(CopyBB, ArgDstPtr, ArgSrcPtr, ArgLineSize,
+                             F.getArg(3), F.getArg(4), F.getArg(5));
+      break;
+    case compiler::utils::eMuxBuiltinDMARead3D:
+    case compiler::utils::eMuxBuiltinDMAWrite3D: {
+      Argument *const ArgDstLineStride = F.getArg(3);
+      Argument *const ArgSrcLineStride = F.getArg(4);
+      Argument *const ArgNumLinesPerPlane = F.getArg(5);
+      Argument *const ArgDstPlaneStride = F.getArg(6);
+      Argument *const ArgSrcPlaneStride = F.getArg(7);
+      Argument *const ArgNumPlanes = F.getArg(8);
+
+      // The loop over planes always runs at least once, so skip it when there
+      // are no planes.
+      auto *const PlanesBB = BasicBlock::Create(Ctx, "dma.planes", &F, ExitBB);
+      IRBuilder<> B(CopyBB);
+      B.CreateCondBr(
+          B.CreateICmpEQ(ArgNumPlanes,
+                         ConstantInt::get(ArgNumPlanes->getType(), 0)),
+          ExitBB, PlanesBB);
+
+      compiler::utils::CreateLoopOpts opts;
+      opts.IVs = {ArgSrcPtr, ArgDstPtr};
+      opts.loopIVNames = {"dma.src", "dma.dst"};
+      CopyExitBB = compiler::utils::createLoop(
+          PlanesBB, nullptr, ConstantInt::get(ArgNumPlanes->getType(), 0),
+          ArgNumPlanes, opts,
+          [&](BasicBlock *LoopBB, Value *, ArrayRef<Value *> IVsCurr,
+              MutableArrayRef<Value *> IVsNext) {
+            IRBuilder<> LoopIRB(LoopBB);
+            IVsNext[0] = LoopIRB.CreateGEP(LoopIRB.getInt8Ty(), IVsCurr[0],
+                                           ArgSrcPlaneStride);
+            IVsNext[1] = LoopIRB.CreateGEP(LoopIRB.getInt8Ty(), IVsCurr[1],
+                                           ArgDstPlaneStride);
+            return copyLines(LoopBB, IVsCurr[1], IVsCurr[0], ArgLineSize,
+                             ArgDstLineStride, ArgSrcLineStride,
+                             ArgNumLinesPerPlane);
+          });
+    } break;
+  }
+
+  IRBuilder<> CopyExitIRB(CopyExitBB);
+  CopyExitIRB.CreateBr(ExitBB);
+
+  // The event is the last argument of every dimension of DMA builtin.
+  IRBuilder<> ExitIRB(ExitBB);
+  ExitIRB.CreateRet(F.getArg(F.arg_size() - 1));
+
+  return &F;
+}
+
 Function *HostBIMuxInfo::defineMuxBuiltin(compiler::utils::BuiltinID ID,
                                           Module &M,
                                           ArrayRef<Type *> OverloadInfo) {
@@ -157,6 +299,16 @@ Function *HostBIMuxInfo::defineMuxBuiltin(compiler::utils::BuiltinID ID,
     default:
       return compiler::utils::BIMuxInfoConcept::defineMuxBuiltin(ID, M,
                                                                  OverloadInfo);
+    case compiler::utils::eMuxBuiltinDMARead1D:
+    case compiler::utils::eMuxBuiltinDMAWrite1D:
+    case compiler::utils::eMuxBuiltinDMARead2D:
+    case compiler::utils::eMuxBuiltinDMAWrite2D:
+    case compiler::utils::eMuxBuiltinDMARead3D:
+    case compiler::utils::eMuxBuiltinDMAWrite3D: {
+      auto *const GetLocalIDFn =
+          getOrDeclareMuxBuiltin(compiler::utils::eMuxBuiltinGetLocalId, M);
+      return defineDMA(ID, *F, *GetLocalIDFn);
+    }
     case compiler::utils::eMuxBuiltinGetLocalSize:
       ParamIdx = SchedParamIndices::SCHED;
       DefaultVal = 1;
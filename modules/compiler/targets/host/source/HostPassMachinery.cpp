@@ -30,12 +30,14 @@
 #include <compiler/utils/manual_type_legalization_pass.h>
 #include <compiler/utils/metadata.h>
 #include <compiler/utils/metadata_analysis.h>
+#include <compiler/utils/pass_functions.h>
 #include <compiler/utils/pipeline_parse_helpers.h>
 #include <compiler/utils/remove_exceptions_pass.h>
 #include <compiler/utils/remove_lifetime_intrinsics_pass.h>
 #include <compiler/utils/replace_address_space_qualifier_functions_pass.h>
 #include <compiler/utils/replace_local_module_scope_variables_pass.h>
 #include <compiler/utils/simple_callback_pass.h>
+#include <compiler/utils/sub_group_analysis.h>
 #include <compiler/utils/unique_opaque_structs_pass.h>
 #include <compiler/utils/verify_reqd_sub_group_size_pass.h>
 #include <compiler/utils/work_item_loops_pass.h>
@@ -45,6 +47,7 @@
 #include <host/host_pass_machinery.h>
 #include <host/remove_byval_attributes_pass.h>
 #include <host/target.h>
+#include <host/work_group_arena_pass.h>
 #include <llvm/ADT/APFloat.h>
 #include <llvm/ADT/bit.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
@@ -53,9 +56,112 @@
 #include <multi_llvm/llvm_version.h>
 #include <utils/system.h>
 #include <vecz/pass.h>
+#include <vecz/vecz_target_info.h>
 
 namespace host {
 
+namespace {
+/// @brief Chooses the sub-group size of a kernel using sub-groups that has no
+/// required sub-group size.
+///
+/// Sub-groups map to the lanes of the vectorized kernel, so the size is the
+/// largest of the device's sub-group sizes that fits a vector register with the
+/// kernel's widest element type, narrowed until the values the kernel keeps
+/// live fit in the register file. Sub-group collectives then become operations
+/// within a single register.
+///
+/// @param[in] F Kernel to choose the options for.
+/// @param[in] MAM Module analysis manager.
+///
+/// @return The options to vectorize the kernel with, or std::nullopt if the
+/// generic choice made by vecz::getAutoSubgroupSizeOpts should be used.
+std::optional<vecz::VeczPassOptions> getNativeSubgroupSizeOpts(
+    llvm::Function &F, llvm::ModuleAnalysisManager &MAM) {
+  auto &M = *F.getParent();
+  if (compiler::utils::getReqdSubgroupSize(F) ||
+      !MAM.getResult<compiler::utils::SubgroupAnalysis>(M).usesSubgroups(F)) {
+    return std::nullopt;
+  }
+
+  auto &FAM =
+      MAM.getResult<llvm::FunctionAnalysisManagerModuleProxy>(M).getManager();
+  const auto &TTI = FAM.getResult<llvm::TargetIRAnalysis>(F);
+  vecz::TargetInfo *const TI = MAM.getResult<vecz::TargetInfoAnalysis>(M);
+  const unsigned RegisterWidth =
+      TTI.getRegisterBitWidth(llvm::TargetTransformInfo::RGK_FixedWidthVector)
+          .getFixedValue();
+  if (!TI || RegisterWidth == 0) {
+    return std::nullopt;
+  }
+
+  llvm::SmallVector<const llvm::Value *, 16> LiveValues;
+  compiler::utils::getApproximateLiveValues(F, LiveValues);
+  const unsigned NativeWidth = TI->estimateSimdWidth(
+      TTI, LiveValues,
+      RegisterWidth / compiler::utils::getWidestElementWidth(F));
+
+  const auto LocalSizes = compiler::utils::getLocalSizeMetadata(F);
+  const uint64_t LocalSize = LocalSizes ? (*LocalSizes)[0] : 0;
+  const auto MuxSubgroupSize = compiler::utils::getMuxSubgroupSize(F);
+  const auto &DI = MAM.getResult<compiler::utils::DeviceInfoAnalysis>(M);
+
+  unsigned Width = 0;
+  for (auto Size : DI.reqd_sub_group_sizes) {
+    if (Size < MuxSubgroupSize || Size % MuxSubgroupSize) {
+      continue;
+    }
+    const unsigned Candidate = Size / MuxSubgroupSize;
+    if (Candidate <= NativeWidth &&
+        (LocalSize == 0 || Candidate <= LocalSize)) {
+      Width = std::max(Width, Candidate);
+    }
+  }
+  if (Width < 2) {
+    return std::nullopt;
+  }
+
+  vecz::VeczPassOptions Opts;
+  Opts.vec_dim_idx = 0;
+  Opts.vecz_auto = false;
+  Opts.local_size = LocalSize;
+  Opts.factor = compiler::utils::VectorizationFactor::getFixedWidth(Width);
+  Opts.choices.enable(vecz::VectorizationChoices::eDivisionExceptions);
+  return Opts;
+}
+
+/// @brief Checks whether a kernel vectorized to a width should be given a
+/// vector-predicated tail.
+///
+/// The tail is only worth it where the local size leaves a remainder and the
+/// target can mask memory accesses of the kernel's widest element type, such as
+/// with AVX-512 or SVE. Otherwise the scalar tail is kept.
+///
+/// @param[in] F Kernel to check.
+/// @param[in] MAM Module analysis manager.
+/// @param[in] Width Width the kernel is vectorized to.
+/// @param[in] LocalSize Local size in the vectorized dimension, or zero if it
+/// is not known.
+///
+/// @return Whether to vectorize the kernel with a vector-predicated tail.
+bool hasMaskedTail(llvm::Function &F, llvm::ModuleAnalysisManager &MAM,
+                   unsigned Width, uint64_t LocalSize) {
+  if (Width < 2 || (LocalSize != 0 && LocalSize % Width == 0)) {
+    return false;
+  }
+  auto &M = *F.getParent();
+  auto &FAM =
+      MAM.getResult<llvm::FunctionAnalysisManagerModuleProxy>(M).getManager();
+  const auto &TTI = FAM.getResult<llvm::TargetIRAnalysis>(F);
+  const unsigned ElementWidth = compiler::utils::getWidestElementWidth(F);
+  auto *const VecTy = llvm::FixedVectorType::get(
+      llvm::Type::getIntNTy(F.getContext(), ElementWidth), Width);
+  const llvm::Align Alignment =
+      M.getDataLayout().getABITypeAlign(VecTy->getElementType());
+  return TTI.isLegalMaskedLoad(VecTy, Alignment) &&
+         TTI.isLegalMaskedStore(VecTy, Alignment);
+}
+}  // namespace
+
 bool hostVeczPassOpts(llvm::Function &F, llvm::ModuleAnalysisManager &MAM,
                       llvm::SmallVectorImpl<vecz::VeczPassOptions> &Opts) {
   auto vecz_mode = compiler::getVectorizationMode(F);
@@ -67,9 +173,14 @@ bool hostVeczPassOpts(llvm::Function &F, llvm::ModuleAnalysisManager &MAM,
   if (!compiler::utils::isKernelEntryPt(F)) {
     return false;
   }
-  // Handle auto sub-group sizes. If the kernel uses sub-groups or has a
-  // required sub-group size, only vectorize to one of those lengths. Let vecz
-  // pick.
+  // Handle auto sub-group sizes. If the kernel uses sub-groups, vectorize to
+  // the native vector width where that is one of the device's sub-group sizes.
+  if (auto native_subgroup_vf = getNativeSubgroupSizeOpts(F, MAM)) {
+    Opts.assign(1, *native_subgroup_vf);
+    return true;
+  }
+  // Otherwise, if the kernel uses sub-groups or has a required sub-group size,
+  // only vectorize to one of those lengths. Let vecz pick.
   if (auto auto_subgroup_vf = vecz::getAutoSubgroupSizeOpts(F, MAM)) {
     Opts.assign(1, *auto_subgroup_vf);
     return true;
@@ -104,9 +215,17 @@ bool hostVeczPassOpts(llvm::Function &F, llvm::ModuleAnalysisManager &MAM,
   // times from becoming too long in UnitCL. When the mode is AUTO,
   // it may decide to vectorize narrower than the given width, but
   // never wider.
-  const uint32_t work_width =
+  uint32_t work_width =
       (vecz_mode == compiler::VectorizationMode::ALWAYS) ? 16u : max_work_width;
 
+  // The CA_HOST_VF environment variable overrides the width, e.g. so that
+  // oclc's autotuning mode can search for the best width for a kernel.
+  if (const char *vf_string = std::getenv("CA_HOST_VF")) {
+    if (const int vf = std::atoi(vf_string); vf > 0) {
+      work_width = std::min(static_cast<uint32_t>(vf), max_work_width);
+    }
+  }
+
   // The final vector width will be the kernel's dynamic work width,
   // and dynamic work width must not exceed the device's maximum
   // work width, so cap it before we even attempt vectorization.
@@ -118,6 +237,22 @@ bool hostVeczPassOpts(llvm::Function &F, llvm::ModuleAnalysisManager &MAM,
       compiler::utils::VectorizationFactor::getFixedWidth(SIMDWidth);
 
   Opts.push_back(vecz_options);
+
+  // Setting the CA_HOST_MASKED_TAIL environment variable to 1 also builds a
+  // vector-predicated kernel, which the work-item loops then use as the tail
+  // in place of running the left over work-items one by one.
+  const char *masked_tail_string = std::getenv("CA_HOST_MASKED_TAIL");
+  if (masked_tail_string && std::atoi(masked_tail_string) != 0 &&
+      hasMaskedTail(F, MAM, SIMDWidth, local_size)) {
+    // Vector-predicated kernels cover partial groups themselves, so they are
+    // not given the local size. They only act as the tail of a vector kernel
+    // of the same width, so vecz must not pick another one.
+    vecz_options.local_size = 0;
+    vecz_options.vecz_auto = false;
+    vecz_options.choices.enable(
+        vecz::VectorizationChoices::eVectorPredication);
+    Opts.push_back(vecz_options);
+  }
   return true;
 }
 
@@ -260,6 +395,7 @@ llvm::ModulePassManager HostPassMachinery::getKernelFinalizationPasses(
 
   compiler::utils::WorkItemLoopsPassOptions WIOpts;
   WIOpts.IsDebug = options.opt_disable;
+  WIOpts.SoALiveVars = true;
 
   PM.addPass(compiler::utils::WorkItemLoopsPass(WIOpts));
 
@@ -290,6 +426,10 @@ llvm::ModulePassManager HostPassMachinery::getKernelFinalizationPasses(
   // be inlined even at -O0.
   PM.addPass(llvm::AlwaysInlinerPass());
 
+  // Now that the wrappers are inlined into the entry points, move the
+  // work-group's state off the stack.
+  PM.addPass(host::WorkGroupArenaPass());
+
   // Running this pass here is the "nuclear option", it would be better to
   // ensure exception handling is never introduced in the first place, but
   // it is not always plausible to do.
@@ -0,0 +1,244 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <compiler/utils/attributes.h>
+#include <compiler/utils/builtin_info.h>
+#include <compiler/utils/pass_functions.h>
+#include <host/host_mux_builtin_info.h>
+#include <host/work_group_arena_pass.h>
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Module.h>
+
+using namespace llvm;
+
+namespace {
+/// @brief Alignment of the arena's memory.
+///
+/// NOTE: This must match host::arena_s::alignment in the host mux target.
+constexpr uint64_t ArenaAlignment = 64;
+
+/// @brief Smallest fixed-size allocation worth moving into the arena.
+constexpr uint64_t MinArenaAllocaSize = 1024;
+
+void replaceAlloca(AllocaInst *AI, Value *Ptr) {
+  // Lifetime markers must refer to allocas, the arena memory doesn't need
+  // them.
+  for (auto *U : make_early_inc_range(AI->users())) {
+    auto *const II = dyn_cast<IntrinsicInst>(U);
+    if (II && II->isLifetimeStartOrEnd()) {
+      II->eraseFromParent();
+    }
+  }
+  Ptr->takeName(AI);
+  AI->replaceAllUsesWith(Ptr);
+  AI->eraseFromParent();
+}
+
+bool runOnFunction(Function &F, Argument *SchedInfo, StructType *SchedInfoTy) {
+  Module &M = *F.getParent();
+  const DataLayout &DL = M.getDataLayout();
+  BasicBlock &Entry = F.getEntryBlock();
+  // Code setting up the arena goes after the entry block's allocas.
+  auto IPIt = Entry.getFirstInsertionPt();
+  while (isa<AllocaInst>(*IPIt)) {
+    ++IPIt;
+  }
+  Instruction *const IP = &*IPIt;
+
+  SmallVector<AllocaInst *, 4> StaticAllocas;
+  SmallVector<AllocaInst *, 4> DynamicAllocas;
+  for (auto &I : instructions(F)) {
+    auto *const AI = dyn_cast<AllocaInst>(&I);
+    if (!AI || AI->getType()->getPointerAddressSpace() != 0 ||
+        DL.getTypeAllocSize(AI->getAllocatedType()).isScalable()) {
+      continue;
+    }
+    if (AI->isStaticAlloca()) {
+      const auto Size = AI->getAllocationSizeInBits(DL);
+      if (Size && Size->getFixedValue() / 8 >= MinArenaAllocaSize &&
+          AI->getAlign().value() <= ArenaAlignment) {
+        StaticAllocas.push_back(AI);
+      }
+    } else if (AI->getParent() != &Entry || !AI->comesBefore(IP)) {
+      // Variable-sized allocations ahead of the insertion point can only be
+      // sized by arguments, these are left on the stack.
+      DynamicAllocas.push_back(AI);
+    }
+  }
+
+  if (StaticAllocas.empty() && DynamicAllocas.empty()) {
+    return false;
+  }
+
+  auto *const SizeTy = compiler::utils::getSizeType(M);
+  IRBuilder<> B(IP);
+
+  auto *const ArenaTy =
+      SchedInfoTy->getElementType(host::ScheduleInfoStruct::arena);
+  Value *const Arena = B.CreateLoad(
+      ArenaTy,
+      B.CreateStructGEP(SchedInfoTy, SchedInfo,
+                        host::ScheduleInfoStruct::arena),
+      "arena");
+  Value *const ArenaSize = B.CreateLoad(
+      SizeTy,
+      B.CreateStructGEP(SchedInfoTy, SchedInfo,
+                        host::ScheduleInfoStruct::arena_size),
+      "arena.size");
+  Value *const RequiredPtr = B.CreateStructGEP(
+      SchedInfoTy, SchedInfo, host::ScheduleInfoStruct::arena_required);
+
+  // Fixed-size allocations are laid out at the start of the arena, or all
+  // fall back to the stack together if they don't fit.
+  uint64_t StaticSize = 0;
+  Align StaticAlign(1);
+  SmallVector<uint64_t, 4> StaticOffsets;
+  for (auto *AI : StaticAllocas) {
+    const Align A = AI->getAlign();
+    StaticSize = alignTo(StaticSize, A);
+    StaticOffsets.push_back(StaticSize);
+    StaticSize += AI->getAllocationSizeInBits(DL)->getFixedValue() / 8;
+    StaticAlign = std::max(StaticAlign, A);
+  }
+  auto *const StaticSizeVal = ConstantInt::get(SizeTy, StaticSize);
+
+  // Report the arena size the kernel needs before it first runs. On top of
+  // the fixed-size allocations, variable-sized allocations may be padded for
+  // alignment, and the barrier's live variables grow with the work-group.
+  // Anything else variable-sized, such as `__local` buffer arguments, is only
+  // known when the kernel is enqueued.
+  uint64_t ReportedSize = StaticSize;
+  for (auto *AI : DynamicAllocas) {
+    ReportedSize += AI->getAlign().value();
+  }
+  const uint64_t Reported[2] = {
+      ReportedSize, compiler::utils::getBarrierLiveVarsSize(F).value_or(0)};
+  auto *const ReportedInit =
+      ConstantDataArray::get(M.getContext(), ArrayRef<uint64_t>(Reported));
+  new GlobalVariable(M, ReportedInit->getType(), /*isConstant*/ true,
+                     GlobalValue::ExternalLinkage, ReportedInit,
+                     F.getName() + host::ArenaSizeSymbolSuffix);
+
+  if (!StaticAllocas.empty()) {
+    auto *const Fits = B.CreateICmpULE(StaticSizeVal, ArenaSize);
+    auto *const Fallback = B.CreateAlloca(
+        B.getInt8Ty(),
+        B.CreateSelect(Fits, ConstantInt::get(SizeTy, 0), StaticSizeVal),
+        "arena.fallback");
+    Fallback->setAlignment(StaticAlign);
+    auto *const Base = B.CreateSelect(Fits, Arena, Fallback);
+    for (auto [AI, Offset] : zip(StaticAllocas, StaticOffsets)) {
+      auto *const Ptr = B.CreateInBoundsGEP(B.getInt8Ty(), Base,
+                                            ConstantInt::get(SizeTy, Offset));
+      replaceAlloca(AI, B.CreatePointerCast(Ptr, AI->getType()));
+    }
+  }
+  B.CreateStore(StaticSizeVal, RequiredPtr);
+
+  if (DynamicAllocas.empty()) {
+    return true;
+  }
+
+  // Variable-sized allocations are bumped from a cursor following the
+  // fixed-size ones. The cursor advances even when an allocation falls back to
+  // the stack so that the arena size reported covers everything.
+  IRBuilder<> AllocaB(&Entry, Entry.begin());
+  auto *const Cursor = AllocaB.CreateAlloca(SizeTy, nullptr, "arena.cursor");
+  B.CreateStore(StaticSizeVal, Cursor);
+  Value *const ArenaAddr = B.CreatePtrToInt(Arena, SizeTy);
+
+  // Wherever the stack is restored, so is the cursor, which releases the
+  // arena memory of allocations made in loops.
+  for (auto &I : make_early_inc_range(instructions(F))) {
+    auto *const Save = dyn_cast<IntrinsicInst>(&I);
+    if (!Save || Save->getIntrinsicID() != Intrinsic::stacksave) {
+      continue;
+    }
+    IRBuilder<> SaveB(Save->getNextNode());
+    auto *const Saved = SaveB.CreateLoad(SizeTy, Cursor, "arena.saved");
+    for (auto *U : Save->users()) {
+      auto *const Restore = dyn_cast<IntrinsicInst>(U);
+      if (Restore && Restore->getIntrinsicID() == Intrinsic::stackrestore) {
+        IRBuilder<>(Restore).CreateStore(Saved, Cursor);
+      }
+    }
+  }
+
+  for (auto *AI : DynamicAllocas) {
+    IRBuilder<> AB(AI);
+    const uint64_t A = AI->getAlign().value();
+    auto *const ElementSize = ConstantInt::get(
+        SizeTy, DL.getTypeAllocSize(AI->getAllocatedType()).getFixedValue());
+    auto *const Bytes = AB.CreateMul(
+        AB.CreateZExtOrTrunc(AI->getArraySize(), SizeTy), ElementSize);
+
+    // Align the address rather than the offset, as allocations may be more
+    // aligned than the arena.
+    auto *const Addr =
+        AB.CreateAdd(ArenaAddr, AB.CreateLoad(SizeTy, Cursor, "arena.cur"));
+    auto *const AlignedAddr =
+        AB.CreateAnd(AB.CreateAdd(Addr, ConstantInt::get(SizeTy, A - 1)),
+                     ConstantInt::get(SizeTy, ~(A - 1)));
+    auto *const Begin = AB.CreateSub(AlignedAddr, ArenaAddr);
+    auto *const End = AB.CreateAdd(Begin, Bytes);
+    AB.CreateStore(End, Cursor);
+    AB.CreateStore(
+        AB.CreateBinaryIntrinsic(Intrinsic::umax,
+                                 AB.CreateLoad(SizeTy, RequiredPtr), End),
+        RequiredPtr);
+
+    auto *const Fits = AB.CreateICmpULE(End, ArenaSize);
+    auto *const Fallback = AB.CreateAlloca(
+        AB.getInt8Ty(),
+        AB.CreateSelect(Fits, ConstantInt::get(SizeTy, 0), Bytes),
+        "arena.fallback");
+    Fallback->setAlignment(AI->getAlign());
+    auto *const Ptr = AB.CreateSelect(
+        Fits, AB.CreateInBoundsGEP(AB.getInt8Ty(), Arena, Begin), Fallback);
+    replaceAlloca(AI, AB.CreatePointerCast(Ptr, AI->getType()));
+  }
+
+  return true;
+}
+}  // namespace
+
+PreservedAnalyses host::WorkGroupArenaPass::run(Module &M,
+                                                ModuleAnalysisManager &AM) {
+  auto &BI = AM.getResult<compiler::utils::BuiltinInfoAnalysis>(M);
+  auto *const SchedInfoTy = HostBIMuxInfo::getScheduleInfoStruct(M);
+  bool Changed = false;
+
+  for (auto &F : M) {
+    if (F.isDeclaration() || !compiler::utils::isKernelEntryPt(F)) {
+      continue;
+    }
+    for (const auto &P : BI.getFunctionSchedulingParameters(F)) {
+      if (P.ParamPointeeTy == SchedInfoTy && P.ArgVal) {
+        Changed |= runOnFunction(F, P.ArgVal, SchedInfoTy);
+        break;
+      }
+    }
+  }
+
+  return Changed ? PreservedAnalyses::none() : PreservedAnalyses::all();
+}
@@ -15,6 +15,7 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include <base/base_module_pass_machinery.h>
+#include <base/image_read_specialization_pass.h>
 #include <compiler/utils/attributes.h>
 #include <compiler/utils/cl_builtin_info.h>
 #include <compiler/utils/encode_kernel_metadata_pass.h>
@@ -22,12 +23,14 @@
 #include <compiler/utils/metadata.h>
 #include <compiler/utils/metadata_analysis.h>
 #include <compiler/utils/pass_functions.h>
+#include <compiler/utils/simple_callback_pass.h>
 #include <host/compiler_kernel.h>
 #include <host/host_mux_builtin_info.h>
 #include <host/host_pass_machinery.h>
 #include <host/module.h>
 #include <host/target.h>
 #include <host/utils/relocations.h>
+#include <host/work_group_arena_pass.h>
 #include <llvm/ADT/Statistic.h>
 #include <llvm/ExecutionEngine/JITSymbol.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
@@ -44,6 +47,70 @@
 
 namespace host {
 
+namespace {
+/// @brief Returns the image library sampler value that the host mux target
+/// passes to kernels for the given sampler.
+///
+/// This must match the sampler value constructed when the host mux target
+/// packs kernel arguments.
+uint32_t getImageLibrarySampler(const mux_sampler_t &sampler) {
+  uint32_t value = sampler.normalize_coords ? 0x1 : 0x0;
+  switch (sampler.address_mode) {
+    case mux_address_mode_none:
+      value |= 0x0;
+      break;
+    case mux_address_mode_clamp_edge:
+      value |= 0x2;
+      break;
+    case mux_address_mode_clamp:
+      value |= 0x4;
+      break;
+    case mux_address_mode_repeat:
+      value |= 0x6;
+      break;
+    case mux_address_mode_repeat_mirror:
+      value |= 0x8;
+      break;
+  }
+  // The filter modes are deliberately swapped both when OpenCL creates the
+  // mux sampler and when the host mux target unpacks it.
+  switch (sampler.filter_mode) {
+    case mux_filter_mode_linear:
+      value |= 0x10;
+      break;
+    case mux_filter_mode_nearest:
+      value |= 0x20;
+      break;
+  }
+  return value;
+}
+
+/// @brief Collects the samplers and image formats passed to a kernel.
+compiler::ImageSpecializationInfo getImageSpecializationInfo(
+    const mux_ndrange_options_t &options) {
+  compiler::ImageSpecializationInfo info;
+  for (uint64_t i = 0; i < options.descriptors_length; i++) {
+    const auto &descriptor = options.descriptors[i];
+    switch (descriptor.type) {
+      case mux_descriptor_info_type_sampler:
+        info.Samplers[i] =
+            getImageLibrarySampler(descriptor.sampler_descriptor.sampler);
+        break;
+      case mux_descriptor_info_type_image: {
+        // Mux image formats encode the OpenCL channel order in the low 16
+        // bits and the channel type in the high 16 bits, both of which match
+        // the image library's values.
+        const uint32_t format = descriptor.image_descriptor.image->format;
+        info.Formats[i] = {format & 0xffff, format >> 16};
+      } break;
+      default:
+        break;
+    }
+  }
+  return info;
+}
+}  // namespace
+
 HostKernel::HostKernel(HostTarget &target, compiler::Options &build_options,
                        llvm::Module *module, std::string name,
                        std::array<size_t, 3> preferred_local_sizes,
@@ -142,7 +209,8 @@ HostKernel::createSpecializedKernel(
   std::copy(std::begin(specialization_options.local_size),
             std::end(specialization_options.local_size),
             std::begin(local_size));
-  auto optimized_kernel = lookupOrCreateOptimizedKernel(local_size);
+  auto optimized_kernel = lookupOrCreateOptimizedKernel(
+      local_size, getImageSpecializationInfo(specialization_options));
   if (!optimized_kernel) {
     return cargo::make_unexpected(optimized_kernel.error());
   }
@@ -230,9 +298,12 @@ cargo::expected<size_t, compiler::Result> HostKernel::queryMaxSubGroupCount() {
 }
 
 cargo::expected<const OptimizedKernel &, compiler::Result>
-HostKernel::lookupOrCreateOptimizedKernel(std::array<size_t, 3> local_size) {
-  if (0 < optimized_kernel_map.count(local_size)) {
-    return optimized_kernel_map[local_size];
+HostKernel::lookupOrCreateOptimizedKernel(
+    std::array<size_t, 3> local_size,
+    const compiler::ImageSpecializationInfo &images) {
+  const OptimizedKernelKey key{local_size, images};
+  if (0 < optimized_kernel_map.count(key)) {
+    return optimized_kernel_map[key];
   }
 
   {
@@ -283,6 +354,17 @@ HostKernel::lookupOrCreateOptimizedKernel(std::array<size_t, 3> local_size) {
                             static_cast<uint64_t>(local_size[2])};
     pm.addPass(compiler::utils::EncodeKernelMetadataPass(pass_opts));
 
+    // Describe any samplers and image formats known at enqueue time so that
+    // image reads can be specialized on them.
+    if (!images.empty()) {
+      pm.addPass(compiler::utils::SimpleCallbackPass(
+          [this, &images](llvm::Module &m) {
+            if (auto *f = m.getFunction(name)) {
+              compiler::encodeImageSpecializationMetadata(*f, images);
+            }
+          }));
+    }
+
     pm.addPass(pass_mach.getKernelFinalizationPasses(unique_name));
 
     {
@@ -319,6 +401,18 @@ HostKernel::lookupOrCreateOptimizedKernel(std::array<size_t, 3> local_size) {
               .getResult<compiler::utils::VectorizeMetadataAnalysis>(*f);
     }
 
+    // Retrieve the arena size the kernel reported needing, see
+    // host::WorkGroupArenaPass.
+    uint64_t arena_size[2] = {0, 0};
+    if (auto *gv = optimized_module->getNamedGlobal(
+            unique_name + host::ArenaSizeSymbolSuffix)) {
+      if (auto *init =
+              llvm::dyn_cast<llvm::ConstantDataArray>(gv->getInitializer())) {
+        arena_size[0] = init->getElementAsInteger(0);
+        arena_size[1] = init->getElementAsInteger(1);
+      }
+    }
+
     // Host doesn't support scalable values.
     if (fn_metadata.min_work_item_factor.isScalable() ||
         fn_metadata.pref_work_item_factor.isScalable() ||
@@ -470,11 +564,11 @@ HostKernel::lookupOrCreateOptimizedKernel(std::array<size_t, 3> local_size) {
     std::unique_ptr<host::utils::jit_kernel_s> jit_kernel(
         new host::utils::jit_kernel_s{
             name, hook, static_cast<uint32_t>(fn_metadata.local_memory_usage),
-            min_width, pref_width, sub_group_size});
+            min_width, pref_width, sub_group_size, arena_size[0],
+            arena_size[1]});
     optimized_kernel_map.emplace(
-        local_size,
-        OptimizedKernel{optimized_module_ptr, std::move(jit_kernel)});
+        key, OptimizedKernel{optimized_module_ptr, std::move(jit_kernel)});
   }
-  return optimized_kernel_map[local_size];
+  return optimized_kernel_map[key];
 }
 }  // namespace host
@@ -0,0 +1,78 @@
+; Copyright (C) Codeplay Software Limited
+;
+; Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+; Exceptions; you may not use this file except in compliance with the License.
+; You may obtain a copy of the License at
+;
+;     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+;
+; Unless required by applicable law or agreed to in writing, software
+; distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+; WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+; License for the specific language governing permissions and limitations
+; under the License.
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: muxc --device "%default_device" --passes define-mux-dma,verify -S %s | FileCheck %s
+
+target triple = "x86_64-unknown-unknown"
+target datalayout = "e-p:64:64:64-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+; Host copies with memcpy rather than a byte at a time, on the first work-item.
+; CHECK-LABEL: define ptr @__mux_dma_read_1D(ptr addrspace(3) %0, ptr addrspace(1) %1, i64 %2, ptr %3)
+; CHECK: entry:
+; CHECK: call spir_func i64 @__mux_get_local_id(i32 0)
+; CHECK: br i1 {{%.*}}, label %copy, label %exit
+; CHECK: copy:
+; CHECK-NEXT: call void @llvm.memcpy.p3.p1.i64(ptr addrspace(3) %0, ptr addrspace(1) %1, i64 %2, i1 false)
+; CHECK-NEXT: br label %exit
+; CHECK: exit:
+; CHECK-NEXT: ret ptr %3
+
+; Contiguous lines are copied with a single memcpy, otherwise each line is.
+; CHECK-LABEL: define ptr @__mux_dma_write_2D(ptr addrspace(1) %0, ptr addrspace(3) %1, i64 %2, i64 %3, i64 %4, i64 %5, ptr %6)
+; CHECK: copy:
+; CHECK: [[DST_CONTIG:%.*]] = icmp eq i64 %3, %2
+; CHECK: [[SRC_CONTIG:%.*]] = icmp eq i64 %4, %2
+; CHECK: [[BOTH:%.*]] = and i1 [[DST_CONTIG]], [[SRC_CONTIG]]
+; CHECK: [[NONE:%.*]] = icmp eq i64 %5, 0
+; CHECK: [[CONTIG:%.*]] = or i1 [[BOTH]], [[NONE]]
+; CHECK: br i1 [[CONTIG]], label %dma.contiguous, label %dma.lines
+; CHECK: dma.contiguous:
+; CHECK: [[BYTES:%.*]] = mul i64 %2, %5
+; CHECK: call void @llvm.memcpy.p1.p3.i64(ptr addrspace(1) %0, ptr addrspace(3) %1, i64 [[BYTES]], i1 false)
+; CHECK: dma.lines:
+; CHECK: loopIR:
+; CHECK: %dma.src = phi ptr addrspace(3) [ %1, %dma.lines ], [ [[NEXT_SRC:%.*]], %loopIR ]
+; CHECK: %dma.dst = phi ptr addrspace(1) [ %0, %dma.lines ], [ [[NEXT_DST:%.*]], %loopIR ]
+; CHECK: call void @llvm.memcpy.p1.p3.i64(ptr addrspace(1) %dma.dst, ptr addrspace(3) %dma.src, i64 %2, i1 false)
+; CHECK: [[NEXT_SRC]] = getelementptr i8, ptr addrspace(3) %dma.src, i64 %4
+; CHECK: [[NEXT_DST]] = getelementptr i8, ptr addrspace(1) %dma.dst, i64 %3
+
+; Planes are skipped entirely when there are none.
+; CHECK-LABEL: define ptr @__mux_dma_read_3D(ptr addrspace(3) %0, ptr addrspace(1) %1, i64 %2, i64 %3, i64 %4, i64 %5, i64 %6, i64 %7, i64 %8, ptr %9)
+; CHECK: copy:
+; CHECK: [[NO_PLANES:%.*]] = icmp eq i64 %8, 0
+; CHECK: br i1 [[NO_PLANES]], label %exit, label %dma.planes
+; CHECK: call void @llvm.memcpy.p3.p1.i64(
+; CHECK: ret ptr %9
+
+define ptr @read_1d(ptr addrspace(3) %dst, ptr addrspace(1) %src, i64 %width) {
+  %e = call ptr @__mux_dma_read_1D(ptr addrspace(3) %dst, ptr addrspace(1) %src, i64 %width, ptr null)
+  ret ptr %e
+}
+
+define ptr @write_2d(ptr addrspace(1) %dst, ptr addrspace(3) %src, i64 %width, i64 %dst_stride, i64 %src_stride, i64 %lines) {
+  %e = call ptr @__mux_dma_write_2D(ptr addrspace(1) %dst, ptr addrspace(3) %src, i64 %width, i64 %dst_stride, i64 %src_stride, i64 %lines, ptr null)
+  ret ptr %e
+}
+
+define ptr @read_3d(ptr addrspace(3) %dst, ptr addrspace(1) %src, i64 %width, i64 %dst_line_stride, i64 %src_line_stride, i64 %lines, i64 %dst_plane_stride, i64 %src_plane_stride, i64 %planes) {
+  %e = call ptr @__mux_dma_read_3D(ptr addrspace(3) %dst, ptr addrspace(1) %src, i64 %width, i64 %dst_line_stride, i64 %src_line_stride, i64 %lines, i64 %dst_plane_stride, i64 %src_plane_stride, i64 %planes, ptr null)
+  ret ptr %e
+}
+
+declare ptr @__mux_dma_read_1D(ptr addrspace(3), ptr addrspace(1), i64, ptr)
+declare ptr @__mux_dma_write_2D(ptr addrspace(1), ptr addrspace(3), i64, i64, i64, i64, ptr)
+declare ptr @__mux_dma_read_3D(ptr addrspace(3), ptr addrspace(1), i64, i64, i64, i64, i64, i64, i64, ptr)
@@ -0,0 +1,67 @@
+; Copyright (C) Codeplay Software Limited
+;
+; Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+; Exceptions; you may not use this file except in compliance with the License.
+; You may obtain a copy of the License at
+;
+;     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+;
+; Unless required by applicable law or agreed to in writing, software
+; distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+; WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+; License for the specific language governing permissions and limitations
+; under the License.
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; REQUIRES: codegen_x86_64
+; RUN: env CA_HOST_MASKED_TAIL=1 muxc --device "%x86_64_device" \
+; RUN:   --passes "print<vecz-pass-opts>" -S %s 2>&1 | FileCheck %s
+; RUN: muxc --device "%x86_64_device" --passes "print<vecz-pass-opts>" -S %s \
+; RUN:   2>&1 | FileCheck %s --check-prefix NO-TAIL
+
+target triple = "spir64-unknown-unknown"
+target datalayout = "e-p:64:64:64-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+; A local size which leaves a remainder gets a vector-predicated tail.
+; CHECK: Function 'odd' will be vectorized {
+; CHECK-NEXT:   VF = 8, (auto), vec-dim = 0, local-size = 12, choices = [
+; CHECK-NEXT:     DivisionExceptions
+; CHECK-NEXT:   ]
+; CHECK-NEXT:   VF = 8, vec-dim = 0, choices = [
+; CHECK-NEXT:     DivisionExceptions,VectorPredication
+; CHECK-NEXT:   ]
+; CHECK-NEXT: }
+; NO-TAIL: Function 'odd' will be vectorized {
+; NO-TAIL-NEXT:   VF = 8, (auto), vec-dim = 0, local-size = 12, choices = [
+; NO-TAIL-NEXT:     DivisionExceptions
+; NO-TAIL-NEXT:   ]
+; NO-TAIL-NEXT: }
+define spir_kernel void @odd(ptr addrspace(1) %in) #0 !reqd_work_group_size !0 {
+  %gid = call i64 @__mux_get_global_id(i32 0)
+  %addr = getelementptr i32, ptr addrspace(1) %in, i64 %gid
+  %x = load i32, ptr addrspace(1) %addr
+  store i32 %x, ptr addrspace(1) %addr
+  ret void
+}
+
+; A local size which is a multiple of the width needs no tail at all.
+; CHECK: Function 'even' will be vectorized {
+; CHECK-NEXT:   VF = 16, (auto), vec-dim = 0, local-size = 16, choices = [
+; CHECK-NEXT:     DivisionExceptions
+; CHECK-NEXT:   ]
+; CHECK-NEXT: }
+define spir_kernel void @even(ptr addrspace(1) %in) #0 !reqd_work_group_size !1 {
+  %gid = call i64 @__mux_get_global_id(i32 0)
+  %addr = getelementptr i32, ptr addrspace(1) %in, i64 %gid
+  %x = load i32, ptr addrspace(1) %addr
+  store i32 %x, ptr addrspace(1) %addr
+  ret void
+}
+
+declare i64 @__mux_get_global_id(i32)
+
+attributes #0 = { "mux-kernel"="entry-point" "vecz-mode"="auto" }
+
+!0 = !{ i32 12, i32 1, i32 1 }
+!1 = !{ i32 16, i32 1, i32 1 }
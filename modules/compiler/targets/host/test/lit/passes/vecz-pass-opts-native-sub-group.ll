@@ -0,0 +1,83 @@
+; Copyright (C) Codeplay Software Limited
+;
+; Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+; Exceptions; you may not use this file except in compliance with the License.
+; You may obtain a copy of the License at
+;
+;     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+;
+; Unless required by applicable law or agreed to in writing, software
+; distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+; WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+; License for the specific language governing permissions and limitations
+; under the License.
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; REQUIRES: codegen_x86_64
+; RUN: muxc --device "%x86_64_device" --passes "print<vecz-pass-opts>" -S %s \
+; RUN:   2>&1 | FileCheck %s
+
+; Kernels using sub-groups are vectorized to the largest sub-group size which
+; fits their widest element type into a native vector register, 256 bits for
+; the x86_64 device's default CPU.
+
+target triple = "spir64-unknown-unknown"
+target datalayout = "e-p:64:64:64-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+; CHECK: Function 'sg_i32' will be vectorized {
+; CHECK-NEXT:   VF = 8, vec-dim = 0, choices = [
+; CHECK-NEXT:     DivisionExceptions
+; CHECK-NEXT:   ]
+; CHECK-NEXT: }
+define spir_kernel void @sg_i32(ptr addrspace(1) %in, ptr addrspace(1) %out) #0 {
+  %gid = call i64 @__mux_get_global_id(i32 0)
+  %lid = call i32 @__mux_get_sub_group_local_id()
+  %in.ptr = getelementptr inbounds i32, ptr addrspace(1) %in, i64 %gid
+  %x = load i32, ptr addrspace(1) %in.ptr, align 4
+  %add = add i32 %x, %lid
+  %out.ptr = getelementptr inbounds i32, ptr addrspace(1) %out, i64 %gid
+  store i32 %add, ptr addrspace(1) %out.ptr, align 4
+  ret void
+}
+
+; CHECK: Function 'sg_i64' will be vectorized {
+; CHECK-NEXT:   VF = 4, vec-dim = 0, choices = [
+; CHECK-NEXT:     DivisionExceptions
+; CHECK-NEXT:   ]
+; CHECK-NEXT: }
+define spir_kernel void @sg_i64(ptr addrspace(1) %in, ptr addrspace(1) %out) #0 {
+  %gid = call i64 @__mux_get_global_id(i32 0)
+  %lid = call i32 @__mux_get_sub_group_local_id()
+  %in.ptr = getelementptr inbounds i64, ptr addrspace(1) %in, i64 %gid
+  %x = load i64, ptr addrspace(1) %in.ptr, align 8
+  %lid.ext = zext i32 %lid to i64
+  %add = add i64 %x, %lid.ext
+  %out.ptr = getelementptr inbounds i64, ptr addrspace(1) %out, i64 %gid
+  store i64 %add, ptr addrspace(1) %out.ptr, align 8
+  ret void
+}
+
+; A known local size caps the sub-group size.
+; CHECK: Function 'sg_local_size' will be vectorized {
+; CHECK-NEXT:   VF = 4, vec-dim = 0, local-size = 4, choices = [
+; CHECK-NEXT:     DivisionExceptions
+; CHECK-NEXT:   ]
+; CHECK-NEXT: }
+define spir_kernel void @sg_local_size(ptr addrspace(1) %in, ptr addrspace(1) %out) #0 !reqd_work_group_size !0 {
+  %gid = call i64 @__mux_get_global_id(i32 0)
+  %lid = call i32 @__mux_get_sub_group_local_id()
+  %in.ptr = getelementptr inbounds i32, ptr addrspace(1) %in, i64 %gid
+  %x = load i32, ptr addrspace(1) %in.ptr, align 4
+  %add = add i32 %x, %lid
+  %out.ptr = getelementptr inbounds i32, ptr addrspace(1) %out, i64 %gid
+  store i32 %add, ptr addrspace(1) %out.ptr, align 4
+  ret void
+}
+
+declare i64 @__mux_get_global_id(i32)
+declare i32 @__mux_get_sub_group_local_id()
+
+attributes #0 = { "mux-kernel"="entry-point" "vecz-mode"="auto" }
+
+!0 = !{ i32 4, i32 1, i32 1 }
@@ -0,0 +1,119 @@
+; Copyright (C) Codeplay Software Limited
+;
+; Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+; Exceptions; you may not use this file except in compliance with the License.
+; You may obtain a copy of the License at
+;
+;     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+;
+; Unless required by applicable law or agreed to in writing, software
+; distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+; WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+; License for the specific language governing permissions and limitations
+; under the License.
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: muxc --device "%default_device" --passes work-group-arena,verify -S %s | FileCheck %s
+
+target triple = "x86_64-unknown-unknown"
+target datalayout = "e-p:64:64:64-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+; The arena size the kernel needs is reported ahead of its first run: the
+; fixed-size allocations, alignment padding for variable-sized allocations, and
+; the barrier live variables per work-item.
+; CHECK: @kernel.arena-size = constant [2 x i64] [i64 2176, i64 48]
+; CHECK-NOT: @not_kernel.arena-size
+
+; Small allocations stay on the stack.
+; CHECK-LABEL: define void @kernel(ptr %packed-args, ptr %sched-info)
+; CHECK: %arena.cursor = alloca i64
+; CHECK: %small = alloca [4 x i32], align 16
+; CHECK-NOT: alloca [512 x i32]
+
+; CHECK: [[ARENA_GEP:%.*]] = getelementptr inbounds %Mux_schedule_info_s, ptr %sched-info, i32 0, i32 6
+; CHECK: %arena = load ptr, ptr [[ARENA_GEP]]
+; CHECK: [[SIZE_GEP:%.*]] = getelementptr inbounds %Mux_schedule_info_s, ptr %sched-info, i32 0, i32 7
+; CHECK: %arena.size = load i64, ptr [[SIZE_GEP]]
+; CHECK: [[REQ:%.*]] = getelementptr inbounds %Mux_schedule_info_s, ptr %sched-info, i32 0, i32 8
+
+; Large fixed-size allocations go at the start of the arena.
+; CHECK: [[FITS:%.*]] = icmp ule i64 2048, %arena.size
+; CHECK: [[FB_SIZE:%.*]] = select i1 [[FITS]], i64 0, i64 2048
+; CHECK: %arena.fallback = alloca i8, i64 [[FB_SIZE]], align 16
+; CHECK: [[BASE:%.*]] = select i1 [[FITS]], ptr %arena, ptr %arena.fallback
+; CHECK: %big = getelementptr inbounds i8, ptr [[BASE]], i64 0
+; CHECK: store i64 2048, ptr [[REQ]]
+; CHECK: store i64 2048, ptr %arena.cursor
+; CHECK: [[ARENA_ADDR:%.*]] = ptrtoint ptr %arena to i64
+
+; Variable-sized allocations are bumped from the cursor, which is reset when
+; the stack is restored.
+; CHECK: loop:
+; CHECK: %sp = call ptr @llvm.stacksave{{.*}}()
+; CHECK: %arena.saved = load i64, ptr %arena.cursor
+; CHECK: [[BYTES:%.*]] = mul i64 %n, 4
+; CHECK: %arena.cur = load i64, ptr %arena.cursor
+; CHECK: [[ADDR:%.*]] = add i64 [[ARENA_ADDR]], %arena.cur
+; CHECK: [[T:%.*]] = add i64 [[ADDR]], 127
+; CHECK: [[ALIGNED:%.*]] = and i64 [[T]], -128
+; CHECK: [[BEGIN:%.*]] = sub i64 [[ALIGNED]], [[ARENA_ADDR]]
+; CHECK: [[END:%.*]] = add i64 [[BEGIN]], [[BYTES]]
+; CHECK: store i64 [[END]], ptr %arena.cursor
+; CHECK: [[OLD_REQ:%.*]] = load i64, ptr [[REQ]]
+; CHECK: [[NEW_REQ:%.*]] = call i64 @llvm.umax.i64(i64 [[OLD_REQ]], i64 [[END]])
+; CHECK: store i64 [[NEW_REQ]], ptr [[REQ]]
+; CHECK: [[DYN_FITS:%.*]] = icmp ule i64 [[END]], %arena.size
+; CHECK: [[DYN_FB_SIZE:%.*]] = select i1 [[DYN_FITS]], i64 0, i64 [[BYTES]]
+; CHECK: [[DYN_FB:%.*]] = alloca i8, i64 [[DYN_FB_SIZE]], align 128
+; CHECK: [[IN_ARENA:%.*]] = getelementptr inbounds i8, ptr %arena, i64 [[BEGIN]]
+; CHECK: %dyn = select i1 [[DYN_FITS]], ptr [[IN_ARENA]], ptr [[DYN_FB]]
+; CHECK: call void @use(ptr %dyn)
+; CHECK: store i64 %arena.saved, ptr %arena.cursor
+; CHECK: call void @llvm.stackrestore{{.*}}(ptr %sp)
+define void @kernel(ptr %packed-args, ptr %sched-info) #0 !mux_scheduled_fn !1 {
+entry:
+  %big = alloca [512 x i32], align 16
+  %small = alloca [4 x i32], align 16
+  %n = load i64, ptr %packed-args, align 8
+  call void @llvm.lifetime.start.p0(i64 2048, ptr %big)
+  call void @use(ptr %big)
+  call void @use(ptr %small)
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %sp = call ptr @llvm.stacksave()
+  %dyn = alloca float, i64 %n, align 128
+  call void @use(ptr %dyn)
+  call void @llvm.stackrestore(ptr %sp)
+  %i.next = add i64 %i, 1
+  %done = icmp eq i64 %i.next, 8
+  br i1 %done, label %exit, label %loop
+
+exit:
+  call void @llvm.lifetime.end.p0(i64 2048, ptr %big)
+  ret void
+}
+
+; Functions which aren't kernel entry points are left alone.
+; CHECK-LABEL: define void @not_kernel(
+; CHECK: %big = alloca [512 x i32], align 16
+define void @not_kernel(ptr %sched-info) {
+  %big = alloca [512 x i32], align 16
+  call void @use(ptr %big)
+  ret void
+}
+
+declare void @use(ptr)
+declare ptr @llvm.stacksave()
+declare void @llvm.stackrestore(ptr)
+declare void @llvm.lifetime.start.p0(i64, ptr)
+declare void @llvm.lifetime.end.p0(i64, ptr)
+
+attributes #0 = { "mux-kernel"="entry-point" "mux-barrier-live-vars-size"="48" }
+
+!mux-scheduling-params = !{!0}
+
+!0 = !{!"MuxWorkItemInfo", !"Mux_schedule_info_s", !"MiniWGInfo"}
+!1 = !{i32 -1, i32 1, i32 -1}
@@ -0,0 +1,63 @@
+; Copyright (C) Codeplay Software Limited
+;
+; Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+; Exceptions; you may not use this file except in compliance with the License.
+; You may obtain a copy of the License at
+;
+;     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+;
+; Unless required by applicable law or agreed to in writing, software
+; distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+; WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+; License for the specific language governing permissions and limitations
+; under the License.
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; Check the metadata RiscvKernel specializes a kernel with: the local size it
+; is enqueued with, and the number of dimensions that local size spans.
+
+; RUN: muxc --device "%riscv_device" --passes "encode-kernel-metadata<name=foo;local-sizes=8:1:1>,specialize-max-work-dim,verify" -S %s \
+; RUN:   | FileCheck %s --check-prefix DIM1
+; RUN: muxc --device "%riscv_device" --passes "encode-kernel-metadata<name=foo;local-sizes=8:4:1>,specialize-max-work-dim,verify" -S %s \
+; RUN:   | FileCheck %s --check-prefix DIM2
+; RUN: muxc --device "%riscv_device" --passes "encode-kernel-metadata<name=foo;local-sizes=1:1:2>,specialize-max-work-dim,verify" -S %s \
+; RUN:   | FileCheck %s --check-prefix DIM3
+; RUN: muxc --device "%riscv_device" --passes "encode-kernel-metadata<name=bar;local-sizes=8:4:2>,specialize-max-work-dim,verify" -S %s \
+; RUN:   | FileCheck %s --check-prefix NARROW
+
+target triple = "riscv64-unknown-unknown-elf"
+target datalayout = "e-m:e-p:64:64-i64:64-i128:128-n64-S128"
+
+; DIM1: define spir_kernel void @foo()
+; DIM1-DAG: !reqd_work_group_size [[LOCAL_SIZE:![0-9]+]]
+; DIM1-DAG: !max_work_dim [[MAX_WORK_DIM:![0-9]+]]
+; DIM1-DAG: [[LOCAL_SIZE]] = !{i32 8, i32 1, i32 1}
+; DIM1-DAG: [[MAX_WORK_DIM]] = !{i32 1}
+
+; DIM2: define spir_kernel void @foo()
+; DIM2-DAG: !reqd_work_group_size [[LOCAL_SIZE:![0-9]+]]
+; DIM2-DAG: !max_work_dim [[MAX_WORK_DIM:![0-9]+]]
+; DIM2-DAG: [[LOCAL_SIZE]] = !{i32 8, i32 4, i32 1}
+; DIM2-DAG: [[MAX_WORK_DIM]] = !{i32 2}
+
+; DIM3: define spir_kernel void @foo()
+; DIM3-DAG: !reqd_work_group_size [[LOCAL_SIZE:![0-9]+]]
+; DIM3-DAG: !max_work_dim [[MAX_WORK_DIM:![0-9]+]]
+; DIM3-DAG: [[LOCAL_SIZE]] = !{i32 1, i32 1, i32 2}
+; DIM3-DAG: [[MAX_WORK_DIM]] = !{i32 3}
+define spir_kernel void @foo() {
+  ret void
+}
+
+; A narrower maximum work dimension from the source is kept.
+; NARROW: define spir_kernel void @bar()
+; NARROW-DAG: !reqd_work_group_size [[LOCAL_SIZE:![0-9]+]]
+; NARROW-DAG: !max_work_dim [[MAX_WORK_DIM:![0-9]+]]
+; NARROW-DAG: [[LOCAL_SIZE]] = !{i32 8, i32 4, i32 2}
+; NARROW-DAG: [[MAX_WORK_DIM]] = !{i32 1}
+define spir_kernel void @bar() !max_work_dim !0 {
+  ret void
+}
+
+!0 = !{i32 1}
@@ -0,0 +1,100 @@
+; Copyright (C) Codeplay Software Limited
+;
+; Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+; Exceptions; you may not use this file except in compliance with the License.
+; You may obtain a copy of the License at
+;
+;     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+;
+; Unless required by applicable law or agreed to in writing, software
+; distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+; WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+; License for the specific language governing permissions and limitations
+; under the License.
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; Without CA_RISCV_VF the cost model picks the options, check that the local
+; size picks between a vector kernel, a vector-predicated kernel, or both.
+
+; REQUIRES: riscv_rvv
+; RUN: muxc --device "%riscv_device" --passes "print<vecz-pass-opts>" -S %s 2>&1 \
+; RUN:   | FileCheck %s
+
+target datalayout = "e-m:e-p:64:64-i64:64-i128:128-n64-S128"
+target triple = "riscv64-unknown-unknown-elf"
+
+; A local size which is a multiple of the width needs no tail.
+; CHECK:      Function 'multiple' will be vectorized {
+; CHECK-NEXT:   VF = [[VF:[0-9]+]], vec-dim = 0, local-size = 1024, choices = [
+; CHECK-NEXT:     DivisionExceptions
+; CHECK-NEXT:   ]
+; CHECK-NEXT: }
+define spir_kernel void @multiple(ptr addrspace(1) %a, ptr addrspace(1) %z) #0 !reqd_work_group_size !0 {
+entry:
+  %call = tail call i64 @__mux_get_global_id(i32 0)
+  %arrayidx = getelementptr inbounds i32, ptr addrspace(1) %a, i64 %call
+  %x = load i32, ptr addrspace(1) %arrayidx, align 4
+  %add = add nsw i32 %x, 4
+  %arrayidx1 = getelementptr inbounds i32, ptr addrspace(1) %z, i64 %call
+  store i32 %add, ptr addrspace(1) %arrayidx1, align 4
+  ret void
+}
+
+; A local size smaller than the width is covered by one predicated kernel.
+; CHECK:      Function 'narrow' will be vectorized {
+; CHECK-NEXT:   VF = [[VF]], vec-dim = 0, choices = [
+; CHECK-NEXT:     DivisionExceptions,VectorPredication
+; CHECK-NEXT:   ]
+; CHECK-NEXT: }
+define spir_kernel void @narrow(ptr addrspace(1) %a, ptr addrspace(1) %z) #0 !reqd_work_group_size !1 {
+entry:
+  %call = tail call i64 @__mux_get_global_id(i32 0)
+  %arrayidx = getelementptr inbounds i32, ptr addrspace(1) %a, i64 %call
+  %x = load i32, ptr addrspace(1) %arrayidx, align 4
+  %add = add nsw i32 %x, 4
+  %arrayidx1 = getelementptr inbounds i32, ptr addrspace(1) %z, i64 %call
+  store i32 %add, ptr addrspace(1) %arrayidx1, align 4
+  ret void
+}
+
+; An unknown local size gets a vector kernel with a predicated tail.
+; CHECK:      Function 'unknown' will be vectorized {
+; CHECK-NEXT:   VF = [[VF]], vec-dim = 0, choices = [
+; CHECK-NEXT:     DivisionExceptions
+; CHECK-NEXT:   ]
+; CHECK-NEXT:   VF = [[VF]], vec-dim = 0, choices = [
+; CHECK-NEXT:     DivisionExceptions,VectorPredication
+; CHECK-NEXT:   ]
+; CHECK-NEXT: }
+define spir_kernel void @unknown(ptr addrspace(1) %a, ptr addrspace(1) %z) #0 {
+entry:
+  %call = tail call i64 @__mux_get_global_id(i32 0)
+  %arrayidx = getelementptr inbounds i32, ptr addrspace(1) %a, i64 %call
+  %x = load i32, ptr addrspace(1) %arrayidx, align 4
+  %add = add nsw i32 %x, 4
+  %arrayidx1 = getelementptr inbounds i32, ptr addrspace(1) %z, i64 %call
+  store i32 %add, ptr addrspace(1) %arrayidx1, align 4
+  ret void
+}
+
+; A work-group of one work-item isn't worth vectorizing.
+; CHECK: Function 'single' will not be vectorized
+define spir_kernel void @single(ptr addrspace(1) %a, ptr addrspace(1) %z) #0 !reqd_work_group_size !2 {
+entry:
+  %call = tail call i64 @__mux_get_global_id(i32 0)
+  %arrayidx = getelementptr inbounds i32, ptr addrspace(1) %a, i64 %call
+  %x = load i32, ptr addrspace(1) %arrayidx, align 4
+  %add = add nsw i32 %x, 4
+  %arrayidx1 = getelementptr inbounds i32, ptr addrspace(1) %z, i64 %call
+  store i32 %add, ptr addrspace(1) %arrayidx1, align 4
+  ret void
+}
+
+declare i64 @__mux_get_global_id(i32)
+
+attributes #0 = { "mux-kernel"="entry-point" }
+
+!0 = !{i32 1024, i32 1, i32 1}
+!1 = !{i32 2, i32 1, i32 1}
+!2 = !{i32 1, i32 1, i32 1}
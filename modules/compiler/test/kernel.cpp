@@ -103,6 +103,19 @@ TEST_P(PrecacheLocalSizeTest, PrecacheLocalSizeInvalidZ) {
             kernel->precacheLocalSize(1, 1, 0));
 }
 
+TEST_P(PrecacheLocalSizeTest, PrecacheLocalSizeCached) {
+  // Precaching a local size which was already used must not change the work
+  // width reported for it.
+  const size_t max_local_size_x = device->info->max_work_group_size_x;
+  auto work_width = kernel->getDynamicWorkWidth(max_local_size_x, 1, 1);
+  ASSERT_TRUE(work_width);
+  ASSERT_EQ(compiler::Result::SUCCESS,
+            kernel->precacheLocalSize(max_local_size_x, 1, 1));
+  auto work_width_again = kernel->getDynamicWorkWidth(max_local_size_x, 1, 1);
+  ASSERT_TRUE(work_width_again);
+  EXPECT_EQ(*work_width, *work_width_again);
+}
+
 INSTANTIATE_DEFERRABLE_COMPILER_TARGET_TEST_SUITE_P(PrecacheLocalSizeTest);
 
 /// @brief Test fixture for testing behvaiour of the
@@ -342,6 +355,46 @@ TEST_P(CreateSpecializedKernelTest,
   EXPECT_EQ(compiler::Result::INVALID_VALUE, specialized_kernel.error());
 }
 
+TEST_P(CreateSpecializedKernelTest, CreateSpecializedKernelCached) {
+  // Specializing a kernel for a local size it was already specialized for
+  // must give the same binary, also once it has been specialized for other
+  // local sizes in between.
+  auto specialize = [&](size_t local_size_x) {
+    mux_ndrange_options_t nd_range_options{};
+    nd_range_options.descriptors = nullptr;
+    nd_range_options.descriptors_length = 0;
+    size_t local_size[]{local_size_x, 1, 1};
+    std::memcpy(nd_range_options.local_size, local_size, sizeof(local_size));
+    const size_t global_offset = 0;
+    nd_range_options.global_offset = &global_offset;
+    const size_t global_size = local_size_x;
+    nd_range_options.global_size = &global_size;
+    nd_range_options.dimensions = 1;
+    return kernel->createSpecializedKernel(nd_range_options);
+  };
+  auto isSameBinary = [](const cargo::dynamic_array<uint8_t> &lhs,
+                         const cargo::dynamic_array<uint8_t> &rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  };
+
+  const size_t max_local_size_x = device->info->max_work_group_size_x;
+
+  auto unit = specialize(1);
+  ASSERT_TRUE(unit);
+  auto unit_again = specialize(1);
+  ASSERT_TRUE(unit_again);
+  EXPECT_TRUE(isSameBinary(*unit, *unit_again));
+
+  auto max = specialize(max_local_size_x);
+  ASSERT_TRUE(max);
+  auto unit_after_max = specialize(1);
+  ASSERT_TRUE(unit_after_max);
+  EXPECT_TRUE(isSameBinary(*unit, *unit_after_max));
+  auto max_again = specialize(max_local_size_x);
+  ASSERT_TRUE(max_again);
+  EXPECT_TRUE(isSameBinary(*max, *max_again));
+}
+
 INSTANTIATE_DEFERRABLE_COMPILER_TARGET_TEST_SUITE_P(
     CreateSpecializedKernelTest);
 
@@ -0,0 +1,66 @@
+; Copyright (C) Codeplay Software Limited
+;
+; Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+; Exceptions; you may not use this file except in compliance with the License.
+; You may obtain a copy of the License at
+;
+;     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+;
+; Unless required by applicable law or agreed to in writing, software
+; distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+; WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+; License for the specific language governing permissions and limitations
+; under the License.
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: muxc --passes "work-item-loops<soa>,verify" < %s | FileCheck %s
+
+target triple = "spir64-unknown-unknown"
+target datalayout = "e-i64:64-v16:16-v24:32-v32:32-v48:64-v96:128-v192:256-v256:256-v512:512-v1024:1024"
+
+; Check that each live variable is stored in its own array, indexed by the
+; work-item: %d (8 bytes per work-item) comes first, followed by %a (4 bytes
+; per work-item) once %d's array is past.
+
+; CHECK: define internal i32 @soa.mux-barrier-region(ptr addrspace(1) %0, ptr addrspace(1) %1, ptr %2, i64 %3, i64 %4)
+; CHECK: [[A_ARRAY_OFFSET:%.*]] = mul i64 %4, 8
+; CHECK: [[A_ARRAY:%.*]] = getelementptr inbounds i8, ptr %2, i64 [[A_ARRAY_OFFSET]]
+; CHECK: [[A_OFFSET:%.*]] = mul i64 %3, 4
+; CHECK: %live_gep_a = getelementptr inbounds i8, ptr [[A_ARRAY]], i64 [[A_OFFSET]]
+; CHECK: [[D_OFFSET:%.*]] = mul i64 %3, 8
+; CHECK: %live_gep_d = getelementptr inbounds i8, ptr %2, i64 [[D_OFFSET]]
+; CHECK: store i32 %a, ptr %live_gep_a
+; CHECK: store double %d, ptr %live_gep_d
+; CHECK: ret i32
+
+; CHECK: define internal i32 @soa.mux-barrier-region.1(ptr addrspace(1) %0, ptr addrspace(1) %1, ptr %2, i64 %3, i64 %4)
+; CHECK-DAG: %a_load = load i32, ptr %live_gep_a
+; CHECK-DAG: %d_load = load double, ptr %live_gep_d
+; CHECK: ret i32
+
+; The wrapper allocates 16 bytes per work-item, which it records in its
+; attributes, and passes each subkernel the work-item's index and the number of
+; work-items.
+; CHECK: define void @soa.mux-barrier-wrapper({{.*}}) [[WRAPPER_ATTRS:#[0-9]+]]
+; CHECK: %live_variables = alloca i8, i64 [[SIZE:%.*]], align 8
+; CHECK: call i32 @soa.mux-barrier-region(ptr addrspace(1) %input, ptr addrspace(1) %output, ptr %live_variables, i64 {{%.*}}, i64 [[COUNT:%.*]])
+; CHECK: call i32 @soa.mux-barrier-region.1(ptr addrspace(1) %input, ptr addrspace(1) %output, ptr %live_variables, i64 {{%.*}}, i64 [[COUNT]])
+
+define void @soa(ptr addrspace(1) %input, ptr addrspace(1) %output) #0 {
+entry:
+  %a = load i32, ptr addrspace(1) %input, align 4
+  %d.addr = getelementptr inbounds i8, ptr addrspace(1) %input, i64 8
+  %d = load double, ptr addrspace(1) %d.addr, align 8
+  call void @__mux_work_group_barrier(i32 0, i32 1, i32 272)
+  %dt = fptosi double %d to i32
+  %res = add i32 %a, %dt
+  store i32 %res, ptr addrspace(1) %output, align 4
+  ret void
+}
+
+declare void @__mux_work_group_barrier(i32, i32, i32)
+
+; CHECK: attributes [[WRAPPER_ATTRS]] = { {{.*}}"mux-barrier-live-vars-size"="16"{{.*}} }
+
+attributes #0 = { norecurse nounwind "mux-kernel"="entry-point" }
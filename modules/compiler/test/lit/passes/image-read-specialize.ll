@@ -0,0 +1,101 @@
+; Copyright (C) Codeplay Software Limited
+;
+; Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+; Exceptions; you may not use this file except in compliance with the License.
+; You may obtain a copy of the License at
+;
+;     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+;
+; Unless required by applicable law or agreed to in writing, software
+; distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+; WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+; License for the specific language governing permissions and limitations
+; under the License.
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: muxc --passes image-read-specialize,verify -S %s | FileCheck %s
+
+target triple = "spir64-unknown-unknown"
+target datalayout = "e-p:64:64:64-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+; A constant sampler is folded into a clone of the read function.
+; CHECK-LABEL: define spir_kernel void @const_sampler(
+; CHECK: call <4 x float> @_Z25__Codeplay_read_imagef_2dP5ImagejDv2_f.s20(ptr %img, i32 %s.trunc, <2 x float> %coord)
+define spir_kernel void @const_sampler(ptr %img, <2 x float> %coord, ptr %out) {
+  %s = call i64 @__translate_sampler_initializer(i32 20)
+  %s.trunc = trunc i64 %s to i32
+  %v = call <4 x float> @_Z25__Codeplay_read_imagef_2dP5ImagejDv2_f(ptr %img, i32 %s.trunc, <2 x float> %coord)
+  store <4 x float> %v, ptr %out
+  ret void
+}
+
+; Samplers and image formats described by metadata are folded in too.
+; CHECK-LABEL: define spir_kernel void @known_args(
+; CHECK: call <4 x float> @_Z25__Codeplay_read_imagef_2dP5ImagejDv2_f.s36.f4277_4318(ptr %img, i32 %s.trunc, <2 x float> %coord)
+define spir_kernel void @known_args(ptr %img, i64 %s, <2 x float> %coord, ptr %out) !mux_image_spec !0 {
+  %s.trunc = trunc i64 %s to i32
+  %v = call <4 x float> @_Z25__Codeplay_read_imagef_2dP5ImagejDv2_f(ptr %img, i32 %s.trunc, <2 x float> %coord)
+  store <4 x float> %v, ptr %out
+  ret void
+}
+
+; Unknown samplers leave the call alone.
+; CHECK-LABEL: define spir_kernel void @unknown_sampler(
+; CHECK: call <4 x float> @_Z25__Codeplay_read_imagef_2dP5ImagejDv2_f(ptr %img, i32 %s.trunc, <2 x float> %coord)
+define spir_kernel void @unknown_sampler(ptr %img, i64 %s, <2 x float> %coord, ptr %out) {
+  %s.trunc = trunc i64 %s to i32
+  %v = call <4 x float> @_Z25__Codeplay_read_imagef_2dP5ImagejDv2_f(ptr %img, i32 %s.trunc, <2 x float> %coord)
+  store <4 x float> %v, ptr %out
+  ret void
+}
+
+; The original is left untouched.
+; CHECK: define <4 x float> @_Z25__Codeplay_read_imagef_2dP5ImagejDv2_f(
+; CHECK: switch i32 %mode
+
+; CLK_ADDRESS_CLAMP | CLK_FILTER_NEAREST: only the clamp path remains, but the
+; channel type is still read from the image.
+; CHECK: define internal <4 x float> @_Z25__Codeplay_read_imagef_2dP5ImagejDv2_f.s20(
+; CHECK-NOT: switch
+; CHECK: %type = load i32, ptr %type.addr
+; CHECK-NOT: load i32
+; CHECK: ret <4 x float> %res
+; CHECK-NEXT: }
+
+; CLK_ADDRESS_CLAMP | CLK_FILTER_LINEAR on a CL_RGBA/CL_FLOAT image: the
+; channel loads fold away.
+; CHECK: define internal <4 x float> @_Z25__Codeplay_read_imagef_2dP5ImagejDv2_f.s36.f4277_4318(
+; CHECK-NOT: switch
+; CHECK-NOT: load i32
+; CHECK: ret <4 x float> <float 4.000000e+00, float 4.318000e+03, float 0.000000e+00, float 0.000000e+00>
+; CHECK-NEXT: }
+
+define <4 x float> @_Z25__Codeplay_read_imagef_2dP5ImagejDv2_f(ptr %image, i32 %sampler, <2 x float> %coord) {
+entry:
+  %mode = and i32 %sampler, 14
+  switch i32 %mode, label %other [
+    i32 4, label %clamp
+  ]
+
+clamp:
+  %type.addr = getelementptr inbounds i8, ptr %image, i64 4
+  %type = load i32, ptr %type.addr
+  %type.f = uitofp i32 %type to float
+  %r = insertelement <4 x float> <float 4.0, float 0.0, float 0.0, float 0.0>, float %type.f, i32 1
+  %is.float = icmp eq i32 %type, 4318
+  %res = select i1 %is.float, <4 x float> %r, <4 x float> <float 4.0, float 0.0, float 0.0, float 0.0>
+  ret <4 x float> %res
+
+other:
+  %order = load i32, ptr %image
+  %order.f = uitofp i32 %order to float
+  %o = insertelement <4 x float> zeroinitializer, float %order.f, i32 0
+  ret <4 x float> %o
+}
+
+declare i64 @__translate_sampler_initializer(i32)
+
+!0 = !{!1, !2}
+!1 = !{i32 1, i32 36}
+!2 = !{i32 0, i32 4277, i32 4318}
@@ -0,0 +1,209 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <compiler/utils/lld_linker.h>
+#include <gtest/gtest.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/Twine.h>
+#include <llvm/ObjectYAML/yaml2obj.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/YAMLTraits.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+/// @brief Number of binaries the link cache holds, see lld_linker.cpp.
+constexpr unsigned LinkCacheCapacity = 64;
+
+constexpr const char *LinkerScript = R"(
+SECTIONS {
+  . = 0x10000;
+  .text : { *(.text) }
+}
+)";
+
+/// @brief Fixture linking small RISC-V objects through the link cache.
+///
+/// Each link asks lld to write a map file, so whether lld was invoked, rather
+/// than the binary being returned from the cache, is observed by whether the
+/// map file was written.
+class LldLinkerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // The map file path is part of every link's arguments, so each test
+    // starts with nothing of its own in the cache.
+    ASSERT_FALSE(
+        llvm::sys::fs::createTemporaryFile("lld_linker_test", "map", MapFile));
+    ASSERT_FALSE(llvm::sys::fs::remove(MapFile));
+    LinkArgs.push_back(("--Map=" + MapFile).str());
+  }
+
+  void TearDown() override { (void)llvm::sys::fs::remove(MapFile); }
+
+  /// @brief Assemble an object whose only instruction is `addi x0, x0, imm`.
+  static std::vector<uint8_t> makeObject(uint32_t imm) {
+    const uint32_t insn = (imm << 20) | 0x13;
+    std::string content;
+    llvm::raw_string_ostream contentOS(content);
+    for (unsigned i = 0; i != 4; i++) {
+      contentOS << llvm::format_hex_no_prefix((insn >> (i * 8)) & 0xff, 2);
+    }
+    const std::string yaml = (llvm::Twine(R"(
+--- !ELF
+FileHeader:
+  Class:   ELFCLASS64
+  Data:    ELFDATA2LSB
+  Type:    ET_REL
+  Machine: EM_RISCV
+Sections:
+  - Name:         .text
+    Type:         SHT_PROGBITS
+    Flags:        [ SHF_ALLOC, SHF_EXECINSTR ]
+    AddressAlign: 0x4
+    Content:      ")") + contentOS.str() + R"("
+Symbols:
+  - Name:    _start
+    Type:    STT_FUNC
+    Section: .text
+    Binding: STB_GLOBAL
+)")
+                                 .str();
+    llvm::SmallString<0> object;
+    llvm::raw_svector_ostream objectOS(object);
+    llvm::yaml::Input input(yaml);
+    const bool converted =
+        llvm::yaml::convertYAML(input, objectOS, [](const llvm::Twine &msg) {
+          ADD_FAILURE() << msg.str();
+        });
+    EXPECT_TRUE(converted);
+    return std::vector<uint8_t>(object.begin(), object.end());
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> link(
+      const std::vector<uint8_t> &object,
+      const std::string &script = LinkerScript) {
+    return link(object, script, LinkArgs);
+  }
+
+  static std::unique_ptr<llvm::MemoryBuffer> link(
+      const std::vector<uint8_t> &object, const std::string &script,
+      const llvm::SmallVectorImpl<std::string> &args) {
+    auto binary =
+        compiler::utils::lldLinkToBinary(object, script, nullptr, 0, args);
+    if (!binary) {
+      ADD_FAILURE() << llvm::toString(binary.takeError());
+      return nullptr;
+    }
+    return std::move(*binary);
+  }
+
+  /// @brief Check whether lld was invoked since the last call.
+  bool linkedWithLld() {
+    if (!llvm::sys::fs::exists(MapFile)) {
+      return false;
+    }
+    EXPECT_FALSE(llvm::sys::fs::remove(MapFile));
+    return true;
+  }
+
+  llvm::SmallString<128> MapFile;
+  llvm::SmallVector<std::string, 1> LinkArgs;
+};
+}  // namespace
+
+TEST_F(LldLinkerTest, LinkSameObjectTwice) {
+  const auto object = makeObject(1);
+
+  auto first = link(object);
+  ASSERT_TRUE(first);
+  EXPECT_TRUE(linkedWithLld());
+  EXPECT_FALSE(first->getBuffer().empty());
+
+  auto second = link(object);
+  ASSERT_TRUE(second);
+  EXPECT_FALSE(linkedWithLld());
+  EXPECT_EQ(first->getBuffer(), second->getBuffer());
+  // The cache hands out its own copy of the binary each time.
+  EXPECT_NE(first->getBufferStart(), second->getBufferStart());
+}
+
+TEST_F(LldLinkerTest, LinkDifferentInputs) {
+  const auto object = makeObject(1);
+  auto binary = link(object);
+  ASSERT_TRUE(binary);
+  EXPECT_TRUE(linkedWithLld());
+
+  // A different object.
+  auto otherObject = link(makeObject(2));
+  ASSERT_TRUE(otherObject);
+  EXPECT_TRUE(linkedWithLld());
+  EXPECT_NE(binary->getBuffer(), otherObject->getBuffer());
+
+  // A different linker script.
+  auto otherScript = link(object, R"(
+SECTIONS {
+  . = 0x20000;
+  .text : { *(.text) }
+}
+)");
+  ASSERT_TRUE(otherScript);
+  EXPECT_TRUE(linkedWithLld());
+  EXPECT_NE(binary->getBuffer(), otherScript->getBuffer());
+
+  // Different linker options.
+  auto otherArgs = LinkArgs;
+  otherArgs.push_back("--defsym=lld_linker_test=1");
+  auto otherOptions = link(object, LinkerScript, otherArgs);
+  ASSERT_TRUE(otherOptions);
+  EXPECT_TRUE(linkedWithLld());
+  EXPECT_NE(binary->getBuffer(), otherOptions->getBuffer());
+
+  // None of the above replaced the original entry.
+  auto again = link(object);
+  ASSERT_TRUE(again);
+  EXPECT_FALSE(linkedWithLld());
+  EXPECT_EQ(binary->getBuffer(), again->getBuffer());
+}
+
+TEST_F(LldLinkerTest, LinkAfterEviction) {
+  const auto object = makeObject(0);
+  auto binary = link(object);
+  ASSERT_TRUE(binary);
+  EXPECT_TRUE(linkedWithLld());
+
+  // Fill the cache with other binaries, evicting the first.
+  for (uint32_t imm = 1; imm <= LinkCacheCapacity; imm++) {
+    auto other = link(makeObject(imm));
+    ASSERT_TRUE(other);
+    EXPECT_TRUE(linkedWithLld());
+  }
+
+  // Linking the evicted object invokes lld again, to the same result.
+  auto relinked = link(object);
+  ASSERT_TRUE(relinked);
+  EXPECT_TRUE(linkedWithLld());
+  EXPECT_EQ(binary->getBuffer(), relinked->getBuffer());
+
+  // And is cached again.
+  auto cached = link(object);
+  ASSERT_TRUE(cached);
+  EXPECT_FALSE(linkedWithLld());
+  EXPECT_EQ(binary->getBuffer(), cached->getBuffer());
+}
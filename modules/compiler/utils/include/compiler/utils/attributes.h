@@ -131,6 +131,22 @@ void setDMAReqdSizeBytes(llvm::Function &F, uint32_t DMASizeBytes);
 /// @return The required DMA size order if present, else `std::nullopt`
 std::optional<uint32_t> getDMAReqdSizeBytes(const llvm::Function &F);
 
+/// @brief Sets the number of bytes of barrier live-variable storage a function
+/// allocates for each work-item in its work-group.
+///
+/// @param[in] F Function in which to add the attribute.
+/// @param[in] LiveVarsSize Upper bound of the live-variable storage in bytes
+/// per work-item.
+void setBarrierLiveVarsSize(llvm::Function &F, uint64_t LiveVarsSize);
+
+/// @brief Gets the number of bytes of barrier live-variable storage a function
+/// allocates for each work-item in its work-group.
+///
+/// @param[in] F Function from which to pull the attribute
+/// @return The live-variable storage in bytes per work-item if present, else
+/// `std::nullopt`
+std::optional<uint64_t> getBarrierLiveVarsSize(const llvm::Function &F);
+
 /// @brief Determines the ordering of work item execution after a barrier.
 enum class BarrierSchedule {
   /// @brief The barrier pass is free to schedule work items in any order.
@@ -85,12 +85,14 @@ using BarrierGraph = llvm::SmallVector<BarrierRegion, 8>;
 
 class Barrier {
  public:
-  Barrier(llvm::Module &m, llvm::Function &f, bool IsDebug)
+  Barrier(llvm::Module &m, llvm::Function &f, bool IsDebug,
+          bool SoALiveVars = false)
       : live_var_mem_ty_(nullptr),
         size_t_bytes(compiler::utils::getSizeTypeBytes(m)),
         module_(m),
         func_(f),
         is_debug_(IsDebug),
+        use_soa_live_vars_(SoALiveVars),
         max_live_var_alignment(0) {}
 
   /// @brief perform the Barrier Region analysis and kernel splitting
@@ -121,6 +123,19 @@ class Barrier {
   /// @brief gets the size of the fixed sized part of the barrier struct
   size_t getLiveVarMemSizeFixed() const { return live_var_mem_size_fixed; }
 
+  /// @brief returns whether the live variables are stored as a structure of
+  /// arrays, with one array per member of the barrier struct.
+  ///
+  /// In this layout, the subkernels take the address of the live variables
+  /// memory, the linear index of the work-item and the number of work-items
+  /// in place of the address of a single barrier struct. Each member is
+  /// stored contiguously across consecutive work-items.
+  bool hasSoALiveVars() const { return soa_live_vars_; }
+
+  /// @brief gets the number of bytes each work-item occupies in the
+  /// structure of arrays layout
+  size_t getLiveVarMemSizeSoA() const { return live_var_mem_size_soa; }
+
   /// @brief gets the minimum size of the scalable part of the barrier struct
   size_t getLiveVarMemSizeScalable() const {
     return live_var_mem_size_scalable;
@@ -169,12 +184,20 @@ class Barrier {
     llvm::IRBuilder<> gepBuilder;
     llvm::Value *barrier_struct = nullptr;
     llvm::Value *vscale = nullptr;
+    /// @brief The linear index of the work-item, if the live variables are
+    /// stored as a structure of arrays.
+    llvm::Value *index = nullptr;
+    /// @brief The number of work-items, if the live variables are stored as a
+    /// structure of arrays.
+    llvm::Value *count = nullptr;
 
-    LiveValuesHelper(const Barrier &b, llvm::Instruction *i, llvm::Value *s)
-        : barrier(b), gepBuilder(i), barrier_struct(s) {}
+    LiveValuesHelper(const Barrier &b, llvm::Instruction *i, llvm::Value *s,
+                     llvm::Value *idx = nullptr, llvm::Value *n = nullptr)
+        : barrier(b), gepBuilder(i), barrier_struct(s), index(idx), count(n) {}
 
-    LiveValuesHelper(const Barrier &b, llvm::BasicBlock *bb, llvm::Value *s)
-        : barrier(b), gepBuilder(bb), barrier_struct(s) {}
+    LiveValuesHelper(const Barrier &b, llvm::BasicBlock *bb, llvm::Value *s,
+                     llvm::Value *idx = nullptr, llvm::Value *n = nullptr)
+        : barrier(b), gepBuilder(bb), barrier_struct(s), index(idx), count(n) {}
 
     /// @brief Return a GEP instruction pointing to the given value/idx pair in
     /// the barrier struct.
@@ -214,6 +237,12 @@ class Barrier {
   /// @brief Type for index of live variables on live variable information
   /// Indexed by the pair (value, member_idx)
   using live_variable_scalables_map_t = live_variable_index_map_t;
+  /// @brief Type for the per-work-item byte offset and stride of each array
+  /// in the structure of arrays layout. Indexed by the pair (value,
+  /// member_idx)
+  using live_variable_soa_map_t =
+      llvm::DenseMap<std::pair<const llvm::Value *, unsigned>,
+                     std::pair<unsigned, unsigned>>;
   /// @brief Type for ids of barriers
   using barrier_id_map_t = llvm::DenseMap<llvm::BasicBlock *, unsigned>;
   /// @brief Type for ids of new kernel functions
@@ -236,6 +265,8 @@ class Barrier {
   live_variable_index_map_t live_variable_index_map_;
   /// @brief Keep offsets of scalable live variables.
   live_variable_scalables_map_t live_variable_scalables_map_;
+  /// @brief Keep offsets and strides of live variables stored as arrays.
+  live_variable_soa_map_t live_variable_soa_map_;
   /// @brief Keep ids of barriers.
   barrier_id_map_t barrier_id_map_;
   /// @brief Keep ids of barriers.
@@ -248,6 +279,8 @@ class Barrier {
   size_t live_var_mem_size_scalable = 0;
   /// @brief The index of the scalables buffer array in the barrier struct.
   size_t live_var_mem_scalables_index = 0;
+  /// @brief The size per work-item of the structure of arrays layout
+  size_t live_var_mem_size_soa = 0;
   /// @brief Keep barriers.
   llvm::SmallVector<llvm::CallInst *, 8> barriers_;
   /// @brief Set of basic blocks that have a barrier as their successor
@@ -270,6 +303,13 @@ class Barrier {
   /// debug stub functions and an extra alloca to aide debugging.
   const bool is_debug_;
 
+  /// @brief Set to true if the live variables should be stored as a
+  /// structure of arrays where possible.
+  const bool use_soa_live_vars_;
+
+  /// @brief Whether the live variables are stored as a structure of arrays.
+  bool soa_live_vars_ = false;
+
   // @brief max alignment required for the live variables.
   unsigned max_live_var_alignment;
 
@@ -55,6 +55,11 @@ void appendMLLVMOptions(cargo::array_view<cargo::string_view> options,
 /// @note  This is kept as a header, so that targets are not forced to link with
 /// LLVM LLD libraries. Preserves CA_LLVM_OPTIONS but no other previously
 /// parsed command-line options.
+/// @note Linked binaries are cached for the lifetime of the process, keyed on
+/// the object, linker script, arguments and library, so linking identical
+/// inputs again does not invoke lld. Each library is written out once and
+/// shared by every link against it. Arguments must therefore not refer to
+/// files whose contents change between links.
 llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> lldLinkToBinary(
     const llvm::ArrayRef<uint8_t> rawBinary, const std::string &linkerScriptStr,
     const uint8_t *linkerLib, unsigned int linkerLibBytes,
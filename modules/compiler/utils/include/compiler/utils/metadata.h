@@ -251,6 +251,13 @@ std::optional<std::array<uint64_t, 3>> parseRequiredWGSMetadata(
 /// metadata.
 std::optional<uint32_t> parseMaxWorkDimMetadata(const llvm::Function &f);
 
+/// @brief Encodes the maximum work dimension of a kernel into its function
+/// metadata.
+///
+/// @param[in] f Kernel on which to encode the metadata.
+/// @param[in] max_work_dim The maximum work dimension to encode.
+void encodeMaxWorkDimMetadata(llvm::Function &f, uint32_t max_work_dim);
+
 /// @brief Describes the state of vectorization on a function/loop.
 struct KernelInfo {
   explicit KernelInfo(llvm::StringRef name) : Name(name) {}
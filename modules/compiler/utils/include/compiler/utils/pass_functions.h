@@ -21,6 +21,7 @@
 #ifndef COMPILER_UTILS_PASS_FUNCTIONS_H_INCLUDED
 #define COMPILER_UTILS_PASS_FUNCTIONS_H_INCLUDED
 
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/ADT/Twine.h>
 #include <llvm/Analysis/IVDescriptors.h>
 #include <llvm/IR/Constants.h>
@@ -59,6 +60,26 @@ namespace utils {
 /// @return uint64_t The private memory used by the kernel function in bytes.
 uint64_t computeApproximatePrivateMemoryUsage(const llvm::Function &fn);
 
+/// @brief Returns the widest scalar element width, in bits, that a kernel
+/// loads, stores or computes on, ignoring pointers and booleans.
+///
+/// @param fn The kernel function
+///
+/// @return The widest element width, or 32 if the kernel has no elements.
+unsigned getWidestElementWidth(const llvm::Function &fn);
+
+/// @brief Collects the values standing in for those each work-item of a
+/// kernel keeps live, i.e. its non-pointer loads and phis.
+///
+/// This is a cheap approximation of register pressure, intended to be passed
+/// to `vecz::TargetInfo::estimateSimdWidth` when choosing a vector width.
+///
+/// @param fn The kernel function
+/// @param[out] values The live values, appended to.
+void getApproximateLiveValues(
+    const llvm::Function &fn,
+    llvm::SmallVectorImpl<const llvm::Value *> &values);
+
 /// @brief Forces a constant expression or constant vector back to a normal
 /// instruction
 ///
@@ -48,6 +48,13 @@ struct WorkItemLoopsPassOptions {
   /// tail loops from wrapped vector kernels, even if the local work-group size
   /// is not known to be a multiple of the vectorization factor.
   bool ForceNoTail = false;
+  /// @brief Set to true if the pass should store the variables live across
+  /// barriers as a structure of arrays, so that each variable is contiguous
+  /// across consecutive work-items, rather than as an array of structures.
+  ///
+  /// This is ignored for debug kernels and kernels with scalable live
+  /// variables.
+  bool SoALiveVars = false;
 };
 
 /// @brief The "work-item loops" pass.
@@ -75,7 +82,9 @@ class WorkItemLoopsPass final : public llvm::PassInfoMixin<WorkItemLoopsPass> {
  public:
   /// @brief Constructor.
   WorkItemLoopsPass(const WorkItemLoopsPassOptions &Options)
-      : IsDebug(Options.IsDebug), ForceNoTail(Options.ForceNoTail) {}
+      : IsDebug(Options.IsDebug),
+        ForceNoTail(Options.ForceNoTail),
+        SoALiveVars(Options.SoALiveVars) {}
 
   llvm::PreservedAnalyses run(llvm::Module &, llvm::ModuleAnalysisManager &);
 
@@ -110,6 +119,7 @@ class WorkItemLoopsPass final : public llvm::PassInfoMixin<WorkItemLoopsPass> {
 
   const bool IsDebug;
   const bool ForceNoTail;
+  const bool SoALiveVars;
 };
 }  // namespace utils
 }  // namespace compiler
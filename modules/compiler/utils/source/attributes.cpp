@@ -149,6 +149,22 @@ std::optional<uint32_t> getDMAReqdSizeBytes(const Function &F) {
   return Val && Val >= 0 ? std::optional<uint32_t>(*Val) : std::nullopt;
 }
 
+static constexpr const char *BarrierLiveVarsSizeAttrName =
+    "mux-barrier-live-vars-size";
+
+void setBarrierLiveVarsSize(Function &F, uint64_t LiveVarsSize) {
+  const Attribute Attr = Attribute::get(
+      F.getContext(), BarrierLiveVarsSizeAttrName, itostr(LiveVarsSize));
+  F.addFnAttr(Attr);
+}
+
+std::optional<uint64_t> getBarrierLiveVarsSize(const Function &F) {
+  const Attribute Attr = F.getFnAttribute(BarrierLiveVarsSizeAttrName);
+  auto Val = getStringFnAttrAsInt(Attr);
+  // Only return non-negative integers
+  return Val && Val >= 0 ? std::optional<uint64_t>(*Val) : std::nullopt;
+}
+
 static constexpr const char *BarrierScheduleAttrName = "mux-barrier-schedule";
 
 void setBarrierSchedule(CallInst &CI, BarrierSchedule Sched) {
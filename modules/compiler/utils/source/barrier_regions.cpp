@@ -316,8 +316,37 @@ Value *compiler::utils::Barrier::LiveValuesHelper::getGEP(const Value *live,
     data_ty = AI->getAllocatedType();
   }
 
-  if (auto field_it = barrier.live_variable_index_map_.find(key);
-      field_it != barrier.live_variable_index_map_.end()) {
+  const auto &soa_map = barrier.live_variable_soa_map_;
+  if (auto soa_it = soa_map.find(key);
+      barrier.soa_live_vars_ && soa_it != soa_map.end()) {
+    assert(index && count && "Missing work-item index into live variables");
+    const auto [field_offset, field_stride] = soa_it->second;
+    Type *const size_ty = gepBuilder.getIntNTy(barrier.size_t_bytes * 8);
+    Type *const byte_ty = gepBuilder.getInt8Ty();
+
+    // Each member is an array of `count` elements, laid out one after the
+    // other, so the work-item's element lives at:
+    //   base + (offset * count) + (index * stride)
+    Value *array = barrier_struct;
+    if (field_offset != 0) {
+      auto *const array_offset = gepBuilder.CreateMul(
+          gepBuilder.CreateZExtOrTrunc(count, size_ty),
+          ConstantInt::get(size_ty, field_offset));
+      array = gepBuilder.CreateInBoundsGEP(byte_ty, array, array_offset);
+    }
+    auto *const element_offset =
+        gepBuilder.CreateMul(gepBuilder.CreateZExtOrTrunc(index, size_ty),
+                             ConstantInt::get(size_ty, field_stride));
+    gep = gepBuilder.CreateInBoundsGEP(byte_ty, array, element_offset,
+                                       Twine("live_gep_") + live->getName());
+
+    gep = gepBuilder.CreatePointerCast(
+        gep,
+        PointerType::get(
+            data_ty,
+            cast<PointerType>(barrier_struct->getType())->getAddressSpace()));
+  } else if (auto field_it = barrier.live_variable_index_map_.find(key);
+             field_it != barrier.live_variable_index_map_.end()) {
     LLVMContext &context = barrier.module_.getContext();
     const unsigned field_index = field_it->second;
     Value *live_variable_info_idxs[2] = {
@@ -961,6 +990,11 @@ void compiler::utils::Barrier::MakeLiveVariableMemType() {
 
   // Deal with non-scalable members first
   unsigned offset = 0;
+  // The per-work-item offset of each member's array in the structure of
+  // arrays layout. The members are sorted by decreasing alignment and each
+  // element is padded to its alignment, so every array stays aligned however
+  // many work-items there are.
+  unsigned soa_offset = 0;
   for (auto &member : barrier_members) {
     if (isa<ScalableVectorType>(member.type)) {
       continue;
@@ -968,6 +1002,12 @@ void compiler::utils::Barrier::MakeLiveVariableMemType() {
 
     offset = PadTypeToAlignment(field_tys, offset, member.alignment);
 
+    const unsigned soa_stride = alignTo(member.size, member.alignment);
+    soa_offset = alignTo(soa_offset, member.alignment);
+    live_variable_soa_map_[std::make_pair(member.value, member.member_idx)] =
+        std::make_pair(soa_offset, soa_stride);
+    soa_offset += soa_stride;
+
     // Check if the alloca has a debug info source variable attached. If
     // so record this and the matching byte offset into the struct.
 #if LLVM_VERSION_GREATER_EQUAL(18, 0)
@@ -1015,6 +1055,15 @@ void compiler::utils::Barrier::MakeLiveVariableMemType() {
       PadTypeToAlignment(field_tys_scalable, offset, max_live_var_alignment);
   live_var_mem_size_scalable = offset;  // No more offsets required.
 
+  // The structure of arrays layout is not used for scalable members, whose
+  // size is only known at runtime, nor when debugging, as the debug info
+  // describes each variable as an offset into a single barrier struct.
+  soa_live_vars_ = use_soa_live_vars_ && !is_debug_ && soa_offset != 0 &&
+                   live_var_mem_size_scalable == 0;
+  if (soa_live_vars_) {
+    live_var_mem_size_soa = alignTo(soa_offset, max_live_var_alignment);
+  }
+
   LLVMContext &context = module_.getContext();
   // if the barrier contains scalables, add a flexible byte array on the end
   if (offset != 0) {
@@ -1073,6 +1122,12 @@ Function *compiler::utils::Barrier::GenerateNewKernel(BarrierRegion &region) {
   if (hasBarrierStruct) {
     PointerType *pty = PointerType::get(live_var_mem_ty_, 0);
     new_func_params.push_back(pty);
+    // Arrays of live variables are indexed by the work-item, and are as long
+    // as there are work-items.
+    if (soa_live_vars_) {
+      new_func_params.push_back(compiler::utils::getSizeType(module_));
+      new_func_params.push_back(compiler::utils::getSizeType(module_));
+    }
   }
 
   // Make new kernel function.
@@ -1202,11 +1257,23 @@ Function *compiler::utils::Barrier::GenerateNewKernel(BarrierRegion &region) {
     insert_point = insert_point->getNextNonDebugInstruction();
   }
 
+  Value *live_vars_arg = nullptr;
+  Value *live_vars_index = nullptr;
+  Value *live_vars_count = nullptr;
+  if (hasBarrierStruct) {
+    const unsigned num_args = new_kernel->arg_size();
+    if (soa_live_vars_) {
+      live_vars_arg = new_kernel->getArg(num_args - 3);
+      live_vars_index = new_kernel->getArg(num_args - 2);
+      live_vars_count = new_kernel->getArg(num_args - 1);
+    } else {
+      live_vars_arg = new_kernel->getArg(num_args - 1);
+    }
+  }
+
   // It puts all the GEPs at the start of the kernel, but only once
-  LiveValuesHelper live_values(
-      *this, insert_point,
-      hasBarrierStruct ? compiler::utils::getLastArgument(new_kernel)
-                       : nullptr);
+  LiveValuesHelper live_values(*this, insert_point, live_vars_arg,
+                               live_vars_index, live_vars_count);
 
   // Load live variables and map them.
   // These variables are defined in a different kernel, so we insert the
@@ -20,8 +20,14 @@
 #include <lld/Common/Driver.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SHA1.h>
 #include <multi_llvm/llvm_version.h>
 
+#include <array>
+#include <deque>
+#include <map>
+#include <mutex>
+
 using namespace llvm;
 
 #if LLVM_VERSION_GREATER_EQUAL(17, 0)
@@ -51,54 +57,99 @@ void appendMLLVMOptions(cargo::array_view<cargo::string_view> options,
   }
 }
 
-Expected<std::unique_ptr<MemoryBuffer>> lldLinkToBinary(
-    const ArrayRef<uint8_t> rawBinary, const std::string &linkerScriptStr,
-    const uint8_t *linkerLib, unsigned int linkerLibBytes,
-    const SmallVectorImpl<std::string> &additionalLinkArgs) {
-  struct TemporaryFile {
-    TemporaryFile() = default;
-    TemporaryFile(const Twine &Prefix, StringRef Suffix) {
-      ErrorCode = sys::fs::createTemporaryFile(Prefix, Suffix, FileName);
+namespace {
+struct TemporaryFile {
+  TemporaryFile() = default;
+  TemporaryFile(const Twine &Prefix, StringRef Suffix) {
+    ErrorCode = sys::fs::createTemporaryFile(Prefix, Suffix, FileName);
+  }
+  TemporaryFile(const TemporaryFile &) = delete;
+  TemporaryFile(TemporaryFile &&other) {
+    std::swap(FileName, other.FileName);
+    std::swap(ErrorCode, other.ErrorCode);
+  }
+  ~TemporaryFile() {
+    if (!getErrorCode() && FileName.size()) {
+      (void)sys::fs::remove(FileName);
     }
-    TemporaryFile(const TemporaryFile &) = delete;
-    TemporaryFile(TemporaryFile &&other) {
-      std::swap(FileName, other.FileName);
-      std::swap(ErrorCode, other.ErrorCode);
+  }
+  TemporaryFile &operator=(const TemporaryFile &) = delete;
+  TemporaryFile &operator=(TemporaryFile &&other) {
+    std::swap(FileName, other.FileName);
+    std::swap(ErrorCode, other.ErrorCode);
+    return *this;
+  }
+  const char *getFileName() const { return FileName.c_str(); }
+  std::error_code getErrorCode() const { return ErrorCode; }
+  explicit operator bool() const { return bool(ErrorCode); }
+
+ private:
+  // mutable in order to allow calling c_str().
+  mutable SmallString<128> FileName;
+  std::error_code ErrorCode;
+};
+
+/// @brief Digest identifying the inputs of a link.
+using LinkDigest = std::array<uint8_t, 20>;
+
+/// @brief Maximum number of linked binaries kept by the link cache.
+constexpr size_t LinkCacheCapacity = 64;
+
+/// @brief Process-wide cache of linked binaries, and of the runtime libraries
+/// written out for linking against.
+///
+/// Programs rebuilt with identical object code, such as those compiled for
+/// each local size they are enqueued with, link to identical binaries, so
+/// these are returned without invoking lld again.
+struct LinkCache {
+  static LinkCache &get() {
+    static LinkCache cache;
+    return cache;
+  }
+
+  /// @brief Find a previously linked binary.
+  ///
+  /// @return Returns a copy of the binary, or null if there is none.
+  std::unique_ptr<MemoryBuffer> lookup(const LinkDigest &digest) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    auto it = binaries.find(digest);
+    if (it == binaries.end()) {
+      return nullptr;
     }
-    ~TemporaryFile() {
-      if (!getErrorCode() && FileName.size()) {
-        (void)sys::fs::remove(FileName);
-      }
+    return MemoryBuffer::getMemBufferCopy(it->second);
+  }
+
+  /// @brief Remember a linked binary, evicting the oldest if full.
+  void insert(const LinkDigest &digest, StringRef binary) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (!binaries.try_emplace(digest, binary.str()).second) {
+      return;
     }
-    TemporaryFile &operator=(const TemporaryFile &) = delete;
-    TemporaryFile &operator=(TemporaryFile &&other) {
-      std::swap(FileName, other.FileName);
-      std::swap(ErrorCode, other.ErrorCode);
-      return *this;
+    order.push_back(digest);
+    if (order.size() > LinkCacheCapacity) {
+      binaries.erase(order.front());
+      order.pop_front();
     }
-    const char *getFileName() const { return FileName.c_str(); }
-    std::error_code getErrorCode() const { return ErrorCode; }
-    explicit operator bool() const { return bool(ErrorCode); }
-
-   private:
-    // mutable in order to allow calling c_str().
-    mutable SmallString<128> FileName;
-    std::error_code ErrorCode;
-  };
+  }
 
-  const TemporaryFile objFile("lld", "o");
-  if (objFile) return errorCodeToError(objFile.getErrorCode());
-  const TemporaryFile elfFile("lld", "elf");
-  if (elfFile) return errorCodeToError(elfFile.getErrorCode());
-  const TemporaryFile linkerScript("lld", "ld");
-  if (linkerScript) return errorCodeToError(linkerScript.getErrorCode());
-  TemporaryFile linkRTFile;
-  if (linkerLib) {
-    linkRTFile = TemporaryFile("lld_rt", "a");
-    if (linkRTFile) return errorCodeToError(linkRTFile.getErrorCode());
-    FILE *flinklib = fopen(linkRTFile.getFileName(), "wb+");
+  /// @brief Get the file holding a runtime library, writing it on first use.
+  ///
+  /// The file is shared by every link against the same library and removed
+  /// when the process exits.
+  Expected<std::string> getRuntimeLibFile(const LinkDigest &digest,
+                                          const uint8_t *lib,
+                                          unsigned int libBytes) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    auto it = runtime_libs.find(digest);
+    if (it != runtime_libs.end()) {
+      return it->second.getFileName();
+    }
+    TemporaryFile file("lld_rt", "a");
+    if (file) return errorCodeToError(file.getErrorCode());
+    FILE *flinklib = fopen(file.getFileName(), "wb+");
     if (nullptr != flinklib) {
-      if (fwrite(linkerLib, 1, linkerLibBytes, flinklib) != linkerLibBytes) {
+      if (fwrite(lib, 1, libBytes, flinklib) != libBytes) {
+        fclose(flinklib);
         return createStringError(
             inconvertibleErrorCode(),
             "unable to write linker lib to temporary file");
@@ -108,7 +159,76 @@ Expected<std::unique_ptr<MemoryBuffer>> lldLinkToBinary(
                                  "unable to close temporary linker lib file");
       }
     }
+    std::string name = file.getFileName();
+    runtime_libs.emplace(digest, std::move(file));
+    return name;
+  }
+
+ private:
+  std::mutex mutex;
+  std::map<LinkDigest, std::string> binaries;
+  std::deque<LinkDigest> order;
+  std::map<LinkDigest, TemporaryFile> runtime_libs;
+};
+
+void hashBytes(SHA1 &hasher, ArrayRef<uint8_t> bytes) {
+  // Prefix each input with its size so that adjacent inputs can't alias.
+  const uint64_t size = bytes.size();
+  hasher.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(&size),
+                                  sizeof(size)));
+  hasher.update(bytes);
+}
+
+void hashString(SHA1 &hasher, StringRef str) {
+  hashBytes(hasher, ArrayRef<uint8_t>(
+                        reinterpret_cast<const uint8_t *>(str.data()),
+                        str.size()));
+}
+}  // namespace
+
+Expected<std::unique_ptr<MemoryBuffer>> lldLinkToBinary(
+    const ArrayRef<uint8_t> rawBinary, const std::string &linkerScriptStr,
+    const uint8_t *linkerLib, unsigned int linkerLibBytes,
+    const SmallVectorImpl<std::string> &additionalLinkArgs) {
+  auto &cache = LinkCache::get();
+
+  std::vector<std::string> extraArgs;
+#if !defined(NDEBUG) || defined(CA_ENABLE_LLVM_OPTIONS_IN_RELEASE)
+  if (auto *env = std::getenv("CA_LLVM_OPTIONS")) {
+    auto split_llvm_options = cargo::split(env, " ");
+    compiler::utils::appendMLLVMOptions(split_llvm_options, extraArgs);
+  }
+#endif  // NDEBUG
+  for (const auto &arg : additionalLinkArgs) {
+    extraArgs.push_back(arg);
+  }
+
+  // The linked binary depends only on the object, the linker script and
+  // arguments, and the runtime library.
+  LinkDigest libDigest{};
+  if (linkerLib) {
+    SHA1 libHasher;
+    hashBytes(libHasher, ArrayRef<uint8_t>(linkerLib, linkerLibBytes));
+    libDigest = libHasher.result();
+  }
+  SHA1 hasher;
+  hashBytes(hasher, rawBinary);
+  hashString(hasher, linkerScriptStr);
+  for (const auto &arg : extraArgs) {
+    hashString(hasher, arg);
+  }
+  hashBytes(hasher, libDigest);
+  const LinkDigest digest = hasher.result();
+  if (auto cached = cache.lookup(digest)) {
+    return std::move(cached);
   }
+
+  const TemporaryFile objFile("lld", "o");
+  if (objFile) return errorCodeToError(objFile.getErrorCode());
+  const TemporaryFile elfFile("lld", "elf");
+  if (elfFile) return errorCodeToError(elfFile.getErrorCode());
+  const TemporaryFile linkerScript("lld", "ld");
+  if (linkerScript) return errorCodeToError(linkerScript.getErrorCode());
   FILE *f = fopen(objFile.getFileName(), "wb+");
   if (!f) {
     return createStringError(inconvertibleErrorCode(),
@@ -139,20 +259,15 @@ Expected<std::unique_ptr<MemoryBuffer>> lldLinkToBinary(
   }
 
   std::vector<std::string> args = {"ld.lld", objFile.getFileName()};
-
-#if !defined(NDEBUG) || defined(CA_ENABLE_LLVM_OPTIONS_IN_RELEASE)
-  if (auto *env = std::getenv("CA_LLVM_OPTIONS")) {
-    auto split_llvm_options = cargo::split(env, " ");
-    compiler::utils::appendMLLVMOptions(split_llvm_options, args);
-  }
-#endif  // NDEBUG
-
-  for (const auto &arg : additionalLinkArgs) {
-    args.push_back(arg);
-  }
+  args.insert(args.end(), extraArgs.begin(), extraArgs.end());
   args.push_back((Twine("--script=") + linkerScript.getFileName()).str());
   if (linkerLib) {
-    args.push_back(linkRTFile.getFileName());
+    auto libFile =
+        cache.getRuntimeLibFile(libDigest, linkerLib, linkerLibBytes);
+    if (!libFile) {
+      return libFile.takeError();
+    }
+    args.push_back(std::move(*libFile));
   }
   args.push_back("-o");
   args.push_back(elfFile.getFileName());
@@ -187,6 +302,7 @@ Expected<std::unique_ptr<MemoryBuffer>> lldLinkToBinary(
     return errorCodeToError(bufferOrError.getError());
   }
 
+  cache.insert(digest, (*bufferOrError)->getBuffer());
   return std::move(*bufferOrError);
 }
 
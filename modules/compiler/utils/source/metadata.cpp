@@ -335,6 +335,14 @@ std::optional<uint32_t> parseMaxWorkDimMetadata(const Function &f) {
   return std::nullopt;
 }
 
+void encodeMaxWorkDimMetadata(Function &f, uint32_t max_work_dim) {
+  auto *const i32Ty = Type::getInt32Ty(f.getContext());
+  f.setMetadata("max_work_dim",
+                MDNode::get(f.getContext(),
+                            {ConstantAsMetadata::get(
+                                ConstantInt::get(i32Ty, max_work_dim))}));
+}
+
 void populateKernelList(Module &m, SmallVectorImpl<KernelInfo> &results) {
   // Construct list of kernels from metadata, if present.
   if (auto *md = m.getNamedMetadata("opencl.kernels")) {
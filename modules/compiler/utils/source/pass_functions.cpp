@@ -34,6 +34,7 @@
 #include <multi_llvm/multi_llvm.h>
 #include <multi_llvm/vector_type_helper.h>
 
+#include <algorithm>
 #include <cassert>
 
 llvm::AnalysisKey compiler::utils::DeviceInfoAnalysis::Key;
@@ -73,6 +74,43 @@ uint64_t computeApproximatePrivateMemoryUsage(const llvm::Function &fn) {
   return bytes;
 }
 
+unsigned getWidestElementWidth(const llvm::Function &fn) {
+  unsigned widest = 0;
+  auto visitType = [&widest](llvm::Type *ty) {
+    auto *const scalar_ty = ty->getScalarType();
+    if (scalar_ty->isIntegerTy(1) ||
+        !(scalar_ty->isIntegerTy() || scalar_ty->isFloatingPointTy())) {
+      return;
+    }
+    widest = std::max(widest, scalar_ty->getScalarSizeInBits());
+  };
+  for (const auto &bb : fn) {
+    for (const auto &inst : bb) {
+      if (auto *store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+        visitType(store->getValueOperand()->getType());
+      } else if (llvm::isa<llvm::LoadInst>(inst) ||
+                 llvm::isa<llvm::CastInst>(inst) ||
+                 llvm::isa<llvm::BinaryOperator>(inst)) {
+        visitType(inst.getType());
+      }
+    }
+  }
+  return widest ? widest : 32u;
+}
+
+void getApproximateLiveValues(
+    const llvm::Function &fn,
+    llvm::SmallVectorImpl<const llvm::Value *> &values) {
+  for (const auto &bb : fn) {
+    for (const auto &inst : bb) {
+      if ((llvm::isa<llvm::LoadInst>(inst) || llvm::isa<llvm::PHINode>(inst)) &&
+          !inst.getType()->isPointerTy()) {
+        values.push_back(&inst);
+      }
+    }
+  }
+}
+
 static llvm::SmallVector<llvm::Constant *> getNewOps(llvm::Constant *constant,
                                                      llvm::Constant *from,
                                                      llvm::Constant *to) {
@@ -49,8 +49,9 @@ namespace utils {
 class BarrierWithLiveVars : public Barrier {
  public:
   BarrierWithLiveVars(llvm::Module &m, llvm::Function &f,
-                      VectorizationInfo vf_info, bool IsDebug)
-      : Barrier(m, f, IsDebug), vf_info(vf_info) {}
+                      VectorizationInfo vf_info, bool IsDebug,
+                      bool SoALiveVars)
+      : Barrier(m, f, IsDebug, SoALiveVars), vf_info(vf_info) {}
 
   VectorizationInfo getVFInfo() const { return vf_info; }
 
@@ -77,7 +78,8 @@ class BarrierWithLiveVars : public Barrier {
   // its own view.
   //
   // This is typically used to hold Z*Y*(X/vec_width) individual instances of
-  // the live-variables structure.
+  // the live-variables structure, or as many elements of each of its arrays
+  // when stored as a structure of arrays.
   AllocaInst *mem_space = nullptr;
 
   // Alloca holding the address of the live vars struct for the
@@ -218,11 +220,15 @@ struct ScheduleGenerator {
       return nullptr;
     }
 
-    // Calculate the offset for where the live variables of the current
-    // work item (within the nested loops) are stored.
-    // Loop i,j,k  -->  ((i * dim1) + j) * size0 + k
-    // memory access pattern should not depend on the vectorization
-    // dimension
+    // Arrays of live variables are indexed by the subkernels themselves, so
+    // they are passed the start of the memory.
+    if (barrier.hasSoALiveVars()) {
+      return ir.CreatePointerCast(
+          mem_space,
+          PointerType::get(
+              barrier.getLiveVarsType(),
+              cast<PointerType>(mem_space->getType())->getAddressSpace()));
+    }
 
     Value *live_var_ptr;
     if (!barrier.getStructSize()) {
@@ -247,11 +253,10 @@ struct ScheduleGenerator {
     return live_var_ptr;
   }
 
-  Value *createLiveVarsPtr(const compiler::utils::BarrierWithLiveVars &barrier,
-                           IRBuilder<> &ir, Value *dim_0, Value *dim_1,
-                           Value *dim_2, Value *VF = nullptr) {
-    Value *const mem_space = barrier.getMemSpace();
-    if (!mem_space) {
+  Value *createLiveVarsIndex(
+      const compiler::utils::BarrierWithLiveVars &barrier, IRBuilder<> &ir,
+      Value *dim_0, Value *dim_1, Value *dim_2, Value *VF = nullptr) {
+    if (!barrier.getMemSpace()) {
       return nullptr;
     }
 
@@ -264,9 +269,15 @@ struct ScheduleGenerator {
     auto *const j_offset =
         ir.CreateMul(ir.CreateAdd(i_offset, dim_1), barrier.getSize0());
     auto *const k_offset = VF ? ir.CreateUDiv(dim_0, VF) : dim_0;
-    auto *const offset = ir.CreateAdd(j_offset, k_offset);
+    return ir.CreateAdd(j_offset, k_offset);
+  }
 
-    return createLinearLiveVarsPtr(barrier, ir, offset);
+  compiler::utils::Barrier::LiveValuesHelper getLiveValues(
+      const compiler::utils::BarrierWithLiveVars &barrier, BasicBlock *block,
+      IRBuilder<> &ir, Value *index) {
+    return compiler::utils::Barrier::LiveValuesHelper(
+        barrier, block, createLinearLiveVarsPtr(barrier, ir, index), index,
+        barrier.getTotalSize());
   }
 
   void recreateDebugIntrinsics(
@@ -324,10 +335,16 @@ struct ScheduleGenerator {
                     {ConstantInt::get(i32Ty, workItemDim0), local_id})
           ->setCallingConv(set_local_id->getCallingConv());
 
+      auto *const live_var_index =
+          createLiveVarsIndex(barrier, ir, dim_0, dim_1, dim_2, VF);
       auto *const live_var_ptr =
-          createLiveVarsPtr(barrier, ir, dim_0, dim_1, dim_2, VF);
+          createLinearLiveVarsPtr(barrier, ir, live_var_index);
       if (live_var_ptr) {
         new_kernel_args.push_back(live_var_ptr);
+        if (barrier.hasSoALiveVars()) {
+          new_kernel_args.push_back(live_var_index);
+          new_kernel_args.push_back(barrier.getTotalSize());
+        }
 
         if (auto *debug_addr = barrier.getDebugAddr()) {
           // Update the alloca holding the address of the live vars struct for
@@ -424,9 +441,7 @@ struct ScheduleGenerator {
         [&](BasicBlock *block, Value *index, ArrayRef<Value *> ivs,
             MutableArrayRef<Value *> ivsNext) -> BasicBlock * {
           IRBuilder<> ir(block);
-          auto *const liveVars = createLinearLiveVarsPtr(barrier, ir, index);
-          compiler::utils::Barrier::LiveValuesHelper live_values(barrier, block,
-                                                                 liveVars);
+          auto live_values = getLiveValues(barrier, block, ir, index);
 
           IRBuilder<> ir_load(block);
           auto *const itemOp =
@@ -455,10 +470,7 @@ struct ScheduleGenerator {
     auto *const zero =
         Constant::getNullValue(compiler::utils::getSizeType(module));
     IRBuilder<> ir(block);
-    auto *const barrier0 = ir.CreateInBoundsGEP(barrier.getLiveVarsType(),
-                                                barrier.getMemSpace(), {zero});
-    compiler::utils::Barrier::LiveValuesHelper live_values(barrier, block,
-                                                           barrier0);
+    auto live_values = getLiveValues(barrier, block, ir, zero);
     for (auto &value : values) {
       value = live_values.getReload(value, ir, "_load", true);
     }
@@ -593,10 +605,9 @@ struct ScheduleGenerator {
 
         // Compute the address of the value in the main barrier struct
         auto *const VF = materializeVF(ir, barrierMain.getVFInfo().vf);
-        auto *const liveVars = createLiveVarsPtr(barrierMain, ir, idsMain[0],
-                                                 idsMain[1], idsMain[2], VF);
-        compiler::utils::Barrier::LiveValuesHelper live_values(barrierMain,
-                                                               block, liveVars);
+        auto *const index = createLiveVarsIndex(barrierMain, ir, idsMain[0],
+                                                idsMain[1], idsMain[2], VF);
+        auto live_values = getLiveValues(barrierMain, block, ir, index);
         auto *const GEPmain = live_values.getGEP(op);
         assert(GEPmain && "Could not get broadcasted value");
 
@@ -605,11 +616,10 @@ struct ScheduleGenerator {
 
           // Compute the address of the value in the tail barrier struct
           auto *const offsetDim0 = ir.CreateSub(idsMain[0], mainLoopLimit);
-          auto *const liveVarsTail =
-              createLiveVarsPtr(*barrierTail, ir, offsetDim0, idsMain[1],
-                                idsMain[2], VP ? VF : nullptr);
-          compiler::utils::Barrier::LiveValuesHelper live_values(
-              *barrierTail, block, liveVarsTail);
+          auto *const indexTail =
+              createLiveVarsIndex(*barrierTail, ir, offsetDim0, idsMain[1],
+                                  idsMain[2], VP ? VF : nullptr);
+          auto live_values = getLiveValues(*barrierTail, block, ir, indexTail);
 
           auto *const opTail =
               barrierTail->getBarrierCall(barrierID)->getOperand(1);
@@ -1047,10 +1057,10 @@ struct ScheduleGenerator {
                         if (isScan) {
                           auto *const barrierCall =
                               barrierMain.getBarrierCall(barrierID);
-                          auto *const liveVars = createLiveVarsPtr(
+                          auto *const index = createLiveVarsIndex(
                               barrierMain, ir, dim_0, dim_1, dim_2, VF);
-                          compiler::utils::Barrier::LiveValuesHelper
-                              live_values(barrierMain, block, liveVars);
+                          auto live_values =
+                              getLiveValues(barrierMain, block, ir, index);
                           auto *const itemOp = live_values.getReload(
                               barrierCall->getOperand(1), ir, "_load",
                               /*reuse*/ true);
@@ -1149,10 +1159,10 @@ struct ScheduleGenerator {
                       assert(barrierTail);
                       auto *const barrierCall =
                           barrierTail->getBarrierCall(barrierID);
-                      auto *const liveVars = createLiveVarsPtr(
+                      auto *const index = createLiveVarsIndex(
                           *barrierTail, ir, zero, dim_1, dim_2, nullptr);
-                      compiler::utils::Barrier::LiveValuesHelper live_values(
-                          *barrierTail, tailPreheaderBB, liveVars);
+                      auto live_values = getLiveValues(
+                          *barrierTail, tailPreheaderBB, ir, index);
                       auto *const itemOp = live_values.getReload(
                           barrierCall->getOperand(1), ir, "_load",
                           /*reuse*/ true);
@@ -1201,10 +1211,10 @@ struct ScheduleGenerator {
                             assert(barrierTail);
                             auto *const barrierCall =
                                 barrierTail->getBarrierCall(barrierID);
-                            auto *const liveVars = createLiveVarsPtr(
+                            auto *const index = createLiveVarsIndex(
                                 *barrierTail, ir, dim_0, dim_1, dim_2, nullptr);
-                            compiler::utils::Barrier::LiveValuesHelper
-                                live_values(*barrierTail, block, liveVars);
+                            auto live_values =
+                                getLiveValues(*barrierTail, block, ir, index);
                             auto *const itemOp = live_values.getReload(
                                 barrierCall->getOperand(1), ir, "_load",
                                 /*reuse*/ true);
@@ -1304,7 +1314,16 @@ void setUpLiveVarsAlloca(compiler::utils::BarrierWithLiveVars &barrier,
   auto &m = *B.GetInsertBlock()->getModule();
   auto *const size_ty = compiler::utils::getSizeType(m);
   const auto scalablesSize = barrier.getLiveVarMemSizeScalable();
-  if (scalablesSize == 0) {
+  if (barrier.hasSoALiveVars()) {
+    // Each work-item's share of every array
+    auto *const buffer_size = B.CreateMul(
+        ConstantInt::get(size_ty, barrier.getLiveVarMemSizeSoA()),
+        live_var_size);
+    live_var_mem_space = B.CreateAlloca(B.getInt8Ty(), buffer_size, name);
+    live_var_mem_space->setAlignment(
+        MaybeAlign(barrier.getLiveVarMaxAlignment()).valueOrOne());
+    barrier.setMemSpace(live_var_mem_space);
+  } else if (scalablesSize == 0) {
     live_var_mem_space =
         B.CreateAlloca(barrier.getLiveVarsType(), live_var_size, name);
     live_var_mem_space->setAlignment(
@@ -1332,6 +1351,23 @@ void setUpLiveVarsAlloca(compiler::utils::BarrierWithLiveVars &barrier,
   }
 }
 
+// Returns the number of bytes of live-variable storage setUpLiveVarsAlloca
+// allocates for each vectorized group of work-items, or std::nullopt if it
+// depends on the vector length.
+std::optional<uint64_t> getLiveVarsGroupSize(
+    const compiler::utils::BarrierWithLiveVars &barrier, const DataLayout &DL) {
+  if (!barrier.hasLiveVars()) {
+    return 0;
+  }
+  if (barrier.hasSoALiveVars()) {
+    return barrier.getLiveVarMemSizeSoA();
+  }
+  if (barrier.getLiveVarMemSizeScalable() != 0) {
+    return std::nullopt;
+  }
+  return DL.getTypeAllocSize(barrier.getLiveVarsType()).getFixedValue();
+}
+
 }  // namespace
 
 Function *compiler::utils::WorkItemLoopsPass::makeWrapperFunction(
@@ -1510,6 +1546,19 @@ Function *compiler::utils::WorkItemLoopsPass::makeWrapperFunction(
                         "live_variables_peel", IsDebug);
   }
 
+  // Record how much live-variable storage the work-group needs, so that
+  // targets can provide it before the kernel first runs. There is at most one
+  // group of work-items per work-item in each of the main and tail loops.
+  {
+    const auto &DL = M.getDataLayout();
+    auto mainSize = getLiveVarsGroupSize(barrierMain, DL);
+    auto tailSize = emitTail ? getLiveVarsGroupSize(*barrierTail, DL)
+                             : std::optional<uint64_t>(0);
+    if (mainSize && tailSize) {
+      setBarrierLiveVarsSize(*new_wrapper, *mainSize + *tailSize);
+    }
+  }
+
   // next means next barrier id. This variable is uninitialized to begin with,
   // and is set by the first pass below
   IntegerType *index_type = i32Ty;
@@ -1581,10 +1630,14 @@ Function *compiler::utils::WorkItemLoopsPass::makeWrapperFunction(
                 Constant::getNullValue(compiler::utils::getSizeType(M));
             IRBuilder<> ir(Call);
             auto *const barrier0 =
-                ir.CreateInBoundsGEP(barrierMain.getLiveVarsType(),
-                                     barrierMain.getMemSpace(), {zero});
+                barrierMain.hasSoALiveVars()
+                    ? barrierMain.getMemSpace()
+                    : ir.CreateInBoundsGEP(barrierMain.getLiveVarsType(),
+                                           barrierMain.getMemSpace(), {zero});
 
-            Barrier::LiveValuesHelper live_values(barrierMain, Call, barrier0);
+            Barrier::LiveValuesHelper live_values(barrierMain, Call, barrier0,
+                                                  zero,
+                                                  barrierMain.getTotalSize());
 
             size_t op_index = 0;
             for (auto *const op : Ops) {
@@ -1888,7 +1941,8 @@ PreservedAnalyses compiler::utils::WorkItemLoopsPass::run(
   for (const auto &P : MainTailPairs) {
     assert(P.MainF && "Missing main function");
     // Construct the main barrier
-    BarrierWithLiveVars MainBarrier(M, *P.MainF, P.MainInfo, IsDebug);
+    BarrierWithLiveVars MainBarrier(M, *P.MainF, P.MainInfo, IsDebug,
+                                    SoALiveVars);
     MainBarrier.Run(MAM);
 
     // Tail kernels are optional
@@ -1898,7 +1952,8 @@ PreservedAnalyses compiler::utils::WorkItemLoopsPass::run(
     } else {
       // Construct the tail barrier
       assert(P.TailInfo && "Missing tail info");
-      BarrierWithLiveVars TailBarrier(M, *P.TailF, *P.TailInfo, IsDebug);
+      BarrierWithLiveVars TailBarrier(M, *P.TailF, *P.TailInfo, IsDebug,
+                                      SoALiveVars);
       TailBarrier.Run(MAM);
 
       Wrappers.insert(
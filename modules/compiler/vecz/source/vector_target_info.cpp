@@ -1337,6 +1337,8 @@ std::unique_ptr<TargetInfo> createTargetInfoArm(TargetMachine *tm);
 std::unique_ptr<TargetInfo> createTargetInfoAArch64(TargetMachine *tm);
 
 std::unique_ptr<TargetInfo> createTargetInfoRISCV(TargetMachine *tm);
+
+std::unique_ptr<TargetInfo> createTargetInfoX86(TargetMachine *tm);
 }  // namespace vecz
 
 std::unique_ptr<TargetInfo> vecz::createTargetInfoFromTargetMachine(
@@ -1352,6 +1354,9 @@ std::unique_ptr<TargetInfo> vecz::createTargetInfoFromTargetMachine(
       case Triple::riscv32:
       case Triple::riscv64:
         return createTargetInfoRISCV(tm);
+      case Triple::x86:
+      case Triple::x86_64:
+        return createTargetInfoX86(tm);
       default:
         // Just use the generic TargetInfo unless we know better
         break;
@@ -0,0 +1,193 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include "debugging.h"
+#include "vecz/vecz_target_info.h"
+
+using namespace vecz;
+using namespace llvm;
+
+namespace vecz {
+
+/// @brief Target info for x86 with SSE, AVX2 or AVX-512.
+///
+/// Masked, gather and scatter memory operations are emitted as LLVM's masked
+/// intrinsics by the generic implementation, which the x86 backend selects to
+/// `vmaskmov`, `vpgather` or AVX-512 masked instructions when the subtarget
+/// has them. What x86 adds are three-way interleaved groups, such as RGB
+/// pixels, which a cost model only transposes with shuffles when that is
+/// cheaper than leaving them as gathers and scatters.
+class TargetInfoX86 final : public TargetInfo {
+ public:
+  TargetInfoX86(TargetMachine *tm) : TargetInfo(tm) {}
+
+  ~TargetInfoX86() = default;
+
+  bool canOptimizeInterleavedGroup(const Instruction &val,
+                                   InterleavedOperation kind, int stride,
+                                   unsigned groupSize) const override;
+
+  bool interleaveVectors(IRBuilder<> &builder,
+                         MutableArrayRef<Value *> vectors,
+                         bool forward) const override;
+
+ private:
+  /// @brief Compare the cost of transposing a three-way interleaved group with
+  /// contiguous memory operations and shuffles against the gathers or
+  /// scatters it replaces.
+  ///
+  /// @param[in] val Memory access operation of the group.
+  /// @param[in] kind Kind of interleaved instructions.
+  /// @param[in] stride Stride of the interleaved memory operations, which is
+  /// also the size of the group.
+  ///
+  /// @return true if the transposed group is expected to be cheaper.
+  bool isInterleavedGroupProfitable(const Instruction &val,
+                                    InterleavedOperation kind,
+                                    unsigned stride) const;
+};
+
+std::unique_ptr<TargetInfo> createTargetInfoX86(TargetMachine *tm) {
+  return std::make_unique<TargetInfoX86>(tm);
+}
+
+}  // namespace vecz
+
+bool TargetInfoX86::canOptimizeInterleavedGroup(const Instruction &val,
+                                                InterleavedOperation kind,
+                                                int stride,
+                                                unsigned groupSize) const {
+  // Groups of two and four are handled as on any other target.
+  if (stride != 3) {
+    return TargetInfo::canOptimizeInterleavedGroup(val, kind, stride,
+                                                   groupSize);
+  }
+
+  VECZ_FAIL_IF(groupSize != 3);
+  Type *DataType = nullptr;
+  if (kind == eInterleavedStore || kind == eMaskedInterleavedStore) {
+    DataType = val.getOperand(0)->getType();
+  } else if (kind == eInterleavedLoad || kind == eMaskedInterleavedLoad) {
+    DataType = val.getType();
+  }
+  VECZ_FAIL_IF(!DataType || !isa<FixedVectorType>(DataType));
+  return isInterleavedGroupProfitable(val, kind, stride);
+}
+
+bool TargetInfoX86::isInterleavedGroupProfitable(const Instruction &val,
+                                                 InterleavedOperation kind,
+                                                 unsigned stride) const {
+  if (!TM_) {
+    return true;
+  }
+
+  const bool IsStore =
+      (kind == eInterleavedStore) || (kind == eMaskedInterleavedStore);
+  const bool HasMask =
+      (kind == eMaskedInterleavedLoad) || (kind == eMaskedInterleavedStore);
+  auto *const VecTy = cast<FixedVectorType>(
+      IsStore ? val.getOperand(0)->getType() : val.getType());
+  const Value *const Ptr = val.getOperand(IsStore ? 1 : 0);
+  VECZ_FAIL_IF(!Ptr->getType()->isPointerTy());
+
+  const TargetTransformInfo TTI =
+      TM_->getTargetTransformInfo(*val.getFunction());
+  const auto CostKind = TargetTransformInfo::TCK_RecipThroughput;
+  const unsigned Opcode = IsStore ? Instruction::Store : Instruction::Load;
+  const unsigned AddrSpace = Ptr->getType()->getPointerAddressSpace();
+  const Align Alignment(
+      std::max(VecTy->getScalarSizeInBits() / 8, static_cast<unsigned>(1)));
+
+  // The whole group is accessed with one contiguous vector per member, and
+  // transposed with shuffles.
+  auto *const WideTy = FixedVectorType::get(VecTy->getElementType(),
+                                            VecTy->getNumElements() * stride);
+  SmallVector<unsigned, 4> Indices;
+  for (unsigned i = 0; i < stride; i++) {
+    Indices.push_back(i);
+  }
+  InstructionCost GroupCost = TTI.getInterleavedMemoryOpCost(
+      Opcode, WideTy, stride, Indices, Alignment, AddrSpace, CostKind);
+  if (HasMask) {
+    // The contiguous accesses are masked, not the whole group at once.
+    GroupCost += (TTI.getMaskedMemoryOpCost(Opcode, VecTy, Alignment,
+                                            AddrSpace, CostKind) -
+                  TTI.getMemoryOpCost(Opcode, VecTy, Alignment, AddrSpace,
+                                      CostKind)) *
+                 stride;
+  }
+
+  const InstructionCost GatherCost =
+      TTI.getGatherScatterOpCost(Opcode, VecTy, Ptr, HasMask, Alignment,
+                                 CostKind) *
+      stride;
+
+  return GroupCost.isValid() && GroupCost <= GatherCost;
+}
+
+bool TargetInfoX86::interleaveVectors(IRBuilder<> &B,
+                                      MutableArrayRef<Value *> Vectors,
+                                      bool Forward) const {
+  if (Vectors.size() != 3) {
+    return TargetInfo::interleaveVectors(B, Vectors, Forward);
+  }
+
+  auto *VecTy = dyn_cast<FixedVectorType>(Vectors[0]->getType());
+  VECZ_FAIL_IF(!VecTy);
+  VECZ_FAIL_IF(Vectors[1]->getType() != VecTy ||
+               Vectors[2]->getType() != VecTy);
+  const unsigned Width = VecTy->getNumElements();
+  const StringRef Name = Forward ? "interleave" : "deinterleave";
+
+  // Concatenate the vectors into two of twice the width, padding the second
+  // one, so every element of the three vectors can be picked by shuffling the
+  // pair with its index into the concatenation.
+  SmallVector<int, 16> ConcatMask;
+  SmallVector<int, 16> PadMask;
+  for (unsigned i = 0; i < Width; i++) {
+    ConcatMask.push_back(i);
+    PadMask.push_back(i);
+  }
+  for (unsigned i = 0; i < Width; i++) {
+    ConcatMask.push_back(Width + i);
+    PadMask.push_back(-1);
+  }
+  Value *Lo = B.CreateShuffleVector(Vectors[0], Vectors[1], ConcatMask, Name);
+  Value *Hi = B.CreateShuffleVector(Vectors[2], PadMask, Name);
+
+  SmallVector<int, 16> Mask(Width);
+  for (unsigned i = 0; i < 3; i++) {
+    for (unsigned j = 0; j < Width; j++) {
+      if (Forward) {
+        // Element j of the i'th contiguous vector is lane Index / 3 of vector
+        // Index % 3.
+        const unsigned Index = i * Width + j;
+        Mask[j] = (Index % 3) * Width + Index / 3;
+      } else {
+        // Lane j of the i'th vector is element 3 * j + i of the contiguous
+        // vectors.
+        Mask[j] = 3 * j + i;
+      }
+    }
+    Vectors[i] = B.CreateShuffleVector(Lo, Hi, Mask, Name);
+  }
+  return true;
+}
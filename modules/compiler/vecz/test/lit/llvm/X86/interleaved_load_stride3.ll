@@ -0,0 +1,54 @@
+; Copyright (C) Codeplay Software Limited
+;
+; Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+; Exceptions; you may not use this file except in compliance with the License.
+; You may obtain a copy of the License at
+;
+;     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+;
+; Unless required by applicable law or agreed to in writing, software
+; distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+; WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+; License for the specific language governing permissions and limitations
+; under the License.
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: veczc -vecz-target-triple=x86_64-unknown-unknown -vecz-target-features=+avx2 -vecz-simd-width=4 -S < %s | FileCheck %s
+
+target triple = "spir64-unknown-unknown"
+target datalayout = "e-p:64:64:64-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+; Three-way interleaved loads, as in RGB pixels, are loaded contiguously and
+; de-interleaved with shuffles rather than gathered.
+define spir_kernel void @grey(ptr addrspace(1) %out, ptr addrspace(1) %in) {
+entry:
+  %gid = tail call i64 @__mux_get_global_id(i32 0)
+  %base = mul nsw i64 %gid, 3
+  %r.ptr = getelementptr inbounds float, ptr addrspace(1) %in, i64 %base
+  %r = load float, ptr addrspace(1) %r.ptr, align 4
+  %g.ptr = getelementptr inbounds float, ptr addrspace(1) %r.ptr, i64 1
+  %g = load float, ptr addrspace(1) %g.ptr, align 4
+  %b.ptr = getelementptr inbounds float, ptr addrspace(1) %r.ptr, i64 2
+  %b = load float, ptr addrspace(1) %b.ptr, align 4
+  %rg = fadd float %r, %g
+  %rgb = fadd float %rg, %b
+  %out.ptr = getelementptr inbounds float, ptr addrspace(1) %out, i64 %gid
+  store float %rgb, ptr addrspace(1) %out.ptr, align 4
+  ret void
+}
+
+declare i64 @__mux_get_global_id(i32)
+
+; CHECK: define spir_kernel void @__vecz_v4_grey
+; CHECK: load <4 x float>
+; CHECK: load <4 x float>
+; CHECK: load <4 x float>
+; CHECK-NOT: load <4 x float>
+; CHECK-NOT: call <4 x float> @__vecz_b_interleaved_load
+; CHECK-NOT: call <4 x float> @__vecz_b_gather_load
+; CHECK-NOT: call <4 x float> @llvm.masked.gather
+; CHECK: %deinterleave{{[0-9]*}} = shufflevector <8 x float> %{{.+}}, <8 x float> %{{.+}}, <4 x i32> <i32 0, i32 3, i32 6, i32 9>
+; CHECK: %deinterleave{{[0-9]*}} = shufflevector <8 x float> %{{.+}}, <8 x float> %{{.+}}, <4 x i32> <i32 1, i32 4, i32 7, i32 10>
+; CHECK: %deinterleave{{[0-9]*}} = shufflevector <8 x float> %{{.+}}, <8 x float> %{{.+}}, <4 x i32> <i32 2, i32 5, i32 8, i32 11>
+; CHECK: ret void
@@ -0,0 +1,54 @@
+; Copyright (C) Codeplay Software Limited
+;
+; Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+; Exceptions; you may not use this file except in compliance with the License.
+; You may obtain a copy of the License at
+;
+;     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+;
+; Unless required by applicable law or agreed to in writing, software
+; distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+; WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+; License for the specific language governing permissions and limitations
+; under the License.
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: veczc -vecz-target-triple=x86_64-unknown-unknown -vecz-target-features=+avx2 -vecz-simd-width=4 -S < %s | FileCheck %s
+
+target triple = "spir64-unknown-unknown"
+target datalayout = "e-p:64:64:64-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+; Three-way interleaved stores are interleaved with shuffles and stored
+; contiguously rather than scattered.
+define spir_kernel void @splat_rgb(ptr addrspace(1) %out, ptr addrspace(1) %in) {
+entry:
+  %gid = tail call i64 @__mux_get_global_id(i32 0)
+  %in.ptr = getelementptr inbounds float, ptr addrspace(1) %in, i64 %gid
+  %v = load float, ptr addrspace(1) %in.ptr, align 4
+  %g = fmul float %v, 2.0
+  %b = fmul float %v, 3.0
+  %base = mul nsw i64 %gid, 3
+  %r.ptr = getelementptr inbounds float, ptr addrspace(1) %out, i64 %base
+  store float %v, ptr addrspace(1) %r.ptr, align 4
+  %g.ptr = getelementptr inbounds float, ptr addrspace(1) %r.ptr, i64 1
+  store float %g, ptr addrspace(1) %g.ptr, align 4
+  %b.ptr = getelementptr inbounds float, ptr addrspace(1) %r.ptr, i64 2
+  store float %b, ptr addrspace(1) %b.ptr, align 4
+  ret void
+}
+
+declare i64 @__mux_get_global_id(i32)
+
+; CHECK: define spir_kernel void @__vecz_v4_splat_rgb
+; CHECK-NOT: call void @__vecz_b_interleaved_store
+; CHECK-NOT: call void @__vecz_b_scatter_store
+; CHECK-NOT: call void @llvm.masked.scatter
+; CHECK: %interleave{{[0-9]*}} = shufflevector <8 x float> %{{.+}}, <8 x float> %{{.+}}, <4 x i32> <i32 0, i32 4, i32 8, i32 1>
+; CHECK: %interleave{{[0-9]*}} = shufflevector <8 x float> %{{.+}}, <8 x float> %{{.+}}, <4 x i32> <i32 5, i32 9, i32 2, i32 6>
+; CHECK: %interleave{{[0-9]*}} = shufflevector <8 x float> %{{.+}}, <8 x float> %{{.+}}, <4 x i32> <i32 10, i32 3, i32 7, i32 11>
+; CHECK: store <4 x float>
+; CHECK: store <4 x float>
+; CHECK: store <4 x float>
+; CHECK-NOT: store <4 x float>
+; CHECK: ret void
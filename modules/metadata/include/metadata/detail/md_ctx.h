@@ -26,6 +26,10 @@
 #include <metadata/detail/metadata_impl.h>
 #include <metadata/detail/utils.h>
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 namespace md {
 /// @addtogroup md
 /// @{
@@ -44,6 +48,8 @@ class basic_context {
   // Using shared_ptr due to limitation with allocator aware make_unique()
   // (see P0211)
   using map_t = basic_map<string_t, std::shared_ptr<stack_t>, AllocatorType>;
+  using block_info_list_t =
+      std::vector<CAMD_BlockInfo, AllocatorType<CAMD_BlockInfo>>;
 
   /// @brief Construct a new basic context object.
   ///
@@ -55,6 +61,7 @@ class basic_context {
         userdata(userdata),
         alloc(hooks, userdata),
         stack_map(alloc),
+        pending_blocks(alloc.template get_allocator<CAMD_BlockInfo>()),
         endianness(utils::get_mach_endianness()) {}
 
   /// @brief Default virtual destructor for inheritance.
@@ -67,9 +74,20 @@ class basic_context {
   /// MD_E_STACK_NOT_REGISTERED.
   cargo::expected<stack_t *, md_err> get_block(const char *name) {
     const string_t stack_name(name, alloc.template get_allocator<char>());
-    const auto it = stack_map.find(stack_name);
+    auto it = stack_map.find(stack_name);
     if (it == stack_map.end()) {
-      return cargo::make_unexpected(md_err::MD_E_STACK_NOT_REGISTERED);
+      // Blocks read from a binary are only deserialized on first access.
+      const auto pending = find_pending_block(name);
+      if (pending == pending_blocks.end()) {
+        return cargo::make_unexpected(md_err::MD_E_STACK_NOT_REGISTERED);
+      }
+      const CAMD_BlockInfo info = *pending;
+      pending_blocks.erase(pending);
+      const md_err err = add_block_from_block_info(info, bin_start, endianness);
+      if (MD_CHECK_ERR(err)) {
+        return cargo::make_unexpected(err);
+      }
+      it = stack_map.find(stack_name);
     }
     return it->second.get();
   }
@@ -81,6 +99,9 @@ class basic_context {
   /// MD_E_STACK_ALREADY_REGISTERED if a stack with the name already exists in
   /// this context.
   cargo::expected<stack_t *, md_err> create_block(const char *name) {
+    if (find_pending_block(name) != pending_blocks.end()) {
+      return cargo::make_unexpected(md_err::MD_E_STACK_ALREADY_REGISTERED);
+    }
     const string_t stack_name(name, alloc.template get_allocator<char>());
     const stack_t stack(alloc);
     const std::pair<typename map_t::iterator, bool> in = stack_map.insert(
@@ -123,11 +144,21 @@ class basic_context {
   ///
   /// @return MD_SUCCESS if completed successfully, otherwise an appropriate
   /// error code is returned.
-  md_err finalize() const {
+  md_err finalize() {
     if (!hooks->write || !hooks->finalize) {
       return md_err::MD_E_NO_HOOKS;
     }
 
+    // Any blocks read from a binary but never accessed must still be written.
+    while (!pending_blocks.empty()) {
+      const CAMD_BlockInfo info = pending_blocks.back();
+      pending_blocks.pop_back();
+      const md_err err = add_block_from_block_info(info, bin_start, endianness);
+      if (MD_CHECK_ERR(err)) {
+        return err;
+      }
+    }
+
     // Since the string table is of variable length, we instead compute offsets
     // from the end of the binary (which is fixed), only after we know the
     // length of the string table we can update the offsets to point from the
@@ -208,6 +239,10 @@ class basic_context {
 
   /// @brief Decode from a correctly formatted metadata binary.
   ///
+  /// Only the header and block list are validated here, the blocks themselves
+  /// are deserialized lazily by `get_block`. The pointer returned by the `map`
+  /// hook must therefore remain valid for the lifetime of the context.
+  ///
   /// @return MD_SUCCESS is returned if the decoding of the binary completed
   /// successfully. MD_NO_HOOKS is returned if there is no user-supplied `map`
   /// hook. MD_INVALID_BINARY is returned when the provided binary is not in a
@@ -218,8 +253,7 @@ class basic_context {
     }
 
     size_t bin_size;
-    const uint8_t *bin_start =
-        static_cast<const uint8_t *>(hooks->map(userdata, &bin_size));
+    bin_start = static_cast<const uint8_t *>(hooks->map(userdata, &bin_size));
 
     // Decode the header.
     CAMD_Header header;
@@ -230,22 +264,27 @@ class basic_context {
     }
     endianness = static_cast<MD_ENDIAN>(header.endianness);
 
-    // Decode the block infos.
-    std::vector<CAMD_BlockInfo> infos;
-    const auto infos_err = utils::decode_md_block_info_list(
-        utils::get_block_list_start(bin_start, header), header, infos,
-        bin_size);
-    if (!infos_err.has_value()) {
+    // Decode the block infos, deferring deserialization of the blocks.
+    if (!utils::is_block_list_in_range(header, bin_size)) {
       return md_err::MD_E_INVALID_BINARY;
     }
-
-    // Register each block into the context
-    for (auto info : infos) {
-      const md_err block_info_err =
-          add_block_from_block_info(info, bin_start, endianness);
-      if (MD_CHECK_ERR(block_info_err)) {
+    const uint8_t *block_list_start =
+        utils::get_block_list_start(bin_start, header);
+    pending_blocks.reserve(header.n_blocks);
+    for (size_t i = 0; i < header.n_blocks; ++i) {
+      CAMD_BlockInfo info;
+      const auto info_err = utils::decode_md_block_info(
+          &block_list_start[i * MD_BLOCK_INFO_SIZE], header, info, bin_size);
+      if (!info_err.has_value() || !utils::get_fmt(info.flags).has_value() ||
+          !utils::is_block_info_name_valid(bin_start, header, info)) {
+        return md_err::MD_E_INVALID_BINARY;
+      }
+      // Block names must be unique.
+      if (find_pending_block(utils::get_block_info_name(bin_start, info)) !=
+          pending_blocks.end()) {
         return md_err::MD_E_INVALID_BINARY;
       }
+      pending_blocks.push_back(info);
     }
     return md_err::MD_SUCCESS;
   }
@@ -256,6 +295,20 @@ class basic_context {
   MD_ENDIAN get_endianness() { return endianness; }
 
  private:
+  /// @brief Find a block which has been read from a binary but not yet
+  /// deserialized.
+  ///
+  /// @param name The name of the block to find.
+  /// @return An iterator to the block's info, or `pending_blocks.end()`.
+  typename block_info_list_t::iterator find_pending_block(const char *name) {
+    return std::find_if(pending_blocks.begin(), pending_blocks.end(),
+                        [&](const CAMD_BlockInfo &info) {
+                          return std::strcmp(utils::get_block_info_name(
+                                                 bin_start, info),
+                                             name) == 0;
+                        });
+  }
+
   /// @brief Add a block to the metadata context using a BlockInfo.
   ///
   /// @param info The Block Info from which to add the block.
@@ -311,6 +364,10 @@ class basic_context {
   void *userdata;
   allocator_helper_t alloc;
   map_t stack_map;
+  /// @brief Blocks of the mapped binary which are yet to be deserialized.
+  block_info_list_t pending_blocks;
+  /// @brief Start of the binary returned by the `map` hook, if any.
+  const uint8_t *bin_start = nullptr;
   MD_ENDIAN endianness;
 };
 
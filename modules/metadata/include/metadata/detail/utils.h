@@ -64,6 +64,14 @@ cargo::expected<int, std::string> decode_md_header(const uint8_t *header_start,
                                                    CAMD_Header &header,
                                                    size_t bin_size);
 
+/// @brief Check the block info list described by a header lies within the
+/// binary.
+///
+/// @param header Reference to a decoded header.
+/// @param bin_size The total size of the binary.
+/// @return true if the block info list is in range, false otherwise.
+bool is_block_list_in_range(const CAMD_Header &header, size_t bin_size);
+
 /// @brief Get a pointer to the start of the block info list.
 ///
 /// @param data Pointer to the start of the binary.
@@ -110,6 +118,17 @@ cargo::expected<int, std::string> decode_md_block_info_list(
     const uint8_t *block_list_start, const CAMD_Header &header,
     std::vector<CAMD_BlockInfo> &blocks, size_t bin_size);
 
+/// @brief Check the name of a block is zero-terminated within the string
+/// table.
+///
+/// @param binary_data Pointer to the start of the binary.
+/// @param header Reference to a decoded header.
+/// @param bi Initialized block info reference.
+/// @return true if the name is valid, false otherwise.
+bool is_block_info_name_valid(const uint8_t *binary_data,
+                              const CAMD_Header &header,
+                              const CAMD_BlockInfo &bi);
+
 /// @brief Get the name of a block.
 ///
 /// @param binary_data Pointer to the start of the binary.
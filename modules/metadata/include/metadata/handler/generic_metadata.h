@@ -58,6 +58,10 @@ class GenericMetadataHandler {
 
   /// @brief Initialize the metadata context.
   ///
+  /// If `hooks` provides a `map` callback the handler is initialized for
+  /// reading, in which case kernel entries are decoded in place from the
+  /// mapped binary by `read` and no context is created.
+  ///
   /// @param hooks Hooks forwarded to the context.
   /// @param userdata Userdata passed to the context.
   /// @return true if the context is initialized successfully, false otherwise.
@@ -81,13 +85,19 @@ class GenericMetadataHandler {
   bool write(const GenericMetadata &md);
 
  protected:
+  /// @brief Find a raw bytes block within the binary mapped by `hooks`.
+  ///
+  /// @param name The name of the block.
+  /// @param[out] view The view of the block to fill in.
+  /// @return true if the block was found, false otherwise.
+  bool mapBlock(const char *name, md_block_view &view);
+
   md_ctx ctx = nullptr;
   md_hooks *hooks = nullptr;
   void *userdata = nullptr;
 
  private:
-  char *data = nullptr;
-  size_t data_len = 0;
+  md_block_view block{};
   size_t offset = 0;
 };
 
@@ -78,8 +78,7 @@ class VectorizeInfoMetadataHandler : GenericMetadataHandler {
   bool write(const VectorizeInfoMetadata &md);
 
  private:
-  char *vec_data = nullptr;
-  size_t vec_data_len = 0;
+  md_block_view vec_block{};
   size_t vec_offset = 0;
 };
 
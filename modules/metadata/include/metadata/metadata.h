@@ -227,6 +227,36 @@ enum md_value_type {
 /// @brief Represents valid endian encoding in the metadata binary format.
 enum MD_ENDIAN : uint8_t { LITTLE = 0x01, BIG = 0x02 };
 
+/// @brief A serialized block referenced in place within a metadata binary.
+struct md_block_view {
+  /// @brief Pointer to the start of the block's serialized data.
+  const void *data;
+  /// @brief The length (in bytes) of the block's serialized data.
+  size_t size;
+  /// @brief The serialization format of the block.
+  enum md_fmt fmt;
+  /// @brief The endianness with which the block was serialized.
+  enum MD_ENDIAN endianness;
+};
+
+/// @brief Find a named block within a serialized metadata binary without
+/// creating a context.
+///
+/// Only the header and the block list are validated, no block is deserialized
+/// and no memory is allocated. The returned view points into `binary`, which
+/// must outlive any use of it. This is the preferred way for a consumer which
+/// only needs the serialized bytes of a single block, e.g. for reading a
+/// `MD_FMT_RAW_BYTES` block in place.
+///
+/// @param binary Pointer to the start of the metadata binary.
+/// @param binary_len The length (in bytes) of the metadata binary.
+/// @param name The zero-terminated name of the block to find.
+/// @param view The view to be filled in.
+/// @return MD_SUCCESS if the block was found, MD_E_STACK_NOT_REGISTERED if
+/// the binary does not contain the block, or MD_E_INVALID_BINARY.
+int md_find_block(const void *binary, size_t binary_len, const char *name,
+                  struct md_block_view *view);
+
 /// @brief Get the tag type of value.
 ///
 /// @param val The value to be queried.
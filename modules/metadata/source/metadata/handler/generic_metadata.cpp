@@ -17,6 +17,8 @@
 #include <metadata/detail/utils.h>
 #include <metadata/handler/generic_metadata.h>
 
+#include <cstring>
+
 namespace handler {
 
 GenericMetadata::GenericMetadata(std::string kernel_name,
@@ -39,18 +41,15 @@ GenericMetadataHandler::~GenericMetadataHandler() {
   if (ctx) {
     md_release_ctx(ctx);
   }
-  if (data) {
-    if (hooks && hooks->deallocate) {
-      hooks->deallocate(data, userdata);
-    } else {
-      std::free(data);
-    }
-  }
 }
 
 bool GenericMetadataHandler::init(md_hooks *hooks, void *userdata) {
   this->hooks = hooks;
   this->userdata = userdata;
+  if (hooks->map) {
+    return mapBlock(GENERIC_MD_BLOCK_NAME, block);
+  }
+
   ctx = md_init(hooks, userdata);
   if (!ctx) {
     return false;
@@ -62,14 +61,16 @@ bool GenericMetadataHandler::init(md_hooks *hooks, void *userdata) {
       return false;
     }
   }
+  return true;
+}
 
-  if (hooks->map) {
-    const int err = md_loadf(generic_stack, "s", &data_len, &data);
-    if (MD_CHECK_ERR(err)) {
-      return false;
-    }
+bool GenericMetadataHandler::mapBlock(const char *name, md_block_view &view) {
+  size_t binary_len = 0;
+  const void *binary = hooks->map(userdata, &binary_len);
+  if (md_find_block(binary, binary_len, name, &view) != MD_SUCCESS) {
+    return false;
   }
-  return true;
+  return view.fmt == md_fmt::MD_FMT_RAW_BYTES;
 }
 
 bool GenericMetadataHandler::finalize() {
@@ -89,31 +90,46 @@ bool GenericMetadataHandler::finalize() {
 }
 
 bool GenericMetadataHandler::read(GenericMetadata &md) {
-  if (offset >= data_len) {
+  if (offset >= block.size) {
     return false;
   }
+  const auto *data = static_cast<const char *>(block.data);
+
+  // Entries are decoded directly from the mapped binary, so validate the
+  // lengths of the strings against the block before reading them.
+  const char *kernel_name = data + offset;
+  const char *kernel_name_end = static_cast<const char *>(
+      std::memchr(kernel_name, '\0', block.size - offset));
+  if (!kernel_name_end) {
+    return false;
+  }
+  offset = (kernel_name_end - data) + 1;
 
-  std::string kernel_name(data + offset);
-  offset += kernel_name.size() + 1;
-
-  std::string source_name(data + offset);
-  offset += source_name.size() + 1;
+  const char *source_name = data + offset;
+  const char *source_name_end = static_cast<const char *>(
+      std::memchr(source_name, '\0', block.size - offset));
+  if (!source_name_end) {
+    return false;
+  }
+  offset = (source_name_end - data) + 1;
 
-  const uint64_t local_memory_used = md::utils::read_value<uint64_t>(
-      (uint8_t *)data + offset, md_get_endianness(ctx));
-  offset += sizeof(uint64_t);
+  if (block.size - offset < 3 * sizeof(uint64_t)) {
+    return false;
+  }
+  const auto *values = reinterpret_cast<const uint8_t *>(data + offset);
+  const uint64_t local_memory_used =
+      md::utils::read_value<uint64_t>(values, block.endianness);
 
   // We only use the low 4 bytes of this value, even though it's encoded as 8.
   const uint32_t sub_group_size_fixed = md::utils::read_value<uint64_t>(
-      (uint8_t *)data + offset, md_get_endianness(ctx));
-  offset += sizeof(uint64_t);
+      values + sizeof(uint64_t), block.endianness);
   const bool sub_group_size_is_scalable =
-      md::utils::read_value<uint64_t>((uint8_t *)data + offset,
-                                      md_get_endianness(ctx)) == 1;
-  offset += sizeof(uint64_t);
+      md::utils::read_value<uint64_t>(values + 2 * sizeof(uint64_t),
+                                      block.endianness) == 1;
+  offset += 3 * sizeof(uint64_t);
 
-  md.kernel_name = std::move(kernel_name);
-  md.source_name = std::move(source_name);
+  md.kernel_name.assign(kernel_name, kernel_name_end);
+  md.source_name.assign(source_name, source_name_end);
   md.local_memory_usage = local_memory_used;
   md.sub_group_size = FixedOrScalableQuantity<uint32_t>(
       sub_group_size_fixed, sub_group_size_is_scalable);
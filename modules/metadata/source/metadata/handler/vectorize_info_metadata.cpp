@@ -34,7 +34,7 @@ bool push(md_stack stack, FixedOrScalableQuantity<uint32_t> q) {
   return true;
 }
 
-FixedOrScalableQuantity<uint32_t> read_quantity(uint8_t *&data,
+FixedOrScalableQuantity<uint32_t> read_quantity(const uint8_t *&data,
                                                 MD_ENDIAN endianness) {
   const uint32_t quantity = md::utils::read_value<uint64_t>(data, endianness);
   data += sizeof(uint64_t);
@@ -60,20 +60,16 @@ VectorizeInfoMetadata::VectorizeInfoMetadata(
       min_work_item_factor(min_wi_factor),
       pref_work_item_factor(pref_wi_factor) {}
 
-VectorizeInfoMetadataHandler::~VectorizeInfoMetadataHandler() {
-  if (vec_data) {
-    if (hooks && hooks->deallocate) {
-      hooks->deallocate(vec_data, userdata);
-    } else {
-      std::free(vec_data);
-    }
-  }
-}
+VectorizeInfoMetadataHandler::~VectorizeInfoMetadataHandler() = default;
 
 bool VectorizeInfoMetadataHandler::init(md_hooks *hooks, void *userdata) {
   if (!GenericMetadataHandler::init(hooks, userdata)) {
     return false;
   }
+  if (hooks->map) {
+    return mapBlock(VECTORIZE_MD_BLOCK_NAME, vec_block);
+  }
+
   md_stack vectorize_stack = md_get_block(ctx, VECTORIZE_MD_BLOCK_NAME);
   if (!vectorize_stack) {
     vectorize_stack = md_create_block(ctx, VECTORIZE_MD_BLOCK_NAME);
@@ -81,13 +77,6 @@ bool VectorizeInfoMetadataHandler::init(md_hooks *hooks, void *userdata) {
       return false;
     }
   }
-
-  if (hooks->map) {
-    const int err = md_loadf(vectorize_stack, "s", &vec_data_len, &vec_data);
-    if (MD_CHECK_ERR(err)) {
-      return false;
-    }
-  }
   return true;
 }
 
@@ -107,17 +96,21 @@ bool VectorizeInfoMetadataHandler::read(VectorizeInfoMetadata &md) {
   if (!GenericMetadataHandler::read(md)) {
     return false;
   }
-  if (vec_offset >= vec_data_len) {
-    return 0;
+  // Each entry is a pair of quantities, each encoded as two 64-bit values.
+  constexpr size_t entry_size = 4 * sizeof(uint64_t);
+  if (vec_offset >= vec_block.size ||
+      vec_block.size - vec_offset < entry_size) {
+    return false;
   }
 
-  uint8_t *ptr = (uint8_t *)vec_data + vec_offset;
+  const auto *data = static_cast<const uint8_t *>(vec_block.data);
+  const uint8_t *ptr = data + vec_offset;
 
-  md.min_work_item_factor = read_quantity(ptr, md_get_endianness(ctx));
+  md.min_work_item_factor = read_quantity(ptr, vec_block.endianness);
 
-  md.pref_work_item_factor = read_quantity(ptr, md_get_endianness(ctx));
+  md.pref_work_item_factor = read_quantity(ptr, vec_block.endianness);
 
-  vec_offset = std::distance((uint8_t *)vec_data, ptr);
+  vec_offset = std::distance(data, ptr);
 
   return true;
 }
@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <cstdarg>
+#include <cstring>
 #include <stack>
 
 md_ctx md_init(md_hooks *hooks, void *userdata) {
@@ -114,6 +115,47 @@ int md_hashtable_setkv(md_stack stack, int table_idx, int key_idx,
   return kv_idx.value_or(kv_idx.error());
 }
 
+int md_find_block(const void *binary, size_t binary_len, const char *name,
+                  md_block_view *view) {
+  const auto *bin_start = static_cast<const uint8_t *>(binary);
+  if (!binary) {
+    return md_err::MD_E_INVALID_BINARY;
+  }
+  md::CAMD_Header header;
+  const auto header_err =
+      md::utils::decode_md_header(bin_start, header, binary_len);
+  if (!header_err.has_value() ||
+      !md::utils::is_block_list_in_range(header, binary_len)) {
+    return md_err::MD_E_INVALID_BINARY;
+  }
+
+  const uint8_t *block_list_start =
+      md::utils::get_block_list_start(bin_start, header);
+  for (size_t i = 0; i < header.n_blocks; ++i) {
+    md::CAMD_BlockInfo info;
+    const auto info_err = md::utils::decode_md_block_info(
+        &block_list_start[i * md::MD_BLOCK_INFO_SIZE], header, info,
+        binary_len);
+    if (!info_err.has_value() ||
+        !md::utils::is_block_info_name_valid(bin_start, header, info)) {
+      return md_err::MD_E_INVALID_BINARY;
+    }
+    if (std::strcmp(md::utils::get_block_info_name(bin_start, info), name)) {
+      continue;
+    }
+    const auto fmt = md::utils::get_fmt(info.flags);
+    if (!fmt.has_value()) {
+      return md_err::MD_E_INVALID_BINARY;
+    }
+    view->data = md::utils::get_block_start(bin_start, info);
+    view->size = info.size;
+    view->fmt = fmt.value();
+    view->endianness = static_cast<MD_ENDIAN>(header.endianness);
+    return md_err::MD_SUCCESS;
+  }
+  return md_err::MD_E_STACK_NOT_REGISTERED;
+}
+
 md_stack md_get_block(md_ctx ctx, const char *name) {
   const auto block = ctx->get_block(name);
   if (!block.has_value()) {
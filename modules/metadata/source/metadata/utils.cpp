@@ -71,6 +71,13 @@ cargo::expected<int, std::string> decode_md_header(const uint8_t *header_start,
   return md_err::MD_SUCCESS;
 }
 
+bool is_block_list_in_range(const CAMD_Header &header, size_t bin_size) {
+  const uint64_t block_list_end =
+      header.block_list_offset +
+      (static_cast<uint64_t>(MD_BLOCK_INFO_SIZE) * header.n_blocks);
+  return block_list_end <= bin_size;
+}
+
 const uint8_t *get_block_list_start(const uint8_t *data,
                                     const CAMD_Header &header) {
   return data + header.block_list_offset;
@@ -143,6 +150,16 @@ cargo::expected<int, std::string> decode_md_block_info_list(
   return md_err::MD_SUCCESS;
 }
 
+bool is_block_info_name_valid(const uint8_t *binary_data,
+                              const CAMD_Header &header,
+                              const CAMD_BlockInfo &bi) {
+  if (bi.name_idx < MD_HEADER_SIZE || bi.name_idx >= header.block_list_offset) {
+    return false;
+  }
+  return std::memchr(binary_data + bi.name_idx, '\0',
+                     header.block_list_offset - bi.name_idx) != nullptr;
+}
+
 const char *get_block_info_name(const uint8_t *binary_data,
                                 const CAMD_BlockInfo &bi) {
   return reinterpret_cast<const char *>(binary_data + bi.name_idx);
@@ -680,3 +680,59 @@ TEST_F(MDAllocatorTest, DecodeInvalidBinary) {
   md_ctx ctx = md_init(&hooks, &userdata);
   ASSERT_EQ(ctx, nullptr);
 }
+
+TEST_F(MDAllocatorTest, DecodeBinaryLazily) {
+  hooks.map = [](const void *, size_t *n) -> const void * {
+    *n = sizeof(example_md_bin);
+    return &example_md_bin[0];
+  };
+
+  md_ctx ctx = md_init(&hooks, &userdata);
+  ASSERT_NE(ctx, nullptr);
+
+  // Blocks which are yet to be deserialized are still registered.
+  EXPECT_EQ(md_create_block(ctx, "host_md"), nullptr);
+
+  md_stack host_md = md_get_block(ctx, "host_md");
+  ASSERT_NE(host_md, nullptr);
+  EXPECT_EQ(md_get_block(ctx, "host_md"), host_md);
+  EXPECT_EQ(md_get_block(ctx, "device_md"), nullptr);
+
+  md_release_ctx(ctx);
+}
+
+TEST(MDApiFindBlockTest, FindBlock) {
+  md_block_view view;
+  ASSERT_EQ(md_find_block(example_md_bin, sizeof(example_md_bin), "compiler",
+                          &view),
+            md_err::MD_SUCCESS);
+  EXPECT_EQ(view.data, &example_md_bin[0x58]);
+  EXPECT_EQ(view.size, 20);
+  EXPECT_EQ(view.fmt, md_fmt::MD_FMT_RAW_BYTES);
+  EXPECT_EQ(view.endianness, MD_ENDIAN::BIG);
+
+  ASSERT_EQ(md_find_block(example_md_bin, sizeof(example_md_bin), "host_md",
+                          &view),
+            md_err::MD_SUCCESS);
+  EXPECT_EQ(view.data, &example_md_bin[0x70]);
+  EXPECT_EQ(view.size, 14);
+}
+
+TEST(MDApiFindBlockTest, FindNonExistentBlock) {
+  md_block_view view;
+  EXPECT_EQ(md_find_block(example_md_bin, sizeof(example_md_bin), "device_md",
+                          &view),
+            md_err::MD_E_STACK_NOT_REGISTERED);
+}
+
+TEST(MDApiFindBlockTest, FindBlockInvalidBinary) {
+  md_block_view view;
+  EXPECT_EQ(md_find_block(nullptr, 0, "compiler", &view),
+            md_err::MD_E_INVALID_BINARY);
+  // Truncate the binary part way through the block list.
+  EXPECT_EQ(md_find_block(example_md_bin, 0x30, "compiler", &view),
+            md_err::MD_E_INVALID_BINARY);
+  // Truncate the binary part way through the "host_md" block.
+  EXPECT_EQ(md_find_block(example_md_bin, 0x78, "host_md", &view),
+            md_err::MD_E_INVALID_BINARY);
+}
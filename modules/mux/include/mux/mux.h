@@ -37,7 +37,7 @@ extern "C" {
 /// @brief Mux major version number.
 #define MUX_MAJOR_VERSION 0
 /// @brief Mux minor version number.
-#define MUX_MINOR_VERSION 80
+#define MUX_MINOR_VERSION 82
 /// @brief Mux patch version number.
 #define MUX_PATCH_VERSION 0
 /// @brief Mux combined version number.
@@ -1868,6 +1868,34 @@ mux_result_t muxCommandNDRange(mux_command_buffer_t command_buffer,
                                const mux_sync_point_t *sync_point_wait_list,
                                mux_sync_point_t *sync_point);
 
+/// @brief Push an N-Dimensional run command, whose work-group counts are read
+/// from a buffer when it executes, to the command buffer.
+///
+/// @param[in] command_buffer The command buffer to push the N-Dimensional run
+/// command to.
+/// @param[in] kernel The kernel to execute.
+/// @param[in] options The execution options to use during the run command,
+/// `global_size` is ignored.
+/// @param[in] group_count_buffer The buffer containing the number of
+/// work-groups to execute in each dimension, as `options.dimensions`
+/// `uint32_t` values.
+/// @param[in] group_count_offset The offset in bytes into group_count_buffer of
+/// the work-group counts.
+/// @param[in] num_sync_points_in_wait_list Number of items in
+/// sync_point_wait_list.
+/// @param[in] sync_point_wait_list List of sync-points that need to complete
+/// before this command can be executed.
+/// @param[out] sync_point Returns a sync-point identifying this command, which
+/// may be passed as NULL, that other commands in the command-buffer can wait
+/// on.
+///
+/// @return mux_success, or a mux_error_* if an error occurred.
+mux_result_t muxCommandNDRangeIndirect(
+    mux_command_buffer_t command_buffer, mux_kernel_t kernel,
+    mux_ndrange_options_t options, mux_buffer_t group_count_buffer,
+    uint64_t group_count_offset, uint32_t num_sync_points_in_wait_list,
+    const mux_sync_point_t *sync_point_wait_list, mux_sync_point_t *sync_point);
+
 /// @brief Update arguments to an N-Dimensional run command within the command
 /// buffer.
 ///
@@ -2395,6 +2423,13 @@ struct mux_device_info_s {
   /// @brief List of sub-group sizes supported by the device, sized by
   /// num_sub_group_sizes.
   size_t *sub_group_sizes;
+  /// @brief If `true` the device supports reading the work-group counts of
+  /// N-Dimensional run commands from a buffer via the
+  /// `muxCommandNDRangeIndirect` entry point.
+  bool supports_indirect_ndrange;
+  /// @brief If `true` command buffers dispatched to a queue which do not wait
+  /// on each other through semaphores may execute concurrently.
+  bool supports_concurrent_dispatch;
 };
 
 /// @brief Mux's device container.
@@ -1102,6 +1102,57 @@ mux_result_t muxCommandNDRange(mux_command_buffer_t command_buffer,
   return error;
 }
 
+mux_result_t muxCommandNDRangeIndirect(
+    mux_command_buffer_t command_buffer, mux_kernel_t kernel,
+    mux_ndrange_options_t options, mux_buffer_t group_count_buffer,
+    uint64_t group_count_offset, uint32_t num_sync_points_in_wait_list,
+    const mux_sync_point_t *sync_point_wait_list,
+    mux_sync_point_t *sync_point) {
+  const tracer::TraceGuard<tracer::Mux> guard(__func__);
+
+  if (mux::objectIsInvalid(command_buffer)) {
+    return mux_error_invalid_value;
+  }
+
+  if (!command_buffer->device->info->supports_indirect_ndrange) {
+    return mux_error_feature_unsupported;
+  }
+
+  if (mux::objectIsInvalid(kernel)) {
+    return mux_error_invalid_value;
+  }
+
+  if (mux::objectIsInvalid(group_count_buffer)) {
+    return mux_error_invalid_value;
+  }
+
+  if (options.dimensions == 0 || options.dimensions > 3) {
+    return mux_error_invalid_value;
+  }
+
+  // Check that the work-group counts fit in the buffer, and that they are
+  // aligned so that targets can read them directly.
+  if (group_count_offset % sizeof(uint32_t) ||
+      group_count_buffer->memory_requirements.size <
+          group_count_offset + (options.dimensions * sizeof(uint32_t))) {
+    return mux_error_invalid_value;
+  }
+
+  if (waitlistIsInvalid(num_sync_points_in_wait_list, sync_point_wait_list)) {
+    return mux_error_invalid_value;
+  }
+
+  const mux_result_t error = muxSelectCommandNDRangeIndirect(
+      command_buffer, kernel, options, group_count_buffer, group_count_offset,
+      num_sync_points_in_wait_list, sync_point_wait_list, sync_point);
+  if (mux_success == error && nullptr != sync_point) {
+    mux::setId<mux_object_id_sync_point>(command_buffer->device->info->id,
+                                         *sync_point);
+  }
+
+  return error;
+}
+
 mux_result_t muxUpdateDescriptors(mux_command_buffer_t command_buffer,
                                   mux_command_id_t command_id,
                                   uint64_t num_args, uint64_t *arg_indices,
@@ -0,0 +1,84 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+/// Host's per-thread work-group state arena.
+
+#ifndef HOST_ARENA_H_INCLUDED
+#define HOST_ARENA_H_INCLUDED
+
+#include <cstddef>
+
+namespace host {
+/// @addtogroup host
+/// @{
+
+/// @brief Scratch memory that kernels place their work-group state in.
+///
+/// Barrier live variables and `__local` buffers of large work-groups can
+/// easily exceed the stack of the threads that run them. Kernels built by the
+/// host compiler instead carve them out of the arena handed to them through
+/// `host::schedule_info_s`, only falling back to the stack when it is too
+/// small. Each thread owns one arena, which is reused by every kernel it runs
+/// and only ever grows.
+struct arena_s final {
+  /// @brief Alignment of the arena's memory, a cache line.
+  ///
+  /// NOTE: The host compiler's WorkGroupArenaPass relies on this alignment.
+  static constexpr size_t alignment = 64;
+
+  /// @brief Suffix of the symbol through which a kernel reports the arena
+  /// size it needs.
+  ///
+  /// NOTE: This must match the host compiler's ArenaSizeSymbolSuffix.
+  static constexpr const char size_symbol_suffix[] = ".arena-size";
+
+  /// @brief Size from which the arena is backed by transparent huge pages.
+  static constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+  arena_s() = default;
+  arena_s(const arena_s &) = delete;
+  arena_s &operator=(const arena_s &) = delete;
+  ~arena_s();
+
+  /// @brief Get the arena of the calling thread.
+  static arena_s &get();
+
+  /// @brief Grow the arena to at least `required` bytes.
+  ///
+  /// @param[in] required Number of bytes the arena must hold.
+  ///
+  /// @return Returns true if the arena holds at least `required` bytes, false
+  /// if it could not be grown in which case its previous memory is kept.
+  bool reserve(size_t required);
+
+  /// @brief The arena's memory, aligned to `alignment`.
+  void *data = nullptr;
+  /// @brief Size of `data` in bytes.
+  size_t size = 0;
+
+ private:
+  /// @brief Release the arena's memory.
+  void release();
+
+  /// @brief Whether `data` was mapped rather than allocated.
+  bool mapped = false;
+};
+
+/// @}
+}  // namespace host
+
+#endif  // HOST_ARENA_H_INCLUDED
@@ -23,49 +23,112 @@
 #include <cargo/expected.h>
 
 #include <array>
+#include <cstddef>
 #include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 #include "host/fence.h"
 #include "mux/mux.h"
-#include "mux/utils/dynamic_array.h"
 #include "mux/utils/small_vector.h"
 
 namespace host {
 /// @addtogroup host
 /// @{
 
+struct arg_layout_s;
+
+/// @brief Memory a command buffer owns for the state of its commands.
+///
+/// Allocations are bumped out of chunks which are kept when the command buffer
+/// is reset, so recording the same commands again does not allocate. Objects
+/// created in the arena are never destroyed, so must be trivially
+/// destructible.
+struct command_arena_s final {
+  explicit command_arena_s(mux_allocator_info_t allocator_info)
+      : allocator_info(allocator_info) {}
+  command_arena_s(const command_arena_s &) = delete;
+  command_arena_s &operator=(const command_arena_s &) = delete;
+  ~command_arena_s();
+
+  /// @brief Allocate memory from the arena.
+  ///
+  /// @param[in] size Size in bytes of the allocation.
+  /// @param[in] alignment Alignment in bytes of the allocation, a power of
+  /// two no larger than `alignof(std::max_align_t)`.
+  ///
+  /// @return Returns the allocation, or null if out of memory.
+  void *alloc(size_t size, size_t alignment);
+
+  /// @brief Create an object in the arena.
+  ///
+  /// @return Returns the object, or null if out of memory.
+  template <class T, class... Args>
+  T *create(Args &&...args) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "Objects in the arena are never destroyed");
+    void *const object = alloc(sizeof(T), alignof(T));
+    if (nullptr == object) {
+      return nullptr;
+    }
+    return new (object) T(std::forward<Args>(args)...);
+  }
+
+  /// @brief Release every allocation, keeping the memory for later ones.
+  void reset();
+
+ private:
+  /// @brief Header of a chunk, followed by the chunk's memory.
+  struct alignas(std::max_align_t) chunk_s {
+    /// @brief Next chunk, or null.
+    chunk_s *next;
+    /// @brief Size in bytes of the chunk's memory.
+    size_t size;
+  };
+
+  /// @brief Size of the first chunk, later chunks double in size.
+  static constexpr size_t min_chunk_size = 4096;
+
+  mux_allocator_info_t allocator_info;
+  /// @brief First chunk, or null if nothing was allocated yet.
+  chunk_s *chunks = nullptr;
+  /// @brief Chunk allocations are currently made from.
+  chunk_s *current = nullptr;
+  /// @brief Offset in bytes of the free memory in `current`.
+  size_t offset = 0;
+};
+
 /// @brief Struct that owns kernel args and schedule information for an ND
 /// range.
 ///
 /// This struct later gets cast to `void*` and passed to the lambda that threads
-/// in the threadpool execute to actually run the range.
+/// in the threadpool execute to actually run the range. It is created in the
+/// command buffer's `command_arena_s`.
 struct ndrange_info_s {
-  ndrange_info_s(void *packed_args,
-                 mux::dynamic_array<uint8_t *> &arg_addresses,
-                 mux::dynamic_array<mux_descriptor_info_t> &descriptors,
+  ndrange_info_s(void *packed_args, const arg_layout_s *arg_layout,
                  std::array<size_t, 3> global_size,
                  std::array<size_t, 3> global_offset,
                  std::array<size_t, 3> local_size, size_t dimensions)
       : packed_args(packed_args),
-        arg_addresses(std::move(arg_addresses)),
-        descriptors(std::move(descriptors)),
+        arg_layout(arg_layout),
         global_size(global_size),
         global_offset(global_offset),
         local_size(local_size),
         dimensions(dimensions) {}
 
+  /// @brief Alignment in bytes of the packed arguments.
+  static constexpr size_t packed_args_alignment = alignof(std::max_align_t);
+
   /// @brief Packed descriptors.
   void *packed_args;
 
-  /// @brief Addresses of arguments in packed descriptors.
+  /// @brief Layout of `packed_args`, owned by the kernel.
   ///
-  /// Recording this information is required when packedArgs is populated in
-  /// order to look up the address of the nth argument without knowing the sizes
-  /// of each of the previous arguments.
-  mux::dynamic_array<uint8_t *> arg_addresses;
-
-  /// @brief descriptors for each kernel argument
-  mux::dynamic_array<mux_descriptor_info_t> descriptors;
+  /// Recording this information is required in order to look up the address
+  /// of the nth argument without knowing the sizes of each of the previous
+  /// arguments.
+  const arg_layout_s *arg_layout;
 
   /// @brief Global size.
   std::array<size_t, 3> global_size;
@@ -79,9 +142,22 @@ struct ndrange_info_s {
   /// @brief Dimensions in the ND range.
   size_t dimensions;
 
-  /// @Brief Create a deep copy of the ndrange command
-  cargo::expected<std::unique_ptr<ndrange_info_s>, mux_result_t> clone(
-      mux_allocator_info_t allocator_info) const;
+  /// @brief Trace flow the ND range was enqueued on, or zero.
+  uint64_t trace_flow_id = 0;
+
+  /// @brief Buffer the work-group counts are read from when the ND range
+  /// executes, or null if `global_size` is used as is.
+  mux_buffer_t group_count_buffer = nullptr;
+
+  /// @brief Offset in bytes of the work-group counts in `group_count_buffer`.
+  uint64_t group_count_offset = 0;
+
+  /// @brief Create a deep copy of the ndrange command.
+  ///
+  /// @param[in] arena Arena of the command buffer the copy is recorded in.
+  ///
+  /// @return Returns the copy, or null if out of memory.
+  ndrange_info_s *clone(command_arena_s &arena) const;
 };
 
 /// @brief Implementation of mux sync-point
@@ -306,7 +382,8 @@ struct command_buffer_s final : public mux_command_buffer_s {
   ~command_buffer_s();
 
   mux::small_vector<host::command_info_s, 16> commands;
-  mux::small_vector<std::unique_ptr<host::ndrange_info_s>, 4> ndranges;
+  /// @brief Arena the ND ranges and their packed arguments are created in.
+  command_arena_s arena;
   mux::small_vector<host::sync_point_s *, 4> sync_points;
   std::mutex mutex;
   mux::small_vector<mux_semaphore_t, 8> signal_semaphores;
@@ -24,11 +24,19 @@
 #include "host/queue.h"
 #include "host/thread_pool.h"
 #include "mux/mux.h"
+#include "mux/utils/small_vector.h"
+
+#include <mutex>
+#include <vector>
 
 #ifdef CA_HOST_ENABLE_PAPI_COUNTERS
 #include "host/papi_counter.h"
 #endif
 
+#ifdef CA_HOST_ENABLE_PERF_COUNTERS
+#include "host/perf_counter.h"
+#endif
+
 namespace host {
 /// @addtogroup host
 /// @{
@@ -87,11 +95,29 @@ struct device_info_s final : public mux_device_info_s {
   /// @brief Flag to specify if the compiler using this device info is compiling
   /// natively.
   bool native;
+  /// @brief Disjoint partitions of the CPUs, each backing one of the compute
+  /// queues after queue 0.
+  ///
+  /// Partitions follow the NUMA nodes of the system if there are several,
+  /// otherwise the groups of CPUs sharing an L3 cache, otherwise the CPUs are
+  /// split in two. `CA_HOST_QUEUE_PARTITIONS` overrides this with a number of
+  /// equal partitions, `0` disables them. Empty when not compiling natively.
+  std::vector<std::vector<uint32_t>> cpu_partitions;
+  /// @brief Online NUMA nodes of the system, large memory allocations are
+  /// interleaved over them if there are several. Empty when not compiling
+  /// natively or when the system doesn't report its NUMA nodes.
+  std::vector<uint32_t> numa_nodes;
 
 #ifdef CA_HOST_ENABLE_PAPI_COUNTERS
   cargo::dynamic_array<host_papi_counter> papi_counters;
 #endif
 
+#ifdef CA_HOST_ENABLE_PERF_COUNTERS
+  /// @brief `perf_event_open` events which can be counted on the worker
+  /// threads, empty when not compiling natively.
+  cargo::dynamic_array<host_perf_counter> perf_counters;
+#endif
+
   /// @brief Detects the device's architecture.
   static host::arch detectHostArch();
   /// @brief Detects the device's OS.
@@ -108,11 +134,41 @@ struct device_s final : public mux_device_s {
   /// @param allocator The mux allocator to use for allocations.
   explicit device_s(device_info_s *info, mux_allocator_info_t allocator);
 
+  /// @brief Destructor.
+  ~device_s();
+
+  /// @brief A compute queue executing on its own partition of the CPUs.
+  struct partition_s final {
+    /// @brief Constructor.
+    ///
+    /// @param allocator The mux allocator to use for allocations.
+    /// @param device The device owning the partition.
+    /// @param cpus The CPUs the partition's threads execute on.
+    partition_s(mux_allocator_info_t allocator, device_s *device,
+                cargo::array_view<const uint32_t> cpus);
+
+    /// @brief The thread-pool executing the partition's commands.
+    thread_pool_s thread_pool;
+
+    /// @brief The partition's queue.
+    host::queue_s queue;
+  };
+
+  /// @brief Mutex shared by all of the device's queues, see queue_s::mutex.
+  std::mutex queue_mutex;
+
   /// @brief The thread-pool providing multi-threaded execution.
   thread_pool_s thread_pool;
 
-  /// @brief Host's single queue for command execution.
+  /// @brief Host's queue for command execution on all CPUs, queue index 0.
   host::queue_s queue;
+
+  /// @brief Mux allocator the partitions were allocated with.
+  mux_allocator_info_t allocator_info;
+
+  /// @brief Queues executing on partitions of the CPUs, queue indices 1 and
+  /// above.
+  mux::small_vector<partition_s *, 4> partitions;
 };
 
 /// @}
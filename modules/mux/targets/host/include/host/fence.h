@@ -25,6 +25,8 @@
 #include <atomic>
 
 namespace host {
+struct thread_pool_s;
+
 struct fence_s : mux_fence_s {
   fence_s(mux_device_t device);
   /// @see muxResetFence
@@ -35,6 +37,8 @@ struct fence_s : mux_fence_s {
 
   std::atomic<bool> thread_pool_signal;
   mux_result_t result;
+  /// @brief Thread pool of the queue the fence was last dispatched to.
+  thread_pool_s *thread_pool;
 };
 }  // namespace host
 #endif  // MUX_HOST_FENCE_H_INCLUDED
@@ -31,6 +31,8 @@ namespace host {
 /// @addtogroup host
 /// @{
 
+struct memory_s;
+
 struct image_s final : public mux_image_s {
   /// @brief Host image constructor.
   image_s(mux_memory_requirements_s memory_requirements, mux_image_type_e type,
@@ -41,6 +43,8 @@ struct image_s final : public mux_image_s {
 #ifdef HOST_IMAGE_SUPPORT
   libimg::HostImage image;
 #endif
+  /// @brief Memory the image is bound to if the image is tiled, or null.
+  memory_s *tiledMemory = nullptr;
 };
 
 /// @}
@@ -26,7 +26,9 @@
 #include <cargo/small_vector.h>
 #include <mux/mux.h>
 #include <mux/utils/allocator.h>
+#include <mux/utils/dynamic_array.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -34,6 +36,10 @@ namespace host {
 /// @addtogroup host
 /// @{
 
+/// @brief Scheduling information passed to each slice of a kernel.
+///
+/// NOTE: The host compiler's HostBIMuxInfo::getScheduleInfoStruct must match
+/// this layout.
 struct schedule_info_s final {
   size_t global_size[3];
   size_t global_offset[3];
@@ -41,6 +47,12 @@ struct schedule_info_s final {
   size_t slice;
   size_t total_slices;
   uint32_t work_dim;
+  /// @brief The running thread's `host::arena_s` memory, or null.
+  void *arena;
+  /// @brief Size of `arena` in bytes.
+  size_t arena_size;
+  /// @brief Set by the kernel to the arena size it needed, zero if unused.
+  size_t arena_required;
 };
 
 struct kernel_variant_s {
@@ -52,7 +64,9 @@ struct kernel_variant_s {
 
   explicit kernel_variant_s(std::string name, entry_hook_t hook,
                             size_t local_memory_used, uint32_t min_work_width,
-                            uint32_t pref_work_width, uint32_t sub_group_size);
+                            uint32_t pref_work_width, uint32_t sub_group_size,
+                            size_t arena_size = 0,
+                            size_t arena_size_per_work_item = 0);
   /// @brief Name of the kernel.
   ///
   /// For built-in kernels, this is one of the built-in kernels available on
@@ -67,6 +81,49 @@ struct kernel_variant_s {
   uint32_t min_work_width = 0;
   uint32_t pref_work_width = 0;
   uint32_t sub_group_size = 0;
+  /// @brief Arena size in bytes the kernel reported needing whatever the
+  /// work-group size.
+  size_t arena_size = 0;
+  /// @brief Arena size in bytes the kernel reported needing for each
+  /// work-item in the work-group.
+  size_t arena_size_per_work_item = 0;
+};
+
+/// @brief Layout of a kernel's packed arguments.
+///
+/// The offsets and sizes of a kernel's packed arguments only depend on the
+/// types of its descriptors and the lengths of plain old data, which are the
+/// same for every enqueue of almost all kernels. Layouts are computed the
+/// first time a kernel is enqueued with a given set of descriptors and shared
+/// by every later command recorded with matching ones.
+struct arg_layout_s final {
+  /// @brief Layout of a single argument.
+  struct arg_s {
+    /// @brief Type of the argument's descriptor (one of the values in the
+    /// enum mux_descriptor_info_type_e).
+    uint32_t type;
+    /// @brief Size in bytes of the argument in the packed arguments.
+    size_t size;
+    /// @brief Offset in bytes of the argument in the packed arguments.
+    size_t offset;
+  };
+
+  explicit arg_layout_s(mux::allocator allocator) : args(allocator) {}
+
+  /// @brief Check whether descriptors are packed with this layout.
+  ///
+  /// @param[in] descriptors Descriptors of an ND range.
+  ///
+  /// @return Returns true if the layout matches, false otherwise.
+  bool matches(
+      cargo::array_view<const mux_descriptor_info_t> descriptors) const;
+
+  /// @brief Layout of each argument.
+  mux::dynamic_array<arg_s> args;
+  /// @brief Total size in bytes of the packed arguments.
+  size_t size = 0;
+  /// @brief Next layout of the kernel, or null.
+  arg_layout_s *next = nullptr;
 };
 
 struct kernel_s final : public mux_kernel_s {
@@ -85,11 +142,26 @@ struct kernel_s final : public mux_kernel_s {
   kernel_s(mux_device_t device, mux_allocator_info_t allocator,
            cargo::small_vector<kernel_variant_s, 4> &&variant_data);
 
+  /// @brief Destroy the kernel and its argument layouts.
+  ~kernel_s();
+
   mux_result_t getKernelVariantForWGSize(size_t local_size_x,
                                          size_t local_size_y,
                                          size_t local_size_z,
                                          kernel_variant_s *out_variant_data);
 
+  /// @brief Get the layout the packed arguments of descriptors have.
+  ///
+  /// Looking up an existing layout is lock-free, so that the layout can be
+  /// found on every enqueue.
+  ///
+  /// @param[in] descriptors Descriptors of an ND range.
+  ///
+  /// @return Returns the layout, or null if a new layout was needed but could
+  /// not be allocated.
+  const arg_layout_s *getArgLayout(
+      cargo::array_view<const mux_descriptor_info_t> descriptors);
+
   /// @brief If the kernel is a built-in kernel.
   bool is_builtin_kernel;
 
@@ -98,6 +170,14 @@ struct kernel_s final : public mux_kernel_s {
   mux_allocator_info_t allocator_info;
 
   cargo::small_vector<kernel_variant_s, 4> variant_data;
+
+  /// @brief Largest arena size any enqueue of this kernel has required, used
+  /// to size the threads' arenas for later enqueues.
+  std::atomic<size_t> arena_size_required{0};
+
+  /// @brief Argument layouts the kernel has been enqueued with, layouts are
+  /// only ever added until the kernel is destroyed.
+  std::atomic<arg_layout_s *> arg_layouts{nullptr};
 };
 
 /// @}
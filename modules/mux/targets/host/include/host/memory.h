@@ -23,10 +23,14 @@
 
 #include <mux/mux.h>
 
+#include <memory>
+
 namespace host {
 /// @addtogroup host
 /// @{
 
+struct image_s;
+
 struct memory_s : public mux_memory_s {
   enum heap_e : uint32_t {
     HEAP_ALL = 0x1 << 0,
@@ -34,10 +38,39 @@ struct memory_s : public mux_memory_s {
     HEAP_IMAGE = 0x1 << 2,
   };
 
-  memory_s(uint64_t size, uint32_t properties, void *data, bool useHost);
+  memory_s(uint64_t size, uint32_t properties, void *data, bool useHost,
+           mux_allocation_type_e allocationType);
+
+  /// @brief Check if images bound to this memory may use a tiled layout.
+  ///
+  /// Memory the host expects to access directly, i.e. memory created from a
+  /// host pointer or allocated as host memory, only holds linear images.
+  bool supportsTiledImages() const {
+    return !useHost && mux_allocation_type_alloc_device == allocationType;
+  }
+
+  /// @brief Get the mapped address of an offset into the memory.
+  void *getMappedPointer(uint64_t offset);
+
+  /// @brief Copy the linear representation of the tiled image to the mapping.
+  void copyToMapping(uint64_t offset, uint64_t size);
+
+  /// @brief Copy the mapping to the tiled image, rearranging its data.
+  void copyFromMapping(uint64_t offset, uint64_t size);
 
   void *data;
   bool useHost;
+  mux_allocation_type_e allocationType;
+  /// @brief Size of the pages mapped for `data` when it was mapped directly,
+  /// rather than allocated with the user's allocator, otherwise 0.
+  size_t mappedSize = 0;
+  /// @brief Image with a tiled layout bound to this memory, or null.
+  image_s *tiledImage = nullptr;
+  /// @brief Offset of `tiledImage` in the memory.
+  uint64_t tiledImageOffset = 0;
+  /// @brief Copy of the memory with `tiledImage` laid out linearly, which is
+  /// presented to the host in place of `data` while the memory is mapped.
+  std::unique_ptr<uint8_t[]> mapping;
 };
 
 /// @}
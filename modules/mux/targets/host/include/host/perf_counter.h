@@ -0,0 +1,107 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+/// Host's Linux `perf_event_open` event abstraction.
+
+#ifndef HOST_PERF_COUNTER_H_INCLUDED
+#define HOST_PERF_COUNTER_H_INCLUDED
+
+#include <cargo/dynamic_array.h>
+#include <cargo/expected.h>
+#include <mux/mux.h>
+#include <sys/types.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace host {
+
+/// @brief Struct containing all the information host needs to know about a
+/// `perf_event_open` event.
+///
+/// Also has helper functions to dole this information out into the various Mux
+/// structs.
+struct host_perf_counter final {
+  /// @brief Unique ID host uses to refer to the event, its index in the table
+  /// of events host knows about.
+  uint32_t uuid;
+  /// @brief The `perf_type_id` of the event, hardware or software.
+  uint32_t type;
+  /// @brief The type specific ID of the event, e.g. `PERF_COUNT_HW_*`.
+  uint64_t config;
+  /// @brief Event name, matching the name used by the `perf` tool.
+  const char *name;
+  /// @brief Short description of the event.
+  const char *description;
+  /// @brief Unit of measurement the counter is counting.
+  mux_query_counter_unit_e unit;
+
+  /// @brief Check whether the event is counted by a hardware counter, as
+  /// opposed to by the kernel.
+  bool isHardware() const;
+
+  /// @brief Helper function to populate a `mux_query_counter_s` with this
+  /// counter's info.
+  ///
+  /// @param out_query_counter Counter struct to populate.
+  void populateMuxQueryCounter(mux_query_counter_s *out_query_counter) const {
+    out_query_counter->unit = unit;
+    out_query_counter->storage = mux_query_counter_result_type_uint64;
+    out_query_counter->uuid = uuid;
+    out_query_counter->hardware_counters = isHardware() ? 1 : 0;
+  }
+
+  /// @brief Helper function to populate a `mux_query_counter_descriptions_s`
+  /// with this counter's info.
+  ///
+  /// @param out_description Counter description struct to populate.
+  void populateMuxQueryCounterDescription(
+      mux_query_counter_description_s *out_description) const {
+    std::strncpy(out_description->name, name, 256);
+    std::strncpy(out_description->category,
+                 isHardware() ? "Hardware event" : "Software event", 256);
+    std::strncpy(out_description->description, description, 256);
+  }
+};
+
+/// @brief Look up an event host knows about by its unique ID.
+///
+/// @param uuid Unique ID of the event.
+///
+/// @return Returns the event, or null if `uuid` is not a known event.
+const host_perf_counter *getPerfCounter(uint32_t uuid);
+
+/// @brief Open a disabled, user space only, event counting on a thread.
+///
+/// @param counter Event to count.
+/// @param thread_id System thread ID of the thread to count on, 0 for the
+/// calling thread.
+///
+/// @return Returns the file descriptor of the event, or -1 on failure.
+int openPerfEvent(const host_perf_counter &counter, pid_t thread_id);
+
+/// @brief Helper function that returns a dynamic array of the
+/// `host_perf_counter` events which can be opened by this process.
+///
+/// Hardware events are unavailable when `perf_event_paranoid` forbids them or
+/// in virtual machines without a virtual PMU, which leaves the software events
+/// counted by the kernel.
+cargo::expected<cargo::dynamic_array<host_perf_counter>, mux_result_t>
+initPerfCounters();
+}  // namespace host
+
+#endif  // HOST_PERF_COUNTER_H_INCLUDED
@@ -29,7 +29,8 @@
 #include <cassert>
 #include <mutex>
 
-#ifdef CA_HOST_ENABLE_PAPI_COUNTERS
+#if defined(CA_HOST_ENABLE_PAPI_COUNTERS) || \
+    defined(CA_HOST_ENABLE_PERF_COUNTERS)
 #include <pthread.h>
 #endif
 
@@ -60,6 +61,19 @@ struct host_papi_event_info_s {
 };
 #endif
 
+#ifdef CA_HOST_ENABLE_PERF_COUNTERS
+/// @brief Struct to track the `perf_event_open` events counting on a worker
+/// thread and the results read out of them.
+struct host_perf_event_info_s {
+  /// @brief Handle to the thread the events are counting on.
+  pid_t thread_id;
+  /// @brief File descriptors of the events, one per query slot.
+  cargo::array_view<int> fds;
+  /// @brief Results read from the events, one per query slot.
+  cargo::array_view<uint64_t> results;
+};
+#endif
+
 /// @brief Pool of storage for query results.
 struct query_pool_s final : mux_query_pool_s {
   /// @brief Create a new query pool object.
@@ -91,7 +105,8 @@ struct query_pool_s final : mux_query_pool_s {
     return static_cast<mux_query_duration_result_t>(this->data) + index;
   }
 
-#ifdef CA_HOST_ENABLE_PAPI_COUNTERS
+#if defined(CA_HOST_ENABLE_PAPI_COUNTERS) || \
+    defined(CA_HOST_ENABLE_PERF_COUNTERS)
   /// @brief Start measuring all the events associated with the pool.
   void startEvents();
 
@@ -104,7 +119,9 @@ struct query_pool_s final : mux_query_pool_s {
   ///
   /// @param allocator The allocator used to allocate this query pool's memory.
   void freeEvents(mux::allocator &allocator);
+#endif
 
+#ifdef CA_HOST_ENABLE_PAPI_COUNTERS
   /// @brief Read results from our papi event set and return in the given
   /// buffer.
   ///
@@ -117,6 +134,19 @@ struct query_pool_s final : mux_query_pool_s {
                                size_t result_count, size_t query_index);
 #endif
 
+#ifdef CA_HOST_ENABLE_PERF_COUNTERS
+  /// @brief Read results from our perf events, summed over the worker threads,
+  /// and return in the given buffer.
+  ///
+  /// @param results Pointer to array of `result_count`
+  /// `mux_query_counter_result_s` structs to return the results in.
+  /// @param result_count Number results to read out.
+  /// @param query_index Offset into the pool's query slots to start reading
+  /// from.
+  mux_result_t readPerfResults(mux_query_counter_result_s *results,
+                               size_t result_count, size_t query_index);
+#endif
+
   /// @brief Reset the query pool result storage to zeros.
   void reset();
 
@@ -143,6 +173,11 @@ struct query_pool_s final : mux_query_pool_s {
   cargo::array_view<host_papi_event_info_s> papi_event_infos;
 #endif
 
+#ifdef CA_HOST_ENABLE_PERF_COUNTERS
+  /// @brief The events opened for this query pool, one set per worker thread.
+  cargo::array_view<host_perf_event_info_s> perf_event_infos;
+#endif
+
   /// @brief Pointer to memory used to store query result data.
   void *data;
   /// @brief Size in bytes of memory pointed to by `data`.
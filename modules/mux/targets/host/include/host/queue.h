@@ -31,12 +31,17 @@ namespace host {
 /// @addtogroup host
 /// @{
 
+struct thread_pool_s;
+
 struct queue_s final : public mux_queue_s {
   /// @brief Construct the queue object.
   ///
   /// @param allocator Mux allocator to use.
   /// @param device Mux device which owns the queue.
-  queue_s(mux_allocator_info_t allocator, mux_device_t device);
+  /// @param thread_pool Thread pool which executes the queue's commands.
+  /// @param mutex Mutex shared by all of the device's queues, see `mutex`.
+  queue_s(mux_allocator_info_t allocator, mux_device_t device,
+          thread_pool_s *thread_pool, std::mutex &mutex);
 
   /// @brief Destructor.
   ~queue_s();
@@ -67,8 +72,15 @@ struct queue_s final : public mux_queue_s {
   /// @brief Atomic counter of the current number of running command groups.
   std::atomic<uint32_t> runningGroups;
 
+  /// @brief Thread pool which executes the queue's commands.
+  thread_pool_s *thread_pool;
+
   /// @brief Mutex for users to lock to ensure ordering.
-  std::mutex mutex;
+  ///
+  /// The mutex is owned by the device and shared by all of its queues, as a
+  /// semaphore signalled on completion of work on one queue may release work
+  /// waiting on another.
+  std::mutex &mutex;
 
   /// @brief Holds signaling information associated to a command buffer
   /// dispatch instance.
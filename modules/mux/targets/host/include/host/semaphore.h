@@ -25,6 +25,7 @@
 #include <mux/utils/small_vector.h>
 
 #include <mutex>
+#include <utility>
 
 namespace host {
 /// @addtogroup host
@@ -41,14 +42,17 @@ struct semaphore_s final : public mux_semaphore_s {
 
   void signal(bool terminate = false);
 
-  mux_result_t addWait(mux_command_buffer_t group);
+  mux_result_t addWait(host::queue_s *queue, mux_command_buffer_t group);
 
   void reset();
 
  private:
   bool signalled;
   bool failed;
-  mux::small_vector<mux_command_buffer_t, 8> waitingGroups;
+  /// @brief Command groups waiting on the semaphore, paired with the queue
+  /// they were dispatched to.
+  mux::small_vector<std::pair<host::queue_s *, mux_command_buffer_t>, 8>
+      waitingGroups;
 };
 
 /// @}
@@ -26,13 +26,19 @@
 #include <map>
 #include <mutex>
 #include <new>
+#include <vector>
 
 #ifdef CA_HOST_ENABLE_PAPI_COUNTERS
 #include <papi.h>
+#endif
+
+#if defined(CA_HOST_ENABLE_PAPI_COUNTERS) || \
+    defined(CA_HOST_ENABLE_PERF_COUNTERS)
 #include <sys/syscall.h>
 #include <unistd.h>
 #endif
 
+#include "cargo/array_view.h"
 #include "cargo/thread.h"
 #include "tracer/tracer.h"
 
@@ -54,8 +60,21 @@ struct thread_pool_work_item_s final {
 };
 
 struct thread_pool_s final {
+  /// @brief Construct a thread pool using all of the system's CPUs.
+  ///
+  /// The threads are started immediately.
   explicit thread_pool_s();
 
+  /// @brief Construct a thread pool whose threads are pinned to a partition
+  /// of the system's CPUs.
+  ///
+  /// One thread is created per CPU in the partition, up to `max_num_threads`.
+  /// The threads are only started once work is first enqueued, so partitions
+  /// which are never used do not cost any threads.
+  ///
+  /// @param[in] cpus Indices of the CPUs the threads may run on.
+  explicit thread_pool_s(cargo::array_view<const uint32_t> cpus);
+
   ~thread_pool_s();
 
   /// @brief Blocking function get work to execute.
@@ -71,6 +90,9 @@ struct thread_pool_s final {
   /// The number of threads supported in the thread pool.
   size_t num_threads() const;
 
+  /// @brief Start the threads of the pool if they are not yet running.
+  void start();
+
   /// @brief Enqueue some work on the thread pool.
   /// @param[in] function The function to run in the thread pool.
   /// @param[in] user_data User data to pass to the function.
@@ -105,12 +127,14 @@ struct thread_pool_s final {
   /// @tparam N Length of `signals`.
   template <size_t N>
   void enqueue_range(function_t function, void *user_data, void *user_data2,
+                     void *user_data3,
                      std::array<std::atomic<bool>, N> &signals,
                      std::atomic<uint32_t> *count, size_t slices) {
     const tracer::TraceGuard<tracer::Impl> traceGuard(__func__);
 
     {
       std::unique_lock<std::mutex> lock(mutex);
+      startThreads();
 
       for (size_t index = 0; index < slices; index++) {
         // Count gets incremented before signal gets set.
@@ -135,7 +159,7 @@ struct thread_pool_s final {
         }
 
         queue[queue_write_index] = {
-            function, user_data,         user_data2, nullptr,
+            function, user_data,         user_data2, user_data3,
             index,    &(signals[index]), count,
         };
 
@@ -146,19 +170,39 @@ struct thread_pool_s final {
     new_work.notify_all();
   }
 
-#ifdef CA_HOST_ENABLE_PAPI_COUNTERS
+#if defined(CA_HOST_ENABLE_PAPI_COUNTERS) || \
+    defined(CA_HOST_ENABLE_PERF_COUNTERS)
   /// @brief Register the calling thread's system thread ID in `thread_ids`.
   void registerPid() {
-    std::lock_guard<std::mutex> lock(thread_ids_mutex);
-    thread_ids[std::this_thread::get_id()] = syscall(SYS_gettid);
+    {
+      std::lock_guard<std::mutex> lock(thread_ids_mutex);
+      thread_ids[std::this_thread::get_id()] = syscall(SYS_gettid);
+    }
+    thread_ids_registered.notify_all();
+  }
+
+  /// @brief Get the system thread ID of a worker thread.
+  ///
+  /// Waits for the thread to register itself, as `start()` returns as soon as
+  /// the threads are created.
+  ///
+  /// @param[in] id ID of the worker thread.
+  pid_t getPid(cargo::thread::id id) {
+    std::unique_lock<std::mutex> lock(thread_ids_mutex);
+    thread_ids_registered.wait(lock,
+                               [&] { return thread_ids.count(id) != 0; });
+    return thread_ids[id];
   }
 
   /// @brief Mutex for controlling access to `thread_pids`.
   std::mutex thread_ids_mutex;
+  /// @brief Condition variable notified when a thread registers its ID.
+  std::condition_variable thread_ids_registered;
   /// @brief Mapping of cargo::thread::id to the analagous system thread pid_t.
   ///
-  /// PAPI's thread related APIs work with system thread IDs, so we need to
-  /// store them during initialization, and to be able to look them up later.
+  /// PAPI's thread related APIs and `perf_event_open` work with system thread
+  /// IDs, so we need to store them during initialization, and to be able to
+  /// look them up later.
   std::map<cargo::thread::id, pid_t> thread_ids;
 #endif
 
@@ -214,6 +258,18 @@ struct thread_pool_s final {
 
   /// A variable to query whether the thread pool is still alive or not.
   std::atomic<bool> stayAlive;
+
+  /// CPUs the threads are pinned to, empty if the threads may run anywhere.
+  std::vector<uint32_t> cpus;
+
+  /// Whether the threads have been started, only accessed under `mutex`.
+  bool started = false;
+
+ private:
+  /// @brief Start the threads of the pool if they are not yet running.
+  ///
+  /// @note Callers must hold a lock on `mutex`.
+  void startThreads();
 };
 
 /// @}
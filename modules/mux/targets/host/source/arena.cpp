@@ -0,0 +1,92 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <host/arena.h>
+
+#include <algorithm>
+#include <new>
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sys/mman.h>
+#endif
+
+namespace host {
+arena_s::~arena_s() { release(); }
+
+arena_s &arena_s::get() {
+  static thread_local arena_s arena;
+  return arena;
+}
+
+bool arena_s::reserve(size_t required) {
+  if (required <= size) {
+    return true;
+  }
+
+  // Grow geometrically so that kernels whose requirements creep up do not
+  // reallocate on every enqueue.
+  size_t new_size = std::max(required, size * 2);
+  new_size = (new_size + alignment - 1) & ~(alignment - 1);
+
+#if defined(__linux__) && !defined(__ANDROID__)
+  if (new_size >= huge_page_size) {
+    new_size = (new_size + huge_page_size - 1) & ~(huge_page_size - 1);
+    void *new_data = mmap(nullptr, new_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (new_data == MAP_FAILED) {
+      return false;
+    }
+#ifdef MADV_HUGEPAGE
+    // Best effort, the arena works just as well without huge pages.
+    (void)madvise(new_data, new_size, MADV_HUGEPAGE);
+#endif
+    release();
+    data = new_data;
+    size = new_size;
+    mapped = true;
+    return true;
+  }
+#endif
+
+  void *new_data =
+      ::operator new(new_size, std::align_val_t(alignment), std::nothrow);
+  if (!new_data) {
+    return false;
+  }
+  release();
+  data = new_data;
+  size = new_size;
+  mapped = false;
+  return true;
+}
+
+void arena_s::release() {
+  if (!data) {
+    return;
+  }
+#if defined(__linux__) && !defined(__ANDROID__)
+  if (mapped) {
+    munmap(data, size);
+    data = nullptr;
+    size = 0;
+    return;
+  }
+#endif
+  ::operator delete(data, std::align_val_t(alignment));
+  data = nullptr;
+  size = 0;
+}
+}  // namespace host
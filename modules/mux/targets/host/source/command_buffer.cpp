@@ -22,7 +22,10 @@
 #include <host/query_pool.h>
 #include <mux/utils/allocator.h>
 #include <mux/utils/helpers.h>
+#include <tracer/tracer.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <new>
@@ -30,48 +33,15 @@
 #include "mux/mux.h"
 
 namespace {
-// Returns the number of bytes which need allocated to hold all the packed args,
-// and stores the offset into the allocation for each argument
-size_t calcPackedArgsAllocSize(
-    const mux::dynamic_array<mux_descriptor_info_t> &descriptors,
-    mux::dynamic_array<size_t> &offsets) {
-  size_t offset = 0;
-  for (unsigned i = 0; i < descriptors.size(); i++) {
-    const auto descriptor = descriptors[i];
-    size_t size;
-    switch (descriptor.type) {
-      case mux_descriptor_info_type_sampler:
-        size = sizeof(size_t);
-        break;
-      case mux_descriptor_info_type_buffer:
-      case mux_descriptor_info_type_null_buffer:
-      case mux_descriptor_info_type_image:
-        size = sizeof(void *);
-        break;
-      case mux_descriptor_info_type_plain_old_data: {
-        size = descriptor.plain_old_data_descriptor.length;
-      } break;
-      case mux_descriptor_info_type_shared_local_buffer: {
-        size = sizeof(size_t);
-      } break;
-      default: {
-        size = 0;
-      } break;
-    }
-    offsets[i] = offset;
-    offset += size;
-  }
-  return offset;
-}
-
 // Iterates through the argument descriptors and for each argument sets the
-// location in the packed args location to the correct value.
+// location in the packed args allocation given by the layout to the correct
+// value.
 void populatePackedArgs(
-    uint8_t *packed_args_alloc,
-    const mux::dynamic_array<mux_descriptor_info_t> &descriptors) {
-  size_t offset = 0;
-  for (unsigned i = 0; i < descriptors.size(); i++) {
-    const auto descriptor = descriptors[i];
+    uint8_t *packed_args_alloc, const host::arg_layout_s &layout,
+    cargo::array_view<const mux_descriptor_info_t> descriptors) {
+  for (size_t i = 0; i < descriptors.size(); i++) {
+    const auto &descriptor = descriptors[i];
+    uint8_t *const arg_address = packed_args_alloc + layout.args[i].offset;
     switch (descriptor.type) {
       case mux_descriptor_info_type_buffer: {
         const mux_descriptor_info_buffer_s info = descriptor.buffer_descriptor;
@@ -82,8 +52,7 @@ void populatePackedArgs(
         uint8_t *const buffer_value =
             static_cast<uint8_t *>(host_buffer->data) + info.offset;
 
-        std::memcpy(packed_args_alloc + offset, &buffer_value, sizeof(void *));
-        offset += sizeof(void *);
+        std::memcpy(arg_address, &buffer_value, sizeof(void *));
       } break;
       case mux_descriptor_info_type_image: {
 #ifdef HOST_IMAGE_SUPPORT
@@ -95,8 +64,7 @@ void populatePackedArgs(
         void *const image_ptr =
             libimg::HostGetImageKernelImagePtr(&host_image->image);
 
-        std::memcpy(packed_args_alloc + offset, &image_ptr, sizeof(void *));
-        offset += sizeof(void *);
+        std::memcpy(arg_address, &image_ptr, sizeof(void *));
 #endif
       } break;
       case mux_descriptor_info_type_sampler: {
@@ -134,28 +102,24 @@ void populatePackedArgs(
 
         uint64_t sampler_ptr = libimg::HostCreateSampler(
             info.sampler.normalize_coords, addressing_mode, filter_mode);
-        std::memcpy(packed_args_alloc + offset, &sampler_ptr, sizeof(size_t));
-        offset += sizeof(size_t);
+        std::memcpy(arg_address, &sampler_ptr, sizeof(size_t));
 #endif
       } break;
       case mux_descriptor_info_type_plain_old_data: {
         const mux_descriptor_info_plain_old_data_s info =
             descriptor.plain_old_data_descriptor;
 
-        std::memcpy(packed_args_alloc + offset, info.data, info.length);
-        offset += info.length;
+        std::memcpy(arg_address, info.data, info.length);
       } break;
       case mux_descriptor_info_type_shared_local_buffer: {
         mux_descriptor_info_shared_local_buffer_s info =
             descriptor.shared_local_buffer_descriptor;
 
-        std::memcpy(packed_args_alloc + offset, &(info.size), sizeof(size_t));
-        offset += sizeof(size_t);
+        std::memcpy(arg_address, &(info.size), sizeof(size_t));
       } break;
       case mux_descriptor_info_type_null_buffer: {
         void *nullvar = nullptr;
-        std::memcpy(packed_args_alloc + offset, &nullvar, sizeof(void *));
-        offset += sizeof(void *);
+        std::memcpy(arg_address, &nullvar, sizeof(void *));
       } break;
       default:
         break;
@@ -169,7 +133,7 @@ command_buffer_s::command_buffer_s(mux_device_t device,
                                    mux_allocator_info_t allocator_info,
                                    mux_fence_t fence)
     : commands(allocator_info),
-      ndranges(allocator_info),
+      arena(allocator_info),
       sync_points(allocator_info),
       signal_semaphores(allocator_info),
       fence(static_cast<host::fence_s *>(fence)),
@@ -185,55 +149,79 @@ sync_point_s::sync_point_s(mux_command_buffer_t command_buffer) {
   this->command_buffer = command_buffer;
 }
 
-cargo::expected<std::unique_ptr<ndrange_info_s>, mux_result_t>
-ndrange_info_s::clone(mux_allocator_info_t allocator_info) const {
+command_arena_s::~command_arena_s() {
   mux::allocator allocator(allocator_info);
-
-  mux::dynamic_array<mux_descriptor_info_t> clone_descriptors{allocator};
-  if (clone_descriptors.alloc(descriptors.size())) {
-    return cargo::make_unexpected(mux_error_out_of_memory);
+  while (chunks) {
+    auto *const next = chunks->next;
+    allocator.free(chunks);
+    chunks = next;
   }
+}
 
-  // Make a copy of the descriptor so that they are owned by the cloned
-  // command
-  std::copy(std::begin(descriptors), std::end(descriptors),
-            std::begin(clone_descriptors));
-
-  // Setup a new packed args allocation for this cloned command
-  mux::dynamic_array<size_t> clone_offsets{allocator};
-  if (clone_offsets.alloc(descriptors.size())) {
-    return cargo::make_unexpected(mux_error_out_of_memory);
+void *command_arena_s::alloc(size_t size, size_t alignment) {
+  while (current) {
+    const uintptr_t base = reinterpret_cast<uintptr_t>(current + 1);
+    const uintptr_t begin = (base + offset + alignment - 1) & ~(alignment - 1);
+    if (begin + size <= base + current->size) {
+      offset = begin + size - base;
+      return reinterpret_cast<void *>(begin);
+    }
+    // Chunks kept from before the last reset are reused in order, the rest of
+    // this one is left unused.
+    if (nullptr == current->next) {
+      break;
+    }
+    current = current->next;
+    offset = 0;
   }
 
-  // Allocate data for packed arguments and record offset into it for each
-  // argument
-  const uint64_t packed_args_alloc_size =
-      calcPackedArgsAllocSize(clone_descriptors, clone_offsets);
-  uint8_t *const packed_args_allocation =
-      static_cast<uint8_t *>(allocator.alloc(packed_args_alloc_size, 1));
-  if (nullptr == packed_args_allocation) {
-    return cargo::make_unexpected(mux_error_out_of_memory);
+  // Grow geometrically so that large command buffers only need a handful of
+  // chunks.
+  size_t chunk_size = std::max(min_chunk_size, size);
+  if (current) {
+    chunk_size = std::max(chunk_size, current->size * 2);
   }
+  mux::allocator allocator(allocator_info);
+  void *const memory =
+      allocator.alloc(sizeof(chunk_s) + chunk_size, alignof(chunk_s));
+  if (nullptr == memory) {
+    return nullptr;
+  }
+  auto *const chunk = new (memory) chunk_s{nullptr, chunk_size};
+  if (current) {
+    current->next = chunk;
+  } else {
+    chunks = chunk;
+  }
+  current = chunk;
+  offset = size;
+  return chunk + 1;
+}
 
-  // Store address of each argument
-  mux::dynamic_array<uint8_t *> clone_arg_addresses{allocator};
-  if (clone_arg_addresses.alloc(descriptors.size())) {
-    return cargo::make_unexpected(mux_error_out_of_memory);
-  }
-  for (size_t i = 0; i < descriptors.size(); i++) {
-    clone_arg_addresses[i] = packed_args_allocation + clone_offsets[i];
-  }
+void command_arena_s::reset() {
+  current = chunks;
+  offset = 0;
+}
 
+ndrange_info_s *ndrange_info_s::clone(command_arena_s &arena) const {
   // Populate packed args struct by copying original. We do this rather
   // than recreating from the descriptors, as for POD descriptors the data
   // pointer will no longer be valid if the kernel argument has since been
   // overwritten with clSetKernelArg, freeing the original
   // _cl_kernel::argument.
-  std::memcpy(packed_args_allocation, packed_args, packed_args_alloc_size);
+  void *const clone_packed_args =
+      arena.alloc(arg_layout->size, packed_args_alignment);
+  if (nullptr == clone_packed_args) {
+    return nullptr;
+  }
+  std::memcpy(clone_packed_args, packed_args, arg_layout->size);
 
-  return std::make_unique<host::ndrange_info_s>(
-      packed_args_allocation, clone_arg_addresses, clone_descriptors,
-      global_size, global_offset, local_size, dimensions);
+  auto *const clone = arena.create<ndrange_info_s>(*this);
+  if (nullptr == clone) {
+    return nullptr;
+  }
+  clone->packed_args = clone_packed_args;
+  return clone;
 }
 }  // namespace host
 
@@ -898,21 +886,28 @@ mux_result_t hostCommandCopyBufferToImage(
 #endif
 }
 
-mux_result_t hostCommandNDRange(mux_command_buffer_t command_buffer,
-                                mux_kernel_t kernel,
-                                mux_ndrange_options_t options,
-                                uint32_t num_sync_points_in_wait_list,
-                                const mux_sync_point_t *sync_point_wait_list,
-                                mux_sync_point_t *sync_point) {
-  // TODO CA-4364
-  (void)num_sync_points_in_wait_list;
-  (void)sync_point_wait_list;
-
-  auto host = static_cast<host::command_buffer_s *>(command_buffer);
+namespace {
+/// @brief Push an ND range command to a command buffer.
+///
+/// @param[in] host Command buffer to push the command to.
+/// @param[in] kernel Kernel to execute.
+/// @param[in] options Execution options, `global_size` is only read if
+/// `group_count_buffer` is null.
+/// @param[in] group_count_buffer Buffer to read the work-group counts from
+/// when the command executes, or null.
+/// @param[in] group_count_offset Offset in bytes of the work-group counts in
+/// `group_count_buffer`.
+/// @param[out] sync_point Sync-point identifying the command, may be null.
+///
+/// @return mux_success, or a mux_error_* if an error occurred.
+mux_result_t pushNDRange(host::command_buffer_s *host, mux_kernel_t kernel,
+                         const mux_ndrange_options_t &options,
+                         mux_buffer_t group_count_buffer,
+                         uint64_t group_count_offset,
+                         mux_sync_point_t *sync_point) {
   const std::lock_guard<std::mutex> lock(host->mutex);
 
   auto host_kernel = static_cast<host::kernel_s *>(kernel);
-  mux::allocator allocator(host_kernel->allocator_info);
 
   std::array<size_t, 3> global_size;
   std::array<size_t, 3> global_offset;
@@ -920,58 +915,41 @@ mux_result_t hostCommandNDRange(mux_command_buffer_t command_buffer,
 
   for (size_t i = 0; i < 3; i++) {
     const bool in_range = i < options.dimensions;
-    global_size[i] = in_range ? options.global_size[i] : 1;
+    global_size[i] =
+        in_range && !group_count_buffer ? options.global_size[i] : 1;
     global_offset[i] = in_range ? options.global_offset[i] : 0;
     local_size[i] = options.local_size[i];
   }
 
-  mux::dynamic_array<mux_descriptor_info_t> descriptors{allocator};
-  if (descriptors.alloc(options.descriptors_length)) {
-    return mux_error_out_of_memory;
-  }
-
-  // Make a copy of the descriptor so that their lifetime extends beyond this
-  // function call.
-  cargo::array_view<mux_descriptor_info_t> option_descriptors(
+  // The layout is almost always found on the kernel already, so the arguments
+  // can be written straight into the command buffer's arena.
+  const cargo::array_view<const mux_descriptor_info_t> descriptors(
       options.descriptors, options.descriptors_length);
-  std::copy(std::begin(option_descriptors), std::end(option_descriptors),
-            std::begin(descriptors));
-
-  mux::dynamic_array<size_t> offsets{allocator};
-  if (offsets.alloc(descriptors.size())) {
+  const host::arg_layout_s *const arg_layout =
+      host_kernel->getArgLayout(descriptors);
+  if (nullptr == arg_layout) {
     return mux_error_out_of_memory;
   }
 
-  // Allocate memory for the packed kernel arguments and record the offset
-  // into the allocation for each argument
-  const uint64_t packed_args_alloc_size =
-      calcPackedArgsAllocSize(descriptors, offsets);
-  uint8_t *const packed_args_allocation =
-      static_cast<uint8_t *>(allocator.alloc(packed_args_alloc_size, 1));
-  if (nullptr == packed_args_allocation) {
+  auto *const packed_args = static_cast<uint8_t *>(host->arena.alloc(
+      arg_layout->size, host::ndrange_info_s::packed_args_alignment));
+  if (nullptr == packed_args) {
     return mux_error_out_of_memory;
   }
+  populatePackedArgs(packed_args, *arg_layout, descriptors);
 
-  // Store the address in packed args allocation of each argument
-  mux::dynamic_array<uint8_t *> arg_addresses{allocator};
-  if (arg_addresses.alloc(descriptors.size())) {
-    return mux_error_out_of_memory;
-  }
-  for (size_t i = 0; i < descriptors.size(); i++) {
-    arg_addresses[i] = packed_args_allocation + offsets[i];
-  }
-
-  // Store necessary argument information in the packed args allocation
-  populatePackedArgs(packed_args_allocation, descriptors);
-
-  if (host->ndranges.emplace_back(std::make_unique<host::ndrange_info_s>(
-          packed_args_allocation, arg_addresses, descriptors, global_size,
-          global_offset, local_size, options.dimensions))) {
+  auto *const ndrange_info = host->arena.create<host::ndrange_info_s>(
+      packed_args, arg_layout, global_size, global_offset, local_size,
+      options.dimensions);
+  if (nullptr == ndrange_info) {
     return mux_error_out_of_memory;
   }
+  ndrange_info->trace_flow_id = tracer::getCurrentFlowId();
+  ndrange_info->group_count_buffer = group_count_buffer;
+  ndrange_info->group_count_offset = group_count_offset;
 
   if (host->commands.push_back(
-          host::command_info_ndrange_s{kernel, host->ndranges.back().get()})) {
+          host::command_info_ndrange_s{kernel, ndrange_info})) {
     return mux_error_out_of_memory;
   }
 
@@ -987,6 +965,36 @@ mux_result_t hostCommandNDRange(mux_command_buffer_t command_buffer,
 
   return mux_success;
 }
+}  // namespace
+
+mux_result_t hostCommandNDRange(mux_command_buffer_t command_buffer,
+                                mux_kernel_t kernel,
+                                mux_ndrange_options_t options,
+                                uint32_t num_sync_points_in_wait_list,
+                                const mux_sync_point_t *sync_point_wait_list,
+                                mux_sync_point_t *sync_point) {
+  // TODO CA-4364
+  (void)num_sync_points_in_wait_list;
+  (void)sync_point_wait_list;
+
+  return pushNDRange(static_cast<host::command_buffer_s *>(command_buffer),
+                     kernel, options, nullptr, 0, sync_point);
+}
+
+mux_result_t hostCommandNDRangeIndirect(
+    mux_command_buffer_t command_buffer, mux_kernel_t kernel,
+    mux_ndrange_options_t options, mux_buffer_t group_count_buffer,
+    uint64_t group_count_offset, uint32_t num_sync_points_in_wait_list,
+    const mux_sync_point_t *sync_point_wait_list,
+    mux_sync_point_t *sync_point) {
+  // TODO CA-4364
+  (void)num_sync_points_in_wait_list;
+  (void)sync_point_wait_list;
+
+  return pushNDRange(static_cast<host::command_buffer_s *>(command_buffer),
+                     kernel, options, group_count_buffer, group_count_offset,
+                     sync_point);
+}
 
 mux_result_t hostUpdateDescriptors(mux_command_buffer_t command_buffer,
                                    mux_command_id_t command_id,
@@ -1004,8 +1012,11 @@ mux_result_t hostUpdateDescriptors(mux_command_buffer_t command_buffer,
   // Patch its arguments.
   for (unsigned i = 0; i < num_args; ++i) {
     auto index = arg_indices[i];
-    uint8_t *const arg_address =
-        nd_range_to_update.ndrange_command.ndrange_info->arg_addresses[index];
+    const auto *const ndrange_info =
+        nd_range_to_update.ndrange_command.ndrange_info;
+    uint8_t *const arg_address = static_cast<uint8_t *>(
+                                     ndrange_info->packed_args) +
+                                 ndrange_info->arg_layout->args[index].offset;
     auto arg_descriptor = descriptors[i];
     switch (arg_descriptor.type) {
       default:
@@ -1188,6 +1199,7 @@ mux_result_t hostResetCommandBuffer(mux_command_buffer_t command_buffer) {
   const std::lock_guard<std::mutex> lock(host->mutex);
 
   host->commands.clear();
+  host->arena.reset();
 
   return mux_success;
 }
@@ -1233,20 +1245,15 @@ mux_result_t hostCloneCommandBuffer(mux_device_t device,
           command.ndrange_command;
       const auto &ndrange_info = ndrange_command.ndrange_info;
 
-      auto cloned_ndrange_info = ndrange_info->clone(allocator_info);
-      if (!cloned_ndrange_info) {
-        return cloned_ndrange_info.error();
-      }
-
-      if (cloned_command_buffer->ndranges.emplace_back(
-              std::move(*cloned_ndrange_info))) {
+      auto *const cloned_ndrange_info =
+          ndrange_info->clone(cloned_command_buffer->arena);
+      if (nullptr == cloned_ndrange_info) {
         return mux_error_out_of_memory;
       }
 
       if (cloned_command_buffer->commands.push_back(
-              host::command_info_ndrange_s{
-                  ndrange_command.kernel,
-                  cloned_command_buffer->ndranges.back().get()})) {
+              host::command_info_ndrange_s{ndrange_command.kernel,
+                                           cloned_ndrange_info})) {
         return mux_error_out_of_memory;
       }
     }
@@ -1264,10 +1271,6 @@ void hostDestroyCommandBuffer(mux_device_t device,
   mux::allocator allocator(allocator_info);
 
   auto host = static_cast<host::command_buffer_s *>(command_buffer);
-  for (auto &range : host->ndranges) {
-    allocator.free(range->packed_args);
-  }
-
   for (auto sync_point : host->sync_points) {
     allocator.destroy(sync_point);
   }
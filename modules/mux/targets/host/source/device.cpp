@@ -33,7 +33,9 @@
 #include <limits>
 #include <memory>
 #include <new>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #ifdef __linux__
 #include <sys/sysinfo.h>
@@ -339,6 +341,119 @@ uint32_t os_num_cpus() {
 #endif
 }
 
+#ifdef __linux__
+/// @brief Reads a sysfs CPU list, such as "0-3,8-11", into CPU indices.
+///
+/// @param path Path to the sysfs file.
+///
+/// @return The CPU indices, empty if the file could not be read.
+std::vector<uint32_t> os_read_cpu_list(const std::string &path) {
+  std::vector<uint32_t> cpus;
+  FILE *const file = fopen(path.c_str(), "r");
+  if (nullptr == file) {
+    return cpus;
+  }
+
+  char data[4096];
+  const size_t bytes_read = fread(data, 1, sizeof(data) - 1, file);
+  (void)fclose(file);
+  data[bytes_read] = '\0';
+
+  const char *cursor = data;
+  while (true) {
+    char *end = nullptr;
+    const unsigned long first = strtoul(cursor, &end, 10);
+    if (end == cursor) {
+      break;
+    }
+    unsigned long last = first;
+    if ('-' == *end) {
+      cursor = end + 1;
+      last = strtoul(cursor, &end, 10);
+    }
+    for (unsigned long cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(static_cast<uint32_t>(cpu));
+    }
+    if (',' != *end) {
+      break;
+    }
+    cursor = end + 1;
+  }
+  return cpus;
+}
+#endif
+
+/// @brief Splits the online CPUs into disjoint partitions, one per compute
+/// queue after queue 0.
+///
+/// @return The CPU indices of each partition, empty if the CPUs should not be
+/// partitioned.
+std::vector<std::vector<uint32_t>> os_cpu_partitions() {
+  std::vector<uint32_t> online;
+#ifdef __linux__
+  online = os_read_cpu_list("/sys/devices/system/cpu/online");
+#endif
+  if (online.empty()) {
+    for (uint32_t cpu = 0, e = os_num_cpus(); cpu < e; cpu++) {
+      online.push_back(cpu);
+    }
+  }
+
+  std::vector<std::vector<uint32_t>> partitions;
+  auto splitEqually = [&](size_t count) {
+    count = std::min(count, online.size());
+    for (size_t i = 0; i < count; i++) {
+      partitions.emplace_back(online.begin() + (i * online.size() / count),
+                              online.begin() +
+                                  ((i + 1) * online.size() / count));
+    }
+  };
+
+  // Register the value of the CA_HOST_QUEUE_PARTITIONS environment variable,
+  // this overrides the partitioning derived from the system's topology.
+  if (const char *env = std::getenv("CA_HOST_QUEUE_PARTITIONS")) {
+    splitEqually(std::strtoul(env, nullptr, 10));
+    return partitions;
+  }
+
+#ifdef __linux__
+  // Prefer NUMA nodes, as memory access latency differs most between them.
+  for (const uint32_t node :
+       os_read_cpu_list("/sys/devices/system/node/online")) {
+    auto cpus = os_read_cpu_list("/sys/devices/system/node/node" +
+                                 std::to_string(node) + "/cpulist");
+    if (!cpus.empty()) {
+      partitions.push_back(std::move(cpus));
+    }
+  }
+  if (partitions.size() > 1) {
+    return partitions;
+  }
+  partitions.clear();
+
+  // Then groups of CPUs sharing an L3 cache.
+  for (const uint32_t cpu : online) {
+    auto cpus = os_read_cpu_list("/sys/devices/system/cpu/cpu" +
+                                 std::to_string(cpu) +
+                                 "/cache/index3/shared_cpu_list");
+    if (!cpus.empty() && std::find(partitions.begin(), partitions.end(),
+                                   cpus) == partitions.end()) {
+      partitions.push_back(std::move(cpus));
+    }
+  }
+  if (partitions.size() > 1) {
+    return partitions;
+  }
+  partitions.clear();
+#endif
+
+  // Otherwise split the CPUs in two.
+  if (online.size() > 1) {
+    splitEqually(2);
+  }
+  return partitions;
+}
+
 namespace host {
 device_info_s::device_info_s()
     : device_info_s(detectHostArch(), detectHostOS(), /* native */ true,
@@ -471,8 +586,15 @@ device_info_s::device_info_s(host::arch arch, host::os os, bool native,
   this->max_samplers = 0;
 #endif
 
-  // we have only one queue on host
-  this->queue_types[mux_queue_type_compute] = 1;
+  // Queue 0 executes on all CPUs, followed by one queue per CPU partition.
+  if (native) {
+    cpu_partitions = os_cpu_partitions();
+#ifdef __linux__
+    numa_nodes = os_read_cpu_list("/sys/devices/system/node/online");
+#endif
+  }
+  this->queue_types[mux_queue_type_compute] =
+      1 + static_cast<uint32_t>(cpu_partitions.size());
 
   this->device_priority = 0;
 
@@ -518,11 +640,31 @@ device_info_s::device_info_s(host::arch arch, host::os os, bool native,
     this->query_counter_support = false;
     this->max_hardware_counters = 0;
   }
+#elif defined(CA_HOST_ENABLE_PERF_COUNTERS)
+  this->query_counter_support = false;
+  this->max_hardware_counters = 0;
+  // The events are counted on this machine's threads, so there are none to
+  // report when cross compiling.
+  if (native) {
+    auto errorOrCounterArray = initPerfCounters();
+    if (errorOrCounterArray.has_value() &&
+        !errorOrCounterArray.value().empty()) {
+      this->query_counter_support = true;
+      this->perf_counters = std::move(errorOrCounterArray.value());
+      // The kernel multiplexes hardware events when there are more than it
+      // has counters for, scaling their results up, so any number can be used.
+      this->max_hardware_counters = std::numeric_limits<uint32_t>::max();
+    }
+  }
 #else
   this->query_counter_support = false;
 #endif
   this->descriptors_updatable = true;
   this->can_clone_command_buffers = true;
+  this->supports_indirect_ndrange = true;
+  // Each dispatch runs on the thread pool as soon as its semaphores are
+  // signalled, independent dispatches share the threads.
+  this->supports_concurrent_dispatch = true;
   this->max_sub_group_count = this->max_concurrent_work_items;
   this->sub_groups_support_ifp = false;
   this->supports_work_group_collectives = true;
@@ -579,10 +721,25 @@ host::device_info_s &device_info_s::getHostInstance() {
 }
 
 device_s::device_s(device_info_s *info, mux_allocator_info_t allocator_info)
-    : queue(allocator_info, this) {
+    : queue(allocator_info, this, &thread_pool, queue_mutex),
+      allocator_info(allocator_info),
+      partitions(allocator_info) {
   this->info = info;
 }
 
+device_s::~device_s() {
+  mux::allocator allocator(allocator_info);
+  for (auto *partition : partitions) {
+    allocator.destroy(partition);
+  }
+}
+
+device_s::partition_s::partition_s(mux_allocator_info_t allocator,
+                                   device_s *device,
+                                   cargo::array_view<const uint32_t> cpus)
+    : thread_pool(cpus),
+      queue(allocator, device, &thread_pool, device->queue_mutex) {}
+
 }  // namespace host
 
 mux_result_t hostGetDeviceInfos(uint32_t device_types,
@@ -625,8 +782,25 @@ mux_result_t hostCreateDevices(uint64_t devices_length,
     return mux_error_out_of_memory;
   }
 
-  out_devices[0] = new (allocation)
-      host::device_s(&host::device_info_s::getHostInstance(), allocator);
+  auto &device_info = host::device_info_s::getHostInstance();
+  auto *device = new (allocation) host::device_s(&device_info, allocator);
+
+  // Create the queues executing on partitions of the CPUs.
+  mux::allocator partition_allocator(allocator);
+  for (const auto &cpus : device_info.cpu_partitions) {
+    auto *partition = partition_allocator.create<host::device_s::partition_s>(
+        allocator, device, cpus);
+    if (nullptr == partition ||
+        cargo::success != device->partitions.push_back(partition)) {
+      if (partition) {
+        partition_allocator.destroy(partition);
+      }
+      partition_allocator.destroy(device);
+      return mux_error_out_of_memory;
+    }
+  }
+
+  out_devices[0] = device;
 
   return mux_success;
 }
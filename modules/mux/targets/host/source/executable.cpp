@@ -15,6 +15,7 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include <cargo/string_algorithm.h>
+#include <host/arena.h>
 #include <host/device.h>
 #include <host/executable.h>
 #include <host/host.h>
@@ -25,6 +26,7 @@
 #include <mux/utils/allocator.h>
 #include <utils/system.h>
 
+#include <cstring>
 #include <memory>
 #include <new>
 
@@ -39,7 +41,8 @@ host::executable_s::executable_s(mux_device_t device,
                   std::vector<binary_kernel_s>(
                       {{kernel.hook, kernel.name, kernel.local_memory_used,
                         kernel.min_work_width, kernel.pref_work_width,
-                        kernel.sub_group_size}}));
+                        kernel.sub_group_size, kernel.arena_size,
+                        kernel.arena_size_per_work_item}}));
 }
 
 host::executable_s::executable_s(
@@ -172,6 +175,19 @@ mux_result_t hostCreateExecutable(mux_device_t device, const void *binary,
         return mux_error_invalid_binary;
       }
       variant.hook = *hook;
+
+      // Kernels which place work-group state in the arena report the size
+      // they need alongside their hook.
+      const std::string arena_size_name =
+          variant.kernel_name + host::arena_s::size_symbol_suffix;
+      if (auto arena_size = elf_map.getSymbolTargetAddress(
+              {arena_size_name.data(), arena_size_name.size()})) {
+        uint64_t reported[2];
+        std::memcpy(reported, reinterpret_cast<const void *>(*arena_size),
+                    sizeof(reported));
+        variant.arena_size = reported[0];
+        variant.arena_size_per_work_item = reported[1];
+      }
     }
   }
 
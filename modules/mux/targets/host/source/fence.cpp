@@ -22,7 +22,9 @@
 namespace host {
 
 fence_s::fence_s(mux_device_t device)
-    : thread_pool_signal{false}, result{mux_error_internal} {
+    : thread_pool_signal{false},
+      result{mux_error_internal},
+      thread_pool{nullptr} {
   this->device = device;
 }
 
@@ -35,8 +37,12 @@ mux_result_t fence_s::tryWait(uint64_t timeout) {
   // If timeout is UINT64_MAX, we need to wait on fence instead of timeout
   // value.
   if (timeout == UINT64_MAX) {
-    auto *hostDevice = static_cast<host::device_s *>(device);
-    hostDevice->thread_pool.wait(&thread_pool_signal);
+    // Wait on the thread pool of the queue the fence was dispatched to, which
+    // is the one that will signal it.
+    auto *pool = thread_pool
+                     ? thread_pool
+                     : &static_cast<host::device_s *>(device)->thread_pool;
+    pool->wait(&thread_pool_signal);
     assert((result != mux_error_internal) &&
            "Thread pool was signalled yet no fence result was set");
     return result;
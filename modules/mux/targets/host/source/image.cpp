@@ -44,6 +44,16 @@ image_s::image_s(mux_memory_requirements_s memory_requirements,
 
 #ifdef HOST_IMAGE_SUPPORT
 namespace {
+/// @brief Check if images may be stored in a tiled layout, setting the
+/// CA_HOST_IMAGE_TILING environment variable to 0 stores all images linearly.
+bool isImageTilingEnabled() {
+  static const bool enabled = [] {
+    const char *env = std::getenv("CA_HOST_IMAGE_TILING");
+    return nullptr == env || 0 != std::atoi(env);
+  }();
+  return enabled;
+}
+
 inline cl_image_format getImageFormat(mux_image_format_e format) {
   return {static_cast<cl_channel_order>(format & 0xffff),
           static_cast<cl_channel_type>((format & 0xffff0000) >> 16)};
@@ -284,6 +294,9 @@ void hostDestroyImage(mux_device_t device, mux_image_t image,
 #ifdef HOST_IMAGE_SUPPORT
   mux::allocator allocator(allocator_info);
   auto hostImage = static_cast<host::image_s *>(image);
+  if (hostImage->tiledMemory) {
+    hostImage->tiledMemory->tiledImage = nullptr;
+  }
   allocator.destroy(hostImage);
 #else
   (void)image;
@@ -307,6 +320,24 @@ mux_result_t hostBindImageMemory(mux_device_t device, mux_memory_t memory,
   // NOTE: Bind the device memory
   libimg::HostAttachImageStorage(&hostImage->image, pointer);
 
+  // NOTE: 2D and 3D images in device memory are stored in a tiled layout so
+  // neighbouring rows, as accessed by stencils and linear filtering, share
+  // cache lines and pages. Host access is only possible by mapping the memory,
+  // which presents a linear copy of the image, so the memory must not already
+  // hold another tiled image. The copy is only synchronised by the flush entry
+  // points, so the memory stops being host coherent.
+  if (hostMemory->supportsTiledImages() && !hostMemory->tiledImage &&
+      isImageTilingEnabled() &&
+      libimg::HostIsImageLayoutSupported(&hostImage->image,
+                                         IMAGE_LAYOUT_TILED)) {
+    libimg::HostSetImageLayout(&hostImage->image, IMAGE_LAYOUT_TILED);
+    hostImage->tiling = mux_image_tiling_optimal;
+    hostImage->tiledMemory = hostMemory;
+    hostMemory->tiledImage = hostImage;
+    hostMemory->tiledImageOffset = offset;
+    hostMemory->properties &= ~mux_memory_property_host_coherent;
+  }
+
   return mux_success;
 #else
   (void)memory;
@@ -41,6 +41,27 @@ inline void setPreferredSizes(host::kernel_s &hostKernel) {
   hostKernel.preferred_local_size_z =
       std::min(4u, hostKernel.device->info->max_work_group_size_z);
 }
+
+/// @brief Get the size of an argument in the packed arguments.
+///
+/// @param[in] descriptor Descriptor of the argument.
+///
+/// @return Returns the size in bytes.
+size_t getPackedArgSize(const mux_descriptor_info_t &descriptor) {
+  switch (descriptor.type) {
+    case mux_descriptor_info_type_sampler:
+    case mux_descriptor_info_type_shared_local_buffer:
+      return sizeof(size_t);
+    case mux_descriptor_info_type_buffer:
+    case mux_descriptor_info_type_null_buffer:
+    case mux_descriptor_info_type_image:
+      return sizeof(void *);
+    case mux_descriptor_info_type_plain_old_data:
+      return descriptor.plain_old_data_descriptor.length;
+    default:
+      return 0;
+  }
+}
 }  // namespace
 
 namespace host {
@@ -48,13 +69,17 @@ kernel_variant_s::kernel_variant_s(std::string name, entry_hook_t hook,
                                    size_t local_memory_used,
                                    uint32_t min_work_width,
                                    uint32_t pref_work_width,
-                                   uint32_t sub_group_size)
+                                   uint32_t sub_group_size,
+                                   size_t arena_size,
+                                   size_t arena_size_per_work_item)
     : name(name),
       hook(hook),
       local_memory_used(local_memory_used),
       min_work_width(min_work_width),
       pref_work_width(pref_work_width),
-      sub_group_size(sub_group_size) {}
+      sub_group_size(sub_group_size),
+      arena_size(arena_size),
+      arena_size_per_work_item(arena_size_per_work_item) {}
 
 // Kernel with a built-in kernel
 kernel_s::kernel_s(mux_device_t device, mux::allocator allocator,
@@ -85,6 +110,63 @@ kernel_s::kernel_s(mux_device_t device, mux_allocator_info_t allocator_info,
   }
   setPreferredSizes(*this);
 }
+
+kernel_s::~kernel_s() {
+  mux::allocator allocator(allocator_info);
+  for (auto *layout = arg_layouts.load(); layout;) {
+    auto *const next = layout->next;
+    allocator.destroy(layout);
+    layout = next;
+  }
+}
+
+bool arg_layout_s::matches(
+    cargo::array_view<const mux_descriptor_info_t> descriptors) const {
+  if (descriptors.size() != args.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < descriptors.size(); i++) {
+    if (descriptors[i].type != args[i].type ||
+        getPackedArgSize(descriptors[i]) != args[i].size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const arg_layout_s *kernel_s::getArgLayout(
+    cargo::array_view<const mux_descriptor_info_t> descriptors) {
+  auto *head = arg_layouts.load(std::memory_order_acquire);
+  for (auto *layout = head; layout; layout = layout->next) {
+    if (layout->matches(descriptors)) {
+      return layout;
+    }
+  }
+
+  mux::allocator allocator(allocator_info);
+  auto *const layout = allocator.create<arg_layout_s>(allocator);
+  if (nullptr == layout) {
+    return nullptr;
+  }
+  if (layout->args.alloc(descriptors.size())) {
+    allocator.destroy(layout);
+    return nullptr;
+  }
+  for (size_t i = 0; i < descriptors.size(); i++) {
+    const size_t size = getPackedArgSize(descriptors[i]);
+    layout->args[i] = {descriptors[i].type, size, layout->size};
+    layout->size += size;
+  }
+
+  // Two threads racing to add the same layout both succeed, which is harmless
+  // as either layout is correct and the race only happens once.
+  layout->next = head;
+  while (!arg_layouts.compare_exchange_weak(layout->next, layout,
+                                            std::memory_order_release,
+                                            std::memory_order_acquire)) {
+  }
+  return layout;
+}
 }  // namespace host
 
 mux_result_t hostCreateBuiltInKernel(mux_device_t device, const char *name,
@@ -140,7 +222,8 @@ mux_result_t hostCreateKernel(mux_device_t device, mux_executable_t executable,
         std::string(name, name_length),
         reinterpret_cast<host::kernel_variant_s::entry_hook_t>(v.hook),
         v.local_memory_used, v.min_work_width, v.pref_work_width,
-        v.sub_group_size});
+        v.sub_group_size, static_cast<size_t>(v.arena_size),
+        static_cast<size_t>(v.arena_size_per_work_item)});
     if (err != cargo::success) {
       return mux_error_out_of_memory;
     }
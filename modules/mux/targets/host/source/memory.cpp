@@ -16,30 +16,279 @@
 
 #include <host/device.h>
 #include <host/host.h>
+#include <host/image.h>
 #include <host/memory.h>
 #include <mux/utils/allocator.h>
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
+#include <iterator>
+#include <new>
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace host {
-memory_s::memory_s(uint64_t size, uint32_t properties, void *data, bool useHost)
+memory_s::memory_s(uint64_t size, uint32_t properties, void *data, bool useHost,
+                   mux_allocation_type_e allocationType)
 
-    : data(data), useHost(useHost) {
+    : data(data), useHost(useHost), allocationType(allocationType) {
   this->size = size;
   this->properties = properties;
   this->handle = reinterpret_cast<uintptr_t>(data);
 }
+
+void *memory_s::getMappedPointer(uint64_t offset) {
+  uint8_t *base = mapping ? mapping.get() : static_cast<uint8_t *>(data);
+  return base + offset;
+}
+
+#ifdef HOST_IMAGE_SUPPORT
+namespace {
+/// @brief Calls `copyImage(imageOffset, imageSize)` for the part of the range
+/// of the memory which overlaps the tiled image, and `copyBytes(offset, size)`
+/// for the parts which do not, or for the whole range if the image has been
+/// destroyed.
+template <class CopyImage, class CopyBytes>
+void splitRangeByImage(const memory_s &memory, uint64_t offset, uint64_t size,
+                       CopyImage &&copyImage, CopyBytes &&copyBytes) {
+  if (!memory.tiledImage) {
+    copyBytes(offset, size);
+    return;
+  }
+  const uint64_t end = offset + size;
+  const auto &image = *memory.tiledImage;
+  const uint64_t imageBegin = memory.tiledImageOffset;
+  const uint64_t imageEnd = imageBegin + image.memory_requirements.size;
+  if (end <= imageBegin || offset >= imageEnd) {
+    copyBytes(offset, size);
+    return;
+  }
+  if (offset < imageBegin) {
+    copyBytes(offset, imageBegin - offset);
+  }
+  if (end > imageEnd) {
+    copyBytes(imageEnd, end - imageEnd);
+  }
+  // The image can only be rearranged in whole pixels, widen the range to the
+  // pixels it touches.
+  const uint64_t pixelSize = image.pixel_size;
+  const uint64_t begin = std::max(offset, imageBegin) - imageBegin;
+  const uint64_t last = std::min(end, imageEnd) - imageBegin;
+  const uint64_t pixelBegin = begin - (begin % pixelSize);
+  const uint64_t pixelEnd = ((last + pixelSize - 1) / pixelSize) * pixelSize;
+  copyImage(pixelBegin, pixelEnd - pixelBegin);
+}
+}  // namespace
+
+void memory_s::copyToMapping(uint64_t offset, uint64_t size) {
+  uint8_t *const dst = mapping.get();
+  splitRangeByImage(
+      *this, offset, size,
+      [&](uint64_t imageOffset, uint64_t imageSize) {
+        libimg::HostCopyImageToLinear(&tiledImage->image, imageOffset,
+                                      imageSize, dst + tiledImageOffset);
+      },
+      [&](uint64_t byteOffset, uint64_t byteSize) {
+        std::memcpy(dst + byteOffset, static_cast<uint8_t *>(data) + byteOffset,
+                    byteSize);
+      });
+}
+
+void memory_s::copyFromMapping(uint64_t offset, uint64_t size) {
+  const uint8_t *const src = mapping.get();
+  splitRangeByImage(
+      *this, offset, size,
+      [&](uint64_t imageOffset, uint64_t imageSize) {
+        libimg::HostCopyLinearToImage(&tiledImage->image, imageOffset,
+                                      imageSize, src + tiledImageOffset);
+      },
+      [&](uint64_t byteOffset, uint64_t byteSize) {
+        std::memcpy(static_cast<uint8_t *>(data) + byteOffset, src + byteOffset,
+                    byteSize);
+      });
+}
+#else
+void memory_s::copyToMapping(uint64_t, uint64_t) {}
+
+void memory_s::copyFromMapping(uint64_t, uint64_t) {}
+#endif
 }  // namespace host
 
+#if defined(__linux__) && !defined(__ANDROID__)
+namespace {
+/// @brief Size of a huge page, allocations at least this large are mapped
+/// directly so they can be backed by huge pages and placed on NUMA nodes.
+constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+/// @brief Kind of huge pages backing large allocations.
+enum huge_pages_e {
+  /// @brief Large allocations are made with the user's allocator.
+  huge_pages_none = 0,
+  /// @brief Transparent huge pages, used where the kernel enables them.
+  huge_pages_transparent = 1,
+  /// @brief Pages from the kernel's pool of huge pages, falling back to
+  /// transparent huge pages when the pool is exhausted.
+  huge_pages_explicit = 2,
+};
+
+/// @brief Get the kind of huge pages set by the CA_HOST_HUGE_PAGES environment
+/// variable, transparent huge pages by default.
+huge_pages_e getHugePages() {
+  static const huge_pages_e huge_pages = [] {
+    const char *env = std::getenv("CA_HOST_HUGE_PAGES");
+    if (nullptr == env) {
+      return huge_pages_transparent;
+    }
+    switch (std::atoi(env)) {
+      case 0:
+        return huge_pages_none;
+      case 2:
+        return huge_pages_explicit;
+      default:
+        return huge_pages_transparent;
+    }
+  }();
+  return huge_pages;
+}
+
+/// @brief Set the NUMA placement of pages mapped for a large allocation, before
+/// they are first touched.
+///
+/// The CA_HOST_MEMORY_NODE environment variable chooses the node the pages are
+/// preferably placed on, e.g. the node of the queue partition which processes
+/// them, and `-1` leaves them on the node of the thread which first touches
+/// them. By default, or if the variable isn't a node number, they are
+/// interleaved over all the nodes so kernels running on every CPU share the
+/// bandwidth of all nodes.
+///
+/// @param info Device the memory is allocated on.
+/// @param data Pages mapped for the allocation.
+/// @param size Size of the mapped pages.
+void placeMappedMemory(const host::device_info_s &info, void *data,
+                       size_t size) {
+  static const long node = [] {
+    const char *env = std::getenv("CA_HOST_MEMORY_NODE");
+    if (nullptr == env) {
+      return -2l;
+    }
+    char *end = nullptr;
+    const long value = std::strtol(env, &end, 10);
+    return end == env || *end != '\0' || value < -1 ? -2l : value;
+  }();
+  if (-1 == node) {
+    return;
+  }
+
+  constexpr size_t bits = sizeof(unsigned long) * 8;
+  unsigned long mask[1024 / bits] = {};
+  int mode = MPOL_INTERLEAVE;
+  if (node >= 0) {
+    mode = MPOL_PREFERRED;
+    if (static_cast<size_t>(node) >= std::size(mask) * bits) {
+      return;
+    }
+    mask[node / bits] |= 1ul << (node % bits);
+  } else {
+    if (info.numa_nodes.size() < 2) {
+      return;
+    }
+    for (const uint32_t numa_node : info.numa_nodes) {
+      if (numa_node < std::size(mask) * bits) {
+        mask[numa_node / bits] |= 1ul << (numa_node % bits);
+      }
+    }
+  }
+  // Best effort, the memory works just as well wherever the kernel puts it.
+  (void)syscall(SYS_mbind, data, size, mode, mask, std::size(mask) * bits + 1,
+                0);
+}
+
+/// @brief Map pages for a large allocation, backed by huge pages.
+///
+/// @param info Device the memory is allocated on.
+/// @param size Size of the allocation.
+/// @param[out] mapped_size Size of the mapped pages.
+///
+/// @return Returns the pages aligned to a huge page, or null if the allocation
+/// should be made with the user's allocator instead.
+void *mapLargeMemory(const host::device_info_s &info, size_t size,
+                     size_t &mapped_size) {
+  const huge_pages_e huge_pages = getHugePages();
+  if (!info.native || size < huge_page_size || huge_pages_none == huge_pages) {
+    return nullptr;
+  }
+  const size_t length = (size + huge_page_size - 1) & ~(huge_page_size - 1);
+
+  void *data = MAP_FAILED;
+  if (huge_pages_explicit == huge_pages) {
+    data = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  }
+  if (MAP_FAILED == data) {
+    // Transparent huge pages only back whole aligned huge pages, so map an
+    // extra huge page and trim the mapping down to an aligned one.
+    auto *const mapped = static_cast<uint8_t *>(
+        mmap(nullptr, length + huge_page_size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (MAP_FAILED == static_cast<void *>(mapped)) {
+      return nullptr;
+    }
+    const size_t misalignment =
+        reinterpret_cast<uintptr_t>(mapped) % huge_page_size;
+    const size_t head = misalignment ? huge_page_size - misalignment : 0;
+    if (head) {
+      munmap(mapped, head);
+    }
+    if (huge_page_size - head) {
+      munmap(mapped + head + length, huge_page_size - head);
+    }
+    data = mapped + head;
+#ifdef MADV_HUGEPAGE
+    // Best effort, the memory works just as well without huge pages.
+    (void)madvise(data, length, MADV_HUGEPAGE);
+#endif
+  }
+
+  placeMappedMemory(info, data, length);
+  mapped_size = length;
+  return data;
+}
+}  // namespace
+#endif
+
+namespace {
+/// @brief Free the memory backing a `host::memory_s` allocated by
+/// `hostAllocateMemory`.
+///
+/// @param allocator Allocator the memory was allocated with, if not mapped.
+/// @param data Memory to free.
+/// @param mapped_size Size of the pages mapped for `data`, or 0.
+void freeAllocatedMemory(mux::allocator &allocator, void *data,
+                         size_t mapped_size) {
+#if defined(__linux__) && !defined(__ANDROID__)
+  if (mapped_size) {
+    munmap(data, mapped_size);
+    return;
+  }
+#else
+  (void)mapped_size;
+#endif
+  allocator.free(data);
+}
+}  // namespace
+
 mux_result_t hostAllocateMemory(mux_device_t device, size_t size, uint32_t heap,
                                 uint32_t memory_properties,
                                 mux_allocation_type_e allocation_type,
                                 uint32_t alignment,
                                 mux_allocator_info_t allocator_info,
                                 mux_memory_t *out_memory) {
-  (void)device;
-  (void)allocation_type;
-
   mux::allocator allocator(allocator_info);
 
   // Ensure the specified heap is valid, as heaps are target specific the check
@@ -60,17 +309,30 @@ mux_result_t hostAllocateMemory(mux_device_t device, size_t size, uint32_t heap,
   // Align all allocations to at least 128 bytes to match the size of the
   // largest 16-wide OpenCL-C vector types.
   const size_t host_align = std::max(128u, alignment);
-  void *host_pointer = allocator.alloc(size, host_align);
+  void *host_pointer = nullptr;
+  size_t mapped_size = 0;
+#if defined(__linux__) && !defined(__ANDROID__)
+  if (host_align <= huge_page_size) {
+    host_pointer = mapLargeMemory(
+        *static_cast<host::device_info_s *>(device->info), size, mapped_size);
+  }
+#else
+  (void)device;
+#endif
+  if (nullptr == host_pointer) {
+    host_pointer = allocator.alloc(size, host_align);
+  }
   if (nullptr == host_pointer) {
     return mux_error_out_of_memory;
   }
 
-  auto memory = allocator.create<host::memory_s>(size, memory_properties,
-                                                 host_pointer, false);
+  auto memory = allocator.create<host::memory_s>(
+      size, memory_properties, host_pointer, false, allocation_type);
   if (nullptr == memory) {
-    allocator.free(host_pointer);
+    freeAllocatedMemory(allocator, host_pointer, mapped_size);
     return mux_error_out_of_memory;
   }
+  memory->mappedSize = mapped_size;
 
   *out_memory = memory;
 
@@ -87,8 +349,9 @@ mux_result_t hostCreateMemoryFromHost(mux_device_t device, size_t size,
   // Our host device has coherent memory with the host-side platform
   const uint32_t memory_properties =
       mux_memory_property_host_visible | mux_memory_property_host_coherent;
-  auto memory = allocator.create<host::memory_s>(size, memory_properties,
-                                                 host_pointer, true);
+  auto memory = allocator.create<host::memory_s>(
+      size, memory_properties, host_pointer, true,
+      mux_allocation_type_alloc_host);
 
   if (nullptr == memory) {
     return mux_error_out_of_memory;
@@ -107,7 +370,7 @@ void hostFreeMemory(mux_device_t device, mux_memory_t memory,
   auto hostMemory = static_cast<host::memory_s *>(memory);
 
   if (!hostMemory->useHost) {
-    allocator.free(hostMemory->data);
+    freeAllocatedMemory(allocator, hostMemory->data, hostMemory->mappedSize);
   }
 
   allocator.destroy(hostMemory);
@@ -120,10 +383,20 @@ mux_result_t hostMapMemory(mux_device_t device, mux_memory_t memory,
   auto hostMemory = static_cast<host::memory_s *>(memory);
 
   // NOTE: On host we can't map a range of virtual memory because the entire
-  // memory block is already addressable due to using unified memory.
+  // memory block is already addressable due to using unified memory. Memory
+  // holding a tiled image is the exception, the host is presented with a copy
+  // of the memory in which the image is laid out linearly. That memory isn't
+  // host coherent, so the copy is only filled by flushing ranges from the
+  // device, which callers do when the map command executes on the queue
+  // rather than here.
   (void)size;
-  void *addressMap = hostMemory->data;
-  *out_data = static_cast<unsigned char *>(addressMap) + offset;
+  if (hostMemory->tiledImage && !hostMemory->mapping) {
+    hostMemory->mapping.reset(new (std::nothrow) uint8_t[hostMemory->size]);
+    if (!hostMemory->mapping) {
+      return mux_error_out_of_memory;
+    }
+  }
+  *out_data = hostMemory->getMappedPointer(offset);
 
   return mux_success;
 }
@@ -132,12 +405,13 @@ mux_result_t hostFlushMappedMemoryToDevice(mux_device_t device,
                                            mux_memory_t memory, uint64_t offset,
                                            uint64_t size) {
   (void)device;
-  (void)memory;
-  (void)offset;
-  (void)size;
 
   // NOTE: On host flushing is a noop because we take advantage of unified
-  // memory.
+  // memory, unless the memory holds a tiled image.
+  auto hostMemory = static_cast<host::memory_s *>(memory);
+  if (hostMemory->mapping) {
+    hostMemory->copyFromMapping(offset, size);
+  }
 
   return mux_success;
 }
@@ -146,21 +420,25 @@ mux_result_t hostFlushMappedMemoryFromDevice(mux_device_t device,
                                              mux_memory_t memory,
                                              uint64_t offset, uint64_t size) {
   (void)device;
-  (void)memory;
-  (void)offset;
-  (void)size;
 
   // NOTE: On host flushing is a noop because we take advantage of unified
-  // memory.
+  // memory, unless the memory holds a tiled image.
+  auto hostMemory = static_cast<host::memory_s *>(memory);
+  if (hostMemory->mapping) {
+    hostMemory->copyToMapping(offset, size);
+  }
 
   return mux_success;
 }
 
 mux_result_t hostUnmapMemory(mux_device_t device, mux_memory_t memory) {
   (void)device;
-  (void)memory;
 
-  // NOTE: On host unmap is a noop because we take advantage of unified memory.
+  // NOTE: On host unmap is a noop because we take advantage of unified memory,
+  // unless the memory holds a tiled image in which case the linear copy is
+  // discarded.
+  auto hostMemory = static_cast<host::memory_s *>(memory);
+  hostMemory->mapping.reset();
 
   return mux_success;
 }
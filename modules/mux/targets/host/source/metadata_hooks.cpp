@@ -66,8 +66,8 @@ cargo::optional<kernel_variant_map> readBinaryMetadata(loader::ElfFile *elf,
   kernel_variant_map kernels;
 
   md_hooks hooks = getHostMdReadHooks();
-  // The handler below uses this userdata in its destructor, so it must be
-  // alive longer than the handler.
+  // The handler below reads kernel entries in place from the section mapped
+  // through this userdata, so it must be alive longer than the handler.
   ElfUserdata userdata{elf, alloc};
   handler::VectorizeInfoMetadataHandler handler;
 
@@ -88,7 +88,9 @@ cargo::optional<kernel_variant_map> readBinaryMetadata(loader::ElfFile *elf,
         static_cast<uint32_t>(md.local_memory_usage),
         md.min_work_item_factor.getFixedValue(),
         md.pref_work_item_factor.getFixedValue(),
-        md.sub_group_size.getFixedValue()};
+        md.sub_group_size.getFixedValue(),
+        /*arena_size*/ 0,
+        /*arena_size_per_work_item*/ 0};
     auto it = kernels.find(md.source_name);
     if (it != kernels.end()) {
       it->second.push_back(kernel);
@@ -0,0 +1,109 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cargo/small_vector.h>
+#include <host/perf_counter.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+/// @brief The events host reports, the uuid of each is its index.
+const host::host_perf_counter perf_counters[] = {
+    {0, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles",
+     "CPU cycles", mux_query_counter_unit_cycles},
+    {1, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions",
+     "Retired instructions", mux_query_counter_unit_generic},
+    {2, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES, "cache-references",
+     "Last level cache accesses", mux_query_counter_unit_generic},
+    {3, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, "cache-misses",
+     "Last level cache misses", mux_query_counter_unit_generic},
+    {4, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+     "branch-instructions", "Retired branch instructions",
+     mux_query_counter_unit_generic},
+    {5, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "branch-misses",
+     "Mispredicted branch instructions", mux_query_counter_unit_generic},
+    {6, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, "task-clock",
+     "Time spent running on a CPU", mux_query_counter_unit_nanoseconds},
+    {7, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, "context-switches",
+     "Context switches", mux_query_counter_unit_generic},
+    {8, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS, "cpu-migrations",
+     "Migrations to another CPU", mux_query_counter_unit_generic},
+    {9, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, "page-faults",
+     "Page faults", mux_query_counter_unit_generic},
+};
+}  // namespace
+
+namespace host {
+
+bool host_perf_counter::isHardware() const {
+  return type == PERF_TYPE_HARDWARE;
+}
+
+const host_perf_counter *getPerfCounter(uint32_t uuid) {
+  if (uuid >= std::size(perf_counters)) {
+    return nullptr;
+  }
+  return &perf_counters[uuid];
+}
+
+int openPerfEvent(const host_perf_counter &counter, pid_t thread_id) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = counter.type;
+  attr.config = counter.config;
+  // Events are enabled by the begin query command, and only count user space,
+  // which is all `perf_event_paranoid` allows by default.
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // When there are more events than hardware counters the kernel multiplexes
+  // them, these times are used to scale the count up to the whole period.
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, thread_id,
+                                  /* cpu */ -1, /* group_fd */ -1,
+                                  PERF_FLAG_FD_CLOEXEC));
+}
+
+cargo::expected<cargo::dynamic_array<host_perf_counter>, mux_result_t>
+initPerfCounters() {
+  cargo::small_vector<host_perf_counter, std::size(perf_counters)>
+      counter_buffer;
+  for (const auto &counter : perf_counters) {
+    // Events which can't be opened now won't be openable on the worker
+    // threads either, so are not reported.
+    const int fd = openPerfEvent(counter, 0);
+    if (fd < 0) {
+      continue;
+    }
+    close(fd);
+    if (counter_buffer.push_back(counter)) {
+      return cargo::make_unexpected(mux_error_out_of_memory);
+    }
+  }
+
+  cargo::dynamic_array<host_perf_counter> out_array;
+  if (out_array.alloc(counter_buffer.size())) {
+    return cargo::make_unexpected(mux_error_out_of_memory);
+  }
+  std::copy_n(counter_buffer.begin(), counter_buffer.size(), out_array.begin());
+  return {std::move(out_array)};
+}
+}  // namespace host
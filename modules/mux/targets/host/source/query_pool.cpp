@@ -22,12 +22,25 @@
 #include <papi.h>
 #endif
 
+#ifdef CA_HOST_ENABLE_PERF_COUNTERS
+#include <host/perf_counter.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#endif
+
 cargo::expected<host::query_pool_s *, mux_result_t> host::query_pool_s::create(
     mux_query_type_e query_type, uint32_t query_count, mux::allocator allocator,
     const mux_query_counter_config_t *query_configs, mux_queue_t queue) {
-#ifdef CA_HOST_ENABLE_PAPI_COUNTERS
-  auto host_device = static_cast<host::device_s *>(queue->device);
-  auto thread_count = host_device->thread_pool.initialized_threads;
+#if defined(CA_HOST_ENABLE_PAPI_COUNTERS) || \
+    defined(CA_HOST_ENABLE_PERF_COUNTERS)
+  // Counters are collected on the threads of the queue's own pool, which must
+  // be running for their thread IDs to be known.
+  auto &thread_pool = *static_cast<host::queue_s *>(queue)->thread_pool;
+  thread_pool.start();
+  auto thread_count = thread_pool.initialized_threads;
 #endif
   // Calculate the result storage offset past the end of the query_pool_s.
   // FIXME: This wastes sizeof(mux_query_duration_result_s) bytes when
@@ -41,6 +54,11 @@ cargo::expected<host::query_pool_s *, mux_result_t> host::query_pool_s::create(
   } else if (query_type == mux_query_type_counter) {
     query_data_offset = sizeof(query_pool_s) + sizeof(host_papi_event_info_s) -
                         sizeof(query_pool_s) % sizeof(host_papi_event_info_s);
+#endif
+#ifdef CA_HOST_ENABLE_PERF_COUNTERS
+  } else if (query_type == mux_query_type_counter) {
+    query_data_offset = sizeof(query_pool_s) + sizeof(host_perf_event_info_s) -
+                        sizeof(query_pool_s) % sizeof(host_perf_event_info_s);
 #endif
   }
   // Calculate the total size of the allocation.
@@ -53,6 +71,15 @@ cargo::expected<host::query_pool_s *, mux_result_t> host::query_pool_s::create(
   } else if (query_type == mux_query_type_counter) {
     query_size = sizeof(host_papi_event_info_s) * thread_count;
     query_align = alignof(host_papi_event_info_s);
+#endif
+#ifdef CA_HOST_ENABLE_PERF_COUNTERS
+  } else if (query_type == mux_query_type_counter) {
+    // Each thread's events are tracked by an event info, followed by the
+    // results of all threads and then by the file descriptors of all threads.
+    query_size = (sizeof(host_perf_event_info_s) +
+                  (sizeof(uint64_t) + sizeof(int)) * query_count) *
+                 thread_count;
+    query_align = alignof(host_perf_event_info_s);
 #endif
   }
   const size_t alloc_size = query_data_offset + query_size;
@@ -79,10 +106,10 @@ cargo::expected<host::query_pool_s *, mux_result_t> host::query_pool_s::create(
         event_info_begin, event_info_begin + thread_count);
     // Create and store a `host_papi_event_info_s` for each worker thread.
     for (size_t thread_index = 0; thread_index < thread_count; thread_index++) {
-      auto thread_id = host_device->thread_pool.pool[thread_index].get_id();
+      auto thread_id = thread_pool.pool[thread_index].get_id();
       host_papi_event_info_s event_info = {
           PAPI_NULL,
-          host_device->thread_pool.thread_ids[thread_id],
+          thread_pool.getPid(thread_id),
           {},
           nullptr};
       // Each `host_papi_event_info_s` wraps a papi event set.
@@ -135,6 +162,44 @@ cargo::expected<host::query_pool_s *, mux_result_t> host::query_pool_s::create(
       query_pool->papi_event_infos[thread_index] = std::move(event_info);
     }
   }
+#endif
+#ifdef CA_HOST_ENABLE_PERF_COUNTERS
+  if (query_type == mux_query_type_counter) {
+    auto event_info_begin =
+        static_cast<host_perf_event_info_s *>(query_pool->data);
+    auto results_begin =
+        reinterpret_cast<uint64_t *>(event_info_begin + thread_count);
+    auto fds_begin =
+        reinterpret_cast<int *>(results_begin + thread_count * query_count);
+    query_pool->perf_event_infos = cargo::array_view<host_perf_event_info_s>(
+        event_info_begin, event_info_begin + thread_count);
+    // Initialize every event info first so a failure to open an event can
+    // close the ones opened before it.
+    for (size_t thread_index = 0; thread_index < thread_count; thread_index++) {
+      auto thread_id = thread_pool.pool[thread_index].get_id();
+      auto fds = fds_begin + thread_index * query_count;
+      auto results = results_begin + thread_index * query_count;
+      std::fill_n(fds, query_count, -1);
+      new (&query_pool->perf_event_infos[thread_index]) host_perf_event_info_s{
+          thread_pool.getPid(thread_id),
+          cargo::array_view<int>(fds, fds + query_count),
+          cargo::array_view<uint64_t>(results, results + query_count)};
+    }
+    // Open each requested counter on each worker thread.
+    for (auto &event_info : query_pool->perf_event_infos) {
+      for (uint32_t query_index = 0; query_index < query_count; query_index++) {
+        auto counter = getPerfCounter(query_configs[query_index].uuid);
+        auto fd = counter ? openPerfEvent(*counter, event_info.thread_id) : -1;
+        if (fd < 0) {
+          query_pool->freeEvents(allocator);
+          allocator.destroy(query_pool);
+          return cargo::make_unexpected(counter ? mux_error_failure
+                                                : mux_error_invalid_value);
+        }
+        event_info.fds[query_index] = fd;
+      }
+    }
+  }
 #endif
   // Finally reset the result storage to zeros ready for use.
   query_pool->reset();
@@ -160,6 +225,11 @@ void host::query_pool_s::reset() {
     }
   }
 #endif
+#ifdef CA_HOST_ENABLE_PERF_COUNTERS
+  if (type == mux_query_type_counter) {
+    reset(0, count);
+  }
+#endif
 }
 
 void host::query_pool_s::reset(size_t offset, size_t count) {
@@ -179,6 +249,16 @@ void host::query_pool_s::reset(size_t offset, size_t count) {
     }
   }
 #endif
+#ifdef CA_HOST_ENABLE_PERF_COUNTERS
+  if (type == mux_query_type_counter) {
+    for (auto &event_info : perf_event_infos) {
+      for (size_t i = offset; i < offset + count; i++) {
+        event_info.results[i] = 0;
+        ioctl(event_info.fds[i], PERF_EVENT_IOC_RESET, 0);
+      }
+    }
+  }
+#endif
 }
 
 #ifdef CA_HOST_ENABLE_PAPI_COUNTERS
@@ -293,26 +373,86 @@ mux_result_t host::query_pool_s::readPapiResults(
 
 #endif
 
+#ifdef CA_HOST_ENABLE_PERF_COUNTERS
+void host::query_pool_s::startEvents() {
+  for (const auto &event_info : perf_event_infos) {
+    for (auto fd : event_info.fds) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+}
+
+void host::query_pool_s::endEvents() {
+  for (auto &event_info : perf_event_infos) {
+    for (size_t i = 0; i < event_info.fds.size(); i++) {
+      const int fd = event_info.fds[i];
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      // The value followed by the time enabled and running, as requested in
+      // the event's `read_format`.
+      uint64_t values[3] = {};
+      if (read(fd, values, sizeof(values)) != sizeof(values) || !values[2]) {
+        event_info.results[i] = 0;
+      } else if (values[2] < values[1]) {
+        // The event was multiplexed with others, scale it up to the whole
+        // time it was enabled for.
+        event_info.results[i] = static_cast<uint64_t>(
+            static_cast<double>(values[0]) * values[1] / values[2]);
+      } else {
+        event_info.results[i] = values[0];
+      }
+    }
+  }
+}
+
+void host::query_pool_s::freeEvents(mux::allocator &) {
+  for (auto &event_info : perf_event_infos) {
+    for (auto fd : event_info.fds) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+}
+
+mux_result_t host::query_pool_s::readPerfResults(
+    mux_query_counter_result_s *results, size_t result_count,
+    size_t query_index) {
+  for (size_t result_index = 0; result_index < result_count; result_index++) {
+    results[result_index].uint64 = 0;
+    for (const auto &event_info : perf_event_infos) {
+      results[result_index].uint64 +=
+          event_info.results[query_index + result_index];
+    }
+  }
+  return mux_success;
+}
+#endif
+
 mux_result_t hostGetSupportedQueryCounters(
     mux_device_t device, mux_queue_type_e queue_type, uint32_t count,
     mux_query_counter_t *out_counters,
     mux_query_counter_description_t *out_descriptions, uint32_t *out_count) {
-#ifdef CA_HOST_ENABLE_PAPI_COUNTERS
+#if defined(CA_HOST_ENABLE_PAPI_COUNTERS) || \
+    defined(CA_HOST_ENABLE_PERF_COUNTERS)
   auto host_device_info = static_cast<host::device_info_s *>(device->info);
+#ifdef CA_HOST_ENABLE_PAPI_COUNTERS
+  const auto &counters = host_device_info->papi_counters;
+#else
+  const auto &counters = host_device_info->perf_counters;
+#endif
   if (out_count) {
-    *out_count = static_cast<uint32_t>(host_device_info->papi_counters.size());
+    *out_count = static_cast<uint32_t>(counters.size());
   }
 
   // We only need to enter to loop if we have either of the out buffers.
   if (out_counters || out_descriptions) {
     for (uint32_t i = 0; i < count; i++) {
       if (out_counters) {
-        host_device_info->papi_counters[i].populateMuxQueryCounter(
-            &out_counters[i]);
+        counters[i].populateMuxQueryCounter(&out_counters[i]);
       }
       if (out_descriptions) {
-        host_device_info->papi_counters[i].populateMuxQueryCounterDescription(
-            &out_descriptions[i]);
+        counters[i].populateMuxQueryCounterDescription(&out_descriptions[i]);
       }
     }
   }
@@ -349,7 +489,8 @@ void hostDestroyQueryPool(mux_queue_t queue, mux_query_pool_t query_pool,
   (void)queue;
   mux::allocator allocator(allocator_info);
   auto host_query_pool = static_cast<host::query_pool_s *>(query_pool);
-#ifdef CA_HOST_ENABLE_PAPI_COUNTERS
+#if defined(CA_HOST_ENABLE_PAPI_COUNTERS) || \
+    defined(CA_HOST_ENABLE_PERF_COUNTERS)
   host_query_pool->freeEvents(allocator);
 #endif
   allocator.destroy(host_query_pool);
@@ -361,7 +502,8 @@ mux_result_t hostGetQueryCounterRequiredPasses(
     uint32_t *out_pass_count) {
   (void)queue;
   (void)query_counter_configs;
-#ifdef CA_HOST_ENABLE_PAPI_COUNTERS
+#if defined(CA_HOST_ENABLE_PAPI_COUNTERS) || \
+    defined(CA_HOST_ENABLE_PERF_COUNTERS)
   for (uint32_t i = 0; i < query_count; i++) {
     out_pass_count[i] = 1;
   }
@@ -395,6 +537,10 @@ mux_result_t hostGetQueryPoolResults(mux_queue_t queue,
     return host_query_pool->readPapiResults(
         static_cast<mux_query_counter_result_s *>(data), query_count,
         query_index);
+#elif defined(CA_HOST_ENABLE_PERF_COUNTERS)
+    return host_query_pool->readPerfResults(
+        static_cast<mux_query_counter_result_s *>(data), query_count,
+        query_index);
 #else
     return mux_error_feature_unsupported;
 #endif
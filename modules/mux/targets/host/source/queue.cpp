@@ -14,6 +14,7 @@
 //
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <host/arena.h>
 #include <host/buffer.h>
 #include <host/command_buffer.h>
 #include <host/device.h>
@@ -32,10 +33,13 @@
 #include <libimg/host.h>
 #endif
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
 #include <memory>
 #include <new>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -44,6 +48,47 @@ namespace {
 /// kernel exists early, which allows other threads to pickup the extra work.
 constexpr size_t slice_multiplier = 1;
 
+/// @brief Work shared by every slice of an ND range.
+struct ndrange_work_s {
+  host::kernel_variant_s variant;
+  /// @brief Global size of the ND range, read from the work-group count
+  /// buffer for indirect ND ranges.
+  std::array<size_t, 3> global_size;
+  /// @brief Arena size each slice's thread should provide.
+  size_t arena_size;
+  /// @brief Largest arena size any slice reported it required.
+  std::atomic<size_t> arena_required{0};
+};
+
+/// @brief Estimate the arena size an ND range needs before it first runs.
+///
+/// The compiler reports the arena size of the kernel's own state, including
+/// the barrier live variables of each work-item, but not the `__local` buffer
+/// arguments. The kernel reports its exact requirements once it has run,
+/// which are remembered on the kernel for later enqueues.
+size_t estimateArenaSize(host::kernel_s *kernel,
+                         const host::kernel_variant_s &variant,
+                         const host::ndrange_info_s *ndrange_info) {
+  const size_t work_items = ndrange_info->local_size[0] *
+                            ndrange_info->local_size[1] *
+                            ndrange_info->local_size[2];
+  size_t size = std::max(variant.local_memory_used, variant.arena_size) +
+                variant.arena_size_per_work_item * work_items;
+  for (const auto &arg : ndrange_info->arg_layout->args) {
+    if (arg.type == mux_descriptor_info_type_shared_local_buffer) {
+      // The packed arguments hold the sizes of local buffers, which are
+      // aligned to 128 bytes.
+      size_t local_size;
+      std::memcpy(&local_size,
+                  static_cast<uint8_t *>(ndrange_info->packed_args) +
+                      arg.offset,
+                  sizeof(size_t));
+      size += local_size + 128;
+    }
+  }
+  return std::max(size, kernel->arena_size_required.load());
+}
+
 void threadPoolCleanup(void *const v_queue, void *const v_command_buffer,
                        void *const v_fence, size_t terminate) {
   auto queue = static_cast<host::queue_s *>(v_queue);
@@ -230,73 +275,212 @@ void commandCopyBufferToImage(host::command_info_s *info) {
 #endif
 }
 
-void commandNDRange(host::queue_s *queue, host::command_info_s *info) {
-  host::command_info_ndrange_s *const ndrange = &(info->ndrange_command);
+/// @brief Check if consecutive ND ranges may be fused into one round of the
+/// thread pool, setting the CA_HOST_FUSE_NDRANGES environment variable to 0
+/// dispatches each ND range separately.
+bool isNDRangeFusionEnabled() {
+  static const bool enabled = [] {
+    const char *env = std::getenv("CA_HOST_FUSE_NDRANGES");
+    return nullptr == env || 0 != std::atoi(env);
+  }();
+  return enabled;
+}
 
+/// @brief Consecutive ND ranges executed in a single round of the thread pool.
+///
+/// Each thread that picks the round up takes slices of the ND ranges in order
+/// from `next_slice`, and only starts a slice of an ND range once every slice
+/// of the ND range before it has completed, so the ND ranges still execute one
+/// after another without returning to the thread pool in between. Threads only
+/// ever wait on slices which have already been taken by a running thread, so
+/// the round completes however few of the pool's threads pick it up.
+struct fused_ndranges_s {
+  /// @brief Maximum number of ND ranges in a round, longer sequences of ND
+  /// ranges take several rounds.
+  static constexpr size_t max_ndranges = 16;
+
+  std::array<ndrange_work_s, max_ndranges> work;
+  std::array<const host::command_info_ndrange_s *, max_ndranges> ndranges;
+  size_t num_ndranges = 0;
+  /// @brief Number of slices each ND range is divided into.
+  size_t slices = 0;
+  /// @brief Index of the next slice to run, counting across all ND ranges.
+  std::atomic<size_t> next_slice{0};
+  /// @brief Number of slices of each ND range which have completed.
+  std::array<std::atomic<size_t>, max_ndranges> completed{};
+};
+
+/// @brief Prepare an ND range command to be executed.
+///
+/// @param[in] ndrange ND range command to prepare.
+/// @param[out] work Work shared by every slice of the ND range.
+///
+/// @return Returns true if the ND range can be executed, false otherwise.
+bool prepareNDRange(const host::command_info_ndrange_s *ndrange,
+                    ndrange_work_s *work) {
   auto host_kernel = static_cast<host::kernel_s *>(ndrange->kernel);
-
-  auto host_device = static_cast<host::device_s *>(queue->device);
-
-  const size_t slices =
-      host_device->thread_pool.num_threads() * slice_multiplier;
+  const host::ndrange_info_s *const ndrange_info = ndrange->ndrange_info;
 
   host::kernel_variant_s variant;
   if (mux_success != host_kernel->getKernelVariantForWGSize(
-                         info->ndrange_command.ndrange_info->local_size[0],
-                         info->ndrange_command.ndrange_info->local_size[1],
-                         info->ndrange_command.ndrange_info->local_size[2],
-                         &variant)) {
-    return;
+                         ndrange_info->local_size[0],
+                         ndrange_info->local_size[1],
+                         ndrange_info->local_size[2], &variant)) {
+    return false;
+  }
+
+  work->variant = std::move(variant);
+  if (ndrange_info->group_count_buffer) {
+    // Work-group counts are only known once the commands before this one
+    // have executed.
+    auto *const buffer =
+        static_cast<host::buffer_s *>(ndrange_info->group_count_buffer);
+    const auto *const counts = reinterpret_cast<const uint32_t *>(
+        static_cast<const uint8_t *>(buffer->data) +
+        ndrange_info->group_count_offset);
+    for (size_t k = 0; k < 3; k++) {
+      work->global_size[k] = k < ndrange_info->dimensions
+                                 ? counts[k] * ndrange_info->local_size[k]
+                                 : 1;
+    }
+  } else {
+    work->global_size = ndrange_info->global_size;
+  }
+  work->arena_size =
+      estimateArenaSize(host_kernel, work->variant, ndrange_info);
+  work->arena_required = 0;
+  return true;
+}
+
+/// @brief Execute one slice of an ND range on the calling thread.
+void runNDRangeSlice(ndrange_work_s *work,
+                     const host::ndrange_info_s *ndrange_info, size_t slice,
+                     size_t total_slices) {
+  tracer::recordFlowStep<tracer::Impl>(ndrange_info->trace_flow_id);
+
+  for (uint8_t k = 0; k < ndrange_info->dimensions; ++k) {
+    if (work->global_size[k] == 0) {
+      return;
+    }
+  }
+
+  host::schedule_info_s schedule_info;
+
+  for (uint8_t k = 0; k < 3; k++) {
+    schedule_info.global_size[k] = work->global_size[k];
+    schedule_info.global_offset[k] = ndrange_info->global_offset[k];
+    schedule_info.local_size[k] = ndrange_info->local_size[k];
+  }
+  schedule_info.slice = slice;
+  schedule_info.total_slices = total_slices;
+  schedule_info.work_dim = static_cast<uint32_t>(ndrange_info->dimensions);
+
+  // Work-group state lives in this thread's arena where it fits, the kernel
+  // falls back to the stack otherwise.
+  auto &arena = host::arena_s::get();
+  arena.reserve(work->arena_size);
+  schedule_info.arena = arena.data;
+  schedule_info.arena_size = arena.size;
+  schedule_info.arena_required = 0;
+
+  work->variant.hook(ndrange_info->packed_args, &schedule_info);
+
+  size_t required = work->arena_required.load();
+  while (schedule_info.arena_required > required &&
+         !work->arena_required.compare_exchange_weak(
+             required, schedule_info.arena_required)) {
+  }
+}
+
+/// @brief Execute a sequence of consecutive ND range commands.
+///
+/// As many of the ND ranges as possible are executed in a single round of the
+/// thread pool, which saves a round trip through the thread pool for each ND
+/// range after the first. This matters most for chains of small kernels,
+/// where that round trip is a large part of each kernel's execution time.
+///
+/// @param[in] queue Queue executing the commands.
+/// @param[in] infos First of the ND range commands.
+/// @param[in] count Number of consecutive ND range commands at `infos`.
+///
+/// @return Returns the number of the commands which were executed, at least
+/// one.
+size_t commandNDRanges(host::queue_s *queue, host::command_info_s *infos,
+                       size_t count) {
+  const tracer::TraceGuard<tracer::Impl> traceGuard(__func__);
+
+  // Slice the work across the threads of the queue's own pool.
+  auto thread_pool = queue->thread_pool;
+
+  fused_ndranges_s fused;
+  fused.slices = thread_pool->num_threads() * slice_multiplier;
+
+  size_t executed = 0;
+  for (; executed < count && fused.num_ndranges < fused.max_ndranges;
+       executed++) {
+    const host::command_info_ndrange_s *const ndrange =
+        &infos[executed].ndrange_command;
+    // The work-group counts of an indirect ND range are read before the round
+    // starts, so it can't follow an ND range in the same round which might
+    // write them.
+    if (executed != 0 && ndrange->ndrange_info->group_count_buffer) {
+      break;
+    }
+    tracer::recordFlowStep<tracer::Impl>(ndrange->ndrange_info->trace_flow_id);
+    // ND ranges without a kernel variant for their local size are skipped.
+    if (prepareNDRange(ndrange, &fused.work[fused.num_ndranges])) {
+      fused.ndranges[fused.num_ndranges] = ndrange;
+      fused.num_ndranges++;
+    }
+  }
+
+  if (0 == fused.num_ndranges) {
+    return executed;
   }
 
   constexpr size_t signal_count =
       host::thread_pool_s::max_num_threads * slice_multiplier;
   std::array<std::atomic<bool>, signal_count> signals;
   std::atomic<uint32_t> queued(0);
-  host_device->thread_pool.enqueue_range(
-      [](void *const in, void *const info, void *fence, size_t index) {
-        auto *const kernel_variant = static_cast<host::kernel_variant_s *>(in);
-        auto *const ndrange = static_cast<host::command_info_ndrange_s *>(info);
-        auto *const ndrange_info = ndrange->ndrange_info;
-        auto host_device =
-            static_cast<host::device_s *>(ndrange->kernel->device);
-
-        for (uint8_t k = 0; k < ndrange_info->dimensions; ++k) {
-          if (ndrange_info->global_size[k] == 0) {
-            return;
+  thread_pool->enqueue_range(
+      [](void *const in, void *const, void *const, size_t) {
+        auto *const fused = static_cast<fused_ndranges_s *>(in);
+        const size_t total = fused->num_ndranges * fused->slices;
+        for (size_t next = fused->next_slice++; next < total;
+             next = fused->next_slice++) {
+          const size_t index = next / fused->slices;
+          const size_t slice = next % fused->slices;
+
+          // Lightweight barrier between ND ranges, the slices of the previous
+          // ND range have all been taken by threads which are running them.
+          if (index != 0) {
+            while (fused->completed[index - 1].load(std::memory_order_acquire) <
+                   fused->slices) {
+              std::this_thread::yield();
+            }
           }
-        }
-
-        host::schedule_info_s schedule_info;
 
-        for (uint8_t k = 0; k < 3; k++) {
-          schedule_info.global_size[k] = ndrange_info->global_size[k];
-          schedule_info.global_offset[k] = ndrange_info->global_offset[k];
-          schedule_info.local_size[k] = ndrange_info->local_size[k];
+          runNDRangeSlice(&fused->work[index],
+                          fused->ndranges[index]->ndrange_info, slice,
+                          fused->slices);
+          fused->completed[index].fetch_add(1, std::memory_order_release);
         }
-        schedule_info.slice = index;
-        schedule_info.total_slices =
-            (host_device->thread_pool.num_threads() * slice_multiplier);
-        schedule_info.work_dim =
-            static_cast<uint32_t>(ndrange_info->dimensions);
-
-        kernel_variant->hook(ndrange_info->packed_args, &schedule_info);
       },
-      &variant, ndrange, signals, &queued, slices);
+      &fused, nullptr, nullptr, signals, &queued, fused.slices);
 
   // Ensure all threads to be done with 'queued' by the time it gets destroyed.
-  host_device->thread_pool.wait(&queued);
+  thread_pool->wait(&queued);
   {
-    std::unique_lock<std::mutex> lock(host_device->thread_pool.wait_mutex);
-    host_device->thread_pool.finished.wait(lock,
-                                           [&queued] { return queued == 0; });
+    std::unique_lock<std::mutex> lock(thread_pool->wait_mutex);
+    thread_pool->finished.wait(lock, [&queued] { return queued == 0; });
   }
 
   // We do need to wait on for 'queued' to be 0 explicitly here, despite the
   // thread_pool.wait and the fact that each signals[i] was set under the same
   // lock that is used when changing 'queued'. This was discovered as seeing
   // that another thread managed to somehow trigger the counter ('queued')
-  // after it being freed (exiting the scope of the `commandNDRange` function).
+  // after it being freed (exiting the scope of the `commandNDRanges`
+  // function).
   //
   // It was previously assumed that when the final signal that was signalled
   // 'queued' was set to 0 under the same lock and thus 'queued' must always be
@@ -304,6 +488,21 @@ void commandNDRange(host::queue_s *queue, host::command_info_s *info) {
   // investigation is required on this to get rid of the inneficiency of the
   // extra atomic synchronisation used to guarantee the thread-safety here.
   assert(0 == queued);
+
+  // Remember what the kernels needed so that later enqueues size the arenas
+  // up front.
+  for (size_t index = 0; index < fused.num_ndranges; index++) {
+    auto host_kernel =
+        static_cast<host::kernel_s *>(fused.ndranges[index]->kernel);
+    const size_t required = fused.work[index].arena_required.load();
+    size_t known = host_kernel->arena_size_required.load();
+    while (required > known &&
+           !host_kernel->arena_size_required.compare_exchange_weak(known,
+                                                                   required)) {
+    }
+  }
+
+  return executed;
 }
 
 void commandUserCallback(host::queue_s *queue, host::command_info_s *info,
@@ -339,7 +538,8 @@ void commandUserCallback(host::queue_s *queue, host::command_info_s *info,
   return duration_query;
 }
 
-#ifdef CA_HOST_ENABLE_PAPI_COUNTERS
+#if defined(CA_HOST_ENABLE_PAPI_COUNTERS) || \
+    defined(CA_HOST_ENABLE_PERF_COUNTERS)
 void commandBeginQuery(host::command_info_s *info) {
   host::command_info_begin_query_s *const begin_query =
       &(info->begin_query_command);
@@ -410,9 +610,19 @@ void threadPoolProcessCommands(void *const v_queue,
       case host::command_type_copy_buffer_to_image:
         commandCopyBufferToImage(info);
         break;
-      case host::command_type_ndrange:
-        commandNDRange(queue, info);
-        break;
+      case host::command_type_ndrange: {
+        // Consecutive ND ranges are executed together, unless each needs to
+        // be timed by a duration query.
+        size_t count = 1;
+        if (!duration_query && isNDRangeFusionEnabled()) {
+          while (i + count < e &&
+                 host::command_type_ndrange ==
+                     command_buffer->commands[i + count].type) {
+            count++;
+          }
+        }
+        i += commandNDRanges(queue, info, count) - 1;
+      } break;
       case host::command_type_user_callback:
         commandUserCallback(queue, info, command_buffer);
         break;
@@ -420,7 +630,8 @@ void threadPoolProcessCommands(void *const v_queue,
         if (info->end_query_command.pool->type == mux_query_type_duration) {
           duration_query = commandBeginQuery(info, duration_query);
         }
-#ifdef CA_HOST_ENABLE_PAPI_COUNTERS
+#if defined(CA_HOST_ENABLE_PAPI_COUNTERS) || \
+    defined(CA_HOST_ENABLE_PERF_COUNTERS)
         if (info->end_query_command.pool->type == mux_query_type_counter) {
           commandBeginQuery(info);
         }
@@ -430,7 +641,8 @@ void threadPoolProcessCommands(void *const v_queue,
         if (info->end_query_command.pool->type == mux_query_type_duration) {
           duration_query = commandEndQuery(info, duration_query);
         }
-#ifdef CA_HOST_ENABLE_PAPI_COUNTERS
+#if defined(CA_HOST_ENABLE_PAPI_COUNTERS) || \
+    defined(CA_HOST_ENABLE_PERF_COUNTERS)
         if (info->end_query_command.pool->type == mux_query_type_counter) {
           commandEndQuery(info);
         }
@@ -453,8 +665,12 @@ void threadPoolProcessCommands(void *const v_queue,
 }  // namespace
 
 namespace host {
-queue_s::queue_s(mux_allocator_info_t allocator, mux_device_t device)
-    : runningGroups(0), signalInfos(allocator) {
+queue_s::queue_s(mux_allocator_info_t allocator, mux_device_t device,
+                 thread_pool_s *thread_pool, std::mutex &mutex)
+    : runningGroups(0),
+      thread_pool(thread_pool),
+      mutex(mutex),
+      signalInfos(allocator) {
   this->device = device;
 }
 
@@ -466,7 +682,6 @@ void queue_s::signalCompleted(mux_command_buffer_t group, bool terminate) {
                                    return group == info.first;
                                  });
   if (signalInfos.end() != signalInfo) {
-    auto hostDevice = static_cast<device_s *>(group->device);
     auto hostGroup = static_cast<command_buffer_s *>(group);
     auto *hostFence = static_cast<fence_s *>(signalInfo->second.fence);
     auto *threadPoolSignal =
@@ -476,18 +691,17 @@ void queue_s::signalCompleted(mux_command_buffer_t group, bool terminate) {
       // and fire off a no-op enqueue to the thread pool because another thread
       // could already be waiting for the group via the thread pool, so we need
       // to signal wait complete in the normal way.
-      hostDevice->thread_pool.enqueue(threadPoolCleanup, this, hostGroup,
-                                      hostFence, true, threadPoolSignal,
-                                      &this->runningGroups);
+      thread_pool->enqueue(threadPoolCleanup, this, hostGroup, hostFence, true,
+                           threadPoolSignal, &this->runningGroups);
     } else {
       // we got a signal, so decrement the wait count
       (signalInfo->second.wait_count)--;
 
       // if we were the last signal on the group, run it!
       if (0 == signalInfo->second.wait_count) {
-        hostDevice->thread_pool.enqueue(threadPoolProcessCommands, this,
-                                        hostGroup, hostFence, false,
-                                        threadPoolSignal, &this->runningGroups);
+        thread_pool->enqueue(threadPoolProcessCommands, this, hostGroup,
+                             hostFence, false, threadPoolSignal,
+                             &this->runningGroups);
 
         // lastly wipe the tracking info for the group
         signalInfos.erase(signalInfo);
@@ -500,14 +714,12 @@ void queue_s::signalCompleted(mux_command_buffer_t group, bool terminate) {
 mux_result_t queue_s::addGroup(mux_command_buffer_t group, mux_fence_t fence,
                                uint64_t numWaits) {
   if (0 == numWaits) {
-    auto *hostDevice = static_cast<device_s *>(group->device);
     auto *hostGroup = static_cast<command_buffer_s *>(group);
     auto *hostFence = static_cast<fence_s *>(fence);
     auto *hostThreadPoolSignal =
         hostFence ? &hostFence->thread_pool_signal : nullptr;
-    hostDevice->thread_pool.enqueue(threadPoolProcessCommands, this, hostGroup,
-                                    hostFence, 0, hostThreadPoolSignal,
-                                    &this->runningGroups);
+    thread_pool->enqueue(threadPoolProcessCommands, this, hostGroup, hostFence,
+                         0, hostThreadPoolSignal, &this->runningGroups);
   } else {
     const signal_info_s signal_info{numWaits, fence};
     if (signalInfos.emplace_back(group, signal_info)) {
@@ -519,11 +731,19 @@ mux_result_t queue_s::addGroup(mux_command_buffer_t group, mux_fence_t fence,
 }
 }  // namespace host
 
-mux_result_t hostGetQueue(mux_device_t device, mux_queue_type_e, uint32_t,
-                          mux_queue_t *out_queue) {
+mux_result_t hostGetQueue(mux_device_t device, mux_queue_type_e,
+                          uint32_t queue_index, mux_queue_t *out_queue) {
   auto hostDevice = static_cast<host::device_s *>(device);
 
-  *out_queue = &(hostDevice->queue);
+  // Queue 0 executes on every CPU, the remaining queues each execute on their
+  // own partition of the CPUs, see host::device_info_s::cpu_partitions.
+  if (0 == queue_index) {
+    *out_queue = &(hostDevice->queue);
+  } else if (queue_index <= hostDevice->partitions.size()) {
+    *out_queue = &(hostDevice->partitions[queue_index - 1]->queue);
+  } else {
+    return mux_error_invalid_value;
+  }
 
   return mux_success;
 }
@@ -554,6 +774,7 @@ mux_result_t hostDispatch(
   // The fence is optional, it may be null.
   if (hostFence) {
     hostFence->reset();
+    hostFence->thread_pool = hostQueue->thread_pool;
   }
 
   // track the group in the queue...
@@ -562,7 +783,7 @@ mux_result_t hostDispatch(
   // ...then tell the semaphores in the wait list about the group
   for (uint64_t i = 0; i < wait_semaphores_length; i++) {
     auto *semaphore = static_cast<host::semaphore_s *>(wait_semaphores[i]);
-    semaphore->addWait(command_buffer);
+    semaphore->addWait(hostQueue, command_buffer);
   }
 
   return mux_success;
@@ -578,8 +799,7 @@ mux_result_t hostTryWait(mux_queue_t queue, uint64_t timeout,
 
 mux_result_t hostWaitAll(mux_queue_t queue) {
   auto host = static_cast<host::queue_s *>(queue);
-  auto hostDevice = static_cast<host::device_s *>(host->device);
-  auto &hostPool = hostDevice->thread_pool;
+  auto &hostPool = *host->thread_pool;
 
   // Wait for all work to have left the thread pool, this occurs when the
   // runningGroups atomic reaches zero.
@@ -31,27 +31,25 @@ void semaphore_s::signal(bool terminate) {
   signalled = true;
   failed = terminate;
 
-  // This is only called from hostDispatch which already holds a lock on the
-  // queues mutex.
-  auto &hostQueue = static_cast<host::device_s *>(device)->queue;
-
+  // This is only called with a lock held on the device's queue mutex, which
+  // is shared by all of its queues.
   // Run through our waits to signal them.
   for (size_t i = 0; i < waitingGroups.size(); i++) {
-    auto command_buffer = waitingGroups[i];
-    hostQueue.signalCompleted(command_buffer, terminate);
+    auto &waitingGroup = waitingGroups[i];
+    waitingGroup.first->signalCompleted(waitingGroup.second, terminate);
   }
 }
 
-mux_result_t semaphore_s::addWait(mux_command_buffer_t group) {
+mux_result_t semaphore_s::addWait(host::queue_s *queue,
+                                  mux_command_buffer_t group) {
   // Check if the semaphore has already been signalled.
   if (signalled) {
     // This is only called from hostDispatch which already holds a lock on the
     // queues mutex.
-    static_cast<host::device_s *>(this->device)
-        ->queue.signalCompleted(group, failed);
+    queue->signalCompleted(group, failed);
   } else {
     // and save the queue and group onto the list
-    if (cargo::success != waitingGroups.push_back(group)) {
+    if (cargo::success != waitingGroups.push_back({queue, group})) {
       return mux_error_out_of_memory;
     }
   }
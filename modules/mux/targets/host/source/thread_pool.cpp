@@ -18,6 +18,11 @@
 
 #include <algorithm>
 
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 namespace {
 
 /// Number of threads in pool is total_cores - ca_free_hw_threads.
@@ -63,7 +68,8 @@ void threadFuncBody(host::thread_pool_s *const me,
 
 /// The function for each cargo::thread to call.
 void threadFunc(host::thread_pool_s *const me) {
-#ifdef CA_HOST_ENABLE_PAPI_COUNTERS
+#if defined(CA_HOST_ENABLE_PAPI_COUNTERS) || \
+    defined(CA_HOST_ENABLE_PERF_COUNTERS)
   me->registerPid();
 #endif
   host::thread_pool_work_item_s item;
@@ -103,12 +109,15 @@ thread_pool_s::thread_pool_s() : stayAlive(true) {
 
   // Must be set before num_threads() is called.
   initialized_threads = std::min({desired_threads, max_threads, debug_threads});
-  for (size_t i = 0, e = num_threads(); i < e; i++) {
-    pool[i] = cargo::thread(threadFunc, this);
-    pool[i].set_name("host:pool:" + std::to_string(i));
-  }
+  start();
 }
 
+thread_pool_s::thread_pool_s(cargo::array_view<const uint32_t> cpus)
+    : initialized_threads(std::min(std::max<size_t>(cpus.size(), 1),
+                                   thread_pool_s::max_num_threads)),
+      stayAlive(true),
+      cpus(cpus.begin(), cpus.end()) {}
+
 thread_pool_s::~thread_pool_s() {
   const tracer::TraceGuard<tracer::Impl> traceGuard(__func__);
 
@@ -120,12 +129,47 @@ thread_pool_s::~thread_pool_s() {
   // wake up all our threads
   new_work.notify_all();
 
-  // wait for all our threads
-  for (size_t i = 0, e = num_threads(); i < e; i++) {
+  // wait for all our threads, if they were ever started
+  for (size_t i = 0, e = started ? num_threads() : 0; i < e; i++) {
     pool[i].join();
   }
 }
 
+void thread_pool_s::start() {
+  const std::lock_guard<std::mutex> guard(mutex);
+  startThreads();
+}
+
+void thread_pool_s::startThreads() {
+  if (started) {
+    return;
+  }
+  started = true;
+
+#if defined(__linux__) && !defined(__ANDROID__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (const uint32_t cpu : cpus) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+#endif
+
+  // The threads block on `mutex` in getWork() until the caller releases it.
+  for (size_t i = 0, e = num_threads(); i < e; i++) {
+    pool[i] = cargo::thread(threadFunc, this);
+    pool[i].set_name("host:pool:" + std::to_string(i));
+#if defined(__linux__) && !defined(__ANDROID__)
+    if (!cpus.empty()) {
+      // Pinning is a hint, if it fails the thread simply runs unpinned.
+      (void)pthread_setaffinity_np(pool[i].native_handle(), sizeof(cpu_set),
+                                   &cpu_set);
+    }
+#endif
+  }
+}
+
 bool thread_pool_s::getWork(thread_pool_work_item_s *const work) {
   if (!stayAlive) {
     return false;
@@ -189,6 +233,7 @@ void thread_pool_s::enqueue(function_t function, void *user_data,
 
   {
     std::unique_lock<std::mutex> lock(mutex);
+    startThreads();
 
     unsigned next_write_index = (queue_write_index + 1) % queue_max;
 
@@ -103,6 +103,11 @@ struct command_ndrange_s {
   std::array<size_t, 3> global_offset;
   std::array<size_t, 3> local_size;
   size_t dimensions;
+  /// @brief Buffer the work-group counts are read from when the command
+  /// executes, or null if `global_size` is used as is.
+  riscv::buffer_s *group_count_buffer = nullptr;
+  /// @brief Offset in bytes of the work-group counts in `group_count_buffer`.
+  uint64_t group_count_offset = 0;
 
   void operator()(riscv::queue_s *queue, bool &error);
 };
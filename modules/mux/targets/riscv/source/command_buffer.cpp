@@ -83,10 +83,31 @@ void command_ndrange_s::operator()(riscv::queue_s *queue, bool &error) {
     error = true;
     return;
   }
+  // work-group counts of indirect ndranges are only known once the commands
+  // before this one have executed
+  std::array<size_t, 3> exec_global_size = global_size;
+  if (group_count_buffer) {
+    std::array<uint32_t, 3> counts = {1, 1, 1};
+    if (!hal_device->mem_read(counts.data(),
+                              group_count_buffer->targetPtr + group_count_offset,
+                              dimensions * sizeof(uint32_t))) {
+      hal_device->program_free(program);
+      error = true;
+      return;
+    }
+    for (size_t i = 0; i < dimensions; i++) {
+      exec_global_size[i] = counts[i] * local_size[i];
+    }
+    if (std::any_of(exec_global_size.begin(), exec_global_size.end(),
+                    [](size_t size) { return size == 0; })) {
+      hal_device->program_free(program);
+      return;
+    }
+  }
   // copy across the ndrange to run
   const hal::hal_ndrange_t hal_ndrange = {
       {global_offset[0], global_offset[1], global_offset[2]},
-      {global_size[0], global_size[1], global_size[2]},
+      {exec_global_size[0], exec_global_size[1], exec_global_size[2]},
       {local_size[0], local_size[1], local_size[2]}};
   // execute the kernel
   bool success =
@@ -792,12 +813,25 @@ void setHALArgs(mux::dynamic_array<uint8_t> &pod_data,
 }
 }  // anonymous namespace
 
-mux_result_t riscvCommandNDRange(mux_command_buffer_t command_buffer,
-                                 mux_kernel_t kernel,
-                                 mux_ndrange_options_t options, uint32_t,
-                                 const mux_sync_point_t *,
-                                 mux_sync_point_t *sync_point) {
-  auto riscv = static_cast<riscv::command_buffer_s *>(command_buffer);
+namespace {
+/// @brief Push an ndrange command to a command buffer.
+///
+/// @param[in] riscv Command buffer to push the command to.
+/// @param[in] kernel Kernel to execute.
+/// @param[in] options Execution options, `global_size` is only read if
+/// `group_count_buffer` is null.
+/// @param[in] group_count_buffer Buffer to read the work-group counts from
+/// when the command executes, or null.
+/// @param[in] group_count_offset Offset in bytes of the work-group counts in
+/// `group_count_buffer`.
+/// @param[out] sync_point Sync-point identifying the command, may be null.
+///
+/// @return mux_success, or a mux_error_* if an error occurred.
+mux_result_t pushNDRange(riscv::command_buffer_s *riscv, mux_kernel_t kernel,
+                         const mux_ndrange_options_t &options,
+                         mux_buffer_t group_count_buffer,
+                         uint64_t group_count_offset,
+                         mux_sync_point_t *sync_point) {
   cargo::lock_guard<cargo::mutex> lock(riscv->mutex);
 
   auto *riscv_device = static_cast<riscv::device_s *>(riscv->device);
@@ -833,7 +867,8 @@ mux_result_t riscvCommandNDRange(mux_command_buffer_t command_buffer,
   std::array<size_t, 3> local_size;
   for (size_t i = 0; i < 3; i++) {
     const bool in_range = i < options.dimensions;
-    global_size[i] = in_range ? options.global_size[i] : 1;
+    global_size[i] =
+        in_range && !group_count_buffer ? options.global_size[i] : 1;
     global_offset[i] = in_range ? options.global_offset[i] : 0;
     local_size[i] = options.local_size[i];
   }
@@ -844,7 +879,9 @@ mux_result_t riscvCommandNDRange(mux_command_buffer_t command_buffer,
           static_cast<riscv::kernel_s *>(kernel), kernel_args.data(),
           descriptors.data(), static_cast<uint32_t>(options.descriptors_length),
           pod_data.data(), global_size, global_offset, local_size,
-          options.dimensions})) {
+          options.dimensions,
+          static_cast<riscv::buffer_s *>(group_count_buffer),
+          group_count_offset})) {
     return mux_error_out_of_memory;
   }
 
@@ -872,6 +909,26 @@ mux_result_t riscvCommandNDRange(mux_command_buffer_t command_buffer,
 
   return mux_success;
 }
+}  // anonymous namespace
+
+mux_result_t riscvCommandNDRange(mux_command_buffer_t command_buffer,
+                                 mux_kernel_t kernel,
+                                 mux_ndrange_options_t options, uint32_t,
+                                 const mux_sync_point_t *,
+                                 mux_sync_point_t *sync_point) {
+  return pushNDRange(static_cast<riscv::command_buffer_s *>(command_buffer),
+                     kernel, options, nullptr, 0, sync_point);
+}
+
+mux_result_t riscvCommandNDRangeIndirect(
+    mux_command_buffer_t command_buffer, mux_kernel_t kernel,
+    mux_ndrange_options_t options, mux_buffer_t group_count_buffer,
+    uint64_t group_count_offset, uint32_t, const mux_sync_point_t *,
+    mux_sync_point_t *sync_point) {
+  return pushNDRange(static_cast<riscv::command_buffer_s *>(command_buffer),
+                     kernel, options, group_count_buffer, group_count_offset,
+                     sync_point);
+}
 
 mux_result_t riscvUpdateDescriptors(mux_command_buffer_t command_buffer,
                                     mux_command_id_t command_id,
@@ -1107,7 +1164,8 @@ mux_result_t cloneNDRangeCommand(mux_allocator_info_t allocator_info,
   if (cloned_command_buffer->commands.push_back(riscv::command_ndrange_s{
           original.kernel, kernel_args.data(), descriptors.data(),
           original.num_kernel_args, pod_data.data(), original.global_size,
-          original.global_offset, original.local_size, original.dimensions})) {
+          original.global_offset, original.local_size, original.dimensions,
+          original.group_count_buffer, original.group_count_offset})) {
     return mux_error_out_of_memory;
   }
 
@@ -147,6 +147,8 @@ device_info_s::device_info_s()
   this->descriptors_updatable = true;
   this->supports_builtin_kernels = false;
   this->can_clone_command_buffers = true;
+  this->supports_indirect_ndrange = true;
+  this->supports_concurrent_dispatch = false;
   this->max_sub_group_count = this->max_concurrent_work_items;
   this->sub_groups_support_ifp = false;
   // No known upper limit, so just make it something big enough to not matter.
@@ -129,3 +129,66 @@ TEST_P(muxAllocateMemoryTest, DeviceAlignment) {
     muxFreeMemory(device, memory, allocator);
   }
 }
+
+TEST_P(muxAllocateMemoryTest, AllocLarge) {
+  // Large allocations may be backed differently from small ones, e.g. the host
+  // target maps them directly to use huge pages, so check that they can be
+  // written, read back and freed whichever way they are backed.
+  int property = mux_memory_property_host_visible;
+  if (device->info->allocation_capabilities &
+      mux_allocation_capabilities_coherent_host) {
+    property |= mux_memory_property_host_coherent;
+  } else if (device->info->allocation_capabilities &
+             mux_allocation_capabilities_cached_host) {
+    property |= mux_memory_property_host_cached;
+  } else {
+    GTEST_SKIP();
+  }
+
+  constexpr size_t huge_page_size = 2 * 1024 * 1024;
+  const std::array<size_t, 3> sizes = {
+      huge_page_size, huge_page_size + 1, (2 * huge_page_size) + 123};
+  const std::array<uint32_t, 2> alignments = {0, 4096};
+  for (const size_t size : sizes) {
+    if (size > device->info->allocation_size) {
+      continue;
+    }
+    for (const uint32_t align : alignments) {
+      mux_memory_t memory;
+      ASSERT_SUCCESS(muxAllocateMemory(device, size, 1, property,
+                                       mux_allocation_type_alloc_host, align,
+                                       allocator, &memory));
+      if (align) {
+        EXPECT_TRUE((memory->handle % align) == 0)
+            << "For alignment " << align << " at address 0x" << std::hex
+            << memory->handle << std::dec;
+      }
+
+      uint8_t *data;
+      ASSERT_SUCCESS(muxMapMemory(device, memory, 0, size, (void **)&data));
+      for (size_t i = 0; i < size; i++) {
+        data[i] = static_cast<uint8_t>(i % 251);
+      }
+      ASSERT_SUCCESS(muxFlushMappedMemoryToDevice(device, memory, 0, size));
+      ASSERT_SUCCESS(muxUnmapMemory(device, memory));
+
+      // Map the last bytes on their own, they are past any huge page boundary.
+      const size_t tail = size - 16;
+      ASSERT_SUCCESS(muxMapMemory(device, memory, tail, 16, (void **)&data));
+      ASSERT_SUCCESS(muxFlushMappedMemoryFromDevice(device, memory, tail, 16));
+      for (size_t i = 0; i < 16; i++) {
+        ASSERT_EQ(static_cast<uint8_t>((tail + i) % 251), data[i]);
+      }
+      ASSERT_SUCCESS(muxUnmapMemory(device, memory));
+
+      ASSERT_SUCCESS(muxMapMemory(device, memory, 0, size, (void **)&data));
+      ASSERT_SUCCESS(muxFlushMappedMemoryFromDevice(device, memory, 0, size));
+      for (size_t i = 0; i < size; i++) {
+        ASSERT_EQ(static_cast<uint8_t>(i % 251), data[i]) << "At byte " << i;
+      }
+      ASSERT_SUCCESS(muxUnmapMemory(device, memory));
+
+      muxFreeMemory(device, memory, allocator);
+    }
+  }
+}
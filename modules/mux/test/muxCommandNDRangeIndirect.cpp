@@ -0,0 +1,155 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <mux/utils/helpers.h>
+
+#include "common.h"
+
+enum { GROUP_COUNT_SIZE = 3 * sizeof(uint32_t) };
+
+struct muxCommandNDRangeIndirectTest : DeviceCompilerTest {
+  mux_memory_t memory = nullptr;
+  mux_buffer_t group_count_buffer = nullptr;
+  mux_command_buffer_t command_buffer = nullptr;
+  mux_executable_t executable = nullptr;
+  mux_kernel_t kernel = nullptr;
+
+  const size_t global_offset[3] = {0, 0, 0};
+  mux_ndrange_options_t nd_range_options{};
+
+  void SetUp() override {
+    RETURN_ON_FATAL_FAILURE(DeviceCompilerTest::SetUp());
+
+    ASSERT_SUCCESS(
+        muxCreateCommandBuffer(device, callback, allocator, &command_buffer));
+    ASSERT_SUCCESS(createMuxExecutable("void kernel nop() {}", &executable));
+    ASSERT_SUCCESS(muxCreateKernel(device, executable, "nop", strlen("nop"),
+                                   allocator, &kernel));
+
+    ASSERT_SUCCESS(muxCreateBuffer(device, GROUP_COUNT_SIZE, allocator,
+                                   &group_count_buffer));
+    const mux_allocation_type_e allocation_type =
+        (mux_allocation_capabilities_alloc_device &
+         device->info->allocation_capabilities)
+            ? mux_allocation_type_alloc_device
+            : mux_allocation_type_alloc_host;
+    const uint32_t heap = mux::findFirstSupportedHeap(
+        group_count_buffer->memory_requirements.supported_heaps);
+    ASSERT_SUCCESS(muxAllocateMemory(device, GROUP_COUNT_SIZE, heap,
+                                     mux_memory_property_host_visible,
+                                     allocation_type, 0, allocator, &memory));
+    ASSERT_SUCCESS(muxBindBufferMemory(device, memory, group_count_buffer, 0));
+
+    for (size_t &size : nd_range_options.local_size) {
+      size = 1;
+    }
+    nd_range_options.global_offset = &global_offset[0];
+    nd_range_options.dimensions = 3;
+  }
+
+  void TearDown() override {
+    if (nullptr != group_count_buffer) {
+      muxDestroyBuffer(device, group_count_buffer, allocator);
+    }
+    if (nullptr != memory) {
+      muxFreeMemory(device, memory, allocator);
+    }
+    if (nullptr != kernel) {
+      muxDestroyKernel(device, kernel, allocator);
+    }
+    if (nullptr != executable) {
+      muxDestroyExecutable(device, executable, allocator);
+    }
+    if (nullptr != command_buffer) {
+      muxDestroyCommandBuffer(device, command_buffer, allocator);
+    }
+    DeviceCompilerTest::TearDown();
+  }
+};
+
+INSTANTIATE_DEVICE_TEST_SUITE_P(muxCommandNDRangeIndirectTest);
+
+TEST_P(muxCommandNDRangeIndirectTest, Default) {
+  const mux_result_t result = muxCommandNDRangeIndirect(
+      command_buffer, kernel, nd_range_options, group_count_buffer, 0, 0,
+      nullptr, nullptr);
+  if (!device->info->supports_indirect_ndrange) {
+    ASSERT_ERROR_EQ(mux_error_feature_unsupported, result);
+  } else {
+    ASSERT_SUCCESS(result);
+  }
+}
+
+TEST_P(muxCommandNDRangeIndirectTest, Offset) {
+  if (!device->info->supports_indirect_ndrange) {
+    GTEST_SKIP();
+  }
+  nd_range_options.dimensions = 2;
+  ASSERT_SUCCESS(muxCommandNDRangeIndirect(
+      command_buffer, kernel, nd_range_options, group_count_buffer,
+      sizeof(uint32_t), 0, nullptr, nullptr));
+}
+
+TEST_P(muxCommandNDRangeIndirectTest, InvalidGroupCountBuffer) {
+  if (!device->info->supports_indirect_ndrange) {
+    GTEST_SKIP();
+  }
+  mux_buffer_s invalid_buffer{};
+  ASSERT_ERROR_EQ(mux_error_invalid_value,
+                  muxCommandNDRangeIndirect(command_buffer, kernel,
+                                            nd_range_options, &invalid_buffer,
+                                            0, 0, nullptr, nullptr));
+}
+
+TEST_P(muxCommandNDRangeIndirectTest, UnalignedGroupCountOffset) {
+  if (!device->info->supports_indirect_ndrange) {
+    GTEST_SKIP();
+  }
+  nd_range_options.dimensions = 1;
+  ASSERT_ERROR_EQ(mux_error_invalid_value,
+                  muxCommandNDRangeIndirect(command_buffer, kernel,
+                                            nd_range_options,
+                                            group_count_buffer, 1, 0, nullptr,
+                                            nullptr));
+}
+
+TEST_P(muxCommandNDRangeIndirectTest, GroupCountOutOfBounds) {
+  if (!device->info->supports_indirect_ndrange) {
+    GTEST_SKIP();
+  }
+  ASSERT_ERROR_EQ(mux_error_invalid_value,
+                  muxCommandNDRangeIndirect(
+                      command_buffer, kernel, nd_range_options,
+                      group_count_buffer, sizeof(uint32_t), 0, nullptr,
+                      nullptr));
+}
+
+TEST_P(muxCommandNDRangeIndirectTest, Sync) {
+  if (!device->info->supports_indirect_ndrange) {
+    GTEST_SKIP();
+  }
+  mux_sync_point_t wait = nullptr;
+  ASSERT_SUCCESS(muxCommandNDRangeIndirect(command_buffer, kernel,
+                                           nd_range_options,
+                                           group_count_buffer, 0, 0, nullptr,
+                                           &wait));
+  ASSERT_NE(wait, nullptr);
+
+  ASSERT_SUCCESS(muxCommandNDRangeIndirect(command_buffer, kernel,
+                                           nd_range_options,
+                                           group_count_buffer, 0, 1, &wait,
+                                           nullptr));
+}
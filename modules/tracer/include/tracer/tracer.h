@@ -21,35 +21,64 @@
 #ifndef TRACER_H_INCLUDED
 #define TRACER_H_INCLUDED
 
+#include <atomic>
 #include <cstdint>
 
 namespace tracer {
 /// @addtogroup tracer
 /// @{
 
+/// @brief Phase of a flow event, linking slices across threads.
+enum class FlowPhase : uint8_t {
+  /// @brief Starts a flow in the enclosing slice.
+  Start,
+  /// @brief Continues a flow in the enclosing slice.
+  Step,
+};
+
 /// @brief recordTrace records an event.
-/// @param name usually the function name, or event you wish to record.
-/// @param cat the category of the trace (eg Microseconds).
-/// @param start the start timestamp (eg Microseconds).
-/// @param end the end timestamp.
+/// @param name usually the function name, or event you wish to record, must
+/// outlive the tracer (e.g. a string literal or `__func__`).
+/// @param cat the category of the trace, must outlive the tracer.
+/// @param start the start timestamp in nanoseconds.
+/// @param end the end timestamp in nanoseconds.
 ///
-/// This function is the real meat of tracer - it'll record a trace event to the
-/// .trace file for this execution of the process. The trace produced is
-/// viewable via chrome's tracing mode:
-/// * open chrome and go to chrome://tracing
-/// * open the tracing file
-///   * on Windows these are located at
-///   `%APPDATA%\\.ComputeAortaTracer\\*.trace`
-///   * on Linux these are located at `$HOME/.ComputeAortaTracer/*.trace`
+/// Events are recorded in a fixed size binary form into a ring buffer owned by
+/// the calling thread, whose lock is only contended during a flush, so
+/// recording never waits on other threads or formats a string.
+/// The buffers are converted to the JSON trace event format when the tracer is
+/// flushed, and the trace produced is viewable via chrome's tracing mode or
+/// Perfetto:
+/// * open chrome and go to chrome://tracing, or https://ui.perfetto.dev
+/// * open the tracing file, as named by the `CA_TRACE_FILE` environment
+///   variable
 /// * enjoy the tracing information produced!
 void recordTrace(const char *name, const char *cat, uint64_t start,
                  uint64_t end);
 
-/// @return Returns the current time stamp in Microseconds.
+/// @brief Records a flow event on the calling thread.
+/// @param id identifier of the flow, as returned by `createFlowId`.
+/// @param phase the phase of the flow event.
+///
+/// The flow event binds to the slice enclosing the current time on the calling
+/// thread, so it must be recorded while a `TraceGuard` is in scope.
+void recordFlow(uint64_t id, FlowPhase phase);
+
+/// @return Returns a new, non-zero, flow identifier.
+uint64_t createFlowId();
+
+/// @brief Writes all recorded events to the trace file.
+///
+/// This is called automatically when the process exits, calling it earlier
+/// allows inspecting long running processes or bounding the ring buffers.
+void flush();
+
+/// @return Returns the current time stamp in nanoseconds.
 uint64_t getCurrentTimestamp();
 
 // Tracer configs defined here so we don't need various defines to be
-// defined in just to be able to use the functionality.
+// defined in just to be able to use the functionality. These compile the
+// tracing of a layer in, whether it is recorded is decided at runtime.
 
 #ifndef CA_TRACE_CL
 #define CA_TRACE_CL 0
@@ -67,21 +96,60 @@ uint64_t getCurrentTimestamp();
 #define CA_TRACE_IMPLEMENTATION 0
 #endif
 
+/// @brief Bit masks of the trace categories, as used by `setEnabled`.
+enum CategoryMask : uint32_t {
+  OpenCLMask = 0x1 << 0,
+  CoreMask = 0x1 << 1,
+  MuxMask = 0x1 << 2,
+  ImplMask = 0x1 << 3,
+  AllMask = OpenCLMask | CoreMask | MuxMask | ImplMask,
+};
+
+namespace detail {
+/// @brief Categories currently being recorded, see `setEnabled`.
+extern std::atomic<uint32_t> enabledCategories;
+
+/// @brief Flow the calling thread is currently issuing work on behalf of.
+extern thread_local uint64_t currentFlowId;
+}  // namespace detail
+
+/// @brief Enables recording of the given categories at runtime.
+///
+/// By default all categories compiled in are recorded if the `CA_TRACE_FILE`
+/// environment variable is set, optionally restricted by the comma separated
+/// `CA_TRACE_CATEGORIES` environment variable, and none are recorded
+/// otherwise. Enabling categories without a trace file has no effect.
+///
+/// @param mask Bitwise or of `CategoryMask` values to record.
+void setEnabled(uint32_t mask);
+
+/// @return Returns true if any of the categories in `mask` are being recorded.
+inline bool isEnabled(uint32_t mask) {
+  return 0 != (detail::enabledCategories.load(std::memory_order_relaxed) &
+               mask);
+}
+
+/// @return Returns the flow the calling thread is currently issuing work on
+/// behalf of, see `FlowGuard`, or zero if there is none.
+inline uint64_t getCurrentFlowId() { return detail::currentFlowId; }
+
 /// @brief Benchmark base class for the Bench object.
-template <bool enable>
+template <bool enable, uint32_t category_mask>
 struct BenchmarkCategory {
   constexpr static bool enabled = enable;
+  constexpr static uint32_t mask = category_mask;
 };
 
 template <class T>
 inline const char *getCategoryName();
 
 /// @brief Helper to generate the types and category names
-#define TRACER_GUARD_CATEGORY(type, enabled)                             \
-  struct type : public BenchmarkCategory<static_cast<bool>(enabled)> {}; \
-  template <>                                                            \
-  inline const char *getCategoryName<type>() {                           \
-    return #type;                                                        \
+#define TRACER_GUARD_CATEGORY(type, enabled)                                 \
+  struct type                                                                \
+      : public BenchmarkCategory<static_cast<bool>(enabled), type##Mask> {}; \
+  template <>                                                                \
+  inline const char *getCategoryName<type>() {                               \
+    return #type;                                                            \
   }
 
 TRACER_GUARD_CATEGORY(OpenCL, CA_TRACE_CL)
@@ -93,17 +161,20 @@ TRACER_GUARD_CATEGORY(Impl, CA_TRACE_IMPLEMENTATION)
 
 /// @brief A scoped timer. Construct the TracerGuard object with one of the
 /// category types. eg: tracer::TraceGuard<OpenCL>("function");
+///
+/// When the category is compiled in but not enabled the only cost is a relaxed
+/// load of the enabled categories.
 template <typename Category>
 struct TraceGuard {
   TraceGuard(const char *name) : trace_name(nullptr), start_time(0) {
-    if (Category::enabled) {
+    if (Category::enabled && isEnabled(Category::mask)) {
       trace_name = name;
       start_time = getCurrentTimestamp();
     }
   };
 
   ~TraceGuard() {
-    if (Category::enabled) {
+    if (Category::enabled && trace_name) {
       const uint64_t end_time = getCurrentTimestamp();
       const char *cat_name = getCategoryName<Category>();
       recordTrace(trace_name, cat_name, start_time, end_time);
@@ -114,6 +185,37 @@ struct TraceGuard {
   uint64_t start_time;
 };
 
+/// @brief Starts a flow from the enclosing slice and makes it the calling
+/// thread's current flow for the guard's lifetime, so that work issued within
+/// the guard's scope can be linked back to it. eg:
+/// tracer::FlowGuard<OpenCL> flow;
+///
+/// Must be constructed after a `TraceGuard` so that it is enclosed by a slice.
+template <typename Category>
+struct FlowGuard {
+  FlowGuard() : previous_id(detail::currentFlowId) {
+    if (Category::enabled && isEnabled(Category::mask)) {
+      const uint64_t id = createFlowId();
+      recordFlow(id, FlowPhase::Start);
+      detail::currentFlowId = id;
+    }
+  }
+
+  ~FlowGuard() { detail::currentFlowId = previous_id; }
+
+  uint64_t previous_id;
+};
+
+/// @brief Records a step of the given flow from the enclosing slice, if the
+/// flow exists and the category is enabled. eg:
+/// tracer::recordFlowStep<Impl>(flow_id);
+template <typename Category>
+inline void recordFlowStep(uint64_t id) {
+  if (Category::enabled && 0 != id && isEnabled(Category::mask)) {
+    recordFlow(id, FlowPhase::Step);
+  }
+}
+
 /// @}
 }  // namespace tracer
 
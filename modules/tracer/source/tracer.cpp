@@ -17,274 +17,313 @@
 #include <tracer/tracer.h>
 #include <utils/system.h>
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
-#include <ctime>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #if defined(__linux__)
-#include <fcntl.h>
-#include <sys/mman.h>
-#include <sys/stat.h>
 #include <sys/syscall.h>
-#include <sys/types.h>
 #include <unistd.h>
 #elif defined(_MSC_VER) || defined(__MINGW32__) || defined(__MINGW64__)
-#include <direct.h>
 #include <windows.h>
 #elif defined(__APPLE__) || defined(__QNX__) || defined(__MCOS_POSIX__)
-// These platforms are known to be unsupported, and have a stub implementation.
+#include <unistd.h>
+#else
+#error Platform not supported!
 #endif
-#include <atomic>
-#include <mutex>
+
+std::atomic<uint32_t> tracer::detail::enabledCategories{0};
+thread_local uint64_t tracer::detail::currentFlowId = 0;
 
 namespace {
 
 #if defined(__linux__)
-const int pid = static_cast<int>(syscall(SYS_getpid));
-thread_local const int tid = static_cast<int>(syscall(SYS_gettid));
+int getProcessId() { return static_cast<int>(syscall(SYS_getpid)); }
+int getThreadId() { return static_cast<int>(syscall(SYS_gettid)); }
 #elif defined(_MSC_VER) || defined(__MINGW32__) || defined(__MINGW64__)
-const int pid = static_cast<int>(GetCurrentProcessId());
-thread_local const int tid = static_cast<int>(GetCurrentThreadId());
-#elif defined(__APPLE__) || defined(__QNX__) || defined(__MCOS_POSIX__)
-// These platforms are known to be unsupported, and have a stub implementation.
+int getProcessId() { return static_cast<int>(GetCurrentProcessId()); }
+int getThreadId() { return static_cast<int>(GetCurrentThreadId()); }
 #else
-#error Platform not supported!
+int getProcessId() { return static_cast<int>(getpid()); }
+int getThreadId() {
+  // There is no portable numeric thread id, number threads as they are seen.
+  static std::atomic<int> next_id{1};
+  return next_id.fetch_add(1);
+}
 #endif
 
-#if defined(__linux__)
-struct TracerVirtualMemFileImpl {
-  explicit TracerVirtualMemFileImpl()
-      : export_file(std::getenv("CA_TRACE_FILE")) {
-    const uint64_t start = tracer::getCurrentTimestamp();
+/// @brief Default number of events in each thread's ring buffer, overridden by
+/// the CA_TRACE_BUFFER_EVENTS environment variable.
+constexpr size_t default_buffer_events = 1 << 16;
 
-    if ((nullptr == export_file) || (0 == std::strlen(export_file))) {
-      return;
-    }
-    tmp_name = "/tmp/ca_" + std::to_string(pid) + ".tracer";
-    const int f = open(tmp_name.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
-
-    if (f == 0) {
-      (void)fprintf(stderr, "Could not open %s temp file for tracing.\n",
-                    tmp_name.c_str());
-      return;
-    }
+enum class EventType : uint8_t {
+  Complete,
+  FlowStart,
+  FlowStep,
+};
 
-    size_t requested_mb = 1024;
+/// @brief Fixed size binary trace event, converted to JSON when flushed.
+struct Event {
+  const char *name;
+  const char *category;
+  uint64_t timestamp;
+  /// @brief Duration of complete events, or identifier of flow events.
+  uint64_t value;
+  EventType type;
+};
 
-    const char *mb_str = std::getenv("CA_TRACE_FILE_BUFFER_MB");
+/// @brief Ring buffer of events recorded by a single thread.
+///
+/// Only the owning thread writes events, but `flush` reads them from whichever
+/// thread calls it, and the owning thread may wrap around onto the slots being
+/// read. Both sides hold `mutex`, which is only contended while a flush copies
+/// the buffer's events out, so recording an event stays cheap.
+struct ThreadBuffer {
+  ThreadBuffer(size_t capacity, int tid)
+      : events(new Event[capacity]), capacity(capacity), tid(tid) {}
+
+  void push(const Event &event) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    events[written % capacity] = event;
+    written++;
+  }
 
-    if (nullptr != mb_str && std::strlen(mb_str)) {
-      /* seems good to have a max, 75GB */
-      constexpr size_t max_mb = 76800;
-      requested_mb = std::min<size_t>(std::stoul(mb_str), max_mb);
-      requested_mb = std::max<size_t>(requested_mb, 0);
+  /// @brief Copy the events which haven't yet been flushed.
+  ///
+  /// @param[out] out Events in the order they were recorded.
+  ///
+  /// @return The number of events which were overwritten before they could
+  /// be flushed.
+  uint64_t takeUnflushed(std::vector<Event> &out) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    uint64_t begin = flushed;
+    uint64_t overwritten = 0;
+    if (written - begin > capacity) {
+      overwritten = written - begin - capacity;
+      begin = written - capacity;
     }
-
-    // MB to bytes
-    const size_t bytes = 1048576 * requested_mb;
-    max_offset = bytes;
-
-    /* resize the file */
-    lseek64(f, bytes, SEEK_SET);
-    auto written = write(f, "", 1);
-    if (0 == written) {
-      (void)fprintf(stderr, "Failed to resize %s.\n", tmp_name.c_str());
-      (void)remove(tmp_name.c_str());
-      return;
+    out.clear();
+    out.reserve(written - begin);
+    for (uint64_t i = begin; i < written; i++) {
+      out.push_back(events[i % capacity]);
     }
-    lseek64(f, 0, SEEK_SET);
+    flushed = written;
+    return overwritten;
+  }
 
-    void *mapping = mmap(0, bytes, PROT_WRITE, MAP_SHARED, f, 0);
-    map = static_cast<char *>(mapping);
-    close(f);
+  std::mutex mutex;
+  std::unique_ptr<Event[]> events;
+  const size_t capacity;
+  const int tid;
+  /// @brief Total number of events ever pushed.
+  uint64_t written{0};
+  /// @brief Total number of events copied out by `takeUnflushed`.
+  uint64_t flushed{0};
+};
 
-    if (map == MAP_FAILED) {
-      (void)fprintf(stderr, "Failed to map tmp file:%s.\n", strerror(errno));
-      (void)remove(tmp_name.c_str());
+struct Tracer {
+  Tracer() : pid(getProcessId()) {
+    const char *file = std::getenv("CA_TRACE_FILE");
+    if ((nullptr == file) || (0 == std::strlen(file))) {
+      return;
     }
+    export_file = file;
 
-    // Buffer to keep things stack allocated.
-    char buf[256]{};
-
-    int consumed = std::snprintf(buf, sizeof(buf),
-                                 "{\n\t\"otherData\":{},\n\t\"traceEvents\":[");
-    writeToMemMap(buf, consumed);
-    std::memset((void *)buf, 0, sizeof(buf));
-
-    // Insert dummy value so we can ignore JSON's comma requirements.
-    const uint64_t end = tracer::getCurrentTimestamp();
-
-    consumed = std::snprintf(
-        buf, sizeof(buf),
-        "\n\t\t{\"name\":\"%s\", "
-        "\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%" PRIu64
-        ","
-        "\"dur\":%" PRIu64 "}",
-        "tracer-startup", "tracer-startup", pid, tid, start, end - start);
-
-    writeToMemMap(buf, consumed);
-  };
-
-  ~TracerVirtualMemFileImpl() {
-    if (0 != map) {
-      const char *ending = "\n\t]\n}\n";
-
-      if (std::strlen(ending) + offset > max_offset) {
-        (void)fprintf(stderr,
-                      "Trace overflow, failed to write data, increase "
-                      "CA_TRACE_FILE_BUFFER_MB");
+    if (const char *events = std::getenv("CA_TRACE_BUFFER_EVENTS")) {
+      if (const long long n = std::atoll(events); n > 0) {
+        buffer_events = static_cast<size_t>(n);
       }
+    }
 
-      writeToMemMap(ending, std::strlen(ending));
-
-      // Copy mem-mapped file into a proper file.
-      // This reduces the footprint, and stops to some file issues, with editors
-      // opening up empty and/or very large files.
-      FILE *file = fopen(export_file, "w");
-
-      if (nullptr != file) {
-        bool write_error =
-            fwrite(map, sizeof(map[0]), offset.load(), file) != offset.load();
-        write_error |= fclose(file);
-
-        if (write_error) {
-          (void)fprintf(stderr, "Trace file could not be shrunk down.");
+    uint32_t mask = tracer::AllMask;
+    if (const char *categories = std::getenv("CA_TRACE_CATEGORIES")) {
+      mask = 0;
+      const std::string list = categories;
+      size_t begin = 0;
+      while (begin <= list.size()) {
+        size_t end = list.find(',', begin);
+        if (end == std::string::npos) {
+          end = list.size();
         }
+        const std::string name = list.substr(begin, end - begin);
+        if (name == "OpenCL") {
+          mask |= tracer::OpenCLMask;
+        } else if (name == "Core") {
+          mask |= tracer::CoreMask;
+        } else if (name == "Mux") {
+          mask |= tracer::MuxMask;
+        } else if (name == "Impl") {
+          mask |= tracer::ImplMask;
+        } else if (!name.empty()) {
+          (void)fprintf(stderr, "Unknown trace category '%s'.\n",
+                        name.c_str());
+        }
+        begin = end + 1;
       }
-
-      munmap(map, max_offset);
-      map = nullptr;
-      (void)remove(tmp_name.c_str());
     }
+    tracer::detail::enabledCategories.store(mask, std::memory_order_relaxed);
   }
 
-  void doTrace(const char *name, const char *category, uint64_t start,
-               uint64_t end) {
-    // Buffer to keep stack allocated.
-    char buf[256]{};
-    const int consumed = std::snprintf(
-        buf, sizeof(buf),
-        ",\n\t\t{\"name\":\"%s\", "
-        "\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%" PRIu64
-        ","
-        "\"dur\":%" PRIu64 "}",
-        name, category, pid, tid, start, end - start);
-    writeToMemMap(buf, consumed);
+  ThreadBuffer *createThreadBuffer() {
+    const std::lock_guard<std::mutex> lock(mutex);
+    buffers.push_back(std::make_unique<ThreadBuffer>(buffer_events,
+                                                     getThreadId()));
+    return buffers.back().get();
   }
 
- private:
-  void writeToMemMap(const char *buf, int size) {
-    if (map == nullptr || size <= 0) {
-      return;
-    }
-
-    const uint64_t insert_pt = offset.fetch_add(size);
-
-    if ((insert_pt + size) < max_offset) {
-      std::memcpy((void *)&map[insert_pt], (const void *)buf, size);
+  void writeEvent(const char *separator, const Event &event, int tid) {
+    // Timestamps are recorded in nanoseconds but the trace format expects
+    // microseconds.
+    const uint64_t ts = event.timestamp;
+    switch (event.type) {
+      case EventType::Complete:
+        (void)fprintf(file,
+                      "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                      "\"pid\":%d,\"tid\":%d,\"ts\":%" PRIu64 ".%03" PRIu64
+                      ",\"dur\":%" PRIu64 ".%03" PRIu64 "}",
+                      separator, event.name, event.category, pid, tid,
+                      ts / 1000, ts % 1000, event.value / 1000,
+                      event.value % 1000);
+        break;
+      case EventType::FlowStart:
+      case EventType::FlowStep: {
+        const char phase = event.type == EventType::FlowStart ? 's' : 't';
+        (void)fprintf(file,
+                      "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\","
+                      "\"bp\":\"e\",\"id\":%" PRIu64
+                      ",\"pid\":%d,\"tid\":%d,\"ts\":%" PRIu64 ".%03" PRIu64
+                      "}",
+                      separator, event.name, event.category, phase,
+                      event.value, pid, tid, ts / 1000, ts % 1000);
+        break;
+      }
     }
   }
 
-  uint64_t max_offset{0};
-  char *map{nullptr};
-  const char *export_file{nullptr};
-  std::string tmp_name{""};
-  std::atomic<uint64_t> offset{0};
-};
-
-#elif defined(_WIN32)
-/*
- *  TracerFileImpl creates a file and appends to it while holding a mutex.
- */
-struct TracerFileImpl {
-  explicit TracerFileImpl() {
-    uint64_t start = tracer::getCurrentTimestamp();
-
-    const char *env = std::getenv("CA_TRACE_FILE");
-
-    // If we couldn't find an env variable for the user folder or the returned
-    // value was an empty string, bail out.
-    if ((nullptr == env) || (0 == std::strlen(env))) {
+  void flush() {
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (export_file.empty()) {
       return;
     }
 
-    // KLOCWORK "SV.TAINTED.PATH_TRAVERSAL" possible false positive
-    // Opening a file based on an environment variable is a security issue.
-    // Here, it's mitigated by the fact that tracer is a debug feature, not a
-    // release feature.
-    file = fopen(env, "w");
-
+    // The trace is written in the JSON array format, whose closing bracket is
+    // optional, so the file is loadable after every flush even if the process
+    // later terminates abnormally.
     if (nullptr == file) {
-      (void)fprintf(stderr, "Could not open '%s' for tracing.\n", env);
-      return;
+      file = fopen(export_file.c_str(), "w");
+      if (nullptr == file) {
+        (void)fprintf(stderr, "Could not open '%s' for tracing.\n",
+                      export_file.c_str());
+        export_file.clear();
+        tracer::detail::enabledCategories.store(0);
+        return;
+      }
+      (void)fprintf(file, "[");
     }
 
-    // Now we have a file handle, we need to output the start of the JSON
-    // tracing format.
-    fprintf(file, "{\n\t\"otherData\":{},\n\t\"traceEvents\":[");
-
-    // Insert dummy value so we can ignore JSON's comma requirements.
-    uint64_t end = tracer::getCurrentTimestamp();
-
-    fprintf(file,
-            "\n\t\t{\"name\":\"%s\", "
-            "\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%" PRIu64
-            ","
-            "\"dur\":%" PRIu64 "}",
-            "tracer-startup", "tracer-startup", pid, tid, start, end - start);
+    // Events are copied out of each buffer before they are formatted, so the
+    // owning thread is only blocked for the copy.
+    std::vector<Event> events;
+    for (auto &buffer : buffers) {
+      dropped += buffer->takeUnflushed(events);
+      for (const auto &event : events) {
+        writeEvent(first_event ? "" : ",", event, buffer->tid);
+        first_event = false;
+      }
+    }
+    (void)fflush(file);
+
+    if (0 != dropped && !reported_dropped) {
+      (void)fprintf(stderr,
+                    "Trace ring buffer overflow, the oldest events were "
+                    "dropped, increase CA_TRACE_BUFFER_EVENTS or flush more "
+                    "often.\n");
+      reported_dropped = true;
+    }
   }
 
-  ~TracerFileImpl() {
+  void close() {
+    flush();
+    const std::lock_guard<std::mutex> lock(mutex);
     if (nullptr != file) {
-      // Lastly we close our traceEvents member, and the main JSON object.
-      fprintf(file, "\n\t]\n}\n");
-
-      // And close the file.
-      fclose(file);
+      (void)fprintf(file, "\n]\n");
+      (void)fclose(file);
+      file = nullptr;
     }
   }
 
-  void doTrace(const char *name, const char *category, uint64_t start,
-               uint64_t end) {
-    std::lock_guard<std::mutex> lock(mtx);
+  const int pid;
+  std::string export_file;
+  size_t buffer_events = default_buffer_events;
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+  FILE *file = nullptr;
+  bool first_event = true;
+  uint64_t dropped = 0;
+  bool reported_dropped = false;
+};
 
-    if (nullptr != file) {
-      fprintf(
-          file,
-          ",\n\t\t{\"name\":\"%s\", "
-          "\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%" PRIu64
-          ","
-          "\"dur\":%" PRIu64 "}",
-          name, category, pid, tid, start, end - start);
-    }
+/// @brief Returns the tracer, which is deliberately never destroyed as
+/// threads may record events during static destruction.
+Tracer &getTracer() {
+  static Tracer *tracer = new Tracer();
+  return *tracer;
+}
+
+/// @brief Writes the trace file on exit.
+struct TracerFinalizer {
+  TracerFinalizer() { (void)getTracer(); }
+  ~TracerFinalizer() {
+    tracer::detail::enabledCategories.store(0);
+    getTracer().close();
   }
+} tracer_finalizer;
 
-  std::mutex mtx;
-  FILE *file{nullptr};
-};
-#elif defined(__APPLE__) || defined(__QNX__) || defined(__MCOS_POSIX__)
-// These platforms are known to be unsupported, and have a stub implementation.
-struct TracerVirtualMemFileImpl {
-  void doTrace(const char *, const char *, uint64_t, uint64_t) {}
-};
-#endif
+thread_local ThreadBuffer *thread_buffer = nullptr;
 
-#if defined(__linux__) || defined(__APPLE__) || defined(__QNX__) || \
-    defined(__MCOS_POSIX__)
-TracerVirtualMemFileImpl trace_impl;
-#elif defined(_WIN32) || defined(__MINGW32__) || defined(__MINGW64__)
-TracerFileImpl trace_impl;
-#endif
+void pushEvent(const Event &event) {
+  if (nullptr == thread_buffer) {
+    thread_buffer = getTracer().createThreadBuffer();
+  }
+  thread_buffer->push(event);
+}
+
+std::atomic<uint64_t> next_flow_id{1};
 
 }  // namespace
 
 uint64_t tracer::getCurrentTimestamp() {
-  return utils::timestampMicroSeconds();
+  return utils::timestampNanoSeconds();
 }
 
 void tracer::recordTrace(const char *name, const char *category, uint64_t start,
                          uint64_t end) {
-  trace_impl.doTrace(name, category, start, end);
+  pushEvent({name, category, start, end - start, EventType::Complete});
+}
+
+void tracer::recordFlow(uint64_t id, FlowPhase phase) {
+  const EventType type =
+      phase == FlowPhase::Start ? EventType::FlowStart : EventType::FlowStep;
+  // Flow events are matched on their name and category as well as their
+  // identifier, so all share the same ones.
+  pushEvent({"flow", "flow", getCurrentTimestamp(), id, type});
+}
+
+uint64_t tracer::createFlowId() {
+  return next_flow_id.fetch_add(1, std::memory_order_relaxed);
 }
+
+void tracer::setEnabled(uint32_t mask) {
+  if (getTracer().export_file.empty()) {
+    return;
+  }
+  detail::enabledCategories.store(mask, std::memory_order_relaxed);
+}
+
+void tracer::flush() { getTracer().flush(); }
@@ -48,6 +48,11 @@ struct jit_kernel_s {
   /// * If zero, denotes a 'degenerate' sub-group (i.e., the size of the
   /// work-group at enqueue time).
   uint32_t sub_group_size;
+  /// @brief Arena size in bytes the kernel needs whatever the work-group size.
+  uint64_t arena_size;
+  /// @brief Arena size in bytes the kernel needs for each work-item in the
+  /// work-group.
+  uint64_t arena_size_per_work_item;
 };
 
 /// @brief Detects whether this binary buffer contains a JIT kernel hook and
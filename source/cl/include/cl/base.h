@@ -409,6 +409,27 @@ void releaseInternal(T object) {
 template <>
 void releaseInternal<cl_mem>(cl_mem object);
 
+/// @brief Declare specialization for `cl_event`.
+///
+/// Events are allocated from their context's storage rather than with `new`,
+/// see `_cl_event::destroy`.
+///
+/// @param object Object to decrement the reference count on.
+///
+/// @return Returns CL_SUCCESS or CL_INVALID_EVENT if the external reference
+/// count is zero.
+template <>
+cl_int releaseExternal<cl_event>(cl_event object);
+
+/// @brief Declare specialization for `cl_event`.
+///
+/// Events are allocated from their context's storage rather than with `new`,
+/// see `_cl_event::destroy`.
+///
+/// @param object Object to decrement the reference count on.
+template <>
+void releaseInternal<cl_event>(cl_event object);
+
 /// @}
 }  // namespace cl
 
@@ -145,6 +145,25 @@ struct _cl_command_queue final : public cl::base<_cl_command_queue> {
   [[nodiscard]] cargo::expected<mux_command_buffer_t, cl_int> getCommandBuffer(
       cargo::array_view<const cl_event> event_wait_list, cl_event event);
 
+  /// @brief Get a command buffer to push a marker or barrier command onto.
+  ///
+  /// @note This member function is not thread-safe, callers **must** hold a
+  /// lock on `_cl_command_queue->mutex` when calling it.
+  ///
+  /// Markers and barriers are implicit in in-order queues, where this is the
+  /// same as `getCommandBuffer()`. In out-of-order queues a marker or barrier
+  /// with no wait events waits for all previously enqueued commands, and all
+  /// commands enqueued after a barrier wait for it to complete.
+  ///
+  /// @param event_wait_list List of events to wait on.
+  /// @param event Return event the dispatch sets status of, may be null.
+  /// @param is_barrier Whether commands enqueued later must wait for this one.
+  ///
+  /// @return Returns the expected command buffer or `CL_OUT_OF_RESOURCES`.
+  [[nodiscard]] cargo::expected<mux_command_buffer_t, cl_int>
+  getSyncCommandBuffer(cargo::array_view<const cl_event> event_wait_list,
+                       cl_event event, bool is_barrier);
+
   /// @brief Register a command buffer dispatch completion callback.
   ///
   /// @note This member function is not thread-safe, callers **must** hold a
@@ -166,6 +185,40 @@ struct _cl_command_queue final : public cl::base<_cl_command_queue> {
       mux_command_buffer_t command_buffer, cl_event event,
       std::function<void()> callback);
 
+  /// @brief Check if the command queue executes commands out-of-order.
+  ///
+  /// @return Returns true if `CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE` was set.
+  bool isOutOfOrder() const {
+    return properties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
+  }
+
+  /// @brief A duration query in one of the command queue's query pools.
+  struct duration_query_t {
+    /// @brief Query pool the query belongs to.
+    mux_query_pool_t pool;
+    /// @brief Index of the query in `pool`.
+    uint32_t index;
+  };
+
+  /// @brief Get an unused duration query for profiling a command.
+  ///
+  /// @note This member function is thread-safe.
+  ///
+  /// Duration queries are carved out of query pools shared by all the events
+  /// of the command queue, a new pool is only created once all the queries of
+  /// the existing ones are in use.
+  ///
+  /// @return Returns the expected duration query or `CL_OUT_OF_RESOURCES`.
+  [[nodiscard]] cargo::expected<duration_query_t, cl_int>
+  acquireDurationQuery();
+
+  /// @brief Return a duration query once its results are no longer needed.
+  ///
+  /// @note This member function is thread-safe.
+  ///
+  /// @param query Duration query returned by `acquireDurationQuery()`.
+  void releaseDurationQuery(duration_query_t query);
+
   /// @brief Flush and wait for any outstanding events
   ///
   ///
@@ -230,6 +283,21 @@ struct _cl_command_queue final : public cl::base<_cl_command_queue> {
   [[nodiscard]] cargo::expected<mux_command_buffer_t, cl_int>
   getCurrentCommandBuffer();
 
+  /// @brief Register a command's events with its command buffer's dispatch.
+  ///
+  /// @note This member function is not thread-safe, callers **must** hold a
+  /// lock on `_cl_command_queue->mutex` when calling it.
+  ///
+  /// @param command_buffer The expected command buffer the command is pushed
+  /// onto, `event` is set to the failure status if it holds an error.
+  /// @param event_wait_list List of events the command waits on.
+  /// @param event Return event the dispatch sets status of.
+  ///
+  /// @return Returns the expected command buffer or `CL_OUT_OF_RESOURCES`.
+  [[nodiscard]] cargo::expected<mux_command_buffer_t, cl_int> registerEvents(
+      cargo::expected<mux_command_buffer_t, cl_int> command_buffer,
+      cargo::array_view<const cl_event> event_wait_list, cl_event event);
+
   /// @brief Get a command buffer suitable for the given wait events.
   ///
   /// @note This member function is not thread-safe, callers **must** hold a
@@ -269,11 +337,41 @@ struct _cl_command_queue final : public cl::base<_cl_command_queue> {
   /// submits pending dispatches to the queue when the user event is in a
   /// success state, and removes them when in a failure state.
   ///
+  /// Out-of-order queues instead only order commands by their wait events and
+  /// barriers, see `getOutOfOrderDependencies()`.
+  ///
   /// @param event_wait_list List of events to wait for.
+  /// @param wait_for_all Whether the command waits for all previously enqueued
+  /// commands, only used by out-of-order queues.
   ///
   /// @return Returns the expected command buffer or `CL_OUT_OF_RESOURCES`.
   [[nodiscard]] cargo::expected<mux_command_buffer_t, cl_int>
-  getCommandBufferPending(cargo::array_view<const cl_event> event_wait_list);
+  getCommandBufferPending(cargo::array_view<const cl_event> event_wait_list,
+                          bool wait_for_all = false);
+
+  /// @brief Find the dispatches a command in an out-of-order queue waits for.
+  ///
+  /// @note This member function is not thread-safe, callers **must** hold a
+  /// lock on `_cl_command_queue->mutex` when calling it.
+  ///
+  /// Commands only wait for the commands signalling their wait events and the
+  /// last barrier, so commands without dependencies on each other are placed
+  /// in separate command buffers which the device may run concurrently. A
+  /// command whose only dependency is a pending dispatch of this queue is
+  /// batched into that dispatch's command buffer instead.
+  ///
+  /// @param[in] event_wait_list List of events to wait for.
+  /// @param[in] wait_for_all Whether the command waits for all previously
+  /// enqueued commands, as markers and barriers with no wait events do.
+  /// @param[out] semaphores Semaphores the command's dispatch must wait for.
+  /// @param[out] append_to Command buffer to batch the command into, or null if
+  /// a new one is required.
+  ///
+  /// @return Returns `CL_SUCCESS` or `CL_OUT_OF_RESOURCES`.
+  [[nodiscard]] cl_int getOutOfOrderDependencies(
+      cargo::array_view<const cl_event> event_wait_list, bool wait_for_all,
+      cargo::small_vector<mux_shared_semaphore, 8> &semaphores,
+      mux_command_buffer_t &append_to);
 
   /// @brief Dispatch the given command buffers.
   ///
@@ -499,9 +597,24 @@ struct _cl_command_queue final : public cl::base<_cl_command_queue> {
   /// to a `muxDispatch`'s callback `user_data` argument.
   std::unordered_map<mux_command_buffer_t, finish_state_t> finish_state;
 
+  /// @brief Number of queries in each of `duration_query_pools`.
+  static constexpr uint32_t duration_query_pool_size = 64;
+  /// @brief Mutex protecting `duration_query_pools` and `duration_queries`,
+  /// events release their queries without holding the command queue mutex.
+  std::mutex duration_query_mutex;
+  /// @brief Query pools profiled commands record their durations in.
+  cargo::small_vector<mux_query_pool_t, 4> duration_query_pools;
+  /// @brief Duration queries not used by any event.
+  cargo::small_vector<duration_query_t, duration_query_pool_size>
+      duration_queries;
+
   /// @brief A set of command buffers that are idle and ready to use.
   cargo::ring_buffer<mux_command_buffer_t, 16> cached_command_buffers;
 
+  /// @brief Signal semaphore of the last barrier enqueued to an out-of-order
+  /// queue, which all later commands wait for until it completes.
+  mux_shared_semaphore barrier_semaphore;
+
   /// @brief List of completed signal semaphores which are still being waited
   /// on by running dispatches.
   cargo::small_vector<mux_shared_semaphore, 32> completed_signal_semaphores;
@@ -27,6 +27,8 @@
 #include <cargo/expected.h>
 #include <cargo/small_vector.h>
 #include <cl/base.h>
+#include <cl/event.h>
+#include <cl/platform.h>
 #include <compiler/context.h>
 #include <compiler/target.h>
 #include <mux/mux.h>
@@ -217,6 +219,8 @@ struct _cl_context final : public cl::base<_cl_context> {
 
   /// @brief List of the context's enabled properties.
   cargo::dynamic_array<cl_context_properties> properties;
+  /// @brief Storage the context's events are allocated from.
+  cl::event_storage events;
 #ifdef OCL_EXTENSION_cl_intel_unified_shared_memory
   /// @brief List of allocations made through the USM extension entry points.
   cargo::small_vector<std::unique_ptr<extension::usm::allocation_info>, 1>
@@ -235,6 +239,9 @@ struct _cl_context final : public cl::base<_cl_context> {
   std::once_flag compiler_context_initialized;
   /// @brief Compiler context, lazily allocated when required.
   std::unique_ptr<compiler::Context> compiler_context;
+  /// @brief Compiler context and targets taken from the platform, used
+  /// instead of `compiler_context` when there is no notify callback.
+  std::unique_ptr<_cl_platform_id::compiler_cache_s> compiler_cache;
   /// @brief A mutex that guards the compiler_targets map.
   std::mutex compiler_targets_mutex;
   /// @brief A mutex that guards any command queues.
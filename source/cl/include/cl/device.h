@@ -23,6 +23,7 @@
 
 #include <CL/cl.h>
 #include <CL/cl_ext.h>
+#include <cargo/array_view.h>
 #include <cargo/fixed_vector.h>
 #include <cargo/small_vector.h>
 #include <cargo/string_view.h>
@@ -47,6 +48,19 @@ struct _cl_device_id final : public cl::base<_cl_device_id> {
   _cl_device_id(cl_platform_id platform, mux_allocator_info_t mux_allocator,
                 mux_device_t mux_device);
 
+  /// @brief Sub-device constructor.
+  ///
+  /// @param parent Device the sub-device is partitioned from.
+  /// @param mux_queue_index Index of the mux compute queue the sub-device's
+  /// command queues execute on.
+  /// @param compute_units Number of compute units in the sub-device.
+  /// @param partition_type Zero terminated partition property list the
+  /// sub-device was created with.
+  _cl_device_id(cl_device_id parent, uint32_t mux_queue_index,
+                cl_uint compute_units,
+                cargo::array_view<const cl_device_partition_property>
+                    partition_type);
+
   /// @brief Deleted move constructor.
   ///
   /// Also deletes the copy constructor and the assignment operators.
@@ -61,6 +75,9 @@ struct _cl_device_id final : public cl::base<_cl_device_id> {
   mux_allocator_info_t mux_allocator;
   /// @brief Associated mux device.
   mux_device_t mux_device;
+  /// @brief Index of the mux compute queue command queues execute on, 0 for
+  /// root devices.
+  uint32_t mux_queue_index;
   /// @brief Associated compiler.
   const compiler::Info *compiler_info;
   /// @brief Device version string.
@@ -211,7 +228,7 @@ struct _cl_device_id final : public cl::base<_cl_device_id> {
   /// @brief List of partition types supported, possible values:
   /// CL_DEVICE_PARTITION_{EQUALLY, BY_COUNTS, BY_AFFINITY_DOMAIN}, or 0 if
   /// none of these are supported.
-  cl_device_partition_property partition_properties;
+  cargo::small_vector<cl_device_partition_property, 2> partition_properties;
   /// @brief List of supported affinity domains for partitioning the device. Bit
   /// field with possible values: CL_DEVICE_AFFINITY_DOMAIN_{NUMA, L4_CACHE,
   /// L3_CACHE, L2_CACHE, L1_CACHE, NEXT_PATITIONABLE}, or 0 if the device
@@ -222,7 +239,7 @@ struct _cl_device_id final : public cl::base<_cl_device_id> {
   /// param_value_size_ret of 0 i.e. there is no partition type associated with
   /// device or can return a property value of 0 (where 0 is used to terminate
   /// the partition property list) in the memory that param_value points to.
-  cl_device_partition_property partition_type;
+  cargo::small_vector<cl_device_partition_property, 3> partition_type;
 
   // Preferred vector sizes:
   /// @brief Preferred vector width size for char.
@@ -256,7 +273,8 @@ struct _cl_device_id final : public cl::base<_cl_device_id> {
   /// possible values: CL_QUEUE_{OUT_OF_ORDER_EXEC_MODE_ENABLE,
   /// PROFILING_ENABLE}, minimum capability: CL_QUEUE_PROFILING_ENABLE.
   cl_command_queue_properties queue_properties;
-  /// @brief Device reference count, 1 if the device is a root-level device.
+  /// @brief Device reference count for root-level devices, which is always 1.
+  /// Sub-devices report their external reference count instead.
   cl_uint reference_count;
   /// @brief Describes the single precision floating-point capabilities of the
   /// device in a bit-field with the possible values: CL_FP_{DENORM, INF_NAN,
@@ -352,6 +370,16 @@ struct _cl_device_id final : public cl::base<_cl_device_id> {
   /// TODO: Should probably be a core property, see CA-2717.
   size_t preferred_work_group_size_multiple;
 #endif
+
+ private:
+  /// @brief Constructor shared by root devices and sub-devices.
+  ///
+  /// @param ref_count_type Type of reference counting to initialize.
+  /// @param platform Platform the device belongs to.
+  /// @param mux_allocator Allocators be used for mux.
+  /// @param mux_device Associated mux device.
+  _cl_device_id(cl::ref_count_type ref_count_type, cl_platform_id platform,
+                mux_allocator_info_t mux_allocator, mux_device_t mux_device);
 };
 
 /// @}
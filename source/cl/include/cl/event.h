@@ -30,6 +30,7 @@
 #include <mux/mux.h>
 
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 
 namespace cl {
@@ -69,12 +70,11 @@ struct _cl_event final : public cl::base<_cl_event> {
     cl_ulong queued = 0;
     /// @brief Time when the command was submitted for execution.
     cl_ulong submit = 0;
-    /// @brief Mux query pool for storing command duration query results.
+    /// @brief Mux query pool for storing command duration query results,
+    /// owned by the command queue and shared with its other events.
     mux_query_pool_t duration_queries = nullptr;
-    /// @brief associated queue against which profiling queries are made
-    mux_queue_t mux_queue = nullptr;
-    /// @brief the mux allocator that handles the queue
-    mux_allocator_info_t mux_allocator = {};
+    /// @brief Index of the event's query in `duration_queries`.
+    uint32_t duration_index = 0;
     /// @brief Is profiling enabled or not.
     bool enabled = false;
   };
@@ -88,6 +88,9 @@ struct _cl_event final : public cl::base<_cl_event> {
   /// @retval `CL_OUT_OF_HOST_MEMORY` if an allocation failed.
   /// @retval `CL_OUT_OF_RESOURCES` if profiling could not be enabled due to an
   /// error in `muxCreateQueryPool`.
+  ///
+  /// @note Events are allocated from their context's `_cl_context::events`
+  /// storage and **must** be destroyed with `_cl_event::destroy()`.
   static cargo::expected<cl_event, cl_int> create(cl_command_queue queue,
                                                   const cl_command_type type);
 
@@ -99,8 +102,10 @@ struct _cl_event final : public cl::base<_cl_event> {
   /// @retval `CL_OUT_OF_HOST_MEMORY` if an allocation failed.
   static cargo::expected<cl_event, cl_int> create(cl_context context);
 
-  /// @brief Destructor.
-  ~_cl_event();
+  /// @brief Destroy an event and return its storage to its context.
+  ///
+  /// @param[in] event Event to destroy, its reference counts must be zero.
+  static void destroy(cl_event event);
 
   /// @brief Register a notification callback function to the event.
   ///
@@ -149,6 +154,9 @@ struct _cl_event final : public cl::base<_cl_event> {
   _cl_event(const _cl_event &) = delete;
   _cl_event &operator=(const _cl_event &) = delete;
 
+  /// @brief Destructor, releases everything but the context reference.
+  ~_cl_event();
+
   /// @brief Remove all registered callbacks and call them.
   ///
   /// Function removes all callbacks regardless of if their status has been
@@ -176,6 +184,49 @@ namespace cl {
 /// @addtogroup cl
 /// @{
 
+/// @brief Recycled storage for the events of a context.
+///
+/// An event is created for every command which returns one, so events are
+/// allocated in slabs and the storage of destroyed events is reused for new
+/// ones rather than going through the allocator each time.
+class event_storage final {
+ public:
+  event_storage() = default;
+  event_storage(const event_storage &) = delete;
+  event_storage &operator=(const event_storage &) = delete;
+
+  /// @brief Get storage for a new event.
+  ///
+  /// @note This member function is thread-safe.
+  ///
+  /// @return Returns uninitialized storage for a `_cl_event`, or null if a
+  /// new slab could not be allocated.
+  void *alloc();
+
+  /// @brief Return the storage of a destroyed event for reuse.
+  ///
+  /// @note This member function is thread-safe.
+  ///
+  /// @param[in] storage Storage previously returned by `alloc()`.
+  void free(void *storage);
+
+ private:
+  /// @brief Storage for a single event.
+  struct alignas(_cl_event) slot_t {
+    unsigned char data[sizeof(_cl_event)];
+  };
+
+  /// @brief Number of events in each slab.
+  static constexpr size_t slab_size = 64;
+
+  /// @brief Mutex protecting `slabs` and `free_slots`.
+  std::mutex mutex;
+  /// @brief Slabs of event storage, never freed until the context is.
+  cargo::small_vector<std::unique_ptr<slot_t[]>, 4> slabs;
+  /// @brief Slots not used by any event, with capacity for every slot.
+  cargo::small_vector<void *, slab_size> free_slots;
+};
+
 /// @brief Check if an event is a user event.
 ///
 /// @param event Event to check.
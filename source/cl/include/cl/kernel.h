@@ -26,6 +26,7 @@
 #include <cargo/dynamic_array.h>
 #include <cargo/expected.h>
 #include <cargo/optional.h>
+#include <cargo/small_vector.h>
 #include <cl/base.h>
 #include <cl/binary/kernel_info.h>
 #include <cl/validate.h>
@@ -217,6 +218,10 @@ class MuxKernelWrapper {
 
 /// @brief Definition of the OpenCL kernel object.
 struct _cl_kernel final : public cl::base<_cl_kernel> {
+  /// @brief Storage for the descriptors of an enqueue, kept inline for kernels
+  /// with few arguments so that enqueuing them does not allocate.
+  using descriptor_storage_t = cargo::small_vector<mux_descriptor_info_t, 16>;
+
   /// @brief Struct that represents a kernel argument.
   struct argument final {
     /// @brief Default constructor used to initialize arrays of arguments.
@@ -388,18 +393,18 @@ struct _cl_kernel final : public cl::base<_cl_kernel> {
   /// @param[in] global_offset Global index offset to begin work at.
   /// @param[in] global_size Global size of work to do.
   /// @param[in] printf_buffer Buffer to write printf output into.
-  /// @param[out] descriptors A unique_ptr that can be used to store the
-  /// allocated array of mux_descriptor_info_t used in the resulting
-  /// mux_execution_options_t.
+  /// @param[out] descriptors Storage for the array of mux_descriptor_info_t
+  /// used in the resulting mux_execution_options_t, which only allocates for
+  /// kernels with many arguments.
   ///
-  /// @return Returns the relevant kernel execution options.
-  mux_ndrange_options_t createKernelExecutionOptions(
+  /// @return Returns the relevant kernel execution options, or
+  /// CL_OUT_OF_HOST_MEMORY if the descriptors could not be stored.
+  cargo::expected<mux_ndrange_options_t, cl_int> createKernelExecutionOptions(
       cl_device_id device, cl_uint device_index, size_t work_dim,
       const std::array<size_t, cl::max::WORK_ITEM_DIM> &local_size,
       const std::array<size_t, cl::max::WORK_ITEM_DIM> &global_offset,
       const std::array<size_t, cl::max::WORK_ITEM_DIM> &global_size,
-      mux_buffer_t printf_buffer,
-      std::unique_ptr<mux_descriptor_info_t[]> &descriptors);
+      mux_buffer_t printf_buffer, descriptor_storage_t &descriptors);
 
   /// @brief Retain cl_mem objects that are the arguments to a kernel.
   ///
@@ -636,6 +641,32 @@ CL_API_ENTRY cl_int CL_API_CALL EnqueueNDRangeKernel(
     const size_t *local_work_size, cl_uint num_events_in_wait_list,
     const cl_event *event_wait_list, cl_event *event);
 
+/// @brief Enqueue an N-dimensional kernel invocation whose number of
+/// work-groups is read from a buffer when it executes.
+///
+/// @param[in] command_queue Command queue to enqueue the invocation on.
+/// @param[in] kernel Kernel to invoke on the queue.
+/// @param[in] work_dim Number of dimensions for `global_work_offset`,
+/// `local_work_size` and the work-group counts.
+/// @param[in] global_work_offset Offset for global invocation ID's to begin
+/// from, may be null.
+/// @param[in] group_count_buffer Buffer holding `work_dim` `cl_uint`
+/// work-group counts.
+/// @param[in] group_count_offset Offset in bytes of the work-group counts in
+/// `group_count_buffer`, must be a multiple of 4.
+/// @param[in] local_work_size Local work group size, must not be null.
+/// @param[in] num_events_in_wait_list Number of events in list to wait for.
+/// @param[in] event_wait_list List of events to wait for.
+/// @param[out] event Return event if not null.
+///
+/// @return Return error code.
+cl_int EnqueueNDRangeKernelIndirect(
+    cl_command_queue command_queue, cl_kernel kernel, cl_uint work_dim,
+    const size_t *global_work_offset, cl_mem group_count_buffer,
+    size_t group_count_offset, const size_t *local_work_size,
+    cl_uint num_events_in_wait_list, const cl_event *event_wait_list,
+    cl_event *event);
+
 /// @brief Enqueue a single kernel invocation.
 ///
 /// @param[in] command_queue Command queue to queue the invocation on.
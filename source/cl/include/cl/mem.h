@@ -139,6 +139,13 @@ struct _cl_mem : public cl::base<_cl_mem> {
   const cl_mem optional_parent;
   // @brief Pointer to optionally user provided host memory.
   void *host_ptr;
+  /// @brief Offset of `host_ptr` into the device memory.
+  ///
+  /// Non-zero when the device memory was created in place from the aligned
+  /// address below an unaligned `host_ptr`, in which case buffers are bound at
+  /// this offset and mapping offsets into the memory must account for it.
+  /// Sub-buffers share the offset of their parent.
+  size_t host_ptr_offset;
 
   /// @brief List of mux memory objects, the physical device memory allocation.
   cargo::dynamic_array<mux_memory_t> mux_memories;
@@ -26,10 +26,16 @@
 #include <cargo/expected.h>
 #include <cargo/optional.h>
 #include <cl/base.h>
+#include <compiler/context.h>
 #include <compiler/loader.h>
+#include <compiler/target.h>
 #include <mux/mux.h>
 
+#include <map>
+#include <memory>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 /// @addtogroup cl
 /// @{
@@ -74,6 +80,54 @@ struct _cl_platform_id final : cl::base<_cl_platform_id> {
   /// message if library loading failed, an empty optional otherwise.
   cargo::optional<std::string> getCompilerLibraryLoaderError();
 
+  /// @brief A compiler context and the compiler targets created with it.
+  ///
+  /// Contexts without a notify callback take a cache when they first compile
+  /// and hand it back when they are destroyed, so that later contexts reuse
+  /// its initialized targets rather than reloading the builtins. A cache is
+  /// only used by one context at a time, so contexts compiling concurrently
+  /// don't contend on a lock or share an LLVMContext. The immutable builtins
+  /// bitcode is embedded in the compiler library, so it is shared by all.
+  struct compiler_cache_s {
+    /// @brief Access the compiler target for a particular device.
+    ///
+    /// Targets are keyed on the device's compiler info and builtin
+    /// capabilities, devices which agree on both share a target.
+    ///
+    /// @param device The device to get a compiler target for.
+    ///
+    /// @return Returns a pointer to the compiler target, or `nullptr` if one
+    /// could not be created.
+    compiler::Target *getTarget(const cl_device_id device);
+
+    /// @brief Compiler context, must be destroyed after the targets.
+    std::unique_ptr<compiler::Context> context;
+    /// @brief A mutex that guards the targets map.
+    std::mutex targets_mutex;
+    /// @brief Map of compiler infos and builtin capabilities to the compiler
+    /// targets created with `context`.
+    std::map<std::pair<const compiler::Info *, uint32_t>,
+             std::unique_ptr<compiler::Target>>
+        targets;
+    /// @brief Number of contexts which have used the cache.
+    uint32_t uses = 0;
+  };
+
+  /// @brief Take an idle compiler cache, or create a new one.
+  ///
+  /// @return Returns the compiler cache, or `nullptr` if no compiler is
+  /// available.
+  std::unique_ptr<compiler_cache_s> acquireCompilerCache();
+
+  /// @brief Hand back a compiler cache taken with `acquireCompilerCache`.
+  ///
+  /// A cache's LLVMContext keeps types and constants from every compilation,
+  /// so caches are dropped rather than kept for reuse once they have been used
+  /// by `max_compiler_cache_uses` contexts, or when enough caches are idle.
+  ///
+  /// @param cache The compiler cache to hand back.
+  void releaseCompilerCache(std::unique_ptr<compiler_cache_s> cache);
+
   /// @brief List of devices owned by the platform.
   cargo::dynamic_array<cl_device_id> devices;
 
@@ -81,6 +135,15 @@ struct _cl_platform_id final : cl::base<_cl_platform_id> {
   /// @brief Compiler library.
   cargo::expected<std::unique_ptr<compiler::Library>, std::string>
       compiler_library;
+  /// @brief Number of contexts after which a compiler cache is dropped.
+  static constexpr uint32_t max_compiler_cache_uses = 64;
+  /// @brief Number of idle compiler caches kept for reuse.
+  static constexpr size_t max_idle_compiler_caches = 4;
+  /// @brief A mutex that guards the idle_compiler_caches list.
+  std::mutex compiler_caches_mutex;
+  /// @brief Compiler caches not in use by any context, must be destroyed
+  /// before the compiler library.
+  std::vector<std::unique_ptr<compiler_cache_s>> idle_compiler_caches;
 
 #if defined(CL_VERSION_3_0)
  public:
@@ -394,23 +394,20 @@ bool serializeProgramInfo(md_ctx ctx, const compiler::ProgramInfo &program_info,
   return true;
 }
 
-bool deserializeExecutable(md_ctx ctx,
+bool deserializeExecutable(cargo::array_view<const uint8_t> binary,
                            cargo::dynamic_array<uint8_t> &executable) {
-  md_stack executable_stack = md_get_block(ctx, OCL_MD_EXECUTABLE_BLOCK);
-  if (!executable_stack) {
+  // The executable is by far the largest block, copy it straight out of the
+  // binary rather than deserializing it into a context first.
+  md_block_view view;
+  if (md_find_block(binary.data(), binary.size(), OCL_MD_EXECUTABLE_BLOCK,
+                    &view) != md_err::MD_SUCCESS ||
+      view.fmt != md_fmt::MD_FMT_RAW_BYTES) {
     return false;
   }
-  size_t exec_len;
-  char *exec_bytes;
-  const int err = md_loadf(executable_stack, "s", &exec_len, &exec_bytes);
-  if (MD_CHECK_ERR(err)) {
-    return false;
-  }
-  if (executable.alloc(exec_len)) {
+  if (executable.alloc(view.size)) {
     return false;
   }
-  std::memcpy(executable.data(), exec_bytes, exec_len);
-  std::free(exec_bytes);
+  std::memcpy(executable.data(), view.data, view.size);
   return true;
 }
 
@@ -875,7 +872,7 @@ bool deserializeBinary(cargo::array_view<const uint8_t> binary,
     return false;
   }
 
-  if (!deserializeExecutable(ctx.get(), executable)) {
+  if (!deserializeExecutable(binary, executable)) {
     return false;
   }
 
@@ -98,7 +98,7 @@ cargo::expected<std::unique_ptr<_cl_mem_buffer>, cl_int> _cl_mem_buffer::create(
     OCL_CHECK(error, return cargo::make_unexpected(error));
     buffer->mux_memories[index] = mux_memory;
 
-    const uint64_t offset = 0;
+    const uint64_t offset = buffer->host_ptr_offset;
     auto mux_error =
         muxBindBufferMemory(mux_device, mux_memory, mux_buffer, offset);
     OCL_CHECK(mux_error,
@@ -294,6 +294,7 @@ CL_API_ENTRY cl_mem CL_API_CALL cl::CreateSubBuffer(
   OCL_CHECK(!sub_buffer,
             OCL_SET_IF_NOT_NULL(errcode_ret, CL_OUT_OF_HOST_MEMORY);
             return nullptr);
+  sub_buffer->host_ptr_offset = buffer->host_ptr_offset;
 
   for (cl_uint index = 0; index < buffer->context->devices.size(); ++index) {
     auto device = buffer->context->devices[index];
@@ -309,7 +310,8 @@ CL_API_ENTRY cl_mem CL_API_CALL cl::CreateSubBuffer(
 
     mux_error =
         muxBindBufferMemory(device->mux_device, sub_buffer->mux_memories[index],
-                            sub_buffer->mux_buffers[index], origin);
+                            sub_buffer->mux_buffers[index],
+                            sub_buffer->host_ptr_offset + origin);
     OCL_CHECK(mux_error, OCL_SET_IF_NOT_NULL(errcode_ret,
                                              CL_MEM_OBJECT_ALLOCATION_FAILURE);
               return nullptr);
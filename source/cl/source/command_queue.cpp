@@ -49,6 +49,7 @@ _cl_command_queue::_cl_command_queue(cl_context context, cl_device_id device,
       running_command_buffers(),
       finish_state(),
       cached_command_buffers(),
+      barrier_semaphore(nullptr),
       in_flush(false) {
   cl::retainInternal(context);
   cl::retainInternal(device);
@@ -61,6 +62,9 @@ _cl_command_queue::~_cl_command_queue() {
     const std::lock_guard<std::mutex> lock(context->getCommandQueueMutex());
     cleanupCompletedCommandBuffers();
   }
+  if (barrier_semaphore) {
+    releaseSemaphore(barrier_semaphore);
+  }
   // Release any completed signal semaphores
   for (auto semaphore : completed_signal_semaphores) {
     releaseSemaphore(semaphore);
@@ -86,6 +90,12 @@ _cl_command_queue::~_cl_command_queue() {
     muxDestroyQueryPool(mux_queue, counter_queries, device->mux_allocator);
   }
 
+  // All events, and so all duration queries, have been released by now as
+  // events hold a reference to their command queue.
+  for (auto pool : duration_query_pools) {
+    muxDestroyQueryPool(mux_queue, pool, device->mux_allocator);
+  }
+
   cl::releaseInternal(device);
   cl::releaseInternal(context);
 }
@@ -99,16 +109,17 @@ _cl_command_queue::create(cl_context context, cl_device_id device,
     return cargo::make_unexpected(CL_INVALID_VALUE);
   }
 
-#ifndef CA_ENABLE_OUT_OF_ORDER_EXEC_MODE
   if (cl::validate::IsInBitSet(properties,
-                               CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)) {
+                               CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE) &&
+      !cl::validate::IsInBitSet(device->queue_properties,
+                                CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)) {
     return cargo::make_unexpected(CL_INVALID_QUEUE_PROPERTIES);
   }
-#endif
 
   mux_queue_t mux_queue;
   const mux_result_t error =
-      muxGetQueue(device->mux_device, mux_queue_type_compute, 0, &mux_queue);
+      muxGetQueue(device->mux_device, mux_queue_type_compute,
+                  device->mux_queue_index, &mux_queue);
   OCL_CHECK(error, return cargo::make_unexpected(CL_OUT_OF_HOST_MEMORY));
 
   auto queue = std::unique_ptr<_cl_command_queue>(new (
@@ -126,7 +137,8 @@ _cl_command_queue::create(cl_context context, cl_device_id device,
                           const cl_bitfield *properties) {
   mux_queue_t mux_queue;
   const mux_result_t error =
-      muxGetQueue(device->mux_device, mux_queue_type_compute, 0, &mux_queue);
+      muxGetQueue(device->mux_device, mux_queue_type_compute,
+                  device->mux_queue_index, &mux_queue);
   OCL_CHECK(error, return cargo::make_unexpected(CL_OUT_OF_HOST_MEMORY));
 
   auto command_queue = std::unique_ptr<_cl_command_queue>(
@@ -151,11 +163,10 @@ _cl_command_queue::create(cl_context context, cl_device_id device,
         case CL_QUEUE_PROPERTIES:
           if (value & ~valid_properties_mask) {
             return cargo::make_unexpected(CL_INVALID_VALUE);
-#ifndef CA_ENABLE_OUT_OF_ORDER_EXEC_MODE
-          } else if (value & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE) {
-            // TODO(CA-1123): Support out of order command queues.
+          } else if (value & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE &&
+                     !(device->queue_properties &
+                       CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)) {
             return cargo::make_unexpected(CL_INVALID_QUEUE_PROPERTIES);
-#endif
 #if defined(CL_VERSION_3_0)
           } else if (value & CL_QUEUE_ON_DEVICE ||
                      value & CL_QUEUE_ON_DEVICE_DEFAULT) {
@@ -274,19 +285,29 @@ cl_int _cl_command_queue::cleanupCompletedCommandBuffers() {
       break;
     }
 
-    // Check if the first running command buffer has completed.
-    auto fence = fences[running_command_buffers.front().command_buffer];
-    assert(fence && "Missing fence entry for command buffer dispatch!");
-    const mux_result_t error = muxTryWait(mux_queue, 0, fence);
-    OCL_ASSERT(mux_success == error || mux_error_fence_failure == error ||
-                   mux_fence_not_ready == error,
-               "muxTryWait failed!");
+    // Find a running command buffer which has completed. The command groups
+    // of an in-order queue are linearly chained together, if the first
+    // command buffer isn't complete, future ones will not have completed yet
+    // either. Those of an out-of-order queue may complete in any order.
+    auto running = running_command_buffers.begin();
+    const auto last = isOutOfOrder() ? running_command_buffers.end()
+                                     : std::next(running);
+    mux_fence_t fence = nullptr;
+    mux_result_t error = mux_fence_not_ready;
+    for (; running != last; ++running) {
+      fence = fences[running->command_buffer];
+      assert(fence && "Missing fence entry for command buffer dispatch!");
+      error = muxTryWait(mux_queue, 0, fence);
+      OCL_ASSERT(mux_success == error || mux_error_fence_failure == error ||
+                     mux_fence_not_ready == error,
+                 "muxTryWait failed!");
+      if (mux_fence_not_ready != error) {
+        break;
+      }
+    }
 
     if (mux_fence_not_ready == error) {
-      // The command buffer wasn't yet complete. Because of how our command
-      // groups are linearly chained together (we have an in order queue)
-      // we can bail now as if this command buffer isn't complete, future
-      // ones will not have completed yet either.
+      // None of the command buffers we can check are complete yet.
       return CL_SUCCESS;
     }
 
@@ -294,7 +315,7 @@ cl_int _cl_command_queue::cleanupCompletedCommandBuffers() {
     // and remove the associated entry from the map.
     // TODO: We could do better here and reset the fences then reuse them.
     muxDestroyFence(device->mux_device, fence, device->mux_allocator);
-    fences.erase(running_command_buffers.front().command_buffer);
+    fences.erase(running->command_buffer);
 
     // Note that by this point 'error' may be either mux_success or
     // mux_error_fence_failure.  This function does not care about
@@ -303,13 +324,19 @@ cl_int _cl_command_queue::cleanupCompletedCommandBuffers() {
     // accordingly.
 
     // The command buffer has completed so stop tracking it then destroy it.
-    auto completed = std::move(running_command_buffers.front());
+    auto completed = std::move(*running);
     // Any completed buffers that have wait semaphores should be cleaned
     // up
     for (auto &s : completed.wait_semaphores) {
       releaseSemaphore(s);
     }
-    running_command_buffers.pop_front();
+    running_command_buffers.erase(running);
+
+    // Commands enqueued from now on need not wait for a completed barrier.
+    if (completed.signal_semaphore == barrier_semaphore) {
+      releaseSemaphore(barrier_semaphore);
+      barrier_semaphore = nullptr;
+    }
 
 #ifdef OCL_EXTENSION_cl_khr_command_buffer
     // We need to release references on any command buffers associated with user
@@ -400,9 +427,45 @@ cl_uint _cl_command_queue::getDeviceIndex() {
 [[nodiscard]] cargo::expected<mux_command_buffer_t, cl_int>
 _cl_command_queue::getCommandBuffer(
     cargo::array_view<const cl_event> event_wait_list, cl_event event) {
+  return registerEvents(getCommandBufferPending(event_wait_list),
+                        event_wait_list, event);
+}
+
+[[nodiscard]] cargo::expected<mux_command_buffer_t, cl_int>
+_cl_command_queue::getSyncCommandBuffer(
+    cargo::array_view<const cl_event> event_wait_list, cl_event event,
+    bool is_barrier) {
+  if (!isOutOfOrder()) {
+    return getCommandBuffer(event_wait_list, event);
+  }
+
+  auto command_buffer = registerEvents(
+      getCommandBufferPending(event_wait_list, event_wait_list.empty()),
+      event_wait_list, event);
+  if (command_buffer && is_barrier) {
+    // Later commands wait for the barrier's dispatch, this also covers any
+    // previous barrier since the new one depends on it.
+    auto semaphore = pending_dispatches[*command_buffer].signal_semaphore;
+    if (semaphore != barrier_semaphore) {
+      if (auto error = semaphore->retain()) {
+        return cargo::make_unexpected(error);
+      }
+      if (barrier_semaphore) {
+        releaseSemaphore(barrier_semaphore);
+      }
+      barrier_semaphore = semaphore;
+    }
+  }
+  return command_buffer;
+}
+
+[[nodiscard]] cargo::expected<mux_command_buffer_t, cl_int>
+_cl_command_queue::registerEvents(
+    cargo::expected<mux_command_buffer_t, cl_int> command_buffer,
+    cargo::array_view<const cl_event> event_wait_list, cl_event event) {
   // Register the wait and signal events for the command buffer's dispatch.
-  auto registerEvents = [this, event_wait_list,
-                         event](mux_command_buffer_t command_buffer)
+  auto registerDispatchEvents = [this, event_wait_list,
+                                 event](mux_command_buffer_t command_buffer)
       -> cargo::expected<mux_command_buffer_t, cl_int> {
     auto &dispatch = pending_dispatches[command_buffer];
     if (auto error = dispatch.addWaitEvents(event_wait_list)) {
@@ -412,9 +475,15 @@ _cl_command_queue::getCommandBuffer(
       return cargo::make_unexpected(error);
     }
     if (event && (properties & CL_QUEUE_PROFILING_ENABLE)) {
+      // The query may have been used by a previous event.
+      if (auto mux_error = muxCommandResetQueryPool(
+              command_buffer, event->profiling.duration_queries,
+              event->profiling.duration_index, 1, 0, nullptr, nullptr)) {
+        return cargo::make_unexpected(cl::getErrorFrom(mux_error));
+      }
       if (auto mux_error = muxCommandBeginQuery(
-              command_buffer, event->profiling.duration_queries, 0, 1, 0,
-              nullptr, nullptr)) {
+              command_buffer, event->profiling.duration_queries,
+              event->profiling.duration_index, 1, 0, nullptr, nullptr)) {
         return cargo::make_unexpected(cl::getErrorFrom(mux_error));
       }
     }
@@ -427,8 +496,7 @@ _cl_command_queue::getCommandBuffer(
     }
   };
 
-  return getCommandBufferPending(event_wait_list)
-      .and_then(registerEvents)
+  return command_buffer.and_then(registerDispatchEvents)
       .or_else(setEventFailure);
 }
 
@@ -439,9 +507,9 @@ _cl_command_queue::getCommandBuffer(
       pending_dispatches.end() != pending_dispatches.find(command_buffer),
       "command_buffer not found in pending_dispatches");
   if (event && (properties & CL_QUEUE_PROFILING_ENABLE)) {
-    if (auto mux_error = muxCommandEndQuery(command_buffer,
-                                            event->profiling.duration_queries,
-                                            0, 1, 0, nullptr, nullptr)) {
+    if (auto mux_error = muxCommandEndQuery(
+            command_buffer, event->profiling.duration_queries,
+            event->profiling.duration_index, 1, 0, nullptr, nullptr)) {
       return cl::getErrorFrom(mux_error);
     }
   }
@@ -451,6 +519,42 @@ _cl_command_queue::getCommandBuffer(
   return CL_SUCCESS;
 }
 
+[[nodiscard]] cargo::expected<_cl_command_queue::duration_query_t, cl_int>
+_cl_command_queue::acquireDurationQuery() {
+  const std::lock_guard<std::mutex> lock(duration_query_mutex);
+  if (duration_queries.empty()) {
+    mux_query_pool_t pool;
+    if (auto mux_error = muxCreateQueryPool(
+            mux_queue, mux_query_type_duration, duration_query_pool_size,
+            nullptr, device->mux_allocator, &pool)) {
+      OCL_ASSERT(mux_error != mux_error_invalid_value &&
+                     mux_error != mux_error_null_out_parameter,
+                 "internal error calling muxCreateQueryPool");
+      OCL_UNUSED(mux_error);
+      return cargo::make_unexpected(CL_OUT_OF_RESOURCES);
+    }
+    // Reserve room for every query up front so that releasing one can't fail.
+    if (duration_queries.reserve((duration_query_pools.size() + 1) *
+                                 duration_query_pool_size) ||
+        duration_query_pools.push_back(pool)) {
+      muxDestroyQueryPool(mux_queue, pool, device->mux_allocator);
+      return cargo::make_unexpected(CL_OUT_OF_RESOURCES);
+    }
+    // Hand out the lowest indices first.
+    for (uint32_t index = duration_query_pool_size; index > 0; index--) {
+      (void)duration_queries.push_back({pool, index - 1});
+    }
+  }
+  auto query = duration_queries.back();
+  duration_queries.pop_back();
+  return query;
+}
+
+void _cl_command_queue::releaseDurationQuery(duration_query_t query) {
+  const std::lock_guard<std::mutex> lock(duration_query_mutex);
+  (void)duration_queries.push_back(query);
+}
+
 [[nodiscard]] cargo::expected<mux_command_buffer_t, cl_int>
 _cl_command_queue::getCurrentCommandBuffer() {
   if (pending_command_buffers.empty()) {
@@ -464,7 +568,7 @@ _cl_command_queue::getCurrentCommandBuffer() {
 
 [[nodiscard]] cargo::expected<mux_command_buffer_t, cl_int>
 _cl_command_queue::getCommandBufferPending(
-    cargo::array_view<const cl_event> event_wait_list) {
+    cargo::array_view<const cl_event> event_wait_list, bool wait_for_all) {
   // Utility function object adds wait semaphores to a pending dispatch.
   struct add_wait {
     add_wait(cargo::array_view<mux_shared_semaphore> semaphores,
@@ -509,6 +613,20 @@ _cl_command_queue::getCommandBufferPending(
         &pending_dispatches;
   };
 
+  if (isOutOfOrder()) {
+    cargo::small_vector<mux_shared_semaphore, 8> semaphores;
+    mux_command_buffer_t append_to = nullptr;
+    if (auto error = getOutOfOrderDependencies(event_wait_list, wait_for_all,
+                                               semaphores, append_to)) {
+      return cargo::make_unexpected(error);
+    }
+    if (append_to) {
+      return append_to;
+    }
+    return createCommandBuffer().and_then(
+        add_wait{semaphores, pending_dispatches});
+  }
+
   // Storage for the pending dispatches on which this command buffer will
   // depend.
   using dispatch_pair = std::pair<const mux_command_buffer_t, dispatch_state_t>;
@@ -659,6 +777,128 @@ _cl_command_queue::getCommandBufferPending(
       add_wait{semaphores, pending_dispatches});
 }
 
+[[nodiscard]] cl_int _cl_command_queue::getOutOfOrderDependencies(
+    cargo::array_view<const cl_event> event_wait_list, bool wait_for_all,
+    cargo::small_vector<mux_shared_semaphore, 8> &semaphores,
+    mux_command_buffer_t &append_to) {
+  append_to = nullptr;
+
+  // Pending dispatches of this queue the command depends on.
+  cargo::small_vector<mux_command_buffer_t, 8> dependencies;
+
+  // A command waiting on a user event or another queue gets its own command
+  // buffer so that it doesn't hold back the commands it would be batched with.
+  bool can_append = !wait_for_all;
+
+  for (auto wait_event : event_wait_list) {
+    if (CL_COMPLETE == wait_event->command_status) {
+      continue;
+    }
+    if (cl::isUserEvent(wait_event)) {
+      can_append = false;
+      if (!wait_event->addCallback(CL_COMPLETE, &userEventDispatch, this)) {
+        return CL_OUT_OF_RESOURCES;
+      }
+      continue;
+    }
+
+    auto isWaitEvent = [wait_event](const cl_event signal_event) {
+      return wait_event == signal_event;
+    };
+
+    auto *const queue = wait_event->queue;
+    auto pending = std::find_if(
+        queue->pending_dispatches.begin(), queue->pending_dispatches.end(),
+        [&isWaitEvent](const auto &pending) {
+          auto &signal_events = pending.second.signal_events;
+          return std::any_of(signal_events.begin(), signal_events.end(),
+                             isWaitEvent);
+        });
+    if (pending != queue->pending_dispatches.end()) {
+      if (queue == this) {
+        if (dependencies.push_back(pending->first)) {
+          return CL_OUT_OF_RESOURCES;
+        }
+      } else if (semaphores.push_back(pending->second.signal_semaphore)) {
+        return CL_OUT_OF_RESOURCES;
+      }
+      continue;
+    }
+
+    if (queue != this) {
+      // Running dispatches of other queues may be in any order, wait for all
+      // of them.
+      for (auto &running : queue->running_command_buffers) {
+        if (semaphores.push_back(running.signal_semaphore)) {
+          return CL_OUT_OF_RESOURCES;
+        }
+      }
+      continue;
+    }
+
+    // Wait for the running dispatch signalling the event, if there is none
+    // it has already completed.
+    for (auto &running : running_command_buffers) {
+      auto state = finish_state.find(running.command_buffer);
+      if (state != finish_state.end() &&
+          std::any_of(state->second.signal_events.begin(),
+                      state->second.signal_events.end(), isWaitEvent)) {
+        if (semaphores.push_back(running.signal_semaphore)) {
+          return CL_OUT_OF_RESOURCES;
+        }
+        break;
+      }
+    }
+  }
+
+  if (wait_for_all) {
+    if (!dependencies.insert(dependencies.end(),
+                             pending_command_buffers.begin(),
+                             pending_command_buffers.end())) {
+      return CL_OUT_OF_RESOURCES;
+    }
+    for (auto &running : running_command_buffers) {
+      if (semaphores.push_back(running.signal_semaphore)) {
+        return CL_OUT_OF_RESOURCES;
+      }
+    }
+  }
+
+  std::sort(dependencies.begin(), dependencies.end());
+  dependencies.erase(std::unique(dependencies.begin(), dependencies.end()),
+                     dependencies.end());
+
+  // Batch the command into its only dependency, unless that would place it
+  // before a barrier it must wait for.
+  if (can_append && dependencies.size() == 1 && semaphores.empty()) {
+    auto &dispatch = pending_dispatches[dependencies.front()];
+    const bool after_barrier =
+        !barrier_semaphore || dispatch.signal_semaphore == barrier_semaphore ||
+        std::find(dispatch.wait_semaphores.begin(),
+                  dispatch.wait_semaphores.end(),
+                  barrier_semaphore) != dispatch.wait_semaphores.end();
+    if (!dispatch.is_user_command_buffer && after_barrier) {
+      append_to = dependencies.front();
+      return CL_SUCCESS;
+    }
+  }
+
+  for (auto command_buffer : dependencies) {
+    if (semaphores.push_back(
+            pending_dispatches[command_buffer].signal_semaphore)) {
+      return CL_OUT_OF_RESOURCES;
+    }
+  }
+  if (barrier_semaphore && semaphores.push_back(barrier_semaphore)) {
+    return CL_OUT_OF_RESOURCES;
+  }
+
+  std::sort(semaphores.begin(), semaphores.end());
+  semaphores.erase(std::unique(semaphores.begin(), semaphores.end()),
+                   semaphores.end());
+  return CL_SUCCESS;
+}
+
 [[nodiscard]] cl_int _cl_command_queue::dispatch(
     cargo::array_view<mux_command_buffer_t> command_buffers) {
   for (auto command_buffer : command_buffers) {
@@ -847,6 +1087,12 @@ cl_int _cl_command_queue::dropDispatchesPending(
                     [](std::function<void()> &callback) { callback(); });
       dispatch.callbacks.clear();
 
+      // A barrier which will never run can no longer be waited for.
+      if (dispatch.signal_semaphore == barrier_semaphore) {
+        releaseSemaphore(barrier_semaphore);
+        barrier_semaphore = nullptr;
+      }
+
       // Release the signal semaphore if it exists.
       if (auto error = releaseSemaphore(dispatch.signal_semaphore)) {
         return error;
@@ -1177,20 +1423,25 @@ CL_API_ENTRY cl_int CL_API_CALL cl::EnqueueBarrierWithWaitList(
       num_events_in_wait_list, event_wait_list, command_queue->context, event);
   OCL_CHECK(error != CL_SUCCESS, return error);
 
-  if (nullptr != event) {
-    auto new_event = _cl_event::create(command_queue, CL_COMMAND_BARRIER);
-    if (!new_event) {
-      return new_event.error();
+  // barriers are implicit in in-order queues, so are a no-op there if we
+  // don't have a return event
+  if (nullptr != event || command_queue->isOutOfOrder()) {
+    cl_event barrier_event = nullptr;
+    if (nullptr != event) {
+      auto new_event = _cl_event::create(command_queue, CL_COMMAND_BARRIER);
+      if (!new_event) {
+        return new_event.error();
+      }
+      *event = *new_event;
+      barrier_event = *event;
     }
-    *event = *new_event;
 
     const std::lock_guard<std::mutex> lock(
         command_queue->context->getCommandQueueMutex());
 
-    // barriers are implicit in in-order queues, could mostly be a no-op
-    // (especially if we don't have a return event!)
-    auto command_buffer = command_queue->getCommandBuffer(
-        {event_wait_list, num_events_in_wait_list}, *event);
+    auto command_buffer = command_queue->getSyncCommandBuffer(
+        {event_wait_list, num_events_in_wait_list}, barrier_event,
+        /* is_barrier */ true);
     if (!command_buffer) {
       return CL_OUT_OF_RESOURCES;
     }
@@ -1219,8 +1470,9 @@ CL_API_ENTRY cl_int CL_API_CALL cl::EnqueueMarkerWithWaitList(
     const std::lock_guard<std::mutex> lock(
         command_queue->context->getCommandQueueMutex());
 
-    auto mux_command_buffer = command_queue->getCommandBuffer(
-        {event_wait_list, num_events_in_wait_list}, *event);
+    auto mux_command_buffer = command_queue->getSyncCommandBuffer(
+        {event_wait_list, num_events_in_wait_list}, *event,
+        /* is_barrier */ false);
     if (!mux_command_buffer) {
       return CL_OUT_OF_RESOURCES;
     }
@@ -1244,15 +1496,18 @@ CL_API_ENTRY cl_int CL_API_CALL cl::EnqueueWaitForEvents(
               return CL_INVALID_CONTEXT);
   }
 
-#ifndef CA_ENABLE_OUT_OF_ORDER_EXEC_MODE
-  OCL_CHECK(cl::validate::IsInBitSet(queue->properties,
-                                     CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE),
-            OCL_ABORT("OCL API objects event. Error clEnqueueWaitForEvents "
-                      "does not support out of order execution"));
-#endif
-
-  // no-op, as our queue is in-order we guarantee that all events are executed
+  // no-op for in-order queues, we guarantee that all events are executed
   // before this could be!
+  if (queue->isOutOfOrder()) {
+    // Later commands wait for the events just as they would for a barrier.
+    const std::lock_guard<std::mutex> lock(
+        queue->context->getCommandQueueMutex());
+    auto command_buffer = queue->getSyncCommandBuffer(
+        {event_list, num_events}, nullptr, /* is_barrier */ true);
+    if (!command_buffer) {
+      return CL_OUT_OF_RESOURCES;
+    }
+  }
 
   return CL_SUCCESS;
 }
@@ -1321,6 +1576,18 @@ CL_API_ENTRY cl_int CL_API_CALL cl::Finish(cl_command_queue command_queue) {
 CL_API_ENTRY cl_int CL_API_CALL cl::EnqueueBarrier(cl_command_queue queue) {
   const tracer::TraceGuard<tracer::OpenCL> guard("clEnqueueBarrier");
   OCL_CHECK(!queue, return CL_INVALID_COMMAND_QUEUE);
+
+  // barriers are implicit in in-order queues
+  if (queue->isOutOfOrder()) {
+    const std::lock_guard<std::mutex> lock(
+        queue->context->getCommandQueueMutex());
+    auto command_buffer =
+        queue->getSyncCommandBuffer({}, nullptr, /* is_barrier */ true);
+    if (!command_buffer) {
+      return CL_OUT_OF_RESOURCES;
+    }
+  }
+
   return CL_SUCCESS;
 }
 
@@ -1341,7 +1608,8 @@ cl::EnqueueMarker(cl_command_queue command_queue, cl_event *event) {
     const std::lock_guard<std::mutex> lock(
         command_queue->context->getCommandQueueMutex());
 
-    auto mux_command_buffer = command_queue->getCommandBuffer({}, *event);
+    auto mux_command_buffer = command_queue->getSyncCommandBuffer(
+        {}, *event, /* is_barrier */ false);
     if (!mux_command_buffer) {
       return CL_OUT_OF_RESOURCES;
     }
@@ -1409,12 +1677,39 @@ cl::EnqueueMarker(cl_command_queue command_queue, cl_event *event) {
   command_buffer->updates.clear();
 #endif
 
+  // Out-of-order queues only wait for the dispatches signalling the wait
+  // events and the last barrier, which also registers the user event
+  // callbacks.
+  if (isOutOfOrder()) {
+    cargo::small_vector<mux_shared_semaphore, 8> semaphores;
+    mux_command_buffer_t append_to = nullptr;
+    if (auto error = getOutOfOrderDependencies(
+            {event_wait_list, num_events_in_wait_list},
+            /* wait_for_all */ false, semaphores, append_to)) {
+      return error;
+    }
+    // User command buffers can't be batched into, wait for the single
+    // dependency instead.
+    if (append_to &&
+        semaphores.push_back(pending_dispatches[append_to].signal_semaphore)) {
+      return CL_OUT_OF_RESOURCES;
+    }
+    auto &wait_semaphores =
+        pending_dispatches[mux_command_buffer].wait_semaphores;
+    for (auto wait_semaphore : semaphores) {
+      if (wait_semaphores.push_back(wait_semaphore)) {
+        return CL_OUT_OF_RESOURCES;
+      }
+      wait_semaphore->retain();
+    }
+  }
+
   // Since we can't do any batching with user command buffers we can just wait
   // directly on the last pending dispatch (we need to do this anyway to enforce
   // an in order queue). Since the queue is in order, we know that any event
   // dependencies requested by the user will still be respected. This will not
   // work for cross queue event dependencies (see CA-3276).
-  if (!pending_command_buffers.empty()) {
+  if (!isOutOfOrder() && !pending_command_buffers.empty()) {
     auto &signal_semaphore =
         pending_dispatches[pending_command_buffers.back()].signal_semaphore;
     if (pending_dispatches[mux_command_buffer].wait_semaphores.push_back(
@@ -1461,26 +1756,28 @@ cl::EnqueueMarker(cl_command_queue command_queue, cl_event *event) {
     return CL_OUT_OF_RESOURCES;
   }
 
-  // Add callbacks to all the user events in the wait list.
-  for (unsigned i = 0; i < num_events_in_wait_list; ++i) {
-    auto wait_event = event_wait_list[i];
-    // Do not wait on completed commands.
-    if (cl::isUserEvent(wait_event) &&
-        wait_event->command_status != CL_COMPLETE) {
-      if (!wait_event->addCallback(CL_COMPLETE, &userEventDispatch, this)) {
-        return CL_OUT_OF_RESOURCES;
+  if (!isOutOfOrder()) {
+    // Add callbacks to all the user events in the wait list.
+    for (unsigned i = 0; i < num_events_in_wait_list; ++i) {
+      auto wait_event = event_wait_list[i];
+      // Do not wait on completed commands.
+      if (cl::isUserEvent(wait_event) &&
+          wait_event->command_status != CL_COMPLETE) {
+        if (!wait_event->addCallback(CL_COMPLETE, &userEventDispatch, this)) {
+          return CL_OUT_OF_RESOURCES;
+        }
       }
     }
-  }
 
-  // We need to wait on all running commands to enforce ordering.
-  for (auto &running_command_buffer : running_command_buffers) {
-    if (pending_dispatches[mux_command_buffer].wait_semaphores.push_back(
-            running_command_buffer.signal_semaphore)) {
-      releaseSemaphore(*semaphore);
-      return CL_OUT_OF_HOST_MEMORY;
-    } else {
-      running_command_buffer.signal_semaphore->retain();
+    // We need to wait on all running commands to enforce ordering.
+    for (auto &running_command_buffer : running_command_buffers) {
+      if (pending_dispatches[mux_command_buffer].wait_semaphores.push_back(
+              running_command_buffer.signal_semaphore)) {
+        releaseSemaphore(*semaphore);
+        return CL_OUT_OF_HOST_MEMORY;
+      } else {
+        running_command_buffer.signal_semaphore->retain();
+      }
     }
   }
 
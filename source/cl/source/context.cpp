@@ -78,6 +78,9 @@ _cl_context::~_cl_context() {
   // The compiler context must be destroyed before we release the internal
   // references to the devices within the context.
   compiler_context.reset();
+  if (compiler_cache) {
+    devices[0]->platform->releaseCompilerCache(std::move(compiler_cache));
+  }
   // In applications which release the context in a global variables destructor
   // releasing the devices here may cause them to be destroyed at this point if
   // their internal reference count is 1, therefore any objects in the context
@@ -112,6 +115,14 @@ compiler::Context *_cl_context::getCompilerContext() {
     // Note: We are guaranteed to have at least 1 device (checked in
     // cl::CreateContext), and guaranteed to have exactly 1 platform instance
     // (enforced via _cl_platform_id::getInstance()).
+
+    // Without a notify callback there is nothing specific to this context in
+    // the compiler, so it reuses the compiler context and targets of a context
+    // which has been destroyed, if there is one.
+    if (!notify_callback) {
+      compiler_cache = devices[0]->platform->acquireCompilerCache();
+      return;
+    }
     compiler_context =
         compiler::createContext(devices[0]->platform->getCompilerLibrary());
     if (compiler_context) {
@@ -124,6 +135,9 @@ compiler::Context *_cl_context::getCompilerContext() {
       }
     }
   });
+  if (compiler_cache) {
+    return compiler_cache->context.get();
+  }
   return compiler_context.get();
 #else
   return nullptr;
@@ -131,6 +145,12 @@ compiler::Context *_cl_context::getCompilerContext() {
 }
 
 compiler::Target *_cl_context::getCompilerTarget(const cl_device_id device) {
+  if (!notify_callback) {
+    // Targets come with the compiler cache taken by getCompilerContext.
+    getCompilerContext();
+    return compiler_cache ? compiler_cache->getTarget(device) : nullptr;
+  }
+
   const std::lock_guard<std::mutex> guard{compiler_targets_mutex};
 
   auto it = compiler_targets.find(device);
@@ -32,6 +32,7 @@
 #include <algorithm>
 #include <climits>
 #include <cstring>
+#include <new>
 #include <type_traits>
 
 namespace {
@@ -81,10 +82,47 @@ cl_device_fp_config setOpenCLFromMux(uint32_t capabilities) {
 _cl_device_id::_cl_device_id(cl_platform_id platform,
                              mux_allocator_info_t mux_allocator,
                              mux_device_t mux_device)
-    : base<_cl_device_id>(cl::ref_count_type::INTERNAL),
+    : _cl_device_id(cl::ref_count_type::INTERNAL, platform, mux_allocator,
+                    mux_device) {
+  // Each compute queue after the first is a partition of the device, which
+  // sub-devices are mapped onto. Mux doesn't say which affinity domain the
+  // partitions follow, only that they are the device's next level of
+  // partitioning, so that is the only affinity domain supported.
+  partition_max_sub_devices =
+      mux_device->info->queue_types[mux_queue_type_compute] - 1;
+  if (partition_max_sub_devices > 0) {
+    partition_properties.clear();
+    (void)partition_properties.push_back(CL_DEVICE_PARTITION_EQUALLY);
+    (void)partition_properties.push_back(
+        CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN);
+    partition_affinity_domain = CL_DEVICE_AFFINITY_DOMAIN_NEXT_PARTITIONABLE;
+  }
+}
+
+_cl_device_id::_cl_device_id(
+    cl_device_id parent, uint32_t mux_queue_index, cl_uint compute_units,
+    cargo::array_view<const cl_device_partition_property> partition_type)
+    : _cl_device_id(cl::ref_count_type::EXTERNAL, parent->platform,
+                    parent->mux_allocator, parent->mux_device) {
+  cl::retainInternal(parent);
+  this->parent_device = parent;
+  this->mux_queue_index = mux_queue_index;
+  this->max_compute_units = compute_units;
+  this->partition_type.clear();
+  (void)this->partition_type.insert(this->partition_type.end(),
+                                    partition_type.begin(),
+                                    partition_type.end());
+}
+
+_cl_device_id::_cl_device_id(cl::ref_count_type ref_count_type,
+                             cl_platform_id platform,
+                             mux_allocator_info_t mux_allocator,
+                             mux_device_t mux_device)
+    : base<_cl_device_id>(ref_count_type),
       platform(platform),
       mux_allocator(mux_allocator),
       mux_device(mux_device),
+      mux_queue_index(0),
       address_bits(),
       available(CL_TRUE),
       compiler_available(CL_FALSE),
@@ -158,9 +196,9 @@ _cl_device_id::_cl_device_id(cl_platform_id platform,
               : 0),
       parent_device(0),
       partition_max_sub_devices(0),
-      partition_properties(0),
+      partition_properties(),
       partition_affinity_domain(0),
-      partition_type(0),
+      partition_type(),
       preferred_vector_width_char(clamp(
           mux_device->info->preferred_vector_width / sizeof(cl_char), 1, 16)),
       preferred_vector_width_short(clamp(
@@ -187,8 +225,14 @@ _cl_device_id::_cl_device_id(cl_platform_id platform,
       preferred_interop_user_sync(CL_TRUE),
       profile(),
       profiling_timer_resolution(5),                // Get from Mux?
-      queue_properties(CL_QUEUE_PROFILING_ENABLE),  // Get from Mux?
-      reference_count(1),  // All devices are root devices.
+      queue_properties(CL_QUEUE_PROFILING_ENABLE
+#ifdef CA_ENABLE_OUT_OF_ORDER_EXEC_MODE
+                       | (mux_device->info->supports_concurrent_dispatch
+                              ? CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE
+                              : 0)
+#endif
+                           ),
+      reference_count(1),
       single_fp_config(setOpenCLFromMux(mux_device->info->float_capabilities)),
       type(),
       vendor_id(mux_device->info->khronos_vendor_id)
@@ -232,6 +276,11 @@ _cl_device_id::_cl_device_id(cl_platform_id platform,
 {
   cl::retainInternal(platform);
 
+  // Devices can't be partitioned and aren't partitions unless the constructors
+  // delegating to this one say otherwise.
+  (void)partition_properties.push_back(0);
+  (void)partition_type.push_back(0);
+
   version = CA_CL_DEVICE_VERSION;
   compiler_info = compiler::getCompilerForDevice(platform->getCompilerLibrary(),
                                                  mux_device->info);
@@ -333,7 +382,12 @@ _cl_device_id::_cl_device_id(cl_platform_id platform,
 }
 
 _cl_device_id::~_cl_device_id() {
-  muxDestroyDevice(mux_device, mux_allocator);
+  // Sub-devices share the mux device of their root device.
+  if (parent_device) {
+    cl::releaseInternal(parent_device);
+  } else {
+    muxDestroyDevice(mux_device, mux_allocator);
+  }
   cl::releaseInternal(platform);
 }
 
@@ -422,15 +476,18 @@ CL_API_ENTRY cl_int CL_API_CALL cl::RetainDevice(cl_device_id device) {
   const tracer::TraceGuard<tracer::OpenCL> guard("clRetainDevice");
   // The OpenCL spec says that this function does nothing for root level
   // devices (because such devices are not created, they are retrieved via
-  // clGetDeviceIDs). We don't support sub devices yet, so there is no actual
-  // work to do here.  We do, however, need to check if it's a pointer to an
-  // actual device.
+  // clGetDeviceIDs), only sub-devices are reference counted. We do, however,
+  // need to check if a root device is a pointer to an actual device.
   //
   // From section 4.3 of the OpenCL 1.2 spec (page 53):
   // "The function clRetainDevice increments the device reference count if
   // 'device' is a valid sub-device created by a call to clCreateSubDevices. If
   // 'device' is a root level device i.e. a cl_device_id returned by
   // clGetDeviceIDs, the 'device' reference count remains unchanged."
+  OCL_CHECK(!device, return CL_INVALID_DEVICE);
+  if (device->parent_device) {
+    return cl::retainExternal(device);
+  }
   auto platform = _cl_platform_id::getInstance();
   if (!platform) {
     return CL_INVALID_DEVICE;
@@ -444,7 +501,11 @@ CL_API_ENTRY cl_int CL_API_CALL cl::RetainDevice(cl_device_id device) {
 
 CL_API_ENTRY cl_int CL_API_CALL cl::ReleaseDevice(cl_device_id device) {
   const tracer::TraceGuard<tracer::OpenCL> guard("clReleaseDevice");
-  // This function does not release anything, see cl::RetainDevice.
+  // This function only releases sub-devices, see cl::RetainDevice.
+  OCL_CHECK(!device, return CL_INVALID_DEVICE);
+  if (device->parent_device) {
+    return cl::releaseExternal(device);
+  }
   auto platform = _cl_platform_id::getInstance();
   if (!platform) {
     return CL_INVALID_DEVICE;
@@ -618,11 +679,12 @@ CL_API_ENTRY cl_int CL_API_CALL cl::GetDeviceInfo(
       DEVICE_INFO_CASE(CL_DEVICE_PARENT_DEVICE, device->parent_device);
       DEVICE_INFO_CASE(CL_DEVICE_PARTITION_MAX_SUB_DEVICES,
                        device->partition_max_sub_devices);
-      DEVICE_INFO_CASE(CL_DEVICE_PARTITION_PROPERTIES,
-                       device->partition_properties);
+      DEVICE_INFO_CASE_SPECIAL_VECTOR(CL_DEVICE_PARTITION_PROPERTIES,
+                                      device->partition_properties);
       DEVICE_INFO_CASE(CL_DEVICE_PARTITION_AFFINITY_DOMAIN,
                        device->partition_affinity_domain);
-      DEVICE_INFO_CASE(CL_DEVICE_PARTITION_TYPE, device->partition_type);
+      DEVICE_INFO_CASE_SPECIAL_VECTOR(CL_DEVICE_PARTITION_TYPE,
+                                      device->partition_type);
       DEVICE_INFO_CASE(CL_DEVICE_PLATFORM, device->platform);
       DEVICE_INFO_CASE(CL_DEVICE_PREFERRED_VECTOR_WIDTH_CHAR,
                        device->preferred_vector_width_char);
@@ -646,7 +708,9 @@ CL_API_ENTRY cl_int CL_API_CALL cl::GetDeviceInfo(
       DEVICE_INFO_CASE(CL_DEVICE_PROFILING_TIMER_RESOLUTION,
                        device->profiling_timer_resolution);
       DEVICE_INFO_CASE(CL_DEVICE_QUEUE_PROPERTIES, device->queue_properties);
-      DEVICE_INFO_CASE(CL_DEVICE_REFERENCE_COUNT, device->reference_count);
+      DEVICE_INFO_CASE(CL_DEVICE_REFERENCE_COUNT,
+                       device->parent_device ? device->refCountExternal()
+                                             : device->reference_count);
       DEVICE_INFO_CASE(CL_DEVICE_TYPE, device->type);
       DEVICE_INFO_CASE(CL_DEVICE_VENDOR_ID, device->vendor_id);
       DEVICE_INFO_CASE_SPECIAL_STRING(CL_DRIVER_VERSION, driver_version);
@@ -937,42 +1001,67 @@ CL_API_ENTRY cl_int CL_API_CALL cl::CreateSubDevices(
     cl_uint num_devices, cl_device_id *out_devices, cl_uint *num_devices_ret) {
   const tracer::TraceGuard<tracer::OpenCL> guard("clCreateSubDevices");
   OCL_CHECK(!in_device, return CL_INVALID_DEVICE);
+  OCL_CHECK(!properties, return CL_INVALID_VALUE);
+  OCL_CHECK(std::find(in_device->partition_properties.begin(),
+                      in_device->partition_properties.end(),
+                      properties[0]) == in_device->partition_properties.end(),
+            return CL_INVALID_VALUE);
+  OCL_CHECK(0 == in_device->partition_max_sub_devices,
+            return CL_INVALID_VALUE);
 
-  OCL_UNUSED(out_devices);
+  // Sub-devices are mapped onto the mux compute queues after the first, each
+  // of which executes on its own partition of the device. The partitions split
+  // the device's compute units between them, so that is how many compute units
+  // each sub-device reports, whatever the partition type.
+  const cl_uint max_sub_devices = in_device->partition_max_sub_devices;
+  const cl_uint compute_units = in_device->max_compute_units / max_sub_devices;
+  cl_uint num_sub_devices = 0;
+  switch (properties[0]) {
+    case CL_DEVICE_PARTITION_EQUALLY: {
+      OCL_CHECK(properties[2] != 0, return CL_INVALID_VALUE);
+      const auto requested_units = static_cast<cl_uint>(properties[1]);
+      OCL_CHECK(requested_units == 0 ||
+                    requested_units > in_device->max_compute_units,
+                return CL_INVALID_VALUE);
+      // A partition can't be split further, so fewer compute units than
+      // requested can't be provided.
+      OCL_CHECK(requested_units > compute_units,
+                return CL_DEVICE_PARTITION_FAILED);
+      num_sub_devices = std::min(
+          in_device->max_compute_units / requested_units, max_sub_devices);
+    } break;
+    case CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN: {
+      OCL_CHECK(properties[2] != 0, return CL_INVALID_VALUE);
+      const auto domain = static_cast<cl_device_affinity_domain>(properties[1]);
+      // Exactly one of the supported affinity domains must be given.
+      OCL_CHECK(domain == 0 || (domain & (domain - 1)) != 0 ||
+                    (domain & in_device->partition_affinity_domain) == 0,
+                return CL_INVALID_VALUE);
+      num_sub_devices = max_sub_devices;
+    } break;
+    default:
+      return CL_INVALID_VALUE;
+  }
+  OCL_CHECK(num_sub_devices == 0, return CL_DEVICE_PARTITION_FAILED);
+  OCL_CHECK(out_devices && num_devices < num_sub_devices,
+            return CL_INVALID_VALUE);
 
-  if (properties) {
-    switch (properties[0]) {
-      case CL_DEVICE_PARTITION_EQUALLY: {
-        const cl_uint num_sub_devices = static_cast<cl_uint>(properties[1]);
-        OCL_CHECK(num_sub_devices > num_devices, return CL_INVALID_VALUE);
-        return CL_INVALID_VALUE;  // Sub devices not supported
-      }
-      case CL_DEVICE_PARTITION_BY_COUNTS: {
-        OCL_CHECK(static_cast<cl_uint>(properties[1]) >
-                      in_device->partition_max_sub_devices,
-                  return CL_INVALID_DEVICE_PARTITION_COUNT);
-        cl_uint idx = 0, device_count = 0, cu_count = 0;
-        while (properties[++idx] != CL_DEVICE_PARTITION_BY_COUNTS_LIST_END) {
-          if (properties[idx] != 0) {
-            device_count++;
-            cu_count += static_cast<cl_uint>(properties[idx]);
-          }
+  if (out_devices) {
+    const cargo::array_view<const cl_device_partition_property> partition_type(
+        properties, properties + 3);
+    for (cl_uint index = 0; index < num_sub_devices; index++) {
+      out_devices[index] = new (std::nothrow)
+          _cl_device_id(in_device, index + 1, compute_units, partition_type);
+      if (!out_devices[index]) {
+        for (cl_uint created = 0; created < index; created++) {
+          (void)cl::releaseExternal(out_devices[created]);
         }
-        OCL_CHECK(device_count > in_device->max_compute_units,
-                  return CL_INVALID_DEVICE_PARTITION_COUNT);
-        OCL_CHECK(cu_count > in_device->partition_max_sub_devices,
-                  return CL_INVALID_DEVICE_PARTITION_COUNT);
-
-        return CL_INVALID_VALUE;  // Sub devices not supported
+        return CL_OUT_OF_HOST_MEMORY;
       }
-      case CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN:
-        return CL_INVALID_VALUE;  // Sub devices not supported
-      default:
-        return CL_INVALID_VALUE;
     }
   }
 
-  OCL_SET_IF_NOT_NULL(num_devices_ret, in_device->partition_max_sub_devices);
+  OCL_SET_IF_NOT_NULL(num_devices_ret, num_sub_devices);
 
   return CL_SUCCESS;
 }
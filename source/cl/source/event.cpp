@@ -24,39 +24,74 @@
 #include <tracer/tracer.h>
 #include <utils/system.h>
 
+#include <new>
+
+namespace cl {
+void *event_storage::alloc() {
+  const std::lock_guard<std::mutex> lock(mutex);
+  if (free_slots.empty()) {
+    std::unique_ptr<slot_t[]> slab(new (std::nothrow) slot_t[slab_size]);
+    if (!slab) {
+      return nullptr;
+    }
+    // Reserve room for every slot up front so that returning one to the free
+    // list can't fail.
+    if (free_slots.reserve((slabs.size() + 1) * slab_size) ||
+        slabs.push_back(std::move(slab))) {
+      return nullptr;
+    }
+    for (size_t index = 0; index < slab_size; index++) {
+      (void)free_slots.push_back(&slabs.back()[index]);
+    }
+  }
+  void *storage = free_slots.back();
+  free_slots.pop_back();
+  return storage;
+}
+
+void event_storage::free(void *storage) {
+  const std::lock_guard<std::mutex> lock(mutex);
+  (void)free_slots.push_back(storage);
+}
+}  // namespace cl
+
 cargo::expected<cl_event, cl_int> _cl_event::create(
     cl_command_queue queue, const cl_command_type type) {
   OCL_ASSERT(queue != nullptr, "queue must not be null");
-  std::unique_ptr<_cl_event> event(new _cl_event(queue->context, queue, type));
-  if (!event) {
+  void *storage = queue->context->events.alloc();
+  if (!storage) {
     return cargo::make_unexpected(CL_OUT_OF_HOST_MEMORY);
   }
+  cl_event event = new (storage) _cl_event(queue->context, queue, type);
   if (queue->properties & CL_QUEUE_PROFILING_ENABLE) {
     event->profiling.enabled = true;
-    // The lifetime of mux queues is not controllable so this is safe
-    event->profiling.mux_queue = queue->mux_queue;
-    event->profiling.mux_allocator = queue->device->mux_allocator;
     event->profiling.queued = utils::timestampNanoSeconds();
-    if (auto mux_error = muxCreateQueryPool(
-            queue->mux_queue, mux_query_type_duration, 1, nullptr,
-            queue->device->mux_allocator, &event->profiling.duration_queries)) {
-      OCL_ASSERT(mux_error != mux_error_invalid_value &&
-                     mux_error != mux_error_null_out_parameter,
-                 "internal error calling muxCreateQueryPool");
-      OCL_UNUSED(mux_error);
-      return cargo::make_unexpected(CL_OUT_OF_RESOURCES);
+    auto duration_query = queue->acquireDurationQuery();
+    if (!duration_query) {
+      destroy(event);
+      return cargo::make_unexpected(duration_query.error());
     }
+    event->profiling.duration_queries = duration_query->pool;
+    event->profiling.duration_index = duration_query->index;
   }
-  return event.release();
+  return event;
 }
 
 cargo::expected<cl_event, cl_int> _cl_event::create(cl_context context) {
-  std::unique_ptr<_cl_event> event(
-      new _cl_event(context, nullptr, CL_COMMAND_USER));
-  if (!event) {
+  void *storage = context->events.alloc();
+  if (!storage) {
     return cargo::make_unexpected(CL_OUT_OF_HOST_MEMORY);
   }
-  return event.release();
+  return new (storage) _cl_event(context, nullptr, CL_COMMAND_USER);
+}
+
+void _cl_event::destroy(cl_event event) {
+  // The destructor leaves the context reference to us, the context must
+  // outlive the storage being returned to it.
+  cl_context context = event->context;
+  event->~_cl_event();
+  context->events.free(event);
+  cl::releaseInternal(context);
 }
 
 _cl_event::_cl_event(cl_context context, cl_command_queue queue,
@@ -74,14 +109,13 @@ _cl_event::_cl_event(cl_context context, cl_command_queue queue,
 
 _cl_event::~_cl_event() {
   clear();
-  if (profiling.mux_queue && profiling.duration_queries) {
-    muxDestroyQueryPool(profiling.mux_queue, profiling.duration_queries,
-                        profiling.mux_allocator);
+  if (profiling.duration_queries) {
+    queue->releaseDurationQuery(
+        {profiling.duration_queries, profiling.duration_index});
   }
   if (queue) {
     cl::releaseInternal(queue);
   }
-  cl::releaseInternal(context);
 }
 
 bool _cl_event::addCallback(const cl_int type,
@@ -437,7 +471,8 @@ CL_API_ENTRY cl_int CL_API_CALL cl::GetEventProfilingInfo(
     case CL_PROFILING_COMMAND_START: {
       mux_query_duration_result_s duration;
       if (auto mux_error = muxGetQueryPoolResults(
-              event->queue->mux_queue, event->profiling.duration_queries, 0, 1,
+              event->queue->mux_queue, event->profiling.duration_queries,
+              event->profiling.duration_index, 1,
               sizeof(mux_query_duration_result_s), &duration,
               sizeof(mux_query_duration_result_s))) {
         return cl::getErrorFrom(mux_error);
@@ -454,7 +489,8 @@ CL_API_ENTRY cl_int CL_API_CALL cl::GetEventProfilingInfo(
     case CL_PROFILING_COMMAND_END: {
       mux_query_duration_result_s duration;
       if (auto mux_error = muxGetQueryPoolResults(
-              event->queue->mux_queue, event->profiling.duration_queries, 0, 1,
+              event->queue->mux_queue, event->profiling.duration_queries,
+              event->profiling.duration_index, 1,
               sizeof(mux_query_duration_result_s), &duration,
               sizeof(mux_query_duration_result_s))) {
         return cl::getErrorFrom(mux_error);
@@ -37,6 +37,51 @@ typedef CL_API_ENTRY cl_int(CL_API_CALL *clSetKernelExecInfoCODEPLAY_fn)(
     size_t param_value_size,
     const void *param_value) CL_API_SUFFIX__VERSION_1_2;
 
+/*********************************
+ * cl_codeplay_indirect_dispatch *
+ *********************************/
+
+/// @brief Enqueue a kernel whose number of work-groups in each dimension is
+/// read from a buffer when the kernel executes.
+///
+/// @param[in] command_queue Command queue to enqueue the kernel on.
+/// @param[in] kernel Kernel to enqueue.
+/// @param[in] work_dim Number of dimensions of the ND range.
+/// @param[in] global_work_offset Global offset of the ND range, may be null.
+/// @param[in] group_count_buffer Buffer holding `work_dim` `cl_uint`
+/// work-group counts, the global size of each dimension is its count
+/// multiplied by its local size.
+/// @param[in] group_count_offset Offset in bytes of the work-group counts in
+/// `group_count_buffer`, must be a multiple of 4.
+/// @param[in] local_work_size Work-group size of the ND range, must not be
+/// null.
+/// @param[in] num_events_in_wait_list Number of events in `event_wait_list`.
+/// @param[in] event_wait_list Events to wait for before executing the kernel.
+/// @param[out] event Event identifying the kernel execution, may be null.
+///
+/// @return Returns the same error codes as `clEnqueueNDRangeKernel`, and:
+/// * CL_INVALID_OPERATION if the device does not support the extension or if
+/// `kernel` calls `printf`.
+/// * CL_INVALID_MEM_OBJECT if `group_count_buffer` is not a valid buffer.
+/// * CL_INVALID_VALUE if `group_count_offset` is not a multiple of 4, or the
+/// work-group counts do not fit in `group_count_buffer`.
+/// * CL_INVALID_WORK_GROUP_SIZE if `local_work_size` is null and `kernel`
+/// has no required work-group size.
+extern CL_API_ENTRY cl_int CL_API_CALL clEnqueueNDRangeKernelIndirectCODEPLAY(
+    cl_command_queue command_queue, cl_kernel kernel, cl_uint work_dim,
+    const size_t *global_work_offset, cl_mem group_count_buffer,
+    size_t group_count_offset, const size_t *local_work_size,
+    cl_uint num_events_in_wait_list, const cl_event *event_wait_list,
+    cl_event *event);
+
+typedef CL_API_ENTRY cl_int(
+    CL_API_CALL *clEnqueueNDRangeKernelIndirectCODEPLAY_fn)(
+    cl_command_queue command_queue, cl_kernel kernel, cl_uint work_dim,
+    const size_t *global_work_offset, cl_mem group_count_buffer,
+    size_t group_count_offset, const size_t *local_work_size,
+    cl_uint num_events_in_wait_list, const cl_event *event_wait_list,
+    cl_event *event);
+
 /************************************
  * cl_codeplay_performance_counter   *
  ************************************/
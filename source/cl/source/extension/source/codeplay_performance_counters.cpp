@@ -120,7 +120,7 @@ extension::codeplay_performance_counters::ApplyPropertyToCommandQueue(
           reinterpret_cast<mux_query_counter_config_t *>(config->descs),
           command_queue->device->mux_allocator,
           &command_queue->counter_queries)) {
-    cl::getErrorFrom(mux_error);
+    return cl::getErrorFrom(mux_error);
   }
 
   return CL_SUCCESS;
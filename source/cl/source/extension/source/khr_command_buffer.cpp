@@ -818,7 +818,7 @@ cl_int _cl_command_buffer_khr::commandNDRangeKernel(
     return CL_OUT_OF_HOST_MEMORY;
   }
 
-  std::unique_ptr<mux_descriptor_info_t[]> descriptor_info_storage;
+  _cl_kernel::descriptor_storage_t descriptor_info_storage;
   cl_device_id device = command_queue->device;
 
   // create the printf buffer argument if necessary
@@ -838,11 +838,21 @@ cl_int _cl_command_buffer_khr::commandNDRangeKernel(
   }
 
   const cl_uint device_index = kernel->program->context->getDeviceIndex(device);
-  const mux_ndrange_options_t mux_execution_options =
-      kernel->createKernelExecutionOptions(
-          device, device_index, work_dim, final_local_work_size,
-          final_global_offset, final_global_size, printf_buffer,
-          descriptor_info_storage);
+  const auto execution_options = kernel->createKernelExecutionOptions(
+      device, device_index, work_dim, final_local_work_size,
+      final_global_offset, final_global_size, printf_buffer,
+      descriptor_info_storage);
+  if (!execution_options) {
+    if (printf_buffer) {
+      muxDestroyBuffer(device->mux_device, printf_buffer,
+                       device->mux_allocator);
+    }
+    if (printf_memory) {
+      muxFreeMemory(device->mux_device, printf_memory, device->mux_allocator);
+    }
+    return execution_options.error();
+  }
+  const mux_ndrange_options_t &mux_execution_options = *execution_options;
 
   mux_result_t mux_error;
   mux_kernel_t mux_kernel;
@@ -50,7 +50,8 @@ CL_API_ENTRY cl_command_queue CL_API_CALL clCreateCommandQueueWithPropertiesKHR(
   mux_queue_t mux_queue;
   const mux_result_t error =
       muxGetQueue(context->devices[device_index]->mux_device,
-                  mux_queue_type_compute, 0, &mux_queue);
+                  mux_queue_type_compute,
+                  context->devices[device_index]->mux_queue_index, &mux_queue);
   OCL_CHECK(error, OCL_SET_IF_NOT_NULL(errcode_ret, CL_OUT_OF_HOST_MEMORY);
             return nullptr);
 
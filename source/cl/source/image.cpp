@@ -227,7 +227,7 @@ CL_API_ENTRY cl_mem CL_API_CALL cl::CreateImage(
       cl_mem_buffer buffer = static_cast<cl_mem_buffer>(image_desc->buffer);
       image->mux_memories[index] = buffer->mux_memories[index];
       // TODO: Can you actually create an image 1D buffer from a sub-buffer?
-      offset = buffer->offset;
+      offset = buffer->host_ptr_offset + buffer->offset;
     } else {
       const cl_int error = image->allocateMemory(
           device->mux_device, mux_image->memory_requirements.supported_heaps,
@@ -39,19 +39,20 @@
 #include <memory>
 #include <mutex>
 
-mux_ndrange_options_t _cl_kernel::createKernelExecutionOptions(
+cargo::expected<mux_ndrange_options_t, cl_int>
+_cl_kernel::createKernelExecutionOptions(
     cl_device_id device, cl_uint device_index, size_t work_dim,
     const std::array<size_t, cl::max::WORK_ITEM_DIM> &local_size,
     const std::array<size_t, cl::max::WORK_ITEM_DIM> &global_offset,
     const std::array<size_t, cl::max::WORK_ITEM_DIM> &global_size,
-    mux_buffer_t printf_buffer,
-    std::unique_ptr<mux_descriptor_info_t[]> &descriptors) {
+    mux_buffer_t printf_buffer, descriptor_storage_t &descriptors) {
   (void)device;
 
   const size_t num_arguments = info->getNumArguments();
   const bool printf = nullptr != printf_buffer;
-  descriptors = std::unique_ptr<mux_descriptor_info_t[]>(
-      new mux_descriptor_info_t[printf ? num_arguments + 1 : num_arguments]);
+  if (descriptors.resize(printf ? num_arguments + 1 : num_arguments)) {
+    return cargo::make_unexpected(CL_OUT_OF_HOST_MEMORY);
+  }
 
   for (size_t i = 0; i < num_arguments; i++) {
     const _cl_kernel::argument &arg = saved_args[i];
@@ -162,7 +163,7 @@ mux_ndrange_options_t _cl_kernel::createKernelExecutionOptions(
 
   mux_ndrange_options_t execution_options;
   execution_options.descriptors =
-      ((num_arguments == 0) && !printf) ? nullptr : descriptors.get();
+      ((num_arguments == 0) && !printf) ? nullptr : descriptors.data();
   execution_options.descriptors_length =
       printf ? num_arguments + 1 : num_arguments;
   execution_options.local_size[0] = local_size[0];
@@ -231,6 +232,10 @@ namespace {
 /// @param num_events_in_wait_list Number of events in `event_wait_list`.
 /// @param event_wait_list List of evetns to wait on.
 /// @param return_event Kernel execution event.
+/// @param group_count_buffer Buffer to read the work-group counts from when the
+/// kernel executes, or null to execute `global_work_size` work items.
+/// @param group_count_offset Offset in bytes of the work-group counts in
+/// `group_count_buffer`.
 ///
 /// @return Returns appropriate OpenCL error code.
 cl_int PushExecuteKernel(
@@ -239,7 +244,10 @@ cl_int PushExecuteKernel(
     const std::array<size_t, cl::max::WORK_ITEM_DIM> &global_work_size,
     const std::array<size_t, cl::max::WORK_ITEM_DIM> &local_work_size,
     const cl_uint num_events_in_wait_list,
-    const cl_event *const event_wait_list, cl_event return_event) {
+    const cl_event *const event_wait_list, cl_event return_event,
+    cl_mem group_count_buffer = nullptr, size_t group_count_offset = 0) {
+  // Link the kernel's execution on the device back to its enqueue.
+  const tracer::FlowGuard<tracer::OpenCL> flow;
   const std::lock_guard<std::mutex> lock(
       command_queue->context->getCommandQueueMutex());
   auto mux_command_buffer = command_queue->getCommandBuffer(
@@ -290,13 +298,22 @@ cl_int PushExecuteKernel(
     }
   }
 
-  std::unique_ptr<mux_descriptor_info_t[]> descriptor_info_storage;
+  _cl_kernel::descriptor_storage_t descriptor_info_storage;
   const cl_uint device_index = kernel->program->context->getDeviceIndex(device);
-  const mux_ndrange_options_t mux_execution_options =
-      kernel->createKernelExecutionOptions(
-          command_queue->device, device_index, work_dim, local_work_size,
-          global_work_offset, global_work_size, printf_buffer,
-          descriptor_info_storage);
+  const auto execution_options = kernel->createKernelExecutionOptions(
+      command_queue->device, device_index, work_dim, local_work_size,
+      global_work_offset, global_work_size, printf_buffer,
+      descriptor_info_storage);
+  if (!execution_options) {
+    if (printf_buffer) {
+      muxDestroyBuffer(mux_device, printf_buffer, mux_allocator);
+    }
+    if (printf_memory) {
+      muxFreeMemory(mux_device, printf_memory, mux_allocator);
+    }
+    return execution_options.error();
+  }
+  const mux_ndrange_options_t &mux_execution_options = *execution_options;
 
   mux_kernel_t mux_specialized_kernel = nullptr;
   mux_executable_t mux_specialized_executable = nullptr;
@@ -323,9 +340,17 @@ cl_int PushExecuteKernel(
         kernel->device_kernel_map[device]->getPrecompiledKernel();
   }
 
-  mux_result_t mux_error =
-      muxCommandNDRange(*mux_command_buffer, kernel_to_execute,
-                        mux_execution_options, 0, nullptr, nullptr);
+  mux_result_t mux_error = mux_success;
+  if (group_count_buffer) {
+    mux_error = muxCommandNDRangeIndirect(
+        *mux_command_buffer, kernel_to_execute, mux_execution_options,
+        static_cast<cl_mem_buffer>(group_count_buffer)
+            ->mux_buffers[device_index],
+        group_count_offset, 0, nullptr, nullptr);
+  } else {
+    mux_error = muxCommandNDRange(*mux_command_buffer, kernel_to_execute,
+                                  mux_execution_options, 0, nullptr, nullptr);
+  }
   if (mux_success != mux_error) {
     auto error = cl::getErrorFrom(mux_error);
     if (nullptr != return_event) {
@@ -367,6 +392,9 @@ cl_int PushExecuteKernel(
   if (auto error = kernel->retainMems(command_queue, retain)) {
     return error;
   }
+  if (group_count_buffer) {
+    retain(group_count_buffer);
+  }
 
   // don't release the kernel until it has been executed
   kernel_release_guard.dismiss();
@@ -1621,6 +1649,117 @@ CL_API_ENTRY cl_int CL_API_CALL cl::EnqueueNDRangeKernel(
   return CL_SUCCESS;
 }
 
+cl_int cl::EnqueueNDRangeKernelIndirect(
+    cl_command_queue command_queue, cl_kernel kernel, cl_uint work_dim,
+    const size_t *global_work_offset, cl_mem group_count_buffer,
+    size_t group_count_offset, const size_t *local_work_size,
+    cl_uint num_events_in_wait_list, const cl_event *event_wait_list,
+    cl_event *event) {
+  const tracer::TraceGuard<tracer::OpenCL> guard(
+      "clEnqueueNDRangeKernelIndirectCODEPLAY");
+  OCL_CHECK(!command_queue, return CL_INVALID_COMMAND_QUEUE);
+  OCL_CHECK(!kernel, return CL_INVALID_KERNEL);
+  OCL_CHECK(!(kernel->program), return CL_INVALID_PROGRAM_EXECUTABLE);
+  OCL_CHECK(!(command_queue->context), return CL_INVALID_CONTEXT);
+  OCL_CHECK(command_queue->context != kernel->program->context,
+            return CL_INVALID_CONTEXT);
+  OCL_CHECK(
+      !command_queue->device->mux_device->info->supports_indirect_ndrange,
+      return CL_INVALID_OPERATION);
+  OCL_CHECK((0 == work_dim) || (cl::max::WORK_ITEM_DIM < work_dim) ||
+                (command_queue->device->max_work_item_dimensions < work_dim),
+            return CL_INVALID_WORK_DIMENSION);
+
+  // The work-group counts are read from the buffer as `cl_uint`s.
+  OCL_CHECK(!group_count_buffer, return CL_INVALID_MEM_OBJECT);
+  OCL_CHECK(CL_MEM_OBJECT_BUFFER != group_count_buffer->type,
+            return CL_INVALID_MEM_OBJECT);
+  OCL_CHECK(command_queue->context != group_count_buffer->context,
+            return CL_INVALID_CONTEXT);
+  OCL_CHECK(0 != group_count_offset % sizeof(cl_uint),
+            return CL_INVALID_VALUE);
+  OCL_CHECK(group_count_buffer->size < group_count_offset ||
+                group_count_buffer->size - group_count_offset <
+                    work_dim * sizeof(cl_uint),
+            return CL_INVALID_VALUE);
+
+  // Without a global size there is no default local size to pick.
+  if (auto error = kernel->checkReqdWorkGroupSize(work_dim, local_work_size)) {
+    return error;
+  }
+  OCL_CHECK(!local_work_size, return CL_INVALID_WORK_GROUP_SIZE);
+  if (auto error =
+          kernel->checkWorkSizes(command_queue->device, work_dim,
+                                 global_work_offset, nullptr, local_work_size)) {
+    return error;
+  }
+
+  // The printf buffer is sized by the number of work-groups, which isn't known
+  // until the kernel executes.
+  OCL_CHECK(!kernel->program->programs[command_queue->device]
+                 .printf_calls.empty(),
+            return CL_INVALID_OPERATION);
+
+  std::array<size_t, cl::max::WORK_ITEM_DIM> final_local_work_size{1, 1, 1};
+  std::copy_n(local_work_size, work_dim, std::begin(final_local_work_size));
+
+  std::array<size_t, cl::max::WORK_ITEM_DIM> final_global_offset{0, 0, 0};
+  if (global_work_offset) {
+    std::copy_n(global_work_offset, work_dim, std::begin(final_global_offset));
+  }
+
+  if (auto error = kernel->checkKernelArgs()) {
+    return error;
+  }
+
+  if (auto error =
+          cl::validate::EventWaitList(num_events_in_wait_list, event_wait_list,
+                                      command_queue->context, event)) {
+    return error;
+  }
+
+  cl_event return_event = nullptr;
+  cl_int error = 0;
+#ifdef OCL_EXTENSION_cl_intel_unified_shared_memory
+  // See cl::EnqueueNDRangeKernel.
+  const std::lock_guard<std::mutex> context_guard(
+      command_queue->context->usm_mutex);
+  error = extension::usm::createBlockingEventForKernel(
+      command_queue, kernel, CL_COMMAND_NDRANGE_KERNEL, return_event);
+  OCL_CHECK(error != CL_SUCCESS, return error);
+  cl::retainInternal(return_event);
+  if (nullptr != event) {
+    *event = return_event;
+  } else {
+    cl::releaseExternal(return_event);
+  }
+#else
+  if (nullptr != event) {
+    auto new_event =
+        _cl_event::create(command_queue, CL_COMMAND_NDRANGE_KERNEL);
+    if (!new_event) {
+      return new_event.error();
+    }
+    return_event = *new_event;
+    *event = return_event;
+  }
+#endif
+
+  // The kernel is specialized for a single work-group, its global size is
+  // read from `group_count_buffer` when it executes.
+  // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDelete)
+  error = PushExecuteKernel(command_queue, kernel, work_dim, final_global_offset,
+                            final_local_work_size, final_local_work_size,
+                            num_events_in_wait_list, event_wait_list,
+                            return_event, group_count_buffer,
+                            group_count_offset);
+  if (error) {
+    return error;
+  }
+
+  return CL_SUCCESS;
+}
+
 CL_API_ENTRY cl_int CL_API_CALL cl::EnqueueTask(cl_command_queue command_queue,
                                                 cl_kernel kernel,
                                                 cl_uint num_events_in_wait_list,
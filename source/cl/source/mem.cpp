@@ -37,6 +37,7 @@ _cl_mem::_cl_mem(const cl_context context, const cl_mem_flags flags,
       type(type),
       optional_parent(optional_parent),
       host_ptr(host_ptr),
+      host_ptr_offset(0),
       mux_memories(std::move(mux_memories)),
       callbacks(),
       callback_datas(),
@@ -101,10 +102,22 @@ cl_int _cl_mem::allocateMemory(mux_device_t mux_device,
   if ((CL_MEM_USE_HOST_PTR & flags) &&
       (device_alloc_caps & mux_allocation_capabilities_coherent_host)) {
     const uintptr_t host_ptr_uint = reinterpret_cast<uintptr_t>(host_ptr);
-    if (0 == (host_ptr_uint % mux_device->info->buffer_alignment)) {
+    const size_t misalignment =
+        host_ptr_uint % mux_device->info->buffer_alignment;
+    // Buffers can still use an unaligned pointer in place, by creating the
+    // memory from the aligned address below it and binding at the offset of
+    // the pointer within. Memory is only synchronized between the devices of
+    // a context from offset zero, so this is limited to single device
+    // contexts.
+    if (0 == misalignment ||
+        (CL_MEM_OBJECT_BUFFER == type && 1 == context->devices.size())) {
       const mux_result_t error = muxCreateMemoryFromHost(
-          mux_device, size, host_ptr, mux_allocator, out_memory);
-      return error ? CL_MEM_OBJECT_ALLOCATION_FAILURE : CL_SUCCESS;
+          mux_device, size + misalignment,
+          reinterpret_cast<void *>(host_ptr_uint - misalignment),
+          mux_allocator, out_memory);
+      OCL_CHECK(error, return CL_MEM_OBJECT_ALLOCATION_FAILURE);
+      host_ptr_offset = misalignment;
+      return CL_SUCCESS;
     }
   }
 
@@ -252,17 +265,22 @@ cl_int _cl_mem::pushMapMemory(cl_command_queue command_queue,
     void flushMemoryFromDevice() {
       mux_device_t device = mem->context->devices[device_index]->mux_device;
       mux_memory_t memory = mem->mux_memories[device_index];
-      const mux_result_t error =
-          muxFlushMappedMemoryFromDevice(device, memory, offset, size);
+      const mux_result_t error = muxFlushMappedMemoryFromDevice(
+          device, memory, mem->host_ptr_offset + offset, size);
       OCL_ASSERT(mux_success == error,
                  "muxFlushMappedMemoryFromDevice failed!");
       OCL_UNUSED(error);
 
       if (CL_MEM_USE_HOST_PTR & mem->flags) {
         // Copy data from `map_base_pointer` containing our cache of the data.
-        // to `host_ptr` user has access to.
-        std::memcpy(static_cast<char *>(mem->host_ptr) + offset,
-                    static_cast<char *>(mem->map_base_pointer) + offset, size);
+        // to `host_ptr` user has access to, unless the memory was created in
+        // place from `host_ptr` and they are one and the same.
+        char *cache = static_cast<char *>(mem->map_base_pointer) +
+                      mem->host_ptr_offset + offset;
+        char *user = static_cast<char *>(mem->host_ptr) + offset;
+        if (cache != user) {
+          std::memcpy(user, cache, size);
+        }
       }
     }
 
@@ -554,15 +572,20 @@ cl::EnqueueUnmapMemObject(cl_command_queue command_queue, cl_mem memobj,
 
             if (CL_MEM_USE_HOST_PTR & mem->flags) {
               // Copy data from `host_ptr` user has accessed/modified to our
-              // cache of the data in `map_base_pointer`.
-              std::memcpy(
-                  static_cast<char *>(mem->map_base_pointer) + map.offset,
-                  static_cast<char *>(mem->host_ptr) + map.offset, map.size);
+              // cache of the data in `map_base_pointer`, unless the memory
+              // was created in place from `host_ptr`.
+              char *cache = static_cast<char *>(mem->map_base_pointer) +
+                            mem->host_ptr_offset + map.offset;
+              char *user = static_cast<char *>(mem->host_ptr) + map.offset;
+              if (cache != user) {
+                std::memcpy(cache, user, map.size);
+              }
             }
 
             // flush the memory region back to the device if required
             auto mux_error = muxFlushMappedMemoryToDevice(
-                mux_device, mux_memory, map.offset, map.size);
+                mux_device, mux_memory, mem->host_ptr_offset + map.offset,
+                map.size);
             OCL_ASSERT(!mux_error, "muxFlushMappedMemoryToDevice failed!");
             OCL_UNUSED(mux_error);
 
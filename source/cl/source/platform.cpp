@@ -17,6 +17,7 @@
 #include <cargo/allocator.h>
 #include <cargo/small_vector.h>
 #include <cargo/string_view.h>
+#include <cl/binary/binary.h>
 #include <cl/config.h>
 #include <cl/device.h>
 #include <cl/macros.h>
@@ -155,6 +156,73 @@ cargo::optional<std::string> _cl_platform_id::getCompilerLibraryLoaderError() {
   return cargo::nullopt;
 }
 
+compiler::Target *_cl_platform_id::compiler_cache_s::getTarget(
+    const cl_device_id device) {
+  if (!device->compiler_available) {
+    return nullptr;
+  }
+
+  const uint32_t builtins_capabilities =
+      cl::binary::detectBuiltinCapabilities(device->mux_device->info);
+  const auto key = std::make_pair(device->compiler_info, builtins_capabilities);
+
+  const std::lock_guard<std::mutex> guard{targets_mutex};
+
+  auto it = targets.find(key);
+  if (it != targets.end()) {
+    return it->second.get();
+  }
+
+  // Cached targets have no notify callback, contexts with one create their
+  // own targets so that diagnostics reach the right callback.
+  std::unique_ptr<compiler::Target> target =
+      device->compiler_info->createTarget(context.get(),
+                                          compiler::NotifyCallbackFn{});
+  if (!target ||
+      target->init(builtins_capabilities) != compiler::Result::SUCCESS) {
+    return nullptr;
+  }
+
+  return targets.emplace(key, std::move(target)).first->second.get();
+}
+
+std::unique_ptr<_cl_platform_id::compiler_cache_s>
+_cl_platform_id::acquireCompilerCache() {
+#ifdef CA_RUNTIME_COMPILER_ENABLED
+  {
+    const std::lock_guard<std::mutex> guard{compiler_caches_mutex};
+    if (!idle_compiler_caches.empty()) {
+      auto cache = std::move(idle_compiler_caches.back());
+      idle_compiler_caches.pop_back();
+      cache->uses++;
+      return cache;
+    }
+  }
+
+  auto cache = std::make_unique<compiler_cache_s>();
+  cache->context = compiler::createContext(getCompilerLibrary());
+  if (!cache->context) {
+    return nullptr;
+  }
+  cache->uses = 1;
+  return cache;
+#else
+  return nullptr;
+#endif
+}
+
+void _cl_platform_id::releaseCompilerCache(
+    std::unique_ptr<compiler_cache_s> cache) {
+  if (!cache || cache->uses >= max_compiler_cache_uses) {
+    return;
+  }
+  const std::lock_guard<std::mutex> guard{compiler_caches_mutex};
+  if (idle_compiler_caches.size() < max_idle_compiler_caches) {
+    idle_compiler_caches.push_back(std::move(cache));
+  }
+  // Otherwise the cache is destroyed on return, after the lock is released.
+}
+
 CL_API_ENTRY cl_int CL_API_CALL
 cl::GetPlatformIDs(const cl_uint num_entries, cl_platform_id *platforms,
                    cl_uint *const num_platforms) {
@@ -0,0 +1,135 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <BenchCL/environment.h>
+#include <BenchCL/error.h>
+#include <CL/cl.h>
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace {
+// Tree reduction in local memory, each work-item keeps several values live
+// across every barrier of the reduction loop.
+const char *LocalReductionSource = R"(
+kernel void reduce(global const float *in, global float *out,
+                   local float *scratch) {
+  const size_t lid = get_local_id(0);
+  const size_t lsize = get_local_size(0);
+  const float x = in[get_global_id(0)];
+  const float scale = x * 0.5f + 1.0f;
+  scratch[lid] = x;
+  for (size_t stride = lsize / 2; stride > 0; stride /= 2) {
+    barrier(CLK_LOCAL_MEM_FENCE);
+    if (lid < stride) {
+      scratch[lid] += scratch[lid + stride] * scale;
+    }
+  }
+  barrier(CLK_LOCAL_MEM_FENCE);
+  out[get_global_id(0)] = scratch[0] + x * scale;
+}
+)";
+
+struct LocalReductionData {
+  cl_context context;
+  cl_command_queue queue;
+  cl_program program;
+  cl_kernel kernel;
+  cl_mem in;
+  cl_mem out;
+  size_t max_work_group_size;
+
+  LocalReductionData(size_t global_size, size_t local_size) {
+    cl_device_id device = benchcl::env::get()->device;
+
+    cl_int status = CL_SUCCESS;
+    context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+    queue = clCreateCommandQueue(context, device, 0, &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+    program = clCreateProgramWithSource(context, 1, &LocalReductionSource,
+                                        nullptr, &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clBuildProgram(program, 0, nullptr, nullptr,
+                                                 nullptr, nullptr));
+
+    kernel = clCreateKernel(program, "reduce", &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+    ASSERT_EQ_ERRCODE(CL_SUCCESS,
+                      clGetKernelWorkGroupInfo(
+                          kernel, device, CL_KERNEL_WORK_GROUP_SIZE,
+                          sizeof(max_work_group_size), &max_work_group_size,
+                          nullptr));
+
+    std::vector<cl_float> values(global_size);
+    for (size_t i = 0; i < values.size(); i++) {
+      values[i] = static_cast<cl_float>(i % 17);
+    }
+
+    in = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                        global_size * sizeof(cl_float), values.data(),
+                        &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+    out = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                         global_size * sizeof(cl_float), nullptr, &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+    ASSERT_EQ_ERRCODE(CL_SUCCESS,
+                      clSetKernelArg(kernel, 0, sizeof(cl_mem), &in));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS,
+                      clSetKernelArg(kernel, 1, sizeof(cl_mem), &out));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS,
+                      clSetKernelArg(kernel, 2, local_size * sizeof(cl_float),
+                                     nullptr));
+  }
+
+  ~LocalReductionData() {
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseMemObject(out));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseMemObject(in));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseKernel(kernel));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseProgram(program));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseCommandQueue(queue));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseContext(context));
+  }
+};
+}  // namespace
+
+// Barrier-heavy work-groups, whose live variables are saved and restored for
+// every work-item at each barrier.
+void BarrierLocalReduction(benchmark::State &state) {
+  const size_t local_size = static_cast<size_t>(state.range(0));
+  const size_t global_size = local_size * 256;
+  const LocalReductionData data(global_size, local_size);
+
+  if (local_size > data.max_work_group_size) {
+    state.SkipWithError("Work-group size is not supported by the kernel");
+    return;
+  }
+
+  for (auto _ : state) {
+    (void)_;
+    clEnqueueNDRangeKernel(data.queue, data.kernel, 1, nullptr, &global_size,
+                           &local_size, 0, nullptr, nullptr);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clFinish(data.queue));
+  }
+
+  state.SetItemsProcessed(state.iterations() * global_size);
+}
+BENCHMARK(BarrierLocalReduction)->Arg(64)->Arg(256)->Arg(1024);
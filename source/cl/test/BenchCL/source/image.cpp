@@ -0,0 +1,143 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <BenchCL/environment.h>
+#include <BenchCL/error.h>
+#include <CL/cl.h>
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace {
+// 3x3 box filter of bilinearly filtered samples, each work-item reads pixels
+// from three neighbouring rows of the image.
+const char *ImageStencilSource = R"(
+const sampler_t sampler =
+    CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_CLAMP_TO_EDGE | CLK_FILTER_LINEAR;
+
+kernel void stencil(read_only image2d_t in, global float4 *out) {
+  const int x = get_global_id(0);
+  const int y = get_global_id(1);
+  float4 sum = (float4)(0.0f);
+  for (int dy = -1; dy <= 1; dy++) {
+    for (int dx = -1; dx <= 1; dx++) {
+      sum += read_imagef(in, sampler, (float2)(x + dx + 0.25f, y + dy + 0.75f));
+    }
+  }
+  out[y * get_global_size(0) + x] = sum / 9.0f;
+}
+)";
+
+struct ImageStencilData {
+  cl_context context;
+  cl_command_queue queue;
+  cl_program program;
+  cl_kernel kernel;
+  cl_mem image;
+  cl_mem out;
+
+  ImageStencilData(size_t size, cl_mem_flags image_flags) {
+    cl_device_id device = benchcl::env::get()->device;
+
+    cl_int status = CL_SUCCESS;
+    context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+    queue = clCreateCommandQueue(context, device, 0, &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+    program = clCreateProgramWithSource(context, 1, &ImageStencilSource,
+                                        nullptr, &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clBuildProgram(program, 0, nullptr, nullptr,
+                                                 nullptr, nullptr));
+
+    kernel = clCreateKernel(program, "stencil", &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+    std::vector<cl_uchar> pixels(size * size * 4);
+    for (size_t i = 0; i < pixels.size(); i++) {
+      pixels[i] = static_cast<cl_uchar>(i * 7);
+    }
+
+    const cl_image_format format = {CL_RGBA, CL_UNORM_INT8};
+    cl_image_desc desc = {};
+    desc.image_type = CL_MEM_OBJECT_IMAGE2D;
+    desc.image_width = size;
+    desc.image_height = size;
+    image = clCreateImage(context,
+                          CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR | image_flags,
+                          &format, &desc, pixels.data(), &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+    out = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                         size * size * sizeof(cl_float4), nullptr, &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+    ASSERT_EQ_ERRCODE(CL_SUCCESS,
+                      clSetKernelArg(kernel, 0, sizeof(cl_mem), &image));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS,
+                      clSetKernelArg(kernel, 1, sizeof(cl_mem), &out));
+  }
+
+  ~ImageStencilData() {
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseMemObject(out));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseMemObject(image));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseKernel(kernel));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseProgram(program));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseCommandQueue(queue));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseContext(context));
+  }
+};
+
+void ImageStencil(benchmark::State &state, cl_mem_flags image_flags) {
+  cl_bool image_support = CL_FALSE;
+  ASSERT_EQ_ERRCODE(
+      CL_SUCCESS, clGetDeviceInfo(benchcl::env::get()->device,
+                                  CL_DEVICE_IMAGE_SUPPORT,
+                                  sizeof(image_support), &image_support,
+                                  nullptr));
+  if (!image_support) {
+    state.SkipWithError("Device does not support images");
+    return;
+  }
+
+  const size_t size = static_cast<size_t>(state.range(0));
+  const ImageStencilData data(size, image_flags);
+
+  const size_t global_size[2] = {size, size};
+  for (auto _ : state) {
+    (void)_;
+    clEnqueueNDRangeKernel(data.queue, data.kernel, 2, nullptr, global_size,
+                           nullptr, 0, nullptr, nullptr);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clFinish(data.queue));
+  }
+
+  state.SetItemsProcessed(state.iterations() * size * size);
+}
+}  // namespace
+
+// Images in device memory, which the host device stores in tiles.
+void ImageStencilDeviceMemory(benchmark::State &state) {
+  ImageStencil(state, 0);
+}
+BENCHMARK(ImageStencilDeviceMemory)->Arg(256)->Arg(1024)->Arg(4096);
+
+// Images in host memory, which the host device stores linearly.
+void ImageStencilHostMemory(benchmark::State &state) {
+  ImageStencil(state, CL_MEM_ALLOC_HOST_PTR);
+}
+BENCHMARK(ImageStencilHostMemory)->Arg(256)->Arg(1024)->Arg(4096);
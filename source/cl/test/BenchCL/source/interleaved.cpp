@@ -0,0 +1,142 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <BenchCL/environment.h>
+#include <BenchCL/error.h>
+#include <CL/cl.h>
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace {
+// Work-items access channels of packed pixels, which once vectorized are
+// interleaved loads and stores with a stride of the number of channels.
+const char *InterleavedSource = R"(
+kernel void rgb_to_grey(global const float *rgb, global float *grey) {
+  const size_t gid = get_global_id(0);
+  grey[gid] = 0.299f * rgb[3 * gid] + 0.587f * rgb[3 * gid + 1] +
+              0.114f * rgb[3 * gid + 2];
+}
+
+kernel void grey_to_rgb(global const float *grey, global float *rgb) {
+  const size_t gid = get_global_id(0);
+  const float g = grey[gid];
+  rgb[3 * gid] = g;
+  rgb[3 * gid + 1] = g * 0.5f;
+  rgb[3 * gid + 2] = g * 0.25f;
+}
+
+kernel void rgba_to_grey(global const float *rgba, global float *grey) {
+  const size_t gid = get_global_id(0);
+  grey[gid] = 0.299f * rgba[4 * gid] + 0.587f * rgba[4 * gid + 1] +
+              0.114f * rgba[4 * gid + 2] + 0.0f * rgba[4 * gid + 3];
+}
+)";
+
+struct InterleavedData {
+  cl_context context;
+  cl_command_queue queue;
+  cl_program program;
+  cl_kernel kernel;
+  cl_mem packed;
+  cl_mem planar;
+
+  InterleavedData(const char *name, size_t pixels, size_t channels) {
+    cl_device_id device = benchcl::env::get()->device;
+
+    cl_int status = CL_SUCCESS;
+    context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+    queue = clCreateCommandQueue(context, device, 0, &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+    program = clCreateProgramWithSource(context, 1, &InterleavedSource,
+                                        nullptr, &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clBuildProgram(program, 0, nullptr, nullptr,
+                                                 nullptr, nullptr));
+
+    kernel = clCreateKernel(program, name, &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+    std::vector<cl_float> values(pixels * channels);
+    for (size_t i = 0; i < values.size(); i++) {
+      values[i] = static_cast<cl_float>(i % 255);
+    }
+
+    packed = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+                            values.size() * sizeof(cl_float), values.data(),
+                            &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+    planar = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+                            pixels * sizeof(cl_float), values.data(), &status);
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+  }
+
+  ~InterleavedData() {
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseMemObject(planar));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseMemObject(packed));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseKernel(kernel));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseProgram(program));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseCommandQueue(queue));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseContext(context));
+  }
+
+  void run(benchmark::State &state, size_t pixels, bool to_packed) {
+    cl_mem src = to_packed ? planar : packed;
+    cl_mem dst = to_packed ? packed : planar;
+    ASSERT_EQ_ERRCODE(CL_SUCCESS,
+                      clSetKernelArg(kernel, 0, sizeof(cl_mem), &src));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS,
+                      clSetKernelArg(kernel, 1, sizeof(cl_mem), &dst));
+
+    for (auto _ : state) {
+      (void)_;
+      clEnqueueNDRangeKernel(queue, kernel, 1, nullptr, &pixels, nullptr, 0,
+                             nullptr, nullptr);
+      ASSERT_EQ_ERRCODE(CL_SUCCESS, clFinish(queue));
+    }
+
+    state.SetItemsProcessed(state.iterations() * pixels);
+  }
+};
+}  // namespace
+
+// Three-way interleaved loads.
+void InterleavedRGBToGrey(benchmark::State &state) {
+  const size_t pixels = static_cast<size_t>(state.range(0));
+  InterleavedData data("rgb_to_grey", pixels, 3);
+  data.run(state, pixels, /* to_packed */ false);
+}
+BENCHMARK(InterleavedRGBToGrey)->Arg(1 << 16)->Arg(1 << 20);
+
+// Three-way interleaved stores.
+void InterleavedGreyToRGB(benchmark::State &state) {
+  const size_t pixels = static_cast<size_t>(state.range(0));
+  InterleavedData data("grey_to_rgb", pixels, 3);
+  data.run(state, pixels, /* to_packed */ true);
+}
+BENCHMARK(InterleavedGreyToRGB)->Arg(1 << 16)->Arg(1 << 20);
+
+// Four-way interleaved loads.
+void InterleavedRGBAToGrey(benchmark::State &state) {
+  const size_t pixels = static_cast<size_t>(state.range(0));
+  InterleavedData data("rgba_to_grey", pixels, 4);
+  data.run(state, pixels, /* to_packed */ false);
+}
+BENCHMARK(InterleavedRGBAToGrey)->Arg(1 << 16)->Arg(1 << 20);
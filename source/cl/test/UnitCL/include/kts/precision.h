@@ -495,6 +495,50 @@ auto makeULPStreamer(
       ValidatorType{device});
   return s;
 }
+
+/// @brief Validator checking results are within an absolute error.
+///
+/// Some builtins, such as the native variants and sin and cos under relaxed
+/// math, have precision requirements given as an absolute error rather than
+/// in ULP.
+template <typename T, cl_ulong t>
+struct AbsoluteErrValidator final {
+  AbsoluteErrValidator() : threshold(1.0 / static_cast<T>(t)) {}
+
+  // Validator checks for inf and nan, and then just checks the actual value is
+  // within an absolute error of the expected.
+  bool validate(const T &expected, const T &actual) {
+    if (std::isnan(expected) && std::isnan(actual)) {
+      return true;
+    }
+
+    if (std::isinf(expected) && std::isinf(actual)) {
+      return true;
+    }
+
+    const T err = std::fabs(expected - actual);
+    return err < threshold ? true : false;
+  }
+
+  void print(std::stringstream &s, T value) { s << value; }
+
+ private:
+  // Error threshold is 1 over tparam t (template params can't be float).
+  cl_float threshold;
+};
+
+template <typename T, cl_ulong threshold>
+using AbsoluteErrStreamerTy =
+    kts::GenericStreamer<T, AbsoluteErrValidator<T, threshold>>;
+
+template <typename T, cl_ulong threshold, typename F>
+std::shared_ptr<AbsoluteErrStreamerTy<T, threshold>> makeAbsoluteErrStreamer(
+    F &&f) {
+  auto s = std::make_shared<AbsoluteErrStreamerTy<T, threshold>>(
+      kts::Reference1D<T>(std::forward<F>(f)));
+
+  return s;
+}
 }  // namespace ucl
 }  // namespace kts
 
@@ -213,6 +213,16 @@ set(KERNEL_FILES
   ${CMAKE_CURRENT_SOURCE_DIR}/precision.91_double_convert_char_rtp.cl
   ${CMAKE_CURRENT_SOURCE_DIR}/precision.92_half_hypot_edgecases.cl
   ${CMAKE_CURRENT_SOURCE_DIR}/precision.93_divide_relaxed.cl
+  ${CMAKE_CURRENT_SOURCE_DIR}/precision.94_single_relaxed_exp.cl
+  ${CMAKE_CURRENT_SOURCE_DIR}/precision.94_single_relaxed_exp_wide.cl
+  ${CMAKE_CURRENT_SOURCE_DIR}/precision.95_single_relaxed_log.cl
+  ${CMAKE_CURRENT_SOURCE_DIR}/precision.95_single_relaxed_log_near_one.cl
+  ${CMAKE_CURRENT_SOURCE_DIR}/precision.95_single_relaxed_log_small.cl
+  ${CMAKE_CURRENT_SOURCE_DIR}/precision.96_single_relaxed_sincos.cl
+  ${CMAKE_CURRENT_SOURCE_DIR}/precision.97_single_relaxed_rsqrt.cl
+  ${CMAKE_CURRENT_SOURCE_DIR}/precision.98_single_relaxed_erf.cl
+  ${CMAKE_CURRENT_SOURCE_DIR}/precision.99_single_relaxed_pow.cl
+  ${CMAKE_CURRENT_SOURCE_DIR}/precision.99_single_relaxed_pow_edgecases.cl
   ${CMAKE_CURRENT_SOURCE_DIR}/printf.01_hello.cl
   ${CMAKE_CURRENT_SOURCE_DIR}/printf.02_order.cl
   ${CMAKE_CURRENT_SOURCE_DIR}/printf.03_string.cl
@@ -281,6 +281,51 @@ TEST_F(clBuildProgramGoodTest, ConcurrentBuild) {
   EXPECT_SUCCESS(error);
 }
 
+// Contexts reuse the compiler targets of destroyed contexts, so short-lived
+// contexts building in parallel must neither race on handing them over nor on
+// using them.
+TEST_F(clBuildProgramGoodTest, ConcurrentBuildSeparateContexts) {
+  if (!getDeviceCompilerAvailable()) {
+    GTEST_SKIP();
+  }
+
+  const char *src = "kernel void k(global int *a) { *a = 42; }";
+
+  std::atomic<cl_int> error{CL_SUCCESS};
+
+  auto worker = [this, &src, &error]() {
+    for (int round = 0; round < 2; round++) {
+      cl_int err = !CL_SUCCESS;
+      cl_context other_context =
+          clCreateContext(nullptr, 1, &device, nullptr, nullptr, &err);
+      CHECK_ERROR(err);
+      if (!other_context) {
+        return;
+      }
+      cl_program program =
+          clCreateProgramWithSource(other_context, 1, &src, nullptr, &err);
+      CHECK_ERROR(err);
+      CHECK_ERROR(
+          clBuildProgram(program, 0, nullptr, nullptr, nullptr, nullptr));
+      CHECK_ERROR(clReleaseProgram(program));
+      CHECK_ERROR(clReleaseContext(other_context));
+    }
+  };
+
+  const size_t threads = 4;
+  UCL::vector<std::thread> workers(threads);
+
+  for (size_t i = 0; i < threads; i++) {
+    workers[i] = std::thread(worker);
+  }
+
+  for (size_t i = 0; i < threads; i++) {
+    workers[i].join();
+  }
+
+  EXPECT_SUCCESS(error);
+}
+
 class clBuildProgramBadTest : public ucl::ContextTest {
  protected:
   void SetUp() override {
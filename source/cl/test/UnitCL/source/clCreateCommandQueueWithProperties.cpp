@@ -37,10 +37,15 @@ TEST_F(clCreateCommandQueueWithPropertiesTest, DefaultOutOfOrder) {
       {CL_QUEUE_PROPERTIES, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE, 0}};
   cl_command_queue command_queue = clCreateCommandQueueWithProperties(
       context, device, properties.data(), &error);
-#ifndef CA_ENABLE_OUT_OF_ORDER_EXEC_MODE
-  ASSERT_EQ(nullptr, command_queue);
-  ASSERT_EQ(CL_INVALID_QUEUE_PROPERTIES, error);
-#else
+  cl_command_queue_properties device_properties = 0;
+  ASSERT_SUCCESS(clGetDeviceInfo(device, CL_DEVICE_QUEUE_PROPERTIES,
+                                 sizeof(device_properties), &device_properties,
+                                 nullptr));
+  if (!(device_properties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)) {
+    ASSERT_EQ(nullptr, command_queue);
+    ASSERT_EQ(CL_INVALID_QUEUE_PROPERTIES, error);
+    return;
+  }
   EXPECT_SUCCESS(error);
   size_t size;
   EXPECT_SUCCESS(clGetCommandQueueInfo(command_queue, CL_QUEUE_PROPERTIES, 0,
@@ -52,7 +57,6 @@ TEST_F(clCreateCommandQueueWithPropertiesTest, DefaultOutOfOrder) {
   EXPECT_EQ(properties[1], command_queue_properties);
   EXPECT_SUCCESS(error);
   ASSERT_SUCCESS(clReleaseCommandQueue(command_queue));
-#endif
 }
 
 TEST_F(clCreateCommandQueueWithPropertiesTest, DefaultProfiling) {
@@ -81,3 +81,184 @@ TEST_F(clCreateSubDevicesTest, DevicePartitionByCounts) {
     ASSERT_SUCCESS(clReleaseDevice(*iter));
   }
 }
+
+TEST_F(clCreateSubDevicesTest, DevicePartitionByAffinityDomain) {
+  if (!UCL::hasDevicePartitionSupport(device,
+                                      CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN)) {
+    GTEST_SKIP();
+  }
+  cl_device_partition_property properties[] = {
+      CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN,
+      CL_DEVICE_AFFINITY_DOMAIN_NEXT_PARTITIONABLE, 0};
+  cl_uint numSubDevices = 0;
+  EXPECT_SUCCESS(
+      clCreateSubDevices(device, properties, 0, nullptr, &numSubDevices));
+  ASSERT_GT(numSubDevices, 0u);
+  UCL::vector<cl_device_id> subDevices(numSubDevices);
+  ASSERT_SUCCESS(clCreateSubDevices(device, properties, numSubDevices,
+                                    subDevices.data(), nullptr));
+  for (cl_device_id subDevice : subDevices) {
+    cl_device_id parent = nullptr;
+    ASSERT_SUCCESS(clGetDeviceInfo(subDevice, CL_DEVICE_PARENT_DEVICE,
+                                   sizeof(parent), &parent, nullptr));
+    EXPECT_EQ(device, parent);
+    cl_device_partition_property type[3] = {};
+    size_t size = 0;
+    ASSERT_SUCCESS(clGetDeviceInfo(subDevice, CL_DEVICE_PARTITION_TYPE,
+                                   sizeof(type), type, &size));
+    EXPECT_EQ(sizeof(type), size);
+    EXPECT_EQ(properties[0], type[0]);
+    EXPECT_EQ(properties[1], type[1]);
+    ASSERT_SUCCESS(clReleaseDevice(subDevice));
+  }
+}
+
+TEST_F(clCreateSubDevicesTest, InvalidAffinityDomain) {
+  if (!UCL::hasDevicePartitionSupport(device,
+                                      CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN)) {
+    GTEST_SKIP();
+  }
+  cl_device_partition_property properties[] = {
+      CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN,
+      CL_DEVICE_AFFINITY_DOMAIN_NUMA | CL_DEVICE_AFFINITY_DOMAIN_L3_CACHE, 0};
+  cl_device_id subDevice = nullptr;
+  EXPECT_EQ_ERRCODE(CL_INVALID_VALUE, clCreateSubDevices(device, properties, 1,
+                                                         &subDevice, nullptr));
+  ASSERT_FALSE(subDevice);
+}
+
+TEST_F(clCreateSubDevicesTest, UnsupportedAffinityDomain) {
+  if (!UCL::hasDevicePartitionSupport(device,
+                                      CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN)) {
+    GTEST_SKIP();
+  }
+  cl_device_affinity_domain supported = 0;
+  ASSERT_SUCCESS(clGetDeviceInfo(device, CL_DEVICE_PARTITION_AFFINITY_DOMAIN,
+                                 sizeof(supported), &supported, nullptr));
+  for (const cl_device_affinity_domain domain :
+       {CL_DEVICE_AFFINITY_DOMAIN_NUMA, CL_DEVICE_AFFINITY_DOMAIN_L4_CACHE,
+        CL_DEVICE_AFFINITY_DOMAIN_L3_CACHE, CL_DEVICE_AFFINITY_DOMAIN_L2_CACHE,
+        CL_DEVICE_AFFINITY_DOMAIN_L1_CACHE}) {
+    if (supported & domain) {
+      continue;
+    }
+    cl_device_partition_property properties[] = {
+        CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN,
+        static_cast<cl_device_partition_property>(domain), 0};
+    cl_uint numSubDevices = 0;
+    EXPECT_EQ_ERRCODE(CL_INVALID_VALUE, clCreateSubDevices(device, properties,
+                                                           0, nullptr,
+                                                           &numSubDevices));
+  }
+}
+
+// Sub-devices created equally must provide at least the requested compute
+// units, and together no more than the device has.
+TEST_F(clCreateSubDevicesTest, DevicePartitionEquallyComputeUnits) {
+  if (!UCL::hasDevicePartitionSupport(device, CL_DEVICE_PARTITION_EQUALLY)) {
+    GTEST_SKIP();
+  }
+  cl_uint maxComputeUnits = 0;
+  ASSERT_SUCCESS(clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS,
+                                 sizeof(maxComputeUnits), &maxComputeUnits,
+                                 nullptr));
+  cl_device_partition_property properties[] = {
+      CL_DEVICE_PARTITION_EQUALLY, static_cast<cl_device_partition_property>(1),
+      0};
+  cl_uint numSubDevices = 0;
+  ASSERT_SUCCESS(
+      clCreateSubDevices(device, properties, 0, nullptr, &numSubDevices));
+  UCL::vector<cl_device_id> subDevices(numSubDevices);
+  ASSERT_SUCCESS(clCreateSubDevices(device, properties, numSubDevices,
+                                    subDevices.data(), nullptr));
+  cl_uint totalComputeUnits = 0;
+  for (cl_device_id subDevice : subDevices) {
+    cl_uint computeUnits = 0;
+    ASSERT_SUCCESS(clGetDeviceInfo(subDevice, CL_DEVICE_MAX_COMPUTE_UNITS,
+                                   sizeof(computeUnits), &computeUnits,
+                                   nullptr));
+    EXPECT_LE(1u, computeUnits);
+    totalComputeUnits += computeUnits;
+    ASSERT_SUCCESS(clReleaseDevice(subDevice));
+  }
+  EXPECT_LE(totalComputeUnits, maxComputeUnits);
+}
+
+TEST_F(clCreateSubDevicesTest, RetainRelease) {
+  if (!UCL::hasDevicePartitionSupport(device, CL_DEVICE_PARTITION_EQUALLY)) {
+    GTEST_SKIP();
+  }
+  cl_device_partition_property properties[] = {
+      CL_DEVICE_PARTITION_EQUALLY, static_cast<cl_device_partition_property>(1),
+      0};
+  cl_device_id subDevice = nullptr;
+  ASSERT_SUCCESS(
+      clCreateSubDevices(device, properties, 1, &subDevice, nullptr));
+  cl_uint refCount = 0;
+  ASSERT_SUCCESS(clGetDeviceInfo(subDevice, CL_DEVICE_REFERENCE_COUNT,
+                                 sizeof(refCount), &refCount, nullptr));
+  EXPECT_EQ(1u, refCount);
+  ASSERT_SUCCESS(clRetainDevice(subDevice));
+  ASSERT_SUCCESS(clGetDeviceInfo(subDevice, CL_DEVICE_REFERENCE_COUNT,
+                                 sizeof(refCount), &refCount, nullptr));
+  EXPECT_EQ(2u, refCount);
+  ASSERT_SUCCESS(clReleaseDevice(subDevice));
+  ASSERT_SUCCESS(clReleaseDevice(subDevice));
+}
+
+// Each sub-device executes on its own queue, check that work enqueued on all
+// of them concurrently completes.
+TEST_F(clCreateSubDevicesTest, EnqueueOnSubDevices) {
+  if (!UCL::hasDevicePartitionSupport(device,
+                                      CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN)) {
+    GTEST_SKIP();
+  }
+  cl_device_partition_property properties[] = {
+      CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN,
+      CL_DEVICE_AFFINITY_DOMAIN_NEXT_PARTITIONABLE, 0};
+  cl_uint numSubDevices = 0;
+  ASSERT_SUCCESS(
+      clCreateSubDevices(device, properties, 0, nullptr, &numSubDevices));
+  UCL::vector<cl_device_id> subDevices(numSubDevices);
+  ASSERT_SUCCESS(clCreateSubDevices(device, properties, numSubDevices,
+                                    subDevices.data(), nullptr));
+
+  cl_int error = CL_SUCCESS;
+  cl_context context = clCreateContext(nullptr, numSubDevices,
+                                       subDevices.data(), nullptr, nullptr,
+                                       &error);
+  ASSERT_SUCCESS(error);
+
+  const size_t size = 1024;
+  const cl_int pattern = 42;
+  UCL::vector<cl_command_queue> queues(numSubDevices);
+  UCL::vector<cl_mem> buffers(numSubDevices);
+  for (cl_uint i = 0; i < numSubDevices; i++) {
+    queues[i] = clCreateCommandQueue(context, subDevices[i], 0, &error);
+    ASSERT_SUCCESS(error);
+    buffers[i] = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                size * sizeof(cl_int), nullptr, &error);
+    ASSERT_SUCCESS(error);
+    ASSERT_SUCCESS(clEnqueueFillBuffer(queues[i], buffers[i], &pattern,
+                                       sizeof(pattern), 0,
+                                       size * sizeof(cl_int), 0, nullptr,
+                                       nullptr));
+  }
+
+  for (cl_uint i = 0; i < numSubDevices; i++) {
+    UCL::vector<cl_int> result(size);
+    ASSERT_SUCCESS(clEnqueueReadBuffer(queues[i], buffers[i], CL_TRUE, 0,
+                                       size * sizeof(cl_int), result.data(), 0,
+                                       nullptr, nullptr));
+    for (const cl_int value : result) {
+      ASSERT_EQ(pattern, value);
+    }
+    ASSERT_SUCCESS(clReleaseMemObject(buffers[i]));
+    ASSERT_SUCCESS(clReleaseCommandQueue(queues[i]));
+  }
+
+  ASSERT_SUCCESS(clReleaseContext(context));
+  for (cl_device_id subDevice : subDevices) {
+    ASSERT_SUCCESS(clReleaseDevice(subDevice));
+  }
+}
@@ -91,4 +91,52 @@ TEST_F(clEnqueueBarrierWithWaitListTest, DefaultNoEventWaitList) {
   ASSERT_SUCCESS(clReleaseEvent(barrier_event));
 }
 
+TEST_F(clEnqueueBarrierWithWaitListTest, OutOfOrderNoEventWaitList) {
+  cl_command_queue_properties device_properties = 0;
+  ASSERT_SUCCESS(clGetDeviceInfo(device, CL_DEVICE_QUEUE_PROPERTIES,
+                                 sizeof(device_properties), &device_properties,
+                                 nullptr));
+  if (!(device_properties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)) {
+    GTEST_SKIP();
+  }
+
+  cl_int status;
+  cl_command_queue queue = clCreateCommandQueue(
+      context, device, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE, &status);
+  ASSERT_SUCCESS(status);
+  cl_mem buffer = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                 2 * sizeof(cl_float), nullptr, &status);
+  ASSERT_SUCCESS(status);
+  cl_event user_event = clCreateUserEvent(context, &status);
+  ASSERT_SUCCESS(status);
+
+  // The first fill is held back by the user event, the barrier must then hold
+  // back the second fill even though it has no wait events itself.
+  cl_float pattern = 0.0f;
+  cl_event fill_events[2];
+  ASSERT_SUCCESS(clEnqueueFillBuffer(queue, buffer, &pattern, sizeof(cl_float),
+                                     0, sizeof(cl_float), 1, &user_event,
+                                     &fill_events[0]));
+  ASSERT_SUCCESS(clEnqueueBarrierWithWaitList(queue, 0, nullptr, nullptr));
+  ASSERT_SUCCESS(clEnqueueFillBuffer(queue, buffer, &pattern, sizeof(cl_float),
+                                     sizeof(cl_float), sizeof(cl_float), 0,
+                                     nullptr, &fill_events[1]));
+  ASSERT_SUCCESS(clFlush(queue));
+
+  cl_int fill_status = CL_COMPLETE;
+  ASSERT_SUCCESS(clGetEventInfo(fill_events[1],
+                                CL_EVENT_COMMAND_EXECUTION_STATUS,
+                                sizeof(fill_status), &fill_status, nullptr));
+  EXPECT_NE(CL_COMPLETE, fill_status);
+
+  ASSERT_SUCCESS(clSetUserEventStatus(user_event, CL_COMPLETE));
+  ASSERT_SUCCESS(clWaitForEvents(2, fill_events));
+
+  ASSERT_SUCCESS(clReleaseEvent(fill_events[1]));
+  ASSERT_SUCCESS(clReleaseEvent(fill_events[0]));
+  ASSERT_SUCCESS(clReleaseEvent(user_event));
+  ASSERT_SUCCESS(clReleaseMemObject(buffer));
+  ASSERT_SUCCESS(clReleaseCommandQueue(queue));
+}
+
 GENERATE_EVENT_WAIT_LIST_TESTS(clEnqueueBarrierWithWaitListTest)
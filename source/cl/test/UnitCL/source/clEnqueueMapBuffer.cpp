@@ -43,7 +43,7 @@ class clEnqueueMapBufferTest : public ucl::CommandQueueTest,
     cl_int errorcode;
     if (useHostPtr) {
       // Create a host buffer to be used to hold the contents. Deliberately give
-      // poor alignment so we need to create a copy
+      // poor alignment, below what the device would prefer.
       hostBuffer.resize(size + 1);
       void *useptr = static_cast<void *>(hostBuffer.data() + 1);
       inMem = clCreateBuffer(context, CL_MEM_USE_HOST_PTR, int_size, useptr,
@@ -277,6 +277,35 @@ TEST_F(clEnqueueMapBufferTestHostPtr, DefaultWriteInvalidateHostPtr) {
     EXPECT_EQ(-i, outBuffer[i]);
   }
 }
+
+TEST_F(clEnqueueMapBufferTestHostPtr, DefaultReadWriteHostPtr) {
+  cl_int errcode = !CL_SUCCESS;
+  int *const map = reinterpret_cast<int *>(
+      clEnqueueMapBuffer(command_queue, inMem, CL_TRUE,
+                         CL_MAP_READ | CL_MAP_WRITE, 0, int_size, 1,
+                         &writeEvent, &mapEvent, &errcode));
+  ASSERT_SUCCESS(errcode);
+  // Mappings of CL_MEM_USE_HOST_PTR buffers are derived from host_ptr, even
+  // when it is poorly aligned.
+  ASSERT_EQ(hostBuffer.data() + 1, map);
+
+  for (cl_int i = 0; i < static_cast<cl_int>(size); i++) {
+    ASSERT_EQ(inBuffer[i], map[i]);
+    map[i] = i * 3;
+  }
+
+  EXPECT_SUCCESS(clEnqueueUnmapMemObject(command_queue, inMem, map, 0, nullptr,
+                                         &unMapEvent));
+
+  EXPECT_SUCCESS(clEnqueueReadBuffer(command_queue, inMem, CL_TRUE, 0,
+                                     int_size, outBuffer.data(), 1, &unMapEvent,
+                                     &readEvent));
+
+  for (cl_int i = 0; i < static_cast<cl_int>(size); i++) {
+    EXPECT_EQ(i * 3, outBuffer[i]);
+  }
+}
+
 TEST_F(clEnqueueMapBufferTest, DefaultWriteInvalidateBlocking) {
   cl_int errcode = !CL_SUCCESS;
   int *const map = static_cast<int *>(clEnqueueMapBuffer(
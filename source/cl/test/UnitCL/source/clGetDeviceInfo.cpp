@@ -1026,7 +1026,19 @@ TEST_F(clGetDeviceInfoTest, PARTITION_AFFINITY_DOMAIN) {
 
   ASSERT_SUCCESS(clGetDeviceInfo(device, CL_DEVICE_PARTITION_AFFINITY_DOMAIN,
                                  size, &payload, nullptr));
-  ASSERT_EQ(0u, payload);  // assume we don't support any partition types
+  if (UCL::hasDevicePartitionSupport(device,
+                                     CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN)) {
+    ASSERT_NE(0u, payload);
+    const cl_device_affinity_domain domains =
+        CL_DEVICE_AFFINITY_DOMAIN_NUMA | CL_DEVICE_AFFINITY_DOMAIN_L4_CACHE |
+        CL_DEVICE_AFFINITY_DOMAIN_L3_CACHE |
+        CL_DEVICE_AFFINITY_DOMAIN_L2_CACHE |
+        CL_DEVICE_AFFINITY_DOMAIN_L1_CACHE |
+        CL_DEVICE_AFFINITY_DOMAIN_NEXT_PARTITIONABLE;
+    ASSERT_EQ(0u, payload & ~domains);
+  } else {
+    ASSERT_EQ(0u, payload);
+  }
 }
 
 TEST_F(clGetDeviceInfoTest, PARTITION_TYPE) {
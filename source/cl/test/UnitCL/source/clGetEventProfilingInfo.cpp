@@ -15,6 +15,7 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include <thread>
+#include <vector>
 
 #include "Common.h"
 
@@ -147,6 +148,37 @@ TEST_F(clGetEventProfilingInfoTest, Default) {
   EXPECT_GE(end, start);
 }
 
+TEST_F(clGetEventProfilingInfoTest, ManyEvents) {
+  // Enough events to need several of the command queue's duration query pools,
+  // enqueued twice so the second round reuses the queries of the first.
+  std::vector<cl_event> events(200);
+  char data[buffer_size] = {};
+  for (int round = 0; round < 2; round++) {
+    for (auto &many_event : events) {
+      ASSERT_SUCCESS(clEnqueueWriteBuffer(command_queue, buffer, CL_FALSE, 0,
+                                          buffer_size, data, 0, nullptr,
+                                          &many_event));
+    }
+    ASSERT_SUCCESS(clWaitForEvents(static_cast<cl_uint>(events.size()),
+                                   events.data()));
+    for (auto many_event : events) {
+      cl_ulong queued, start, end;
+      ASSERT_SUCCESS(clGetEventProfilingInfo(many_event,
+                                             CL_PROFILING_COMMAND_QUEUED,
+                                             sizeof(queued), &queued, nullptr));
+      ASSERT_SUCCESS(clGetEventProfilingInfo(many_event,
+                                             CL_PROFILING_COMMAND_START,
+                                             sizeof(start), &start, nullptr));
+      ASSERT_SUCCESS(clGetEventProfilingInfo(many_event,
+                                             CL_PROFILING_COMMAND_END,
+                                             sizeof(end), &end, nullptr));
+      EXPECT_GE(start, queued);
+      EXPECT_GE(end, start);
+      ASSERT_SUCCESS(clReleaseEvent(many_event));
+    }
+  }
+}
+
 TEST_F(clGetEventProfilingInfoTest, EarlyRequest) {
   // SetUp already created a command with an event and waited on it, that's
   // fine, now we're going to put some more things into the queue.
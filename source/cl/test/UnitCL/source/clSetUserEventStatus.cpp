@@ -14,6 +14,8 @@
 //
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <array>
+
 #include "Common.h"
 
 class clSetUserEventStatusTest : public ucl::ContextTest {
@@ -735,3 +737,185 @@ TEST_F(clSetUserEventStatusBlockingQueueTest, OnTwoUserEventsReversedCopies) {
   EXPECT_SUCCESS(clReleaseMemObject(final_buffer));
   EXPECT_SUCCESS(clReleaseMemObject(intermediate_buffer));
 }
+
+// Tests the scheduling of commands on an out-of-order queue around commands
+// held back by a user event.
+class clSetUserEventStatusOutOfOrderTest : public ucl::ContextTest {
+ protected:
+  static constexpr size_t num_elements = 4;
+
+  void SetUp() override {
+    UCL_RETURN_ON_FATAL_FAILURE(ContextTest::SetUp());
+    cl_command_queue_properties properties = 0;
+    ASSERT_SUCCESS(clGetDeviceInfo(device, CL_DEVICE_QUEUE_PROPERTIES,
+                                   sizeof(properties), &properties, nullptr));
+    if (!(properties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)) {
+      GTEST_SKIP();
+    }
+
+    cl_int error = CL_SUCCESS;
+    command_queue = clCreateCommandQueue(
+        context, device, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE, &error);
+    ASSERT_SUCCESS(error);
+    user_event = clCreateUserEvent(context, &error);
+    ASSERT_SUCCESS(error);
+    for (auto &buffer : buffers) {
+      buffer = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                              sizeof(cl_int) * num_elements, nullptr, &error);
+      ASSERT_SUCCESS(error);
+    }
+  }
+
+  void TearDown() override {
+    for (auto buffer : buffers) {
+      if (buffer) {
+        EXPECT_SUCCESS(clReleaseMemObject(buffer));
+      }
+    }
+    if (user_event) {
+      EXPECT_SUCCESS(clReleaseEvent(user_event));
+    }
+    if (command_queue) {
+      EXPECT_SUCCESS(clReleaseCommandQueue(command_queue));
+    }
+    ContextTest::TearDown();
+  }
+
+  // Fills element `index` of `buffer` with `value`.
+  cl_event fill(cl_command_queue queue, cl_mem buffer, size_t index,
+                cl_int value, cl_uint num_wait_events,
+                const cl_event *wait_events) {
+    cl_event event = nullptr;
+    EXPECT_SUCCESS(clEnqueueFillBuffer(queue, buffer, &value, sizeof(cl_int),
+                                       index * sizeof(cl_int), sizeof(cl_int),
+                                       num_wait_events, wait_events, &event));
+    return event;
+  }
+
+  cl_int getStatus(cl_event event) {
+    cl_int status = CL_COMPLETE;
+    EXPECT_SUCCESS(clGetEventInfo(event, CL_EVENT_COMMAND_EXECUTION_STATUS,
+                                  sizeof(status), &status, nullptr));
+    return status;
+  }
+
+  std::array<cl_int, num_elements> read(cl_mem buffer) {
+    std::array<cl_int, num_elements> result{};
+    EXPECT_SUCCESS(clEnqueueReadBuffer(command_queue, buffer, CL_TRUE, 0,
+                                       sizeof(result), result.data(), 0,
+                                       nullptr, nullptr));
+    return result;
+  }
+
+  cl_command_queue command_queue = nullptr;
+  cl_event user_event = nullptr;
+  std::array<cl_mem, 2> buffers = {};
+};
+
+TEST_F(clSetUserEventStatusOutOfOrderTest, IndependentCommandCompletes) {
+  // A command without a wait list must not be held back by a command waiting
+  // on a user event which was enqueued before it.
+  cl_event held = fill(command_queue, buffers[0], 0, 1, 1, &user_event);
+  cl_event independent = fill(command_queue, buffers[1], 0, 2, 0, nullptr);
+  ASSERT_SUCCESS(clFlush(command_queue));
+
+  ASSERT_SUCCESS(clWaitForEvents(1, &independent));
+  EXPECT_NE(CL_COMPLETE, getStatus(held));
+
+  ASSERT_SUCCESS(clSetUserEventStatus(user_event, CL_COMPLETE));
+  ASSERT_SUCCESS(clWaitForEvents(1, &held));
+  EXPECT_EQ(1, read(buffers[0])[0]);
+  EXPECT_EQ(2, read(buffers[1])[0]);
+
+  ASSERT_SUCCESS(clReleaseEvent(independent));
+  ASSERT_SUCCESS(clReleaseEvent(held));
+}
+
+TEST_F(clSetUserEventStatusOutOfOrderTest, SameQueueDependencies) {
+  // A chain of commands each waiting on the one before is held back by the
+  // user event at its head, and runs in order once it is set.
+  std::array<cl_event, 8> chain;
+  chain[0] = fill(command_queue, buffers[0], 0, 0, 1, &user_event);
+  for (size_t i = 1; i < chain.size(); i++) {
+    chain[i] = fill(command_queue, buffers[0], 0, static_cast<cl_int>(i), 1,
+                    &chain[i - 1]);
+  }
+
+  // A command waiting on two commands of the chain waits for both of them.
+  const cl_event joined_wait_events[] = {chain[2], chain.back()};
+  cl_event joined = fill(command_queue, buffers[0], 1, 42, 2,
+                         joined_wait_events);
+
+  cl_event independent = fill(command_queue, buffers[1], 0, 2, 0, nullptr);
+  ASSERT_SUCCESS(clFlush(command_queue));
+  ASSERT_SUCCESS(clWaitForEvents(1, &independent));
+  for (auto event : chain) {
+    EXPECT_NE(CL_COMPLETE, getStatus(event));
+  }
+  EXPECT_NE(CL_COMPLETE, getStatus(joined));
+
+  ASSERT_SUCCESS(clSetUserEventStatus(user_event, CL_COMPLETE));
+  ASSERT_SUCCESS(clWaitForEvents(1, &joined));
+  EXPECT_EQ(CL_COMPLETE, getStatus(chain.back()));
+  const auto result = read(buffers[0]);
+  EXPECT_EQ(static_cast<cl_int>(chain.size() - 1), result[0]);
+  EXPECT_EQ(42, result[1]);
+
+  ASSERT_SUCCESS(clReleaseEvent(independent));
+  ASSERT_SUCCESS(clReleaseEvent(joined));
+  for (auto event : chain) {
+    ASSERT_SUCCESS(clReleaseEvent(event));
+  }
+}
+
+TEST_F(clSetUserEventStatusOutOfOrderTest, CrossQueueDependency) {
+  // A command waiting on a command of another queue is held back until that
+  // command completes, without holding back the rest of its own queue.
+  cl_int error = CL_SUCCESS;
+  cl_command_queue other_queue = clCreateCommandQueue(
+      context, device, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE, &error);
+  ASSERT_SUCCESS(error);
+
+  cl_event held = fill(command_queue, buffers[0], 0, 1, 1, &user_event);
+  cl_event dependent = fill(other_queue, buffers[0], 0, 2, 1, &held);
+  cl_event independent = fill(other_queue, buffers[1], 0, 3, 0, nullptr);
+  ASSERT_SUCCESS(clFlush(command_queue));
+  ASSERT_SUCCESS(clFlush(other_queue));
+
+  ASSERT_SUCCESS(clWaitForEvents(1, &independent));
+  EXPECT_NE(CL_COMPLETE, getStatus(held));
+  EXPECT_NE(CL_COMPLETE, getStatus(dependent));
+
+  ASSERT_SUCCESS(clSetUserEventStatus(user_event, CL_COMPLETE));
+  ASSERT_SUCCESS(clWaitForEvents(1, &dependent));
+  EXPECT_EQ(CL_COMPLETE, getStatus(held));
+  EXPECT_EQ(2, read(buffers[0])[0]);
+  EXPECT_EQ(3, read(buffers[1])[0]);
+
+  ASSERT_SUCCESS(clReleaseEvent(independent));
+  ASSERT_SUCCESS(clReleaseEvent(dependent));
+  ASSERT_SUCCESS(clReleaseEvent(held));
+  ASSERT_SUCCESS(clReleaseCommandQueue(other_queue));
+}
+
+TEST_F(clSetUserEventStatusOutOfOrderTest, RetireCommandsInAnyOrder) {
+  // Commands completing after the oldest command of the queue, which is held
+  // back by the user event, must still be retired and their resources reused.
+  cl_event held = fill(command_queue, buffers[0], 0, 1, 1, &user_event);
+  for (cl_int i = 0; i < 256; i++) {
+    cl_event event = fill(command_queue, buffers[1],
+                          static_cast<size_t>(i) % num_elements, i, 0, nullptr);
+    ASSERT_SUCCESS(clWaitForEvents(1, &event));
+    ASSERT_SUCCESS(clReleaseEvent(event));
+  }
+  EXPECT_NE(CL_COMPLETE, getStatus(held));
+
+  ASSERT_SUCCESS(clSetUserEventStatus(user_event, CL_COMPLETE));
+  ASSERT_SUCCESS(clFinish(command_queue));
+  EXPECT_EQ(CL_COMPLETE, getStatus(held));
+  EXPECT_EQ(1, read(buffers[0])[0]);
+  EXPECT_EQ((std::array<cl_int, num_elements>{252, 253, 254, 255}),
+            read(buffers[1]));
+
+  ASSERT_SUCCESS(clReleaseEvent(held));
+}
@@ -0,0 +1,152 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <CL/cl_ext_codeplay.h>
+
+#include <vector>
+
+#include "Common.h"
+
+namespace {
+enum : size_t { LOCAL_SIZE = 8, MAX_GROUPS = 16 };
+}  // namespace
+
+struct clEnqueueNDRangeKernelIndirectCODEPLAYTest : ucl::CommandQueueTest {
+  void SetUp() override {
+    UCL_RETURN_ON_FATAL_FAILURE(CommandQueueTest::SetUp());
+    if (!getDeviceCompilerAvailable() ||
+        !isDeviceExtensionSupported("cl_codeplay_indirect_dispatch")) {
+      GTEST_SKIP();
+    }
+    clEnqueueNDRangeKernelIndirectCODEPLAY =
+        reinterpret_cast<clEnqueueNDRangeKernelIndirectCODEPLAY_fn>(
+            clGetExtensionFunctionAddressForPlatform(
+                platform, "clEnqueueNDRangeKernelIndirectCODEPLAY"));
+    ASSERT_NE(nullptr, clEnqueueNDRangeKernelIndirectCODEPLAY);
+
+    const char *source = R"(
+kernel void iota(global int *out) {
+  size_t id = get_global_id(0);
+  out[id] = (int)id;
+}
+)";
+    const size_t length = std::strlen(source);
+    cl_int error = !CL_SUCCESS;
+    program = clCreateProgramWithSource(context, 1, &source, &length, &error);
+    ASSERT_SUCCESS(error);
+    ASSERT_SUCCESS(clBuildProgram(program, 1, &device, nullptr,
+                                  ucl::buildLogCallback, nullptr));
+    kernel = clCreateKernel(program, "iota", &error);
+    ASSERT_SUCCESS(error);
+
+    out = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                         LOCAL_SIZE * MAX_GROUPS * sizeof(cl_int), nullptr,
+                         &error);
+    ASSERT_SUCCESS(error);
+    ASSERT_SUCCESS(clSetKernelArg(kernel, 0, sizeof(out), &out));
+
+    group_counts = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                  3 * sizeof(cl_uint), nullptr, &error);
+    ASSERT_SUCCESS(error);
+  }
+
+  void TearDown() override {
+    if (group_counts) {
+      EXPECT_SUCCESS(clReleaseMemObject(group_counts));
+    }
+    if (out) {
+      EXPECT_SUCCESS(clReleaseMemObject(out));
+    }
+    if (kernel) {
+      EXPECT_SUCCESS(clReleaseKernel(kernel));
+    }
+    if (program) {
+      EXPECT_SUCCESS(clReleaseProgram(program));
+    }
+    CommandQueueTest::TearDown();
+  }
+
+  /// @brief Run the kernel with `count` work-groups, read from the buffer.
+  void runWithGroupCount(cl_uint count, std::vector<cl_int> &result) {
+    const cl_int fill = -1;
+    ASSERT_SUCCESS(clEnqueueFillBuffer(command_queue, out, &fill, sizeof(fill),
+                                       0, result.size() * sizeof(cl_int), 0,
+                                       nullptr, nullptr));
+    ASSERT_SUCCESS(clEnqueueWriteBuffer(command_queue, group_counts, CL_FALSE,
+                                        0, sizeof(count), &count, 0, nullptr,
+                                        nullptr));
+    const size_t local_size = LOCAL_SIZE;
+    ASSERT_SUCCESS(clEnqueueNDRangeKernelIndirectCODEPLAY(
+        command_queue, kernel, 1, nullptr, group_counts, 0, &local_size, 0,
+        nullptr, nullptr));
+    ASSERT_SUCCESS(clEnqueueReadBuffer(command_queue, out, CL_TRUE, 0,
+                                       result.size() * sizeof(cl_int),
+                                       result.data(), 0, nullptr, nullptr));
+  }
+
+  clEnqueueNDRangeKernelIndirectCODEPLAY_fn
+      clEnqueueNDRangeKernelIndirectCODEPLAY = nullptr;
+  cl_program program = nullptr;
+  cl_kernel kernel = nullptr;
+  cl_mem out = nullptr;
+  cl_mem group_counts = nullptr;
+};
+
+TEST_F(clEnqueueNDRangeKernelIndirectCODEPLAYTest, Default) {
+  std::vector<cl_int> result(LOCAL_SIZE * MAX_GROUPS);
+  const cl_uint count = 5;
+  ASSERT_NO_FATAL_FAILURE(runWithGroupCount(count, result));
+  for (size_t i = 0; i < result.size(); i++) {
+    const cl_int expected = i < count * LOCAL_SIZE ? cl_int(i) : -1;
+    ASSERT_EQ(expected, result[i]) << "at index " << i;
+  }
+}
+
+TEST_F(clEnqueueNDRangeKernelIndirectCODEPLAYTest, ZeroGroups) {
+  std::vector<cl_int> result(LOCAL_SIZE * MAX_GROUPS);
+  ASSERT_NO_FATAL_FAILURE(runWithGroupCount(0, result));
+  for (size_t i = 0; i < result.size(); i++) {
+    ASSERT_EQ(-1, result[i]) << "at index " << i;
+  }
+}
+
+TEST_F(clEnqueueNDRangeKernelIndirectCODEPLAYTest, InvalidGroupCountBuffer) {
+  const size_t local_size = LOCAL_SIZE;
+  EXPECT_EQ_ERRCODE(CL_INVALID_MEM_OBJECT,
+                    clEnqueueNDRangeKernelIndirectCODEPLAY(
+                        command_queue, kernel, 1, nullptr, nullptr, 0,
+                        &local_size, 0, nullptr, nullptr));
+}
+
+TEST_F(clEnqueueNDRangeKernelIndirectCODEPLAYTest, InvalidGroupCountOffset) {
+  const size_t local_size = LOCAL_SIZE;
+  EXPECT_EQ_ERRCODE(CL_INVALID_VALUE,
+                    clEnqueueNDRangeKernelIndirectCODEPLAY(
+                        command_queue, kernel, 1, nullptr, group_counts, 1,
+                        &local_size, 0, nullptr, nullptr));
+  EXPECT_EQ_ERRCODE(CL_INVALID_VALUE,
+                    clEnqueueNDRangeKernelIndirectCODEPLAY(
+                        command_queue, kernel, 1, nullptr, group_counts,
+                        3 * sizeof(cl_uint), &local_size, 0, nullptr,
+                        nullptr));
+}
+
+TEST_F(clEnqueueNDRangeKernelIndirectCODEPLAYTest, NullLocalSize) {
+  EXPECT_EQ_ERRCODE(CL_INVALID_WORK_GROUP_SIZE,
+                    clEnqueueNDRangeKernelIndirectCODEPLAY(
+                        command_queue, kernel, 1, nullptr, group_counts, 0,
+                        nullptr, 0, nullptr, nullptr));
+}
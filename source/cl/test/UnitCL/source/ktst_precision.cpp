@@ -2478,3 +2478,333 @@ TEST_P(Execution, Precision_93_Divide_Relaxed) {
 
   RunGeneric1D(N);
 }
+
+// The relaxed math tests check the single precision builtins against the
+// OpenCL 3.0 requirements for -cl-fast-relaxed-math, which only apply after
+// CL 2.0. Relaxed math also implies -cl-finite-math-only, so the inputs are
+// all finite.
+TEST_P(Execution, Precision_94_Single_Relaxed_Exp) {
+  if (!isSourceTypeIn({OPENCL_C, OFFLINE})) {
+    GTEST_SKIP();
+  }
+  if (!UCL::isDeviceVersionAtLeast({3, 0})) {
+    GTEST_SKIP();
+  }
+  AddBuildOption("-cl-fast-relaxed-math");
+
+  // The relaxed requirement for exp is 3 + floor(fabs(2 * x)) ULP, so keep
+  // the inputs to the range where this is tightest.
+  std::vector<cl_float> input(kts::N);
+  ucl::Environment::instance->GetInputGenerator().GenerateFiniteFloatData(
+      input, -0.5f, 0.5f);
+
+  const size_t N = input.size();
+  AddInputBuffer(
+      N, kts::Reference1D<cl_float>([&input](size_t id) { return input[id]; }));
+
+  AddOutputBuffer(N, makeULPStreamer<cl_float, 3_ULP>(
+                         [&input](size_t id) -> cl_double {
+                           const cl_double promote =
+                               static_cast<cl_double>(input[id]);
+                           return std::exp(promote);
+                         },
+                         this->device));
+
+  RunGeneric1D(N);
+}
+
+TEST_P(Execution, Precision_94_Single_Relaxed_Exp_Wide) {
+  if (!isSourceTypeIn({OPENCL_C, OFFLINE})) {
+    GTEST_SKIP();
+  }
+  if (!UCL::isDeviceVersionAtLeast({3, 0})) {
+    GTEST_SKIP();
+  }
+  AddBuildOption("-cl-fast-relaxed-math");
+
+  // The relaxed requirement for exp grows with the magnitude of x, at the
+  // edges of this range it is 3 + floor(fabs(2 * 4)) ULP.
+  std::vector<cl_float> input(kts::N);
+  ucl::Environment::instance->GetInputGenerator().GenerateFiniteFloatData(
+      input, -4.0f, 4.0f);
+
+  const size_t N = input.size();
+  AddInputBuffer(
+      N, kts::Reference1D<cl_float>([&input](size_t id) { return input[id]; }));
+
+  AddOutputBuffer(N, makeULPStreamer<cl_float, 11_ULP>(
+                         [&input](size_t id) -> cl_double {
+                           const cl_double promote =
+                               static_cast<cl_double>(input[id]);
+                           return std::exp(promote);
+                         },
+                         this->device));
+
+  RunGeneric1D(N);
+}
+
+TEST_P(Execution, Precision_95_Single_Relaxed_Log) {
+  if (!isSourceTypeIn({OPENCL_C, OFFLINE})) {
+    GTEST_SKIP();
+  }
+  if (!UCL::isDeviceVersionAtLeast({3, 0})) {
+    GTEST_SKIP();
+  }
+  AddBuildOption("-cl-fast-relaxed-math");
+
+  // The relaxed requirement for log is 3 ULP outside of [0.5, 2], and an
+  // absolute error of 2^-21 inside it.
+  std::vector<cl_float> input(kts::N);
+  ucl::Environment::instance->GetInputGenerator().GenerateFiniteFloatData(
+      input, 2.0f, std::numeric_limits<cl_float>::max());
+
+  const size_t N = input.size();
+  AddInputBuffer(
+      N, kts::Reference1D<cl_float>([&input](size_t id) { return input[id]; }));
+
+  AddOutputBuffer(N, makeULPStreamer<cl_float, 3_ULP>(
+                         [&input](size_t id) -> cl_double {
+                           const cl_double promote =
+                               static_cast<cl_double>(input[id]);
+                           return std::log(promote);
+                         },
+                         this->device));
+
+  RunGeneric1D(N);
+}
+
+TEST_P(Execution, Precision_95_Single_Relaxed_Log_Near_One) {
+  if (!isSourceTypeIn({OPENCL_C, OFFLINE})) {
+    GTEST_SKIP();
+  }
+  if (!UCL::isDeviceVersionAtLeast({3, 0})) {
+    GTEST_SKIP();
+  }
+  AddBuildOption("-cl-fast-relaxed-math");
+
+  std::vector<cl_float> input(kts::N);
+  ucl::Environment::instance->GetInputGenerator().GenerateFiniteFloatData(
+      input, 0.5f, 2.0f);
+
+  const size_t N = input.size();
+  AddInputBuffer(
+      N, kts::Reference1D<cl_float>([&input](size_t id) { return input[id]; }));
+
+  // Absolute error of 2^-21 in the range [0.5, 2].
+  AddOutputBuffer(N, makeAbsoluteErrStreamer<cl_float, 2097152>(
+                         [&input](size_t id) -> cl_float {
+                           const cl_double promote =
+                               static_cast<cl_double>(input[id]);
+                           return static_cast<cl_float>(std::log(promote));
+                         }));
+
+  RunGeneric1D(N);
+}
+
+TEST_P(Execution, Precision_95_Single_Relaxed_Log_Small) {
+  if (!isSourceTypeIn({OPENCL_C, OFFLINE})) {
+    GTEST_SKIP();
+  }
+  if (!UCL::isDeviceVersionAtLeast({3, 0})) {
+    GTEST_SKIP();
+  }
+  AddBuildOption("-cl-fast-relaxed-math");
+
+  // Denormal inputs are excluded, as their results are -INFINITY on devices
+  // which flush them to zero.
+  std::vector<cl_float> input(kts::N);
+  ucl::Environment::instance->GetInputGenerator().GenerateFiniteFloatData(
+      input, std::numeric_limits<cl_float>::min(), 0.5f);
+
+  const size_t N = input.size();
+  AddInputBuffer(
+      N, kts::Reference1D<cl_float>([&input](size_t id) { return input[id]; }));
+
+  AddOutputBuffer(N, makeULPStreamer<cl_float, 3_ULP>(
+                         [&input](size_t id) -> cl_double {
+                           const cl_double promote =
+                               static_cast<cl_double>(input[id]);
+                           return std::log(promote);
+                         },
+                         this->device));
+
+  RunGeneric1D(N);
+}
+
+TEST_P(Execution, Precision_96_Single_Relaxed_sincos) {
+  if (!isSourceTypeIn({OPENCL_C, OFFLINE})) {
+    GTEST_SKIP();
+  }
+  if (!UCL::isDeviceVersionAtLeast({3, 0})) {
+    GTEST_SKIP();
+  }
+  AddBuildOption("-cl-fast-relaxed-math");
+
+  // The relaxed requirement for sin and cos is an absolute error of 2^-11 in
+  // the range [-pi, pi].
+  std::vector<cl_float> input(kts::N);
+  ucl::Environment::instance->GetInputGenerator().GenerateFiniteFloatData(
+      input, static_cast<cl_float>(-M_PI), static_cast<cl_float>(M_PI));
+
+  const size_t N = input.size();
+  AddInputBuffer(
+      N, kts::Reference1D<cl_float>([&input](size_t id) { return input[id]; }));
+
+  AddOutputBuffer(N, makeAbsoluteErrStreamer<cl_float, 2048>(
+                         [&input](size_t id) -> cl_float {
+                           const cl_double promote =
+                               static_cast<cl_double>(input[id]);
+                           return static_cast<cl_float>(std::sin(promote));
+                         }));
+
+  AddOutputBuffer(N, makeAbsoluteErrStreamer<cl_float, 2048>(
+                         [&input](size_t id) -> cl_float {
+                           const cl_double promote =
+                               static_cast<cl_double>(input[id]);
+                           return static_cast<cl_float>(std::cos(promote));
+                         }));
+
+  RunGeneric1D(N);
+}
+
+TEST_P(Execution, Precision_97_Single_Relaxed_Rsqrt) {
+  if (!isSourceTypeIn({OPENCL_C, OFFLINE})) {
+    GTEST_SKIP();
+  }
+  if (!UCL::isDeviceVersionAtLeast({3, 0})) {
+    GTEST_SKIP();
+  }
+  AddBuildOption("-cl-fast-relaxed-math");
+
+  // Denormal inputs are excluded, as their results overflow on devices which
+  // flush them to zero.
+  std::vector<cl_float> input(kts::N);
+  ucl::Environment::instance->GetInputGenerator().GenerateFiniteFloatData(
+      input, std::numeric_limits<cl_float>::min());
+
+  const size_t N = input.size();
+  AddInputBuffer(
+      N, kts::Reference1D<cl_float>([&input](size_t id) { return input[id]; }));
+
+  AddOutputBuffer(N, makeULPStreamer<cl_float, 2_ULP>(
+                         [&input](size_t id) -> cl_double {
+                           const cl_double promote =
+                               static_cast<cl_double>(input[id]);
+                           return 1.0 / std::sqrt(promote);
+                         },
+                         this->device));
+
+  RunGeneric1D(N);
+}
+
+TEST_P(Execution, Precision_98_Single_Relaxed_Erf) {
+  if (!isSourceTypeIn({OPENCL_C, OFFLINE})) {
+    GTEST_SKIP();
+  }
+  if (!UCL::isDeviceVersionAtLeast({3, 0})) {
+    GTEST_SKIP();
+  }
+  AddBuildOption("-cl-fast-relaxed-math");
+
+  std::vector<cl_float> input(kts::N);
+  ucl::Environment::instance->GetInputGenerator().GenerateFiniteFloatData(
+      input);
+
+  const size_t N = input.size();
+  AddInputBuffer(
+      N, kts::Reference1D<cl_float>([&input](size_t id) { return input[id]; }));
+
+  AddOutputBuffer(N, makeULPStreamer<cl_float, 16_ULP>(
+                         [&input](size_t id) -> cl_double {
+                           const cl_double promote =
+                               static_cast<cl_double>(input[id]);
+                           return std::erf(promote);
+                         },
+                         this->device));
+
+  RunGeneric1D(N);
+}
+
+TEST_P(Execution, Precision_99_Single_Relaxed_Pow) {
+  if (!isSourceTypeIn({OPENCL_C, OFFLINE})) {
+    GTEST_SKIP();
+  }
+  if (!UCL::isDeviceVersionAtLeast({3, 0})) {
+    GTEST_SKIP();
+  }
+  AddBuildOption("-cl-fast-relaxed-math");
+
+  // pow is derived from exp2 and log2 in relaxed math builds, so the
+  // requirement is the 8192 ULP that the OpenCL CTS allows derived
+  // implementations. The ranges keep the results within single precision.
+  std::vector<cl_float> x(kts::N);
+  std::vector<cl_float> y(kts::N);
+  ucl::Environment::instance->GetInputGenerator().GenerateFiniteFloatData(
+      x, std::numeric_limits<cl_float>::min(), 16.0f);
+  ucl::Environment::instance->GetInputGenerator().GenerateFiniteFloatData(
+      y, -1.0f, 1.0f);
+
+  const size_t N = x.size();
+  AddInputBuffer(N,
+                 kts::Reference1D<cl_float>([&x](size_t id) { return x[id]; }));
+  AddInputBuffer(N,
+                 kts::Reference1D<cl_float>([&y](size_t id) { return y[id]; }));
+
+  AddOutputBuffer(N, makeULPStreamer<cl_float, 8192_ULP>(
+                         [&x, &y](size_t id) -> cl_double {
+                           return std::pow(static_cast<cl_double>(x[id]),
+                                           static_cast<cl_double>(y[id]));
+                         },
+                         this->device));
+
+  RunGeneric1D(N);
+}
+
+TEST_P(Execution, Precision_99_Single_Relaxed_Pow_Edgecases) {
+  // Whether or not the kernel will be vectorized at a global size of 1 is
+  // dependent on the target.
+  fail_if_not_vectorized_ = false;
+
+  if (!isSourceTypeIn({OPENCL_C, OFFLINE})) {
+    GTEST_SKIP();
+  }
+  if (!UCL::isDeviceVersionAtLeast({3, 0})) {
+    GTEST_SKIP();
+  }
+  AddBuildOption("-cl-fast-relaxed-math");
+
+  // Relaxed math doesn't imply finite math, so zero, infinite and NaN inputs
+  // must give the same results as the full precision builtin.
+  const size_t N = 10;
+  const cl_uint x_inputs[N] = {
+      0x00000000 /* 0.0 */,  0x80000000 /* -0.0 */, 0x80000000 /* -0.0 */,
+      0x7f800000 /* inf */,  0xff800000 /* -inf */, 0x7fc00000 /* nan */,
+      0xc0000000 /* -2.0 */, 0xbf800000 /* -1.0 */, 0x3f000000 /* 0.5 */,
+      0x40000000 /* 2.0 */};
+  const cl_uint y_inputs[N] = {
+      0xc0000000 /* -2.0 */, 0xc0400000 /* -3.0 */, 0xc0000000 /* -2.0 */,
+      0x40000000 /* 2.0 */,  0x40400000 /* 3.0 */,  0x3f800000 /* 1.0 */,
+      0x3f000000 /* 0.5 */,  0x7f800000 /* inf */,  0xff800000 /* -inf */,
+      0x7f800000 /* inf */};
+  const cl_uint expected_outputs[N] = {
+      0x7f800000 /* inf */,  0xff800000 /* -inf */, 0x7f800000 /* inf */,
+      0x7f800000 /* inf */,  0xff800000 /* -inf */, 0x7fc00000 /* nan */,
+      0x7fc00000 /* nan */,  0x3f800000 /* 1.0 */,  0x7f800000 /* inf */,
+      0x7f800000 /* inf */};
+
+  AddInputBuffer(N, kts::Reference1D<cl_float>([&x_inputs](size_t id) {
+                   return cargo::bit_cast<cl_float>(x_inputs[id]);
+                 }));
+  AddInputBuffer(N, kts::Reference1D<cl_float>([&y_inputs](size_t id) {
+                   return cargo::bit_cast<cl_float>(y_inputs[id]);
+                 }));
+
+  auto ref_output = [&expected_outputs](size_t id) -> cl_double {
+    const cl_float expected = cargo::bit_cast<cl_float>(expected_outputs[id]);
+    return static_cast<cl_double>(expected);
+  };
+  AddOutputBuffer(N,
+                  makeULPStreamer<cl_float, 0_ULP>(ref_output, this->device));
+
+  RunGeneric1D(N);
+}
@@ -62,6 +62,11 @@ int main(int argc, char **argv) {
     return 1;
   }
 
+  // Autotuning builds and executes the kernel in every configuration itself.
+  if (driver.IsAutotuning()) {
+    return driver.Autotune() == oclc::success ? 0 : 1;
+  }
+
   // Build the kernel and saved the compiled output.
   if (driver.BuildProgram() != oclc::success) {
     return 1;
@@ -108,7 +113,9 @@ oclc::Driver::Driver()
       work_dim_(2),
       char_tolerance_(0),
       verbose_(false),
-      execute_(false) {}
+      execute_(false),
+      autotune_(false),
+      autotune_repeat_(10) {}
 
 oclc::Driver::~Driver() {
   if (program_) {
@@ -169,6 +176,18 @@ options:
 -repeat-execution <N>                                   Executes the kernel N times. -global, -local, and -arg
                                                         arguments may be set to {<list>},{<list>},... to take on
                                                         different values on each execution.
+-autotune                                               Times the enqueued kernel in every combination of the
+                                                        candidate local sizes, vectorizer choices and widths,
+                                                        and prints the configurations ranked by execution time.
+-autotune-local <l1>,<l2>,...:<l1>,<l2>,...             Sets the candidate local work sizes to autotune. Defaults to
+                                                        every power of two local size dividing the global size.
+-autotune-vecz-choices '<choices>'                      Adds a CODEPLAY_VECZ_CHOICES value to autotune, may be given
+                                                        multiple times. The choices are always autotuned unset.
+-autotune-widths <w1>,<w2>,...                          Sets the candidate vectorization widths to autotune, a width
+                                                        of 1 disables vectorization. Defaults to 1,4,8,16.
+-autotune-repeat <N>                                    Times each autotuned configuration over N executions.
+                                                        Defaults to 10.
+-autotune-profile <filename>                            Writes the ranked autotuning results to a JSON file.
 
 Available output formats:
   text                                                    textual format such as LLVM IR or assembly
@@ -267,6 +286,34 @@ bool oclc::Driver::ParseArguments(int argc, char **argv) {
       OCLC_CHECK_FMT(limit == 0, "error: seed '%s' is an invalid value.\n",
                      arg_str);
       execution_limit_ = limit;
+    } else if (args.TakeKey("-autotune", failed)) {
+      autotune_ = true;
+    } else if (const char *arg_str =
+                   args.TakeKeyValue("-autotune-local", failed)) {
+      failed = ParseAutotuneLocalSizes(arg_str) == oclc::failure;
+    } else if (const char *arg_str =
+                   args.TakeKeyValue("-autotune-vecz-choices", failed)) {
+      autotune_vecz_choices_.push_back(arg_str);
+    } else if (const char *arg_str =
+                   args.TakeKeyValue("-autotune-widths", failed)) {
+      std::vector<std::string> widthList;
+      SplitAndExpandList(arg_str, '\0', widthList);
+      OCLC_CHECK_FMT(!VerifyGreaterThanZero(widthList),
+                     "error: autotune widths '%s' are invalid.\n", arg_str);
+      for (const std::string &width : widthList) {
+        autotune_widths_.push_back(
+            static_cast<cl_uint>(strtoul(width.c_str(), nullptr, 10)));
+      }
+    } else if (const char *arg_str =
+                   args.TakeKeyValue("-autotune-repeat", failed)) {
+      const size_t repeat = static_cast<size_t>(strtoull(arg_str, nullptr, 10));
+      OCLC_CHECK_FMT(repeat == 0,
+                     "error: autotune repeat count '%s' is an invalid value.\n",
+                     arg_str);
+      autotune_repeat_ = repeat;
+    } else if (const char *arg_str =
+                   args.TakeKeyValue("-autotune-profile", failed)) {
+      autotune_profile_file_ = arg_str;
     } else if (args.TakeKey("-", failed)) {
       // Input file is stdin.
       positional_args.push_back("-");
@@ -297,6 +344,9 @@ bool oclc::Driver::ParseArguments(int argc, char **argv) {
     return oclc::failure;
   }
 
+  OCLC_CHECK(autotune_ && enqueue_kernel_.empty(),
+             "-autotune requires a kernel to be enqueued with -enqueue");
+
   for (const std::string &s : argument_queue_) {
     if (ParseKernelArgument(s.c_str()) == oclc::failure) {
       return oclc::failure;
@@ -1575,7 +1625,10 @@ bool oclc::Driver::EnqueueKernel() {
   }
 
   cl_int err;
-  cl_command_queue queue = clCreateCommandQueue(context_, device_, 0, &err);
+  const cl_command_queue_properties queue_properties =
+      autotune_ ? CL_QUEUE_PROFILING_ENABLE : 0;
+  cl_command_queue queue =
+      clCreateCommandQueue(context_, device_, queue_properties, &err);
   OCLC_CHECK_CL(err, "Creating command queue failed");
 
   cl_kernel kernel = clCreateKernel(program_, enqueue_kernel_.c_str(), &err);
@@ -1955,7 +2008,44 @@ bool oclc::Driver::EnqueueKernel() {
                            ? nullptr
                            : local_work_size_[local_work_size_index].data();
   // Enqueue kernel
-  if (execute_) {
+  if (autotune_) {
+    // The first execution is not timed, it absorbs any compilation deferred
+    // until the kernel is enqueued and warms the caches.
+    for (size_t run = 0; run <= autotune_repeat_; run++) {
+      cl_event event = nullptr;
+      err = clEnqueueNDRangeKernel(
+          queue, kernel, work_dim_, nullptr,
+          global_work_size_[global_work_size_index].data(), local_data, 0,
+          nullptr, &event);
+      if (CL_SUCCESS == err) {
+        err = clWaitForEvents(1, &event);
+      }
+      cl_ulong start = 0;
+      cl_ulong end = 0;
+      if (CL_SUCCESS == err) {
+        err = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START,
+                                      sizeof(cl_ulong), &start, nullptr);
+      }
+      if (CL_SUCCESS == err) {
+        err = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END,
+                                      sizeof(cl_ulong), &end, nullptr);
+      }
+      if (event) {
+        clReleaseEvent(event);
+      }
+      if (CL_SUCCESS != err) {
+        if (verbose_) {
+          (void)fprintf(stderr, "Executing kernel failed: %s (%d)\n",
+                        oclc::cl_error_code_to_name_map[err].c_str(), err);
+        }
+        autotune_timings_.clear();
+        break;
+      }
+      if (run > 0) {
+        autotune_timings_.push_back(end - start);
+      }
+    }
+  } else if (execute_) {
     err =
         clEnqueueNDRangeKernel(queue, kernel, work_dim_, nullptr,
                                global_work_size_[global_work_size_index].data(),
@@ -1976,7 +2066,7 @@ bool oclc::Driver::EnqueueKernel() {
 
     OCLC_CHECK_CL(clReleaseEvent(user_event), "Error releasing user event");
   }
-  if (execute_) {
+  if (execute_ && !autotune_) {
     // display the output from -compare flags
     for (auto &pair : compared_argument_map_) {
       const auto &name = pair.first;
@@ -2122,6 +2212,289 @@ bool oclc::Driver::EnqueueKernel() {
   return oclc::success;
 }
 
+bool oclc::Driver::ParseAutotuneLocalSizes(const char *rawArg) {
+  for (const auto &sizeString : cargo::split(rawArg, ":")) {
+    std::vector<std::string> sizeList;
+    SplitAndExpandList(std::string(sizeString.data(), sizeString.size()), '\0',
+                       sizeList);
+    OCLC_CHECK_FMT(sizeList.empty() || sizeList.size() > 3 ||
+                       !VerifyGreaterThanZero(sizeList),
+                   "error: autotune local sizes '%s' are invalid.\n", rawArg);
+    std::vector<size_t> localSize;
+    for (const std::string &size : sizeList) {
+      localSize.push_back(
+          static_cast<size_t>(strtoull(size.c_str(), nullptr, 10)));
+    }
+    autotune_local_sizes_.push_back(localSize);
+  }
+  return oclc::success;
+}
+
+bool oclc::Driver::GenerateAutotuneLocalSizes(vector2d<size_t> &localSizes) {
+  size_t max_work_group_size = 0;
+  cl_int err =
+      clGetDeviceInfo(device_, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(size_t),
+                      &max_work_group_size, nullptr);
+  OCLC_CHECK_CL(err, "Querying the maximum work-group size failed");
+  std::array<size_t, 3> max_work_item_sizes = {};
+  err = clGetDeviceInfo(device_, CL_DEVICE_MAX_WORK_ITEM_SIZES,
+                        sizeof(max_work_item_sizes),
+                        max_work_item_sizes.data(), nullptr);
+  OCLC_CHECK_CL(err, "Querying the maximum work-item sizes failed");
+
+  // Let the implementation choose too.
+  localSizes.push_back({});
+
+  // Only sweep small sizes in the higher dimensions, since vectorization only
+  // happens along the first.
+  const size_t max_higher_dim_size = 4;
+  const std::vector<size_t> &global = global_work_size_[0];
+  vector2d<size_t> candidates = {{}};
+  for (size_t dim = 0; dim < work_dim_; dim++) {
+    const size_t limit =
+        std::min(max_work_item_sizes[dim],
+                 dim == 0 ? global[dim] : max_higher_dim_size);
+    vector2d<size_t> extended;
+    for (const auto &candidate : candidates) {
+      size_t product = 1;
+      for (const size_t size : candidate) {
+        product *= size;
+      }
+      for (size_t size = 1; size <= limit; size *= 2) {
+        if (global[dim] % size != 0 || product * size > max_work_group_size) {
+          continue;
+        }
+        extended.push_back(candidate);
+        extended.back().push_back(size);
+      }
+    }
+    candidates = std::move(extended);
+  }
+  localSizes.insert(localSizes.end(), candidates.begin(), candidates.end());
+  return oclc::success;
+}
+
+namespace {
+/// @brief Sets an environment variable for the OpenCL implementation to read,
+/// or unsets it if `value` is empty.
+void SetEnvironmentVariable(const char *name, const std::string &value) {
+#ifdef _WIN32
+  (void)_putenv_s(name, value.c_str());
+#else
+  if (value.empty()) {
+    (void)unsetenv(name);
+  } else {
+    (void)setenv(name, value.c_str(), 1);
+  }
+#endif
+}
+
+/// @brief Formats a local work size, or "auto" if empty.
+std::string LocalSizeToString(const std::vector<size_t> &localSize) {
+  if (localSize.empty()) {
+    return "auto";
+  }
+  std::string result;
+  for (const size_t size : localSize) {
+    if (!result.empty()) {
+      result += ",";
+    }
+    result += std::to_string(size);
+  }
+  return result;
+}
+
+/// @brief Escapes a string for use in JSON.
+std::string EscapeJSON(const std::string &str) {
+  std::string result;
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+    }
+    result += c;
+  }
+  return result;
+}
+
+/// @brief Name of the environment variable setting the host vectorization
+/// width.
+constexpr const char *HostVFVariable = "CA_HOST_VF";
+/// @brief Name of the environment variable setting the vectorizer choices.
+constexpr const char *VeczChoicesVariable = "CODEPLAY_VECZ_CHOICES";
+}  // namespace
+
+bool oclc::Driver::Autotune() {
+  vector2d<size_t> localSizes = autotune_local_sizes_;
+  if (localSizes.empty() &&
+      GenerateAutotuneLocalSizes(localSizes) != oclc::success) {
+    return oclc::failure;
+  }
+  std::vector<std::string> veczChoices = {""};
+  veczChoices.insert(veczChoices.end(), autotune_vecz_choices_.begin(),
+                     autotune_vecz_choices_.end());
+  const std::vector<cl_uint> widths =
+      autotune_widths_.empty() ? std::vector<cl_uint>{1, 4, 8, 16}
+                               : autotune_widths_;
+
+  // Restore the environment the user ran oclc with once finished.
+  const char *originalHostVF = std::getenv(HostVFVariable);
+  const char *originalVeczChoices = std::getenv(VeczChoicesVariable);
+  const std::string savedHostVF = originalHostVF ? originalHostVF : "";
+  const std::string savedVeczChoices =
+      originalVeczChoices ? originalVeczChoices : "";
+
+  const std::string baseOptions = cl_options_;
+  std::vector<AutotuneResult> results;
+  size_t failures = 0;
+  for (const std::string &choices : veczChoices) {
+    for (const cl_uint width : widths) {
+      SetEnvironmentVariable(VeczChoicesVariable, choices);
+      SetEnvironmentVariable(HostVFVariable,
+                             width > 1 ? std::to_string(width) : "");
+      cl_options_ = baseOptions;
+      cl_options_ += width > 1 ? " -cl-wfv=always" : " -cl-wfv=never";
+
+      // Each configuration is built from scratch, as the environment is only
+      // read when the kernel is compiled.
+      if (program_) {
+        clReleaseProgram(program_);
+        program_ = nullptr;
+      }
+      if (BuildProgram() != oclc::success) {
+        failures += localSizes.size();
+        continue;
+      }
+
+      for (const auto &localSize : localSizes) {
+        // The kernel is never vectorized wider than its local size, so these
+        // configurations duplicate narrower widths.
+        if (width > 1 && !localSize.empty() && localSize[0] < width) {
+          continue;
+        }
+        local_work_size_.clear();
+        if (!localSize.empty()) {
+          local_work_size_.push_back(localSize);
+          FillSizeInfo(local_work_size_);
+        }
+        autotune_timings_.clear();
+        if (EnqueueKernel() != oclc::success || autotune_timings_.empty()) {
+          if (verbose_) {
+            (void)fprintf(stderr,
+                          "Skipping local size %s, width %u, choices '%s'\n",
+                          LocalSizeToString(localSize).c_str(), width,
+                          choices.c_str());
+          }
+          failures++;
+          continue;
+        }
+        std::sort(autotune_timings_.begin(), autotune_timings_.end());
+        results.push_back({choices, width, localSize,
+                           autotune_timings_[autotune_timings_.size() / 2],
+                           autotune_timings_.front()});
+      }
+    }
+  }
+  SetEnvironmentVariable(VeczChoicesVariable, savedVeczChoices);
+  SetEnvironmentVariable(HostVFVariable, savedHostVF);
+  cl_options_ = baseOptions;
+
+  OCLC_CHECK(results.empty(), "No autotuned configuration could be executed");
+  std::stable_sort(results.begin(), results.end(),
+                   [](const AutotuneResult &a, const AutotuneResult &b) {
+                     return a.median_ns < b.median_ns;
+                   });
+
+  std::ostringstream report;
+  report << "Autotuned " << results.size() << " configurations of kernel '"
+         << enqueue_kernel_ << "'";
+  if (failures) {
+    report << ", " << failures << " failed";
+  }
+  report << "\n\n"
+         << std::left << std::setw(6) << "rank" << std::setw(14)
+         << "median (us)" << std::setw(14) << "min (us)" << std::setw(12)
+         << "speedup" << std::setw(14) << "local size" << std::setw(8)
+         << "width"
+         << "vecz choices\n";
+  const double slowest = static_cast<double>(results.back().median_ns);
+  for (size_t i = 0; i < results.size(); i++) {
+    const AutotuneResult &result = results[i];
+    report << std::setw(6) << (i + 1) << std::fixed << std::setprecision(3)
+           << std::setw(14) << (result.median_ns / 1000.0) << std::setw(14)
+           << (result.min_ns / 1000.0) << std::setprecision(2)
+           << std::setw(12) << (slowest / std::max<double>(result.median_ns, 1))
+           << std::setw(14) << LocalSizeToString(result.local_size)
+           << std::setw(8) << result.width
+           << (result.vecz_choices.empty() ? "-" : result.vecz_choices)
+           << "\n";
+  }
+  const std::string reportString = report.str();
+  (void)fwrite(reportString.data(), 1, reportString.size(), stdout);
+
+  if (!autotune_profile_file_.empty()) {
+    return WriteAutotuneProfile(results);
+  }
+  return oclc::success;
+}
+
+bool oclc::Driver::WriteAutotuneProfile(
+    const std::vector<AutotuneResult> &results) {
+  // Describes how to reproduce a configuration, the build options and
+  // environment apply when building the program, the local size when
+  // enqueueing the kernel.
+  auto describe = [&](const AutotuneResult &result) {
+    std::ostringstream json;
+    json << "{\"median_ns\": " << result.median_ns
+         << ", \"min_ns\": " << result.min_ns << ", \"local_size\": ";
+    if (result.local_size.empty()) {
+      json << "null";
+    } else {
+      json << "[" << LocalSizeToString(result.local_size) << "]";
+    }
+    std::string buildOptions =
+        result.width > 1 ? "-cl-wfv=always" : "-cl-wfv=never";
+    if (!result.local_size.empty()) {
+      // Lets the implementation compile the kernel for the local size when the
+      // program is built rather than when it is first enqueued.
+      buildOptions +=
+          " -cl-precache-local-sizes=" + LocalSizeToString(result.local_size);
+    }
+    json << ", \"build_options\": \"" << EscapeJSON(buildOptions)
+         << "\", \"environment\": {";
+    const char *separator = "";
+    if (result.width > 1) {
+      json << "\"" << HostVFVariable << "\": \"" << result.width << "\"";
+      separator = ", ";
+    }
+    if (!result.vecz_choices.empty()) {
+      json << separator << "\"" << VeczChoicesVariable << "\": \""
+           << EscapeJSON(result.vecz_choices) << "\"";
+    }
+    json << "}}";
+    return json.str();
+  };
+
+  std::ostringstream json;
+  json << "{\n  \"kernel\": \"" << EscapeJSON(enqueue_kernel_) << "\",\n"
+       << "  \"global_size\": ["
+       << LocalSizeToString(global_work_size_[0]) << "],\n"
+       << "  \"best\": " << describe(results.front()) << ",\n"
+       << "  \"results\": [\n";
+  for (size_t i = 0; i < results.size(); i++) {
+    json << "    " << describe(results[i])
+         << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  json << "  ]\n}\n";
+
+  std::ofstream file(autotune_profile_file_);
+  OCLC_CHECK_FMT(!file, "error: could not open '%s' to write the profile.\n",
+                 autotune_profile_file_.c_str());
+  file << json.str();
+  OCLC_CHECK_FMT(!file, "error: could not write the profile to '%s'.\n",
+                 autotune_profile_file_.c_str());
+  return oclc::success;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 bool oclc::Arguments::HasMore() const { return HasMore(1); }
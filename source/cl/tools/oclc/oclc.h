@@ -152,6 +152,12 @@ class Driver {
   /// @brief Try to enqueue a kernel
   /// @return oclc::success or oclc::failure.
   bool EnqueueKernel();
+  /// @brief Determine whether oclc should autotune the enqueued kernel.
+  bool IsAutotuning() const { return autotune_; }
+  /// @brief Build and time the enqueued kernel in every candidate
+  /// configuration, then report the configurations ranked by execution time.
+  /// @return oclc::success or oclc::failure.
+  bool Autotune();
   /// @brief Number of times the kernel should be executed.
   size_t execution_limit_;
   /// @brief The current iteration of the kernel execution.
@@ -309,6 +315,30 @@ class Driver {
   /// @brief Converts an OpenCL buffer to a comma seperated string list.
   std::string BufferToString(const unsigned char *buffer, size_t n,
                              const std::string &dataType);
+  /// @brief Parses a list of local work sizes to autotune, of the form
+  /// `<l1>,<l2>,...:<l1>,<l2>,...`.
+  bool ParseAutotuneLocalSizes(const char *rawArg);
+  /// @brief Generates the local work sizes to autotune when none were given,
+  /// every power of two local size which evenly divides the global work size
+  /// and fits on the device, plus the implementation's choice.
+  bool GenerateAutotuneLocalSizes(vector2d<size_t> &localSizes);
+  /// @brief Execution time of the enqueued kernel in an autotuned
+  /// configuration.
+  struct AutotuneResult {
+    /// @brief Value of `CODEPLAY_VECZ_CHOICES`, empty if unset.
+    std::string vecz_choices;
+    /// @brief Vectorization width, 1 if vectorization was disabled.
+    cl_uint width;
+    /// @brief Local work size, empty if chosen by the implementation.
+    std::vector<size_t> local_size;
+    /// @brief Median execution time in nanoseconds.
+    cl_ulong median_ns;
+    /// @brief Minimum execution time in nanoseconds.
+    cl_ulong min_ns;
+  };
+  /// @brief Writes the ranked autotuning results to `autotune_profile_file_`
+  /// as JSON.
+  bool WriteAutotuneProfile(const std::vector<AutotuneResult> &results);
 
   // Attributes:
 
@@ -381,6 +411,24 @@ class Driver {
   bool verbose_;
   /// @brief True if executing enqueued kernel.
   bool execute_;
+
+  /// @brief True if autotuning the enqueued kernel.
+  bool autotune_;
+  /// @brief Number of timed executions of each autotuned configuration.
+  size_t autotune_repeat_;
+  /// @brief Candidate local work sizes to autotune, an empty local work size
+  /// lets the implementation choose.
+  vector2d<size_t> autotune_local_sizes_;
+  /// @brief Candidate `CODEPLAY_VECZ_CHOICES` values to autotune.
+  std::vector<std::string> autotune_vecz_choices_;
+  /// @brief Candidate vectorization widths to autotune, a width of 1 disables
+  /// vectorization.
+  std::vector<cl_uint> autotune_widths_;
+  /// @brief Path to write the machine-readable autotuning profile to.
+  std::string autotune_profile_file_;
+  /// @brief Kernel execution times in nanoseconds, recorded by EnqueueKernel
+  /// when autotuning.
+  std::vector<cl_ulong> autotune_timings_;
 };
 
 /// @brief Helps with consuming arguments from the command-line.
@@ -245,7 +245,7 @@ struct command_info {
         dispatch_command(dispatch_command) {}
   command_info(command_info_dispatch_indirect dispatch_indirect_command)
       : type(command_type_dispatch_indirect),
-        stage_flag(0),
+        stage_flag(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT),
         dispatch_indirect_command(dispatch_indirect_command) {}
   command_info(command_info_copy_buffer copy_buffer_command)
       : type(command_type_copy_buffer),
@@ -473,6 +473,11 @@ typedef struct command_buffer_t final : icd_t<command_buffer_t> {
     std::array<size_t, 3> local_size;
     std::array<size_t, 3> global_offset;
     std::array<size_t, 3> global_size;
+    /// @brief Buffer the work-group counts of an indirect dispatch are read
+    /// from, or null.
+    mux_buffer_t group_count_buffer;
+    /// @brief Offset of the work-group counts in `group_count_buffer`.
+    uint64_t group_count_offset;
     mux_kernel_t mux_binary_kernel;
     mux::unique_ptr<mux_executable_t> specialized_kernel_executable;
     mux::unique_ptr<mux_kernel_t> specialized_kernel;
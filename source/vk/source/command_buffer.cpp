@@ -119,6 +119,8 @@ command_buffer_t::~command_buffer_t() {}
 command_buffer_t::recorded_kernel::recorded_kernel(vk::allocator allocator)
     : descriptors(
           {allocator.getCallbacks(), VK_SYSTEM_ALLOCATION_SCOPE_COMMAND}),
+      group_count_buffer(nullptr),
+      group_count_offset(0),
       mux_binary_kernel(nullptr),
       specialized_kernel_executable(nullptr,
                                     {nullptr, {nullptr, nullptr, nullptr}}),
@@ -662,13 +664,25 @@ void CmdBindDescriptorSets(vk::command_buffer commandBuffer,
   }
 }
 
-void CmdDispatch(vk::command_buffer commandBuffer, uint32_t x, uint32_t y,
-                 uint32_t z) {
+namespace {
+/// @brief Record a direct or indirect dispatch to a command buffer.
+///
+/// @param commandBuffer Command buffer to record the dispatch to.
+/// @param command Command to record for replaying the dispatch.
+/// @param group_count Number of work-groups in each dimension, ignored if
+/// `group_count_buffer` is not null.
+/// @param group_count_buffer Buffer the number of work-groups is read from
+/// when the dispatch executes, or null.
+/// @param group_count_offset Offset of the work-group counts in
+/// `group_count_buffer`.
+void recordDispatch(vk::command_buffer commandBuffer,
+                    const vk::command_info &command,
+                    std::array<uint32_t, 3> group_count,
+                    mux_buffer_t group_count_buffer,
+                    uint64_t group_count_offset) {
   if (VK_COMMAND_BUFFER_LEVEL_SECONDARY ==
       commandBuffer->command_buffer_level) {
-    const vk::command_info_dispatch command = {x, y, z};
-    if (commandBuffer->compute_command_list->push_back(
-            vk::command_info(command))) {
+    if (commandBuffer->compute_command_list->push_back(command)) {
       commandBuffer->error = VK_ERROR_OUT_OF_HOST_MEMORY;
     }
   } else if (vk::command_buffer_t::recording == commandBuffer->state) {
@@ -894,9 +908,17 @@ void CmdDispatch(vk::command_buffer commandBuffer, uint32_t x, uint32_t y,
     recorded_kernel.local_size = {commandBuffer->wgs[0], commandBuffer->wgs[1],
                                   commandBuffer->wgs[2]};
     recorded_kernel.global_offset = {0, 0, 0};
-    recorded_kernel.global_size = {(size_t)x * (size_t)commandBuffer->wgs[0],
-                                   (size_t)y * (size_t)commandBuffer->wgs[1],
-                                   (size_t)z * (size_t)commandBuffer->wgs[2]};
+    // Indirect dispatches are specialized for a single work-group, the kernel
+    // does not depend on the global size it is run with.
+    if (group_count_buffer) {
+      group_count = {1, 1, 1};
+    }
+    recorded_kernel.global_size = {
+        (size_t)group_count[0] * (size_t)commandBuffer->wgs[0],
+        (size_t)group_count[1] * (size_t)commandBuffer->wgs[1],
+        (size_t)group_count[2] * (size_t)commandBuffer->wgs[2]};
+    recorded_kernel.group_count_buffer = group_count_buffer;
+    recorded_kernel.group_count_offset = group_count_offset;
     if (commandBuffer->mux_binary_kernel) {
       recorded_kernel.mux_binary_kernel = commandBuffer->mux_binary_kernel;
     } else {
@@ -965,25 +987,33 @@ void CmdDispatch(vk::command_buffer commandBuffer, uint32_t x, uint32_t y,
     }
 
     // need to push the command here so that it gets executed in the submit
-    const vk::command_info_dispatch command = {x, y, z};
-    if (commandBuffer->commands.push_back(vk::command_info(command))) {
+    if (commandBuffer->commands.push_back(command)) {
       commandBuffer->error = VK_ERROR_OUT_OF_HOST_MEMORY;
     }
   } else {
     // Take the next kernel off the kernel list
     auto &specialized_kernel = *commandBuffer->specialized_kernels.begin();
+    mux_command_buffer_t mux_command_buffer = nullptr;
     if (command_buffer_t::pending == commandBuffer->state) {
-      if (auto error = muxCommandNDRange(
-              commandBuffer->compute_command_buffer,
-              specialized_kernel.getMuxKernel(),
-              specialized_kernel.getMuxNDRangeOptions(), 0, nullptr, nullptr)) {
-        commandBuffer->error = vk::getVkResult(error);
-      }
+      mux_command_buffer = commandBuffer->compute_command_buffer;
     } else if (command_buffer_t::resolving == commandBuffer->state) {
-      if (auto error = muxCommandNDRange(
-              commandBuffer->barrier_group_infos.back()->command_buffer,
-              specialized_kernel.getMuxKernel(),
-              specialized_kernel.getMuxNDRangeOptions(), 0, nullptr, nullptr)) {
+      mux_command_buffer =
+          commandBuffer->barrier_group_infos.back()->command_buffer;
+    }
+    if (mux_command_buffer) {
+      const mux_result_t error =
+          specialized_kernel.group_count_buffer
+              ? muxCommandNDRangeIndirect(
+                    mux_command_buffer, specialized_kernel.getMuxKernel(),
+                    specialized_kernel.getMuxNDRangeOptions(),
+                    specialized_kernel.group_count_buffer,
+                    specialized_kernel.group_count_offset, 0, nullptr,
+                    nullptr)
+              : muxCommandNDRange(mux_command_buffer,
+                                  specialized_kernel.getMuxKernel(),
+                                  specialized_kernel.getMuxNDRangeOptions(), 0,
+                                  nullptr, nullptr);
+      if (error) {
         commandBuffer->error = vk::getVkResult(error);
       }
     }
@@ -1002,6 +1032,25 @@ void CmdDispatch(vk::command_buffer commandBuffer, uint32_t x, uint32_t y,
         commandBuffer->specialized_kernels.begin());
   }
 }
+}  // namespace
+
+void CmdDispatch(vk::command_buffer commandBuffer, uint32_t x, uint32_t y,
+                 uint32_t z) {
+  const vk::command_info_dispatch command = {x, y, z};
+  recordDispatch(commandBuffer, vk::command_info(command), {x, y, z}, nullptr,
+                 0);
+}
+
+void CmdDispatchIndirect(vk::command_buffer commandBuffer, vk::buffer buffer,
+                         VkDeviceSize offset) {
+  if (!commandBuffer->mux_device->info->supports_indirect_ndrange) {
+    commandBuffer->error = VK_ERROR_FEATURE_NOT_PRESENT;
+    return;
+  }
+  const vk::command_info_dispatch_indirect command = {buffer, offset};
+  recordDispatch(commandBuffer, vk::command_info(command), {1, 1, 1},
+                 buffer->mux_buffer, offset);
+}
 
 void ExecuteCommand(vk::command_buffer commandBuffer,
                     const vk::command_info &command_info) {
@@ -1026,6 +1075,9 @@ void ExecuteCommand(vk::command_buffer commandBuffer,
                       command_info.dispatch_command.z);
       break;
     case vk::command_type_dispatch_indirect:
+      vk::CmdDispatchIndirect(commandBuffer,
+                              command_info.dispatch_indirect_command.buffer,
+                              command_info.dispatch_indirect_command.offset);
       break;
     case vk::command_type_copy_buffer:
       vk::CmdCopyBuffer(commandBuffer,
@@ -1453,14 +1505,6 @@ void CmdPipelineBarrier(vk::command_buffer commandBuffer,
   }
 }
 
-void CmdDispatchIndirect(vk::command_buffer commandBuffer, vk::buffer buffer,
-                         VkDeviceSize offset) {
-  (void)buffer;
-  (void)offset;
-
-  commandBuffer->error = VK_ERROR_FEATURE_NOT_PRESENT;
-}
-
 void CmdCopyImage(vk::command_buffer commandBuffer, vk::image srcImage,
                   VkImageLayout srcImageLayout, vk::image dstImage,
                   VkImageLayout dstImageLayout, uint32_t regionCount,